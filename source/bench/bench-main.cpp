@@ -0,0 +1,60 @@
+#include "bench/bench.hpp"
+
+void bench_rs_graphics_core_colour_conversion();
+void bench_rs_graphics_core_colour_blending();
+void bench_rs_graphics_core_colour_strings();
+void bench_rs_graphics_core_colour_difference();
+void bench_rs_graphics_core_colour_gamut_mapping();
+void bench_rs_graphics_core_colour_lut_evaluation();
+void bench_rs_graphics_core_colour_palette_mapping();
+void bench_rs_graphics_core_linear_map_lookup();
+void bench_rs_graphics_core_matrix_arithmetic();
+void bench_rs_graphics_core_multi_array_access();
+void bench_rs_graphics_core_noise_evaluation();
+void bench_rs_graphics_core_noise_tables();
+void bench_rs_graphics_core_noise_seeding();
+void bench_rs_graphics_core_noise_gradient();
+void bench_rs_graphics_core_planar_image_conversion();
+
+int main(int argc, char** argv) {
+
+    RS::Graphics::Core::Bench::begin(argc, argv);
+
+    // colour-bench.cpp
+    bench_rs_graphics_core_colour_conversion();
+    bench_rs_graphics_core_colour_blending();
+    bench_rs_graphics_core_colour_strings();
+
+    // colour-difference-bench.cpp
+    bench_rs_graphics_core_colour_difference();
+
+    // colour-gamut-bench.cpp
+    bench_rs_graphics_core_colour_gamut_mapping();
+
+    // colour-lut-bench.cpp
+    bench_rs_graphics_core_colour_lut_evaluation();
+
+    // colour-palette-bench.cpp
+    bench_rs_graphics_core_colour_palette_mapping();
+
+    // linear-map-bench.cpp
+    bench_rs_graphics_core_linear_map_lookup();
+
+    // matrix-bench.cpp
+    bench_rs_graphics_core_matrix_arithmetic();
+
+    // multi-array-bench.cpp
+    bench_rs_graphics_core_multi_array_access();
+
+    // noise-bench.cpp
+    bench_rs_graphics_core_noise_evaluation();
+    bench_rs_graphics_core_noise_tables();
+    bench_rs_graphics_core_noise_seeding();
+    bench_rs_graphics_core_noise_gradient();
+
+    // planar-image-bench.cpp
+    bench_rs_graphics_core_planar_image_conversion();
+
+    return RS::Graphics::Core::Bench::end();
+
+}
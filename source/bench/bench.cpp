@@ -0,0 +1,139 @@
+#include "bench/bench.hpp"
+#include "rs-graphics-core/parallel.hpp"
+#include "rs-graphics-core/simd.hpp"
+#include "rs-graphics-core/version.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace RS::Graphics::Core::Bench {
+
+    namespace {
+
+        std::vector<std::string> filters;
+        std::vector<Result> results;
+        double min_time = 0.2;
+        bool json = false;
+
+        void usage(const char* program) {
+            std::printf("Usage: %s [options] [filter...]\n"
+                "Runs the benchmarks whose names contain any of the filter strings (default all).\n"
+                "Options:\n"
+                "    --json          Write the results as JSON to standard output\n"
+                "    --min-time=SEC  Minimum time to run each benchmark (default 0.2)\n"
+                "    --help          Show this message\n",
+                program);
+        }
+
+        std::string quote(const std::string& str) {
+            std::string out = "\"";
+            for (char c: str) {
+                if (c == '"' || c == '\\')
+                    out += '\\';
+                out += c;
+            }
+            out += '"';
+            return out;
+        }
+
+        std::string format_rate(double x) {
+            static constexpr const char* prefixes[] = {"", "k", "M", "G", "T"};
+            int i = 0;
+            for (; x >= 1000 && i < 4; ++i)
+                x /= 1000;
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%.3g%s", x, prefixes[i]);
+            return buf;
+        }
+
+        const char* simd_name(SimdLevel level) noexcept {
+            switch (level) {
+                case SimdLevel::sse2:    return "sse2";
+                case SimdLevel::avx2:    return "avx2";
+                case SimdLevel::avx512:  return "avx512";
+                default:                 return "none";
+            }
+        }
+
+    }
+
+    void begin(int argc, char** argv) {
+
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                usage(argv[0]);
+                std::exit(0);
+            } else if (arg == "--json") {
+                json = true;
+            } else if (arg.compare(0, 11, "--min-time=") == 0) {
+                min_time = std::atof(arg.data() + 11);
+                if (min_time <= 0) {
+                    usage(argv[0]);
+                    std::exit(1);
+                }
+            } else if (arg[0] == '-') {
+                usage(argv[0]);
+                std::exit(1);
+            } else {
+                filters.push_back(arg);
+            }
+        }
+
+        if (! json)
+            std::printf("%-52s %14s %14s\n", "Benchmark", "ns/op", "items/s");
+
+    }
+
+    int end() {
+
+        if (json) {
+            std::printf("{\n");
+            std::printf("  \"context\": {\n");
+            std::printf("    \"library\": \"rs-graphics-core\",\n");
+            std::printf("    \"version\": %s,\n", quote(version_string()).data());
+            std::printf("    \"simd\": \"%s\",\n", simd_name(simd_level()));
+            std::printf("    \"threads\": %d,\n", ThreadPool::global().threads());
+            std::printf("    \"min_time\": %g\n", min_time);
+            std::printf("  },\n");
+            std::printf("  \"benchmarks\": [");
+            for (size_t i = 0; i < results.size(); ++i) {
+                auto& r = results[i];
+                std::printf("%s\n    {\"name\": %s, \"ns_per_op\": %.6g, \"items_per_second\": %.6g, \"ops\": %zu",
+                    i == 0 ? "" : ",", quote(r.name).data(), r.ns_per_op, r.items_per_second, r.ops);
+                if (! r.note.empty())
+                    std::printf(", \"note\": %s", quote(r.note).data());
+                std::printf("}");
+            }
+            std::printf("\n  ]\n}\n");
+        }
+
+        return 0;
+
+    }
+
+    double min_seconds() noexcept {
+        return min_time;
+    }
+
+    void report(const Result& result) {
+        if (json) {
+            results.push_back(result);
+        } else {
+            std::printf("%-52s %14.2f %14s  %s\n", result.name.data(), result.ns_per_op,
+                format_rate(result.items_per_second).data(), result.note.data());
+            std::fflush(stdout);
+        }
+    }
+
+    bool selected(const std::string& name) {
+        if (filters.empty())
+            return true;
+        for (auto& f: filters)
+            if (name.find(f) != std::string::npos)
+                return true;
+        return false;
+    }
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace RS::Graphics::Core::Bench {
+
+    struct Result {
+        std::string name;
+        std::string note;
+        double ns_per_op = 0;
+        double items_per_second = 0;
+        size_t ops = 0;
+    };
+
+    // Harness functions (see bench.cpp)
+
+    void begin(int argc, char** argv);
+    int end();
+    double min_seconds() noexcept;
+    void report(const Result& result);
+    bool selected(const std::string& name);
+
+    // Store a result where the optimizer can't see it, so the work that
+    // produced it is not discarded
+
+    inline volatile double sink = 0;
+
+    inline void keep(double x) noexcept {
+        sink = x;
+    }
+
+    // Call f() repeatedly for at least the minimum time, after one warm-up
+    // call. Each call performs ops_per_call operations, and returns the number
+    // of items processed (pixels, points, etc). Skipped if the name does not
+    // match the command line filters.
+
+    template <typename F>
+    void benchmark(const std::string& name, F f, size_t ops_per_call = 1, const std::string& note = {}) {
+
+        using clock = std::chrono::steady_clock;
+
+        if (! selected(name))
+            return;
+
+        f();
+        size_t calls = 0;
+        size_t items = 0;
+        std::chrono::duration<double> elapsed{};
+        auto start = clock::now();
+
+        do {
+            items += size_t(f());
+            ++calls;
+            elapsed = clock::now() - start;
+        } while (elapsed.count() < min_seconds());
+
+        Result result;
+        result.name = name;
+        result.note = note;
+        result.ops = calls * ops_per_call;
+        result.ns_per_op = 1e9 * elapsed.count() / double(result.ops);
+        result.items_per_second = double(items) / elapsed.count();
+        report(result);
+
+    }
+
+}
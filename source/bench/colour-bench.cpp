@@ -0,0 +1,203 @@
+#include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/colour-space.hpp"
+#include "bench/bench.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace RS::Graphics::Core;
+using namespace RS::Graphics::Core::Bench;
+
+namespace {
+
+    constexpr size_t n_colours = 1024;
+
+    template <typename C>
+    std::vector<C> random_colours() {
+        std::minstd_rand rng(42);
+        std::uniform_real_distribution<double> dist(0, 1);
+        std::vector<C> colours(n_colours);
+        for (auto& c: colours)
+            for (auto& x: c)
+                x = typename C::value_type(dist(rng) * double(C::scale));
+        return colours;
+    }
+
+    template <typename C1, typename C2>
+    void conversion(const std::string& name) {
+        auto in = random_colours<C1>();
+        std::vector<C2> out(n_colours);
+        benchmark("convert_colour " + name, [&] {
+            for (size_t i = 0; i < n_colours; ++i)
+                convert_colour(in[i], out[i]);
+            keep(double(out[0][0]));
+            return n_colours;
+        }, n_colours);
+    }
+
+    template <typename C1, typename C2>
+    void bulk_conversion(const std::string& name, ColourPrecision precision = ColourPrecision::exact) {
+        auto in = random_colours<C1>();
+        std::vector<C2> out(n_colours);
+        auto suffix = precision == ColourPrecision::fast ? " fast" : "";
+        benchmark("convert_colour bulk " + name + suffix, [&] {
+            convert_colour(in.data(), out.data(), n_colours, precision);
+            keep(double(out[0][0]));
+            return n_colours;
+        }, n_colours);
+    }
+
+    template <typename C>
+    void blend(const std::string& name, Pma flags = {}) {
+        auto a = random_colours<C>();
+        auto b = random_colours<C>();
+        std::vector<C> out(n_colours);
+        benchmark("alpha_blend " + name, [&] {
+            for (size_t i = 0; i < n_colours; ++i)
+                out[i] = alpha_blend(a[i], b[i], flags);
+            keep(double(out[0][0]));
+            return n_colours;
+        }, n_colours);
+    }
+
+    template <typename C>
+    void span_blend(const std::string& name, Pma flags = {}, ColourPrecision precision = ColourPrecision::exact) {
+        auto a = random_colours<C>();
+        auto b = random_colours<C>();
+        auto suffix = precision == ColourPrecision::fast ? " fast" : "";
+        benchmark("alpha_blend span " + name + suffix, [&] {
+            alpha_blend(a.data(), b.data(), n_colours, flags, precision);
+            keep(double(b[0][0]));
+            return n_colours;
+        }, n_colours);
+    }
+
+}
+
+void bench_rs_graphics_core_colour_conversion() {
+
+    using AdobeRgb8 = Colour<uint8_t, AdobeRGB, ColourLayout::forward>;
+    using CIELabd = Colour<double, CIELab>;
+    using CIELuvd = Colour<double, CIELuv>;
+    using CIEXYZd = Colour<double, CIEXYZ>;
+    using HCLabd = Colour<double, HCLab>;
+    using HSLd = Colour<double, HSL>;
+    using HSVd = Colour<double, HSV>;
+    using AdobeRgbd = Colour<double, AdobeRGB>;
+    using LinearAdobeRgbd = Colour<double, LinearAdobeRGB>;
+    using LinearProPhotod = Colour<double, LinearProPhoto>;
+    using CIELabf = Colour<float, CIELab, ColourLayout::forward>;
+    using CIELuvf = Colour<float, CIELuv, ColourLayout::forward>;
+    using HCLabf = Colour<float, HCLab, ColourLayout::forward>;
+
+    conversion<sRgbf, Rgbf>("sRGB -> LinearRGB float");
+    conversion<Rgbf, sRgbf>("LinearRGB -> sRGB float");
+    conversion<sRgb8, Rgbf>("sRGB 8-bit -> LinearRGB float");
+    conversion<Rgbf, sRgb8>("LinearRGB float -> sRGB 8-bit");
+    conversion<sRgb16, Rgbf>("sRGB 16-bit -> LinearRGB float");
+    conversion<AdobeRgb8, Rgbf>("AdobeRGB 8-bit -> LinearRGB float");
+    conversion<Rgbf, AdobeRgb8>("LinearRGB float -> AdobeRGB 8-bit");
+    conversion<Rgbd, CIEXYZd>("LinearRGB -> CIEXYZ double");
+    conversion<sRgbd, CIELabd>("sRGB -> CIELab double");
+    conversion<CIELabd, sRgbd>("CIELab -> sRGB double");
+    conversion<sRgbd, CIELuvd>("sRGB -> CIELuv double");
+    conversion<sRgbd, HCLabd>("sRGB -> HCLab double");
+    conversion<sRgbd, HSLd>("sRGB -> HSL double");
+    conversion<HSVd, sRgbd>("HSV -> sRGB double");
+    conversion<HSLd, HSVd>("HSL -> HSV double");
+    conversion<CIELabd, HCLabd>("CIELab -> HCLab double");
+    conversion<sRgbd, AdobeRgbd>("sRGB -> AdobeRGB double");
+    conversion<LinearAdobeRgbd, LinearProPhotod>("LinearAdobeRGB -> LinearProPhoto double");
+    conversion<Rgba8, Rgbaf>("Rgba8 -> Rgbaf");
+    conversion<Rgbaf, Rgba8>("Rgbaf -> Rgba8");
+    conversion<sRgba8, Rgbaf>("sRgba8 -> Rgbaf");
+    conversion<Rgbaf, sRgba8>("Rgbaf -> sRgba8");
+
+    bulk_conversion<Rgba8, Rgbaf>("Rgba8 -> Rgbaf");
+    bulk_conversion<Rgbaf, Rgba8>("Rgbaf -> Rgba8");
+    bulk_conversion<sRgba8, Rgbaf>("sRgba8 -> Rgbaf");
+    bulk_conversion<Rgbaf, sRgba8>("Rgbaf -> sRgba8");
+
+    for (auto precision: {ColourPrecision::exact, ColourPrecision::fast}) {
+        bulk_conversion<sRgbf, Rgbf>("sRgbf -> Rgbf", precision);
+        bulk_conversion<Rgbf, sRgbf>("Rgbf -> sRgbf", precision);
+        bulk_conversion<Rgbaf, sRgba16>("Rgbaf -> sRgba16", precision);
+        bulk_conversion<sRgbf, CIELabf>("sRgbf -> CIELabf", precision);
+        bulk_conversion<CIELabf, sRgbf>("CIELabf -> sRgbf", precision);
+        bulk_conversion<sRgbf, CIELuvf>("sRgbf -> CIELuvf", precision);
+        bulk_conversion<sRgbf, HCLabf>("sRgbf -> HCLabf", precision);
+        bulk_conversion<HCLabf, sRgbf>("HCLabf -> sRgbf", precision);
+    }
+
+}
+
+void bench_rs_graphics_core_colour_blending() {
+
+    blend<Rgbaf>("Rgbaf");
+    blend<Rgbaf>("Rgbaf premultiplied", Pma::all);
+    blend<Rgba8>("Rgba8");
+    blend<Rgba16>("Rgba16");
+
+    span_blend<Rgbaf>("Rgbaf");
+    span_blend<Rgbaf>("Rgbaf premultiplied", Pma::all);
+
+    for (auto precision: {ColourPrecision::exact, ColourPrecision::fast}) {
+        span_blend<Rgba8>("Rgba8", {}, precision);
+        span_blend<Rgba8>("Rgba8 premultiplied", Pma::all, precision);
+        span_blend<Rgba16>("Rgba16", {}, precision);
+    }
+
+}
+
+void bench_rs_graphics_core_colour_strings() {
+
+    static const std::vector<std::string> names = {
+        "AliceBlue", "Crimson", "Forest Green", "Light Goldenrod Yellow", "Royal Blue",
+        "Saddle Brown", "Transparent", "YellowGreen", "#123456", "#789abcde",
+    };
+
+    auto colours = random_colours<sRgba8>();
+    std::vector<std::string> hex_strings;
+    for (auto& c: colours)
+        hex_strings.push_back("#" + c.hex());
+    std::vector<sRgba8> out(n_colours);
+
+    benchmark("Colour hex() string", [&] {
+        size_t total = 0;
+        for (auto& c: colours)
+            total += c.hex().size();
+        keep(double(total));
+        return n_colours;
+    }, n_colours);
+
+    benchmark("Colour hex() buffer", [&] {
+        char buf[8];
+        size_t total = 0;
+        for (auto& c: colours)
+            total += size_t(c.hex(buf) - buf) + size_t(buf[0]);
+        keep(double(total));
+        return n_colours;
+    }, n_colours);
+
+    benchmark("Colour string constructor", [&] {
+        for (size_t i = 0; i < n_colours; ++i)
+            out[i] = sRgba8(hex_strings[i]);
+        keep(double(out[0][0]));
+        return n_colours;
+    }, n_colours);
+
+    benchmark("parse_hex_colour", [&] {
+        for (size_t i = 0; i < n_colours; ++i)
+            parse_hex_colour(hex_strings[i], out[i]);
+        keep(double(out[0][0]));
+        return n_colours;
+    }, n_colours);
+
+    benchmark("parse_css_colour", [&] {
+        for (size_t i = 0; i < n_colours; ++i)
+            parse_css_colour(names[i % names.size()], out[i]);
+        keep(double(out[0][0]));
+        return n_colours;
+    }, n_colours);
+
+}
@@ -0,0 +1,63 @@
+#include "rs-graphics-core/colour-difference.hpp"
+#include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/colour-space.hpp"
+#include "bench/bench.hpp"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace RS::Graphics::Core;
+using namespace RS::Graphics::Core::Bench;
+
+namespace {
+
+    constexpr size_t n_pixels = 65536;
+
+    std::vector<sRgb8> random_pixels(size_t n, unsigned seed) {
+        std::minstd_rand rng(seed);
+        std::uniform_int_distribution<int> dist(0, 255);
+        std::vector<sRgb8> pixels(n);
+        for (auto& c: pixels)
+            c = sRgb8(uint8_t(dist(rng)), uint8_t(dist(rng)), uint8_t(dist(rng)));
+        return pixels;
+    }
+
+    std::string metric_name(DeltaE metric) {
+        switch (metric) {
+            case DeltaE::cie76:  return "76";
+            case DeltaE::cie94:  return "94";
+            default:             return "2000";
+        }
+    }
+
+}
+
+void bench_rs_graphics_core_colour_difference() {
+
+    auto a = random_pixels(n_pixels, 42);
+    auto b = random_pixels(n_pixels, 86);
+    std::vector<float> out(n_pixels);
+
+    // Baseline: scalar double precision per pixel
+
+    benchmark("delta E 2000 scalar double", [&] {
+        double sum = 0;
+        for (size_t i = 0; i < n_pixels; ++i)
+            sum += delta_e(a[i], b[i]);
+        keep(sum);
+        return n_pixels;
+    }, n_pixels);
+
+    for (auto metric: {DeltaE::cie76, DeltaE::cie94, DeltaE::ciede2000}) {
+        for (auto precision: {ColourPrecision::exact, ColourPrecision::fast}) {
+            auto suffix = precision == ColourPrecision::fast ? " fast" : "";
+            benchmark("delta E " + metric_name(metric) + " batch" + suffix, [&] {
+                auto stats = delta_e(a.data(), b.data(), out.data(), n_pixels, metric, 95, precision);
+                keep(stats.percentile);
+                return n_pixels;
+            }, n_pixels);
+        }
+    }
+
+}
@@ -0,0 +1,85 @@
+#include "rs-graphics-core/colour-gamut.hpp"
+#include "rs-graphics-core/colour-lut.hpp"
+#include "rs-graphics-core/colour-space.hpp"
+#include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/vector.hpp"
+#include "bench/bench.hpp"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace RS::Graphics::Core;
+using namespace RS::Graphics::Core::Bench;
+
+namespace {
+
+    constexpr size_t n_colours = 1024;
+
+    // Random ProPhoto colours expressed in sRGB, about half of which are
+    // out of gamut
+
+    std::vector<sRgbaf> wide_colours() {
+        std::minstd_rand rng(42);
+        std::uniform_real_distribution<double> dist(0, 1);
+        std::vector<sRgbaf> colours(n_colours);
+        for (auto& c: colours) {
+            Double3 pp(dist(rng), dist(rng), dist(rng));
+            auto s = convert_colour_space<ProPhoto, sRGB>(pp);
+            c = sRgbaf(float(s[0]), float(s[1]), float(s[2]), 1);
+        }
+        return colours;
+    }
+
+    std::string mode_name(GamutMapping mode) {
+        switch (mode) {
+            case GamutMapping::chroma:     return "chroma";
+            case GamutMapping::soft_knee:  return "soft_knee";
+            default:                       return "clip";
+        }
+    }
+
+}
+
+void bench_rs_graphics_core_colour_gamut_mapping() {
+
+    auto in = wide_colours();
+    std::vector<sRgbaf> out(n_colours);
+    std::vector<uint8_t> mask(n_colours);
+
+    benchmark("gamut_mask sRgbaf", [&] {
+        keep(double(gamut_mask(in.data(), mask.data(), n_colours)));
+        return n_colours;
+    }, n_colours);
+
+    // The span benchmarks include copying the input, since mapping is in place
+
+    for (auto mode: {GamutMapping::clip, GamutMapping::chroma, GamutMapping::soft_knee}) {
+        benchmark("map_to_gamut scalar sRgbaf " + mode_name(mode), [&] {
+            for (size_t i = 0; i < n_colours; ++i)
+                out[i] = map_to_gamut(in[i], mode);
+            keep(double(out[0][0]));
+            return n_colours;
+        }, n_colours);
+        benchmark("map_to_gamut span sRgbaf " + mode_name(mode), [&] {
+            out = in;
+            map_to_gamut(out.data(), n_colours, mode);
+            keep(double(out[0][0]));
+            return n_colours;
+        }, n_colours);
+    }
+
+    auto lut = gamut_mapping_lut<ProPhoto, sRGB>(33);
+    std::vector<Float3> lut_in(n_colours), lut_out(n_colours);
+    std::minstd_rand rng(42);
+    std::uniform_real_distribution<float> dist(0, 1);
+    for (auto& c: lut_in)
+        c = Float3(dist(rng), dist(rng), dist(rng));
+
+    benchmark("gamut_mapping_lut 33 ProPhoto -> sRGB chroma batch", [&] {
+        lut.batch(lut_in.data(), lut_out.data(), n_colours, LutInterpolation::tetrahedral);
+        keep(double(lut_out[0][0]));
+        return n_colours;
+    }, n_colours);
+
+}
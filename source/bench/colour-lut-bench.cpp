@@ -0,0 +1,105 @@
+#include "rs-graphics-core/colour-lut.hpp"
+#include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/colour-space.hpp"
+#include "rs-graphics-core/linear-map.hpp"
+#include "rs-graphics-core/vector.hpp"
+#include "bench/bench.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace RS::Graphics::Core;
+using namespace RS::Graphics::Core::Bench;
+
+namespace {
+
+    constexpr size_t n_colours = 1024;
+
+    std::vector<Float3> random_colours() {
+        std::minstd_rand rng(42);
+        std::uniform_real_distribution<float> dist(0, 1);
+        std::vector<Float3> colours(n_colours);
+        for (auto& c: colours)
+            for (auto& x: c)
+                x = dist(rng);
+        return colours;
+    }
+
+    void evaluation(const ColourLut3D& lut, LutInterpolation mode) {
+        auto in = random_colours();
+        std::vector<Float3> out(n_colours);
+        auto suffix = " " + std::to_string(lut.size()) + (mode == LutInterpolation::tetrahedral ? " tetrahedral" : " trilinear");
+        benchmark("ColourLut3D scalar" + suffix, [&] {
+            for (size_t i = 0; i < n_colours; ++i)
+                out[i] = lut(in[i], mode);
+            keep(double(out[0][0]));
+            return n_colours;
+        }, n_colours);
+        benchmark("ColourLut3D batch" + suffix, [&] {
+            lut.batch(in.data(), out.data(), n_colours, mode);
+            keep(double(out[0][0]));
+            return n_colours;
+        }, n_colours);
+    }
+
+}
+
+void bench_rs_graphics_core_colour_lut_evaluation() {
+
+    auto lut = colour_space_lut<sRGB, AdobeRGB>(33);
+
+    evaluation(lut, LutInterpolation::trilinear);
+    evaluation(lut, LutInterpolation::tetrahedral);
+
+    benchmark("ColourLut3D bake 33 sRGB -> AdobeRGB", [] {
+        auto lut = colour_space_lut<sRGB, AdobeRGB>(33);
+        keep(double(lut.table()(1, 2, 3)[0]));
+        return size_t(33 * 33 * 33);
+    }, 33 * 33 * 33);
+
+    auto in = random_colours();
+
+    benchmark("convert_colour_space sRGB -> AdobeRGB float", [&] {
+        Float3 sum;
+        for (auto& c: in)
+            sum += convert_colour_space<sRGB, AdobeRGB>(c);
+        keep(double(sum[0]));
+        return n_colours;
+    }, n_colours);
+
+    // Colour ramp: LinearMap lookup against the baked table
+
+    LinearMap<float, Rgbaf> map;
+    std::minstd_rand rng(86);
+    std::uniform_real_distribution<float> dist(0, 1);
+    std::vector<float> keys(n_colours);
+    std::vector<Rgbaf> ramp_out(n_colours);
+
+    for (int i = 0; i < 16; ++i)
+        map.insert(float(i) / 15, Rgbaf(dist(rng), dist(rng), dist(rng), 1));
+    for (auto& x: keys)
+        x = dist(rng);
+
+    LinearRamp<float, Rgbaf> ramp(map);
+
+    benchmark("LinearMap<float,Rgbaf> [] 16 knots", [&] {
+        for (size_t i = 0; i < n_colours; ++i)
+            ramp_out[i] = map[keys[i]];
+        keep(double(ramp_out[0][0]));
+        return n_colours;
+    }, n_colours);
+
+    benchmark("LinearRamp<float,Rgbaf> scalar 256", [&] {
+        for (size_t i = 0; i < n_colours; ++i)
+            ramp_out[i] = ramp(keys[i]);
+        keep(double(ramp_out[0][0]));
+        return n_colours;
+    }, n_colours);
+
+    benchmark("LinearRamp<float,Rgbaf> batch 256", [&] {
+        ramp.batch(keys.data(), ramp_out.data(), n_colours);
+        keep(double(ramp_out[0][0]));
+        return n_colours;
+    }, n_colours);
+
+}
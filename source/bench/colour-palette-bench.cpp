@@ -0,0 +1,85 @@
+#include "rs-graphics-core/colour-palette.hpp"
+#include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/colour-space.hpp"
+#include "bench/bench.hpp"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace RS::Graphics::Core;
+using namespace RS::Graphics::Core::Bench;
+
+namespace {
+
+    constexpr size_t n_pixels = 65536;
+
+    std::vector<sRgb8> random_pixels(size_t n, unsigned seed) {
+        std::minstd_rand rng(seed);
+        std::uniform_int_distribution<int> dist(0, 255);
+        std::vector<sRgb8> pixels(n);
+        for (auto& c: pixels)
+            c = sRgb8(uint8_t(dist(rng)), uint8_t(dist(rng)), uint8_t(dist(rng)));
+        return pixels;
+    }
+
+    std::string search_name(PaletteSearch search) {
+        return search == PaletteSearch::grid ? "grid" : "kd_tree";
+    }
+
+}
+
+void bench_rs_graphics_core_colour_palette_mapping() {
+
+    auto pixels = random_pixels(n_pixels, 42);
+    auto entries = random_pixels(256, 86);
+    std::vector<uint8_t> index(n_pixels);
+
+    // Baseline: a linear scan converting each palette entry for every
+    // comparison
+
+    benchmark("palette linear scan 256 CIELab", [&] {
+        size_t n = 1024;
+        for (size_t i = 0; i < n; ++i) {
+            Colour<float, CIELab, ColourLayout::forward> p, q;
+            convert_colour(pixels[i], p);
+            float best_d2 = 0;
+            for (size_t j = 0; j < entries.size(); ++j) {
+                convert_colour(entries[j], q);
+                auto d = p.as_vector() - q.as_vector();
+                float d2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+                if (j == 0 || d2 < best_d2) {
+                    index[i] = uint8_t(j);
+                    best_d2 = d2;
+                }
+            }
+        }
+        keep(double(index[0]));
+        return n;
+    }, 1024);
+
+    for (auto search: {PaletteSearch::kd_tree, PaletteSearch::grid}) {
+        ColourPalette<> palette(entries, search);
+        for (auto precision: {ColourPrecision::exact, ColourPrecision::fast}) {
+            auto suffix = precision == ColourPrecision::fast ? " fast" : "";
+            benchmark("palette nearest 256 CIELab " + search_name(search) + suffix, [&] {
+                palette.nearest(pixels.data(), index.data(), n_pixels, precision);
+                keep(double(index[0]));
+                return n_pixels;
+            }, n_pixels);
+        }
+    }
+
+    benchmark("palette median_cut 256 CIELab", [&] {
+        auto palette = ColourPalette<>::median_cut(pixels.data(), n_pixels, 256);
+        keep(double(palette.metric(0)[0]));
+        return n_pixels;
+    }, n_pixels);
+
+    benchmark("palette k_means 256 CIELab 4 iterations", [&] {
+        auto palette = ColourPalette<>::k_means(pixels.data(), n_pixels, 256, 4);
+        keep(double(palette.metric(0)[0]));
+        return n_pixels;
+    }, n_pixels);
+
+}
@@ -0,0 +1,67 @@
+#include "rs-graphics-core/linear-map.hpp"
+#include "bench/bench.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace RS::Graphics::Core;
+using namespace RS::Graphics::Core::Bench;
+
+void bench_rs_graphics_core_linear_map_lookup() {
+
+    static constexpr size_t n = 1024;
+
+    std::minstd_rand rng(42);
+    std::uniform_real_distribution<double> dist(0, 100);
+    std::vector<double> keys(n);
+
+    for (auto& x: keys)
+        x = dist(rng);
+
+    auto sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<double> out(n);
+
+    for (int knots: {4, 16, 64, 256}) {
+
+        LinearMap<double> map;
+
+        for (int i = 0; i < knots; ++i)
+            map.insert(100.0 * i / (knots - 1), dist(rng));
+
+        benchmark("LinearMap<double> [] " + std::to_string(knots) + " knots", [&] {
+            double sum = 0;
+            for (auto x: keys)
+                sum += map[x];
+            keep(sum);
+            return n;
+        }, n);
+
+        auto frozen = map;
+        frozen.freeze();
+        auto suffix = " " + std::to_string(knots) + " knots";
+
+        benchmark("LinearMap<double> frozen []" + suffix, [&] {
+            double sum = 0;
+            for (auto x: keys)
+                sum += frozen[x];
+            keep(sum);
+            return n;
+        }, n);
+
+        benchmark("LinearMap<double> frozen batch" + suffix, [&] {
+            frozen.batch(keys.data(), out.data(), n);
+            keep(out[0]);
+            return n;
+        }, n);
+
+        benchmark("LinearMap<double> frozen batch sorted" + suffix, [&] {
+            frozen.batch(sorted.data(), out.data(), n);
+            keep(out[0]);
+            return n;
+        }, n);
+
+    }
+
+}
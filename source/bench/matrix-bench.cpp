@@ -0,0 +1,65 @@
+#include "rs-graphics-core/matrix.hpp"
+#include "rs-graphics-core/vector.hpp"
+#include "bench/bench.hpp"
+#include <random>
+#include <vector>
+
+using namespace RS::Graphics::Core;
+using namespace RS::Graphics::Core::Bench;
+
+namespace {
+
+    constexpr size_t n_matrices = 256;
+
+    template <typename M>
+    std::vector<M> random_matrices() {
+        std::minstd_rand rng(42);
+        std::uniform_real_distribution<double> dist(-10, 10);
+        std::vector<M> matrices(n_matrices);
+        for (auto& m: matrices)
+            for (auto& x: m)
+                x = typename M::scalar_type(dist(rng));
+        return matrices;
+    }
+
+}
+
+void bench_rs_graphics_core_matrix_arithmetic() {
+
+    auto d3 = random_matrices<Double3x3>();
+    auto d4 = random_matrices<Double4x4>();
+    auto f4 = random_matrices<Float4x4>();
+
+    benchmark("Double4x4 * Double4x4", [&] {
+        Double4x4 m = Double4x4::identity();
+        for (auto& a: d4)
+            m = m * a * 0.01;
+        keep(m(0, 0));
+        return n_matrices;
+    }, n_matrices);
+
+    benchmark("Float4x4 * Float4", [&] {
+        Float4 v(1, 2, 3, 4);
+        for (auto& a: f4)
+            v = a * v * 0.01f;
+        keep(double(v[0]));
+        return n_matrices;
+    }, n_matrices);
+
+    benchmark("Double3x3 inverse", [&] {
+        double sum = 0;
+        for (auto& a: d3)
+            sum += a.inverse()(0, 0);
+        keep(sum);
+        return n_matrices;
+    }, n_matrices);
+
+    benchmark("Double4x4 inverse", [&] {
+        double sum = 0;
+        for (auto& a: d4)
+            sum += a.inverse()(0, 0);
+        keep(sum);
+        return n_matrices;
+    }, n_matrices);
+
+}
@@ -0,0 +1,53 @@
+#include "rs-graphics-core/multi-array.hpp"
+#include "rs-graphics-core/vector.hpp"
+#include "bench/bench.hpp"
+#include <numeric>
+
+using namespace RS::Graphics::Core;
+using namespace RS::Graphics::Core::Bench;
+
+void bench_rs_graphics_core_multi_array_access() {
+
+    static constexpr int size = 512;
+    static constexpr size_t n = size_t(size) * size;
+
+    MultiArray<float, 2> array(size, size);
+    float value = 0;
+
+    for (auto& x: array)
+        x = value++;
+
+    benchmark("MultiArray<float,2> iteration", [&] {
+        keep(double(std::accumulate(array.begin(), array.end(), 0.0f)));
+        return n;
+    }, n);
+
+    benchmark("MultiArray<float,2> indexing row major", [&] {
+        float sum = 0;
+        Int2 p;
+        for (p.y() = 0; p.y() < size; ++p.y())
+            for (p.x() = 0; p.x() < size; ++p.x())
+                sum += array[p];
+        keep(double(sum));
+        return n;
+    }, n);
+
+    benchmark("MultiArray<float,2> indexing column major", [&] {
+        float sum = 0;
+        Int2 p;
+        for (p.x() = 0; p.x() < size; ++p.x())
+            for (p.y() = 0; p.y() < size; ++p.y())
+                sum += array[p];
+        keep(double(sum));
+        return n;
+    }, n);
+
+    MultiArray<float, 3> array3(64, 64, 64);
+
+    benchmark("MultiArray<float,3> fill", [&] {
+        array3.fill(1.0f);
+        keep(double(array3[Int3(1, 2, 3)]));
+        return array3.size();
+    }, array3.size());
+
+}
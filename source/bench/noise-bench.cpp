@@ -0,0 +1,247 @@
+#include "rs-graphics-core/noise.hpp"
+#include "rs-graphics-core/vector.hpp"
+#include "bench/bench.hpp"
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace RS::Graphics::Core;
+using namespace RS::Graphics::Core::Bench;
+
+namespace {
+
+    constexpr size_t n_points = 1024;
+
+    template <typename T, int N>
+    std::vector<Vector<T, N>> random_points(T range) {
+        std::minstd_rand rng(42);
+        std::uniform_real_distribution<T> dist(- range, range);
+        std::vector<Vector<T, N>> points(n_points);
+        for (auto& p: points)
+            for (auto& x: p)
+                x = dist(rng);
+        return points;
+    }
+
+    std::string layout_name(NoiseLayout layout) {
+        return layout == NoiseLayout::compact ? "compact" : "standard";
+    }
+
+    template <typename T, int N>
+    void noise_evaluation(const std::string& type) {
+
+        using noise_type = Noise<T, N>;
+
+        noise_type noise(42);
+        auto points = random_points<T, N>(T(100));
+        std::vector<T> values(n_points);
+        auto prefix = "Noise<" + type + "," + std::to_string(N) + "> ";
+
+        benchmark(prefix + "point", [&] {
+            T sum = 0;
+            for (auto& p: points)
+                sum += noise(p);
+            keep(double(sum));
+            return n_points;
+        }, n_points);
+
+        benchmark(prefix + "batch", [&] {
+            noise.batch(points.data(), values.data(), n_points);
+            keep(double(values[0]));
+            return n_points;
+        }, n_points);
+
+        // A raster row, 64 points to a lattice unit
+
+        Vector<T, N> origin = points[0];
+        Vector<T, N> step;
+        step[0] = T(1) / T(64);
+
+        benchmark(prefix + "row", [&] {
+            T sum = 0;
+            for (size_t i = 0; i < n_points; ++i)
+                sum += noise(origin + T(i) * step);
+            keep(double(sum));
+            return n_points;
+        }, n_points);
+
+        benchmark(prefix + "scanline", [&] {
+            noise.scanline(origin, step, values.data(), n_points);
+            keep(double(values[0]));
+            return n_points;
+        }, n_points);
+
+    }
+
+    template <typename T, int DimIn, int DimOut>
+    void source_evaluation(const std::string& type, int octaves) {
+
+        using source_type = NoiseSource<T, DimIn, DimOut>;
+
+        source_type source(10, 1, octaves, 42);
+        auto points = random_points<T, DimIn>(T(100));
+        auto name = "NoiseSource<" + type + "," + std::to_string(DimIn) + "," + std::to_string(DimOut) + "> "
+            + std::to_string(octaves) + " octaves";
+
+        benchmark(name, [&] {
+            T sum = 0;
+            for (auto& p: points) {
+                auto value = source(p);
+                if constexpr (DimOut == 1)
+                    sum += value;
+                else
+                    sum += value[0];
+            }
+            keep(double(sum));
+            return n_points;
+        }, n_points);
+
+    }
+
+    // Evaluate k generators at the same scattered points, so that all k
+    // tables compete for cache
+
+    template <typename T, int N, NoiseLayout L>
+    void noise_tables(const std::string& type, int k) {
+
+        using noise_type = Noise<T, N, L>;
+
+        std::vector<noise_type> gens;
+        auto points = random_points<T, N>(T(1000));
+
+        for (int i = 0; i < k; ++i)
+            gens.emplace_back(uint64_t(i));
+
+        auto name = "Noise<" + type + "," + std::to_string(N) + "," + layout_name(L) + "> x" + std::to_string(k);
+        auto bytes = std::to_string(k * sizeof(noise_type) / 1024);
+
+        benchmark(name, [&] {
+            T sum = 0;
+            for (auto& p: points)
+                for (auto& g: gens)
+                    sum += g(p);
+            keep(double(sum));
+            return points.size() * gens.size();
+        }, points.size() * gens.size(), "tables " + bytes + " KB");
+
+    }
+
+    template <typename T, int N, NoiseLayout L>
+    void noise_seeding(const std::string& type, NoiseSeeding mode) {
+
+        using noise_type = Noise<T, N, L>;
+
+        auto gen = std::make_unique<noise_type>();
+        uint64_t s = 0;
+        auto name = "seed Noise<" + type + "," + std::to_string(N) + "," + layout_name(L) + "> "
+            + (mode == NoiseSeeding::fast ? "fast" : "standard");
+
+        benchmark(name, [&] {
+            for (int i = 0; i < 100; ++i)
+                gen->seed(s++, mode);
+            keep(double((*gen)(typename noise_type::vector_type(T(0.5)))));
+            return 100;
+        }, 100);
+
+    }
+
+}
+
+void bench_rs_graphics_core_noise_evaluation() {
+
+    noise_evaluation<float, 2>("float");
+    noise_evaluation<double, 2>("double");
+    noise_evaluation<float, 3>("float");
+    noise_evaluation<double, 3>("double");
+
+    source_evaluation<float, 2, 1>("float", 1);
+    source_evaluation<float, 2, 1>("float", 6);
+    source_evaluation<double, 3, 1>("double", 6);
+    source_evaluation<double, 3, 3>("double", 6);
+
+}
+
+void bench_rs_graphics_core_noise_tables() {
+
+    for (int k: {1, 2, 4, 8, 16, 32}) {
+        noise_tables<double, 3, NoiseLayout::standard>("double", k);
+        noise_tables<double, 3, NoiseLayout::compact>("double", k);
+    }
+
+    for (int k: {1, 4, 16}) {
+        noise_tables<float, 2, NoiseLayout::standard>("float", k);
+        noise_tables<float, 2, NoiseLayout::compact>("float", k);
+    }
+
+}
+
+void bench_rs_graphics_core_noise_seeding() {
+
+    for (auto mode: {NoiseSeeding::standard, NoiseSeeding::fast}) {
+        noise_seeding<double, 3, NoiseLayout::standard>("double", mode);
+        noise_seeding<double, 3, NoiseLayout::compact>("double", mode);
+        noise_seeding<float, 2, NoiseLayout::compact>("float", mode);
+    }
+
+    NoiseCache<double, 3> cache;
+    auto held = cache(42);
+
+    benchmark("NoiseCache<double,3> hit", [&] {
+        double sum = 0;
+        for (int i = 0; i < 1000; ++i)
+            sum += double(cache(42).use_count());
+        keep(sum);
+        return 1000;
+    }, 1000);
+
+}
+
+void bench_rs_graphics_core_noise_gradient() {
+
+    // Value plus gradient, by finite differences and analytically
+
+    static constexpr double h = 1e-4;
+
+    NoiseSource<double, 2, 1> source2(10, 1, 6, 42);
+    NoiseSource<double, 3, 1> source3(10, 1, 6, 42);
+    auto points2 = random_points<double, 2>(100);
+    auto points3 = random_points<double, 3>(100);
+
+    benchmark("NoiseSource<double,2,1> finite diff", [&] {
+        double sum = 0;
+        for (auto& p: points2)
+            sum += source2(p) + source2(p + Double2(h, 0)) + source2(p + Double2(0, h));
+        keep(sum);
+        return n_points;
+    }, n_points);
+
+    benchmark("NoiseSource<double,2,1> eval_with_gradient", [&] {
+        double sum = 0;
+        for (auto& p: points2) {
+            auto [value, grad] = source2.eval_with_gradient(p);
+            sum += value + grad.x() + grad.y();
+        }
+        keep(sum);
+        return n_points;
+    }, n_points);
+
+    benchmark("NoiseSource<double,3,1> finite diff", [&] {
+        double sum = 0;
+        for (auto& p: points3)
+            sum += source3(p) + source3(p + Double3(h, 0, 0)) + source3(p + Double3(0, h, 0)) + source3(p + Double3(0, 0, h));
+        keep(sum);
+        return n_points;
+    }, n_points);
+
+    benchmark("NoiseSource<double,3,1> eval_with_gradient", [&] {
+        double sum = 0;
+        for (auto& p: points3) {
+            auto [value, grad] = source3.eval_with_gradient(p);
+            sum += value + grad.x() + grad.y() + grad.z();
+        }
+        keep(sum);
+        return n_points;
+    }, n_points);
+
+}
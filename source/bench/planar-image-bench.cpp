@@ -0,0 +1,80 @@
+#include "rs-graphics-core/planar-image.hpp"
+#include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/colour-space.hpp"
+#include "rs-graphics-core/vector.hpp"
+#include "bench/bench.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace RS::Graphics::Core;
+using namespace RS::Graphics::Core::Bench;
+
+namespace {
+
+    constexpr Int2 image_shape = {64, 16};
+    constexpr size_t n_pixels = 64 * 16;
+
+    template <typename C>
+    std::vector<C> random_pixels() {
+        std::minstd_rand rng(42);
+        std::uniform_real_distribution<double> dist(0, 1);
+        std::vector<C> pixels(n_pixels);
+        for (auto& c: pixels)
+            for (auto& x: c)
+                x = typename C::value_type(dist(rng) * double(C::scale));
+        return pixels;
+    }
+
+    template <typename C>
+    using PlanarOf = PlanarImage<typename C::value_type, typename C::colour_space, C::layout>;
+
+    template <typename C>
+    void interleaving(const std::string& name) {
+        auto pixels = random_pixels<C>();
+        PlanarOf<C> image(image_shape);
+        benchmark("deinterleave " + name, [&] {
+            deinterleave(pixels.data(), image.view());
+            keep(double(image.plane(0)(0, 0)));
+            return n_pixels;
+        }, n_pixels);
+        benchmark("interleave " + name, [&] {
+            interleave(image.view(), pixels.data());
+            keep(double(pixels[0][0]));
+            return n_pixels;
+        }, n_pixels);
+    }
+
+    template <typename C1, typename C2>
+    void conversion(const std::string& name, ColourPrecision precision = ColourPrecision::exact) {
+        auto suffix = precision == ColourPrecision::fast ? " fast" : "";
+        auto pixels = random_pixels<C1>();
+        PlanarOf<C1> in(image_shape, pixels.data());
+        PlanarOf<C2> out(image_shape);
+        benchmark("convert_colour planar " + name + suffix, [&] {
+            convert_colour(in.view(), out.view(), precision);
+            keep(double(out.plane(0)(0, 0)));
+            return n_pixels;
+        }, n_pixels);
+    }
+
+}
+
+void bench_rs_graphics_core_planar_image_conversion() {
+
+    using LinearAdobeRgbf = Colour<float, LinearAdobeRGB, ColourLayout::forward>;
+
+    interleaving<Rgbf>("Rgbf");
+    interleaving<Rgbaf>("Rgbaf");
+    interleaving<Rgba8>("Rgba8");
+
+    conversion<Rgba8, Rgbaf>("Rgba8 -> Rgbaf");
+    conversion<Rgbaf, Rgba8>("Rgbaf -> Rgba8");
+    conversion<Rgbf, LinearAdobeRgbf>("Rgbf -> LinearAdobeRGB float");
+
+    for (auto precision: {ColourPrecision::exact, ColourPrecision::fast}) {
+        conversion<sRgbf, Rgbf>("sRgbf -> Rgbf", precision);
+        conversion<Rgbf, sRgbf>("Rgbf -> sRgbf", precision);
+    }
+
+}
@@ -6,8 +6,10 @@
 #include <rs-graphics-core/matrix.hpp>
 #include <rs-graphics-core/multi-array.hpp>
 #include <rs-graphics-core/noise.hpp>
+#include <rs-graphics-core/parallel.hpp>
 #include <rs-graphics-core/quaternion.hpp>
 #include <rs-graphics-core/root-finding.hpp>
+#include <rs-graphics-core/simd.hpp>
 #include <rs-graphics-core/transform.hpp>
 #include <rs-graphics-core/vector.hpp>
 #include <rs-graphics-core/version.hpp>
@@ -0,0 +1,312 @@
+#pragma once
+
+#include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/colour-space.hpp"
+#include "rs-graphics-core/maths.hpp"
+#include "rs-graphics-core/multi-array.hpp"
+#include "rs-graphics-core/simd.hpp"
+#include "rs-graphics-core/vector.hpp"
+#include "rs-tl/enum.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace RS::Graphics::Core {
+
+    RS_DEFINE_ENUM_CLASS(DeltaE, int, 0,
+        cie76,
+        cie94,
+        ciede2000
+    )
+
+    struct DeltaEStats {
+        double mean = 0;
+        double max = 0;
+        double percentile = 0;
+    };
+
+    struct DeltaEMap {
+        MultiArray<float, 2> map;
+        DeltaEStats stats;
+    };
+
+    namespace Detail {
+
+        size_t delta_e_simd(const float* lab1, const float* lab2, float* out, size_t n, DeltaE metric) noexcept;
+
+        template <typename T>
+        T delta_e_76(Vector<T, 3> lab1, Vector<T, 3> lab2) noexcept {
+            auto d = lab1 - lab2;
+            return std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        }
+
+        // CIE94 with the graphic arts weights; the first colour is the
+        // reference
+
+        template <typename T>
+        T delta_e_94(Vector<T, 3> lab1, Vector<T, 3> lab2) noexcept {
+            T dl = lab1[0] - lab2[0];
+            T da = lab1[1] - lab2[1];
+            T db = lab1[2] - lab2[2];
+            T c1 = std::sqrt(lab1[1] * lab1[1] + lab1[2] * lab1[2]);
+            T c2 = std::sqrt(lab2[1] * lab2[1] + lab2[2] * lab2[2]);
+            T dc = c1 - c2;
+            T dh2 = da * da + db * db - dc * dc;
+            dh2 = dh2 < 0 ? T(0) : dh2;
+            T sc = 1 + T(0.045) * c1;
+            T sh = 1 + T(0.015) * c1;
+            T xc = dc / sc;
+            return std::sqrt(dl * dl + xc * xc + dh2 / (sh * sh));
+        }
+
+        // CIEDE2000, following Sharma, Wu & Dalal (2005)
+
+        template <typename T>
+        T delta_e_2000(Vector<T, 3> lab1, Vector<T, 3> lab2) noexcept {
+            static constexpr T k25_7 = T(6'103'515'625.0);
+            static constexpr T degree = pi<T> / 180;
+            T c1 = std::sqrt(lab1[1] * lab1[1] + lab1[2] * lab1[2]);
+            T c2 = std::sqrt(lab2[1] * lab2[1] + lab2[2] * lab2[2]);
+            T cm7 = std::pow((c1 + c2) / 2, T(7));
+            T g = (1 - std::sqrt(cm7 / (cm7 + k25_7))) / 2;
+            T a1 = (1 + g) * lab1[1];
+            T a2 = (1 + g) * lab2[1];
+            T cp1 = std::sqrt(a1 * a1 + lab1[2] * lab1[2]);
+            T cp2 = std::sqrt(a2 * a2 + lab2[2] * lab2[2]);
+            T h1 = cp1 == 0 ? T(0) : std::atan2(lab1[2], a1) / degree;
+            T h2 = cp2 == 0 ? T(0) : std::atan2(lab2[2], a2) / degree;
+            h1 += h1 < 0 ? 360 : 0;
+            h2 += h2 < 0 ? 360 : 0;
+            T cc = cp1 * cp2;
+            T dh = h2 - h1;
+            if (cc == 0)
+                dh = 0;
+            else if (dh > 180)
+                dh -= 360;
+            else if (dh < -180)
+                dh += 360;
+            T dhh = 2 * std::sqrt(cc) * std::sin(dh * degree / 2);
+            T hm = h1 + h2;
+            if (cc != 0)
+                hm = (std::abs(h1 - h2) <= 180 ? hm : hm < 360 ? hm + 360 : hm - 360) / 2;
+            T t = 1 - T(0.17) * std::cos((hm - 30) * degree) + T(0.24) * std::cos(2 * hm * degree)
+                + T(0.32) * std::cos((3 * hm + 6) * degree) - T(0.20) * std::cos((4 * hm - 63) * degree);
+            T x = (hm - 275) / 25;
+            T dtheta = 30 * std::exp(- x * x);
+            T cpm7 = std::pow((cp1 + cp2) / 2, T(7));
+            T rc = 2 * std::sqrt(cpm7 / (cpm7 + k25_7));
+            T l2 = std::pow((lab1[0] + lab2[0]) / 2 - 50, T(2));
+            T sl = 1 + T(0.015) * l2 / std::sqrt(20 + l2);
+            T sc = 1 + T(0.045) * (cp1 + cp2) / 2;
+            T sh = 1 + T(0.015) * (cp1 + cp2) / 2 * t;
+            T rt = - std::sin(2 * dtheta * degree) * rc;
+            T xl = (lab2[0] - lab1[0]) / sl;
+            T xc = (cp2 - cp1) / sc;
+            T xh = dhh / sh;
+            T e = xl * xl + xc * xc + xh * xh + rt * xc * xh;
+            return std::sqrt(std::max(e, T(0)));
+        }
+
+        // Single precision CIEDE2000 for the batch functions, with angles in
+        // turns, using fast_atan2_turns(), fast_sincos_turns(), and
+        // fast_exp2(). The vector kernel in colour.cpp gives identical
+        // results.
+
+        inline float delta_e_2000_fast(Float3 lab1, Float3 lab2) noexcept {
+            static constexpr float k25_7 = 6'103'515'625.0f;
+            static constexpr float log2e = 1.442'695'04f;
+            float c1 = std::sqrt(lab1[1] * lab1[1] + lab1[2] * lab1[2]);
+            float c2 = std::sqrt(lab2[1] * lab2[1] + lab2[2] * lab2[2]);
+            float cm = (c1 + c2) * 0.5f;
+            float cm2 = cm * cm;
+            float cm7 = cm2 * cm2 * cm2 * cm;
+            float g = 0.5f * (1 - std::sqrt(cm7 / (cm7 + k25_7)));
+            float a1 = (1 + g) * lab1[1];
+            float a2 = (1 + g) * lab2[1];
+            float cp1 = std::sqrt(a1 * a1 + lab1[2] * lab1[2]);
+            float cp2 = std::sqrt(a2 * a2 + lab2[2] * lab2[2]);
+            float h1 = fast_atan2_turns(lab1[2], a1);
+            float h2 = fast_atan2_turns(lab2[2], a2);
+            float cc = cp1 * cp2;
+            float dh = h2 - h1;
+            if (dh > 0.5f)
+                dh -= 1;
+            if (dh < -0.5f)
+                dh += 1;
+            if (cc == 0)
+                dh = 0;
+            float s, c;
+            fast_sincos_turns(dh * 0.5f, s, c);
+            float dhh = 2 * std::sqrt(cc) * s;
+            float hs = h1 + h2;
+            float hm = hs;
+            if (std::abs(h1 - h2) > 0.5f)
+                hm = hs < 1 ? hs + 1 : hs - 1;
+            hm = cc == 0 ? hs : hm * 0.5f;
+            float c30, c2h, c3h, c4h;
+            fast_sincos_turns(hm - 0.083'333'333f, s, c30);
+            fast_sincos_turns(2 * hm, s, c2h);
+            fast_sincos_turns(3 * hm + 0.016'666'667f, s, c3h);
+            fast_sincos_turns(4 * hm - 0.175f, s, c4h);
+            float t = 1 - 0.17f * c30 + 0.24f * c2h + 0.32f * c3h - 0.20f * c4h;
+            float x = (hm * 360 - 275) / 25;
+            float dtheta = 0.083'333'333f * fast_exp2(- (x * x) * log2e);
+            float cpm = (cp1 + cp2) * 0.5f;
+            float cpm2 = cpm * cpm;
+            float cpm7 = cpm2 * cpm2 * cpm2 * cpm;
+            float rc = 2 * std::sqrt(cpm7 / (cpm7 + k25_7));
+            float l50 = (lab1[0] + lab2[0]) * 0.5f - 50;
+            float l2 = l50 * l50;
+            float sl = 1 + 0.015f * l2 / std::sqrt(20 + l2);
+            float sc = 1 + 0.045f * cpm;
+            float sh = 1 + 0.015f * cpm * t;
+            fast_sincos_turns(2 * dtheta, s, c);
+            float rt = - s * rc;
+            float xl = (lab2[0] - lab1[0]) / sl;
+            float xc = (cp2 - cp1) / sc;
+            float xh = dhh / sh;
+            float e = xl * xl + xc * xc + xh * xh + rt * xc * xh;
+            return std::sqrt(e < 0 ? 0.0f : e);
+        }
+
+        inline void delta_e_batch(const float* lab1, const float* lab2, float* out, size_t n, DeltaE metric) noexcept {
+            for (size_t i = delta_e_simd(lab1, lab2, out, n, metric); i < n; ++i) {
+                Float3 x(lab1 + 3 * i);
+                Float3 y(lab2 + 3 * i);
+                switch (metric) {
+                    case DeltaE::cie76:  out[i] = delta_e_76(x, y); break;
+                    case DeltaE::cie94:  out[i] = delta_e_94(x, y); break;
+                    default:             out[i] = delta_e_2000_fast(x, y); break;
+                }
+            }
+        }
+
+        // Running statistics. The percentile comes from a histogram with
+        // bins 1/64 wide up to 256, so it is accurate to 1/128 (reporting
+        // the middle of the bin, or the maximum if that is lower); the top
+        // bin collects everything above, and reports the maximum. NaN
+        // values are skipped.
+
+        class DeltaEAccumulator {
+
+        public:
+
+            explicit DeltaEAccumulator(double percentile):
+            histogram_(bins + 1), percentile_(percentile) {
+                if (! (percentile >= 0 && percentile <= 100))
+                    throw std::invalid_argument("Percentile must be between 0 and 100");
+            }
+
+            void add(const float* values, size_t n) noexcept {
+                for (size_t i = 0; i < n; ++i) {
+                    float x = values[i];
+                    if (std::isnan(x))
+                        continue;
+                    ++count_;
+                    sum_ += x;
+                    max_ = std::max(max_, double(x));
+                    ++histogram_[x < limit ? size_t(x * resolution) : bins];
+                }
+            }
+
+            DeltaEStats stats() const noexcept {
+                DeltaEStats s;
+                if (count_ == 0)
+                    return s;
+                s.mean = sum_ / double(count_);
+                s.max = max_;
+                auto rank = std::max(uint64_t(std::ceil(percentile_ / 100 * double(count_))), uint64_t(1));
+                uint64_t total = 0;
+                size_t bin = 0;
+                for (; bin < bins; ++bin) {
+                    total += histogram_[bin];
+                    if (total >= rank)
+                        break;
+                }
+                s.percentile = bin < bins ? std::min((double(bin) + 0.5) / resolution, max_) : max_;
+                return s;
+            }
+
+        private:
+
+            static constexpr float resolution = 64;
+            static constexpr float limit = 256;
+            static constexpr size_t bins = size_t(resolution * limit);
+
+            std::vector<uint64_t> histogram_;
+            double percentile_ = 0;
+            uint64_t count_ = 0;
+            double sum_ = 0;
+            double max_ = 0;
+
+        };
+
+    }
+
+    template <typename T>
+    T delta_e(Vector<T, 3> lab1, Vector<T, 3> lab2, DeltaE metric = DeltaE::ciede2000) noexcept {
+        static_assert(std::is_floating_point_v<T>);
+        switch (metric) {
+            case DeltaE::cie76:  return Detail::delta_e_76(lab1, lab2);
+            case DeltaE::cie94:  return Detail::delta_e_94(lab1, lab2);
+            default:             return Detail::delta_e_2000(lab1, lab2);
+        }
+    }
+
+    template <typename VT1, typename CS1, ColourLayout CL1,
+        typename VT2, typename CS2, ColourLayout CL2>
+    double delta_e(Colour<VT1, CS1, CL1> a, Colour<VT2, CS2, CL2> b, DeltaE metric = DeltaE::ciede2000) noexcept {
+        Colour<double, CIELab, ColourLayout::forward> lab1, lab2;
+        convert_colour(a, lab1);
+        convert_colour(b, lab2);
+        return delta_e(lab1.as_vector(), lab2.as_vector(), metric);
+    }
+
+    // Both buffers are converted to CIELab in blocks, in single precision,
+    // and the differences computed in vector kernels. The output buffer
+    // may be null if only the statistics are needed.
+
+    template <typename VT1, typename CS1, ColourLayout CL1,
+        typename VT2, typename CS2, ColourLayout CL2>
+    DeltaEStats delta_e(const Colour<VT1, CS1, CL1>* a, const Colour<VT2, CS2, CL2>* b, float* out, size_t n,
+            DeltaE metric = DeltaE::ciede2000, double percentile = 95,
+            ColourPrecision precision = ColourPrecision::exact) {
+
+        using Lab = Colour<float, CIELab, ColourLayout::forward>;
+        static constexpr size_t block = 256;
+
+        Detail::DeltaEAccumulator acc(percentile);
+        std::array<Lab, block> lab1, lab2;
+        std::array<float, block> buffer;
+
+        for (size_t i = 0; i < n; i += block) {
+            size_t m = std::min(block, n - i);
+            float* delta = out == nullptr ? buffer.data() : out + i;
+            convert_colour(a + i, lab1.data(), m, precision);
+            convert_colour(b + i, lab2.data(), m, precision);
+            Detail::delta_e_batch(lab1.data()->begin(), lab2.data()->begin(), delta, m, metric);
+            acc.add(delta, m);
+        }
+
+        return acc.stats();
+
+    }
+
+    template <typename C1, typename C2>
+    DeltaEMap delta_e_map(const MultiArray<C1, 2>& a, const MultiArray<C2, 2>& b,
+            DeltaE metric = DeltaE::ciede2000, double percentile = 95,
+            ColourPrecision precision = ColourPrecision::exact) {
+        if (a.shape() != b.shape())
+            throw std::invalid_argument("Images for delta E must be the same shape");
+        DeltaEMap result;
+        result.map = MultiArray<float, 2>(a.shape());
+        result.stats = delta_e(a.data(), b.data(), result.map.data(), a.size(), metric, percentile, precision);
+        return result;
+    }
+
+}
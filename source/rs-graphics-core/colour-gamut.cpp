@@ -0,0 +1,170 @@
+#include "rs-graphics-core/colour-gamut.hpp"
+#include "rs-graphics-core/simd.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define RS_GRAPHICS_X86 1
+    #include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+    #define RS_GRAPHICS_TARGET(isa)
+#else
+    #define RS_GRAPHICS_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace RS::Graphics::Core::Detail {
+
+    namespace {
+
+        #ifdef RS_GRAPHICS_X86
+
+            // Gamut kernels, processing 8 colours at a time. Each block of
+            // 8 colours spans one register per channel, so the per-channel
+            // constants are expanded into the same number of registers,
+            // repeating with the channel count. These mirror the scalar
+            // code in colour-gamut.hpp operation for operation, so the
+            // results are bit-for-bit identical. There is no SSE2 version.
+
+            RS_GRAPHICS_TARGET("avx2")
+            void gamut_pattern_avx2(const float* values, int channels, __m256* out) noexcept {
+                alignas(32) float buf[32];
+                for (int k = 0; k < 8 * channels; ++k)
+                    buf[k] = values[k % channels];
+                for (int r = 0; r < channels; ++r)
+                    out[r] = _mm256_load_ps(buf + 8 * r);
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t gamut_mask_avx2(const float* in, uint8_t* mask, const float* lo, const float* hi,
+                    int channels, size_t n) noexcept {
+                __m256 vlo[4];
+                __m256 vhi[4];
+                gamut_pattern_avx2(lo, channels, vlo);
+                gamut_pattern_avx2(hi, channels, vhi);
+                const uint32_t pixel_bits = (1u << channels) - 1;
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8, in += 8 * channels) {
+                    uint32_t bits = 0;
+                    for (int r = 0; r < channels; ++r) {
+                        __m256 x = _mm256_loadu_ps(in + 8 * r);
+                        __m256 out = _mm256_or_ps(_mm256_cmp_ps(x, vlo[r], _CMP_LT_OQ), _mm256_cmp_ps(x, vhi[r], _CMP_GT_OQ));
+                        bits |= uint32_t(_mm256_movemask_ps(out)) << (8 * r);
+                    }
+                    for (int p = 0; p < 8; ++p)
+                        mask[i + p] = uint8_t(((bits >> (channels * p)) & pixel_bits) == 0);
+                }
+                return i;
+            }
+
+            // The operand order of min/max leaves NaN unchanged, as the
+            // scalar clamp does
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t gamut_clip_avx2(float* data, const float* lo, const float* hi, int channels, size_t n) noexcept {
+                __m256 vlo[4];
+                __m256 vhi[4];
+                gamut_pattern_avx2(lo, channels, vlo);
+                gamut_pattern_avx2(hi, channels, vhi);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8, data += 8 * channels) {
+                    for (int r = 0; r < channels; ++r) {
+                        __m256 x = _mm256_loadu_ps(data + 8 * r);
+                        x = _mm256_max_ps(vlo[r], _mm256_min_ps(vhi[r], x));
+                        _mm256_storeu_ps(data + 8 * r, x);
+                    }
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t gamut_soft_knee_avx2(float* data, const float* lo, const float* knee, const float* range,
+                    int channels, size_t n) noexcept {
+                const __m256 one = _mm256_set1_ps(1.0f);
+                __m256 vlo[4];
+                __m256 vknee[4];
+                __m256 vrange[4];
+                gamut_pattern_avx2(lo, channels, vlo);
+                gamut_pattern_avx2(knee, channels, vknee);
+                gamut_pattern_avx2(range, channels, vrange);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8, data += 8 * channels) {
+                    for (int r = 0; r < channels; ++r) {
+                        __m256 x = _mm256_loadu_ps(data + 8 * r);
+                        __m256 above = _mm256_cmp_ps(x, vknee[r], _CMP_GT_OQ);
+                        __m256 below = _mm256_cmp_ps(x, vlo[r], _CMP_LT_OQ);
+                        __m256 d = _mm256_sub_ps(x, vknee[r]);
+                        __m256 y = _mm256_add_ps(vknee[r], _mm256_div_ps(d, _mm256_add_ps(one, _mm256_div_ps(d, vrange[r]))));
+                        x = _mm256_blendv_ps(x, vlo[r], below);
+                        x = _mm256_blendv_ps(x, y, above);
+                        _mm256_storeu_ps(data + 8 * r, x);
+                    }
+                }
+                return i;
+            }
+
+        #endif
+
+    }
+
+    size_t gamut_mask_simd(const float* in, uint8_t* mask, const float* lo, const float* hi,
+            int channels, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            if (channels >= 1 && channels <= 4) {
+                switch (simd_level()) {
+                    case SimdLevel::avx512:  // fall through
+                    case SimdLevel::avx2:    return gamut_mask_avx2(in, mask, lo, hi, channels, n);
+                    default:                 break;
+                }
+            }
+        #else
+            (void)in;
+            (void)mask;
+            (void)lo;
+            (void)hi;
+            (void)channels;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t gamut_clip_simd(float* data, const float* lo, const float* hi, int channels, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            if (channels >= 1 && channels <= 4) {
+                switch (simd_level()) {
+                    case SimdLevel::avx512:  // fall through
+                    case SimdLevel::avx2:    return gamut_clip_avx2(data, lo, hi, channels, n);
+                    default:                 break;
+                }
+            }
+        #else
+            (void)data;
+            (void)lo;
+            (void)hi;
+            (void)channels;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t gamut_soft_knee_simd(float* data, const float* lo, const float* knee, const float* range,
+            int channels, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            if (channels >= 1 && channels <= 4) {
+                switch (simd_level()) {
+                    case SimdLevel::avx512:  // fall through
+                    case SimdLevel::avx2:    return gamut_soft_knee_avx2(data, lo, knee, range, channels, n);
+                    default:                 break;
+                }
+            }
+        #else
+            (void)data;
+            (void)lo;
+            (void)knee;
+            (void)range;
+            (void)channels;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+}
@@ -0,0 +1,292 @@
+#pragma once
+
+#include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/colour-lut.hpp"
+#include "rs-graphics-core/colour-space.hpp"
+#include "rs-graphics-core/parallel.hpp"
+#include "rs-graphics-core/simd.hpp"
+#include "rs-graphics-core/vector.hpp"
+#include "rs-tl/enum.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace RS::Graphics::Core {
+
+    RS_DEFINE_ENUM_CLASS(GamutMapping, int, 0,
+        clip,
+        chroma,
+        soft_knee
+    )
+
+    namespace Detail {
+
+        size_t gamut_mask_simd(const float* in, uint8_t* mask, const float* lo, const float* hi,
+            int channels, size_t n) noexcept;
+        size_t gamut_clip_simd(float* data, const float* lo, const float* hi, int channels, size_t n) noexcept;
+        size_t gamut_soft_knee_simd(float* data, const float* lo, const float* knee, const float* range,
+            int channels, size_t n) noexcept;
+
+        // Per-channel bounds in layout order, following the rules in
+        // is_colour_in_gamut(). The alpha channel, and channels of
+        // unbounded colour spaces, get infinite bounds, so they are never
+        // flagged or modified by the span functions.
+
+        template <typename VT, typename CS, ColourLayout CL>
+        struct GamutBounds {
+
+            using C = Colour<VT, CS, CL>;
+            static constexpr int channels = C::channels;
+
+            std::array<VT, channels> lo;
+            std::array<VT, channels> hi;
+
+            GamutBounds() noexcept {
+                constexpr VT inf = std::numeric_limits<VT>::infinity();
+                C c;
+                int first = int(&c.cs(0) - c.begin());
+                for (int i = 0; i < channels; ++i) {
+                    lo[i] = - inf;
+                    hi[i] = inf;
+                    if (i == C::alpha_index)
+                        continue;
+                    if (cs_is_unit<CS> || (cs_is_polar<CS> && i == first)) {
+                        lo[i] = 0;
+                        hi[i] = C::scale;
+                    }
+                }
+            }
+
+        };
+
+        template <typename VT, typename CS, ColourLayout CL>
+        struct SoftKnee {
+
+            using C = Colour<VT, CS, CL>;
+            static constexpr int channels = C::channels;
+
+            std::array<VT, channels> lo;
+            std::array<VT, channels> knee;
+            std::array<VT, channels> range;
+
+            // A knee of 1 clips at the top of the range (d/0 is infinite, so
+            // the roll-off term is zero); anything outside [0,1] would give
+            // a negative range, and NaN would pass through every colour
+
+            explicit SoftKnee(VT k) {
+                if (! (k >= 0 && k <= 1))
+                    throw std::invalid_argument("Gamut mapping knee must be between 0 and 1");
+                constexpr VT inf = std::numeric_limits<VT>::infinity();
+                VT kv = k * C::scale;
+                for (int i = 0; i < channels; ++i) {
+                    bool active = i != C::alpha_index;
+                    lo[i] = active ? VT(0) : - inf;
+                    knee[i] = active ? kv : inf;
+                    range[i] = C::scale - kv;
+                }
+            }
+
+            // Rational roll-off from the knee towards the top of the range,
+            // mirrored exactly by the vector kernel
+
+            VT operator()(VT x, int i) const noexcept {
+                if (x > knee[i]) {
+                    VT d = x - knee[i];
+                    x = knee[i] + d / (1 + d / range[i]);
+                } else if (x < lo[i]) {
+                    x = lo[i];
+                }
+                return x;
+            }
+
+        };
+
+        // Colour space channels in colour space order, whatever the layout
+
+        template <typename VT, typename CS, ColourLayout CL>
+        constexpr auto cs_vector(const Colour<VT, CS, CL>& colour) noexcept {
+            typename Colour<VT, CS, CL>::partial_vector_type v;
+            for (int i = 0; i < v.dim; ++i)
+                v[i] = colour.cs(i);
+            return v;
+        }
+
+        // Reduce chroma at constant hue and lightness in HCLab, by
+        // bisection, until the colour fits in the unit cube of CS
+
+        template <typename CS, typename T>
+        Vector<T, 3> gamut_compress_chroma(Vector<T, 3> colour) noexcept {
+
+            static constexpr int iterations = 24;
+            static constexpr T tolerance = T(1e-6);
+
+            auto fits = [] (Vector<T, 3> c) noexcept {
+                for (auto x: c)
+                    if (x < - tolerance || x > 1 + tolerance)
+                        return false;
+                return true;
+            };
+
+            if (fits(colour)) {
+                clamp_colour<CS>(colour);
+                return colour;
+            }
+
+            auto hcl = convert_colour_space<CS, HCLab>(colour);
+
+            if (hcl[2] <= 0)
+                return Vector<T, 3>(T(0));
+            if (hcl[2] >= 100)
+                return Vector<T, 3>(T(1));
+
+            T low = 0;
+            T high = hcl[1];
+
+            for (int i = 0; i < iterations; ++i) {
+                T mid = (low + high) / 2;
+                if (fits(convert_colour_space<HCLab, CS>(Vector<T, 3>(hcl[0], mid, hcl[2]))))
+                    low = mid;
+                else
+                    high = mid;
+            }
+
+            auto out = convert_colour_space<HCLab, CS>(Vector<T, 3>(hcl[0], low, hcl[2]));
+            clamp_colour<CS>(out);
+
+            return out;
+
+        }
+
+        template <typename VT, typename CS, ColourLayout CL>
+        void map_colour_to_gamut(Colour<VT, CS, CL>& colour, GamutMapping mode, const SoftKnee<VT, CS, CL>& sk) noexcept {
+            using C = Colour<VT, CS, CL>;
+            switch (mode) {
+                case GamutMapping::chroma: {
+                    auto v = gamut_compress_chroma<CS>(cs_vector(colour) / C::scale) * C::scale;
+                    for (int i = 0; i < 3; ++i)
+                        colour.cs(i) = v[i];
+                    break;
+                }
+                case GamutMapping::soft_knee:
+                    for (int i = 0; i < C::channels; ++i)
+                        colour[i] = sk(colour[i], i);
+                    break;
+                default: {
+                    auto v = cs_vector(colour);
+                    clamp_colour<CS>(v, C::scale);
+                    for (int i = 0; i < 3; ++i)
+                        colour.cs(i) = v[i];
+                    break;
+                }
+            }
+        }
+
+    }
+
+    // Gamut mask: mask[i] is set to 1 if in[i] is in gamut according to
+    // is_colour_in_gamut(), otherwise 0. Returns the number of colours
+    // out of gamut.
+
+    template <typename VT, typename CS, ColourLayout CL>
+    size_t gamut_mask(const Colour<VT, CS, CL>* in, uint8_t* mask, size_t n) noexcept {
+        using C = Colour<VT, CS, CL>;
+        static const Detail::GamutBounds<VT, CS, CL> bounds;
+        size_t i = 0;
+        if constexpr (std::is_same_v<VT, float>)
+            i = Detail::gamut_mask_simd(in->begin(), mask, bounds.lo.data(), bounds.hi.data(), C::channels, n);
+        size_t count = 0;
+        for (size_t j = 0; j < i; ++j)
+            count += size_t(! mask[j]);
+        for (; i < n; ++i) {
+            mask[i] = uint8_t(is_colour_in_gamut<CS>(Detail::cs_vector(in[i]), C::scale));
+            count += size_t(! mask[i]);
+        }
+        return count;
+    }
+
+    // Map a colour into the unit cube of its own RGB colour space. The
+    // alpha channel is never changed.
+
+    template <typename VT, typename CS, ColourLayout CL>
+    Colour<VT, CS, CL> map_to_gamut(Colour<VT, CS, CL> colour, GamutMapping mode = GamutMapping::chroma,
+            VT knee = VT(0.8)) {
+        static_assert(std::is_floating_point_v<VT>);
+        static_assert(cs_is_rgb<CS> && cs_is_unit<CS>);
+        Detail::map_colour_to_gamut(colour, mode, Detail::SoftKnee<VT, CS, CL>(knee));
+        return colour;
+    }
+
+    // Span version. Clipping and soft knee compression run through vector
+    // kernels; chroma compression runs only on the colours flagged by
+    // gamut_mask(), since colours already in gamut are left unchanged.
+
+    template <typename VT, typename CS, ColourLayout CL>
+    void map_to_gamut(Colour<VT, CS, CL>* colours, size_t n, GamutMapping mode = GamutMapping::chroma,
+            VT knee = VT(0.8)) {
+
+        static_assert(std::is_floating_point_v<VT>);
+        static_assert(cs_is_rgb<CS> && cs_is_unit<CS>);
+
+        using C = Colour<VT, CS, CL>;
+        static constexpr bool is_float = std::is_same_v<VT, float>;
+        static constexpr size_t block = 256;
+
+        Detail::SoftKnee<VT, CS, CL> sk(knee);
+        size_t i = 0;
+
+        if (mode == GamutMapping::chroma) {
+
+            uint8_t mask[block];
+
+            for (size_t j = 0; j < n; j += block) {
+                size_t m = std::min(block, n - j);
+                if (gamut_mask(colours + j, mask, m) == 0)
+                    continue;
+                for (size_t k = 0; k < m; ++k)
+                    if (! mask[k])
+                        Detail::map_colour_to_gamut(colours[j + k], mode, sk);
+            }
+
+            return;
+
+        }
+
+        if constexpr (is_float) {
+            if (mode == GamutMapping::soft_knee) {
+                i = Detail::gamut_soft_knee_simd(colours->begin(), sk.lo.data(), sk.knee.data(), sk.range.data(),
+                    C::channels, n);
+            } else {
+                static const Detail::GamutBounds<VT, CS, CL> bounds;
+                i = Detail::gamut_clip_simd(colours->begin(), bounds.lo.data(), bounds.hi.data(), C::channels, n);
+            }
+        }
+
+        for (; i < n; ++i)
+            Detail::map_colour_to_gamut(colours[i], mode, sk);
+
+    }
+
+    // Bake a gamut mapped conversion between colour spaces, calculated in
+    // double precision, over the unit cube of the input space
+
+    template <typename CS1, typename CS2>
+    ColourLut3D gamut_mapping_lut(int size, GamutMapping mode, ThreadPool& pool) {
+        static_assert(CS1::channels.size() == 3);
+        static_assert(cs_is_rgb<CS2> && cs_is_unit<CS2>);
+        return ColourLut3D(size, [mode] (Float3 c) {
+            Colour<double, CS2, ColourLayout::forward> out(convert_colour_space<CS1, CS2>(Double3(c)));
+            out = map_to_gamut(out, mode);
+            return Float3(out.as_vector());
+        }, pool);
+    }
+
+    template <typename CS1, typename CS2>
+    ColourLut3D gamut_mapping_lut(int size, GamutMapping mode = GamutMapping::chroma) {
+        return gamut_mapping_lut<CS1, CS2>(size, mode, ThreadPool::global());
+    }
+
+}
@@ -0,0 +1,192 @@
+#include "rs-graphics-core/colour-lut.hpp"
+#include "rs-graphics-core/simd.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define RS_GRAPHICS_X86 1
+    #include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+    #define RS_GRAPHICS_TARGET(isa)
+#else
+    #define RS_GRAPHICS_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace RS::Graphics::Core::Detail {
+
+    namespace {
+
+        #ifdef RS_GRAPHICS_X86
+
+            // LUT evaluation kernels, processing 8 colours at a time with
+            // gathers from the table. These mirror ColourLut3D::operator()
+            // in colour-lut.hpp operation for operation, so the results are
+            // bit-for-bit identical. There is no SSE2 version, since without
+            // gathers it would be no faster than the scalar code.
+
+            struct LutCell {
+                __m256i base;  // Float offset of the lowest corner
+                __m256 fr, fg, fb;
+            };
+
+            RS_GRAPHICS_TARGET("avx2")
+            __m256 lut_coordinate_avx2(__m256 x, __m256 scale, __m256i last, __m256i& i) noexcept {
+                x = _mm256_max_ps(x, _mm256_setzero_ps());
+                x = _mm256_min_ps(x, _mm256_set1_ps(1.0f));
+                x = _mm256_mul_ps(x, scale);
+                i = _mm256_min_epi32(_mm256_cvttps_epi32(x), last);
+                return _mm256_sub_ps(x, _mm256_cvtepi32_ps(i));
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            LutCell lut_cell_avx2(const float* in, int size) noexcept {
+                const __m256i stride = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+                const __m256 scale = _mm256_set1_ps(float(size - 1));
+                const __m256i last = _mm256_set1_epi32(size - 2);
+                const __m256i n = _mm256_set1_epi32(size);
+                __m256i r, g, b;
+                LutCell cell;
+                cell.fr = lut_coordinate_avx2(_mm256_i32gather_ps(in, stride, 4), scale, last, r);
+                cell.fg = lut_coordinate_avx2(_mm256_i32gather_ps(in + 1, stride, 4), scale, last, g);
+                cell.fb = lut_coordinate_avx2(_mm256_i32gather_ps(in + 2, stride, 4), scale, last, b);
+                __m256i index = _mm256_add_epi32(r, _mm256_mullo_epi32(n, _mm256_add_epi32(g, _mm256_mullo_epi32(n, b))));
+                cell.base = _mm256_mullo_epi32(index, _mm256_set1_epi32(3));
+                return cell;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            __m256 lut_lerp_avx2(__m256 a, __m256 b, __m256 f) noexcept {
+                return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), f));
+            }
+
+            // select(c, x, y) is the vector equivalent of c ? x : y
+
+            RS_GRAPHICS_TARGET("avx2")
+            __m256i select_i(__m256i c, __m256i x, __m256i y) noexcept {
+                return _mm256_blendv_epi8(y, x, c);
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            __m256 select_f(__m256 c, __m256 x, __m256 y) noexcept {
+                return _mm256_blendv_ps(y, x, c);
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            void lut_store_avx2(const __m256* v, float* out) noexcept {
+                alignas(32) float buf[3][8];
+                for (int c = 0; c < 3; ++c)
+                    _mm256_store_ps(buf[c], v[c]);
+                for (int j = 0; j < 8; ++j)
+                    for (int c = 0; c < 3; ++c)
+                        out[3 * j + c] = buf[c][j];
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t lut_trilinear_avx2(const float* table, int size, const float* in, float* out, size_t n) noexcept {
+                const int dr = 3;
+                const int dg = 3 * size;
+                const int db = 3 * size * size;
+                const int offsets[8] = { 0, dr, dg, dr + dg, db, dr + db, dg + db, dr + dg + db };
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    auto cell = lut_cell_avx2(in + 3 * i, size);
+                    __m256 result[3];
+                    for (int c = 0; c < 3; ++c) {
+                        __m256 v[8];
+                        for (int k = 0; k < 8; ++k)
+                            v[k] = _mm256_i32gather_ps(table + c + offsets[k], cell.base, 4);
+                        __m256 c00 = lut_lerp_avx2(v[0], v[1], cell.fr);
+                        __m256 c10 = lut_lerp_avx2(v[2], v[3], cell.fr);
+                        __m256 c01 = lut_lerp_avx2(v[4], v[5], cell.fr);
+                        __m256 c11 = lut_lerp_avx2(v[6], v[7], cell.fr);
+                        __m256 c0 = lut_lerp_avx2(c00, c10, cell.fg);
+                        __m256 c1 = lut_lerp_avx2(c01, c11, cell.fg);
+                        result[c] = lut_lerp_avx2(c0, c1, cell.fb);
+                    }
+                    lut_store_avx2(result, out + 3 * i);
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t lut_tetrahedral_avx2(const float* table, int size, const float* in, float* out, size_t n) noexcept {
+                const __m256i dr = _mm256_set1_epi32(3);
+                const __m256i dg = _mm256_set1_epi32(3 * size);
+                const __m256i db = _mm256_set1_epi32(3 * size * size);
+                const __m256i d_all = _mm256_set1_epi32(3 + 3 * size + 3 * size * size);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    auto cell = lut_cell_avx2(in + 3 * i, size);
+                    __m256 rg = _mm256_cmp_ps(cell.fr, cell.fg, _CMP_GE_OQ);
+                    __m256 gb = _mm256_cmp_ps(cell.fg, cell.fb, _CMP_GE_OQ);
+                    __m256 rb = _mm256_cmp_ps(cell.fr, cell.fb, _CMP_GE_OQ);
+                    __m256i rgi = _mm256_castps_si256(rg);
+                    __m256i gbi = _mm256_castps_si256(gb);
+                    __m256i rbi = _mm256_castps_si256(rb);
+                    __m256i d_max = select_i(rgi, select_i(rbi, dr, db), select_i(gbi, dg, db));
+                    __m256i d_min = select_i(rgi, select_i(gbi, db, dg), select_i(rbi, db, dr));
+                    __m256 f_max = select_f(rg, select_f(rb, cell.fr, cell.fb), select_f(gb, cell.fg, cell.fb));
+                    __m256 f_min = select_f(rg, select_f(gb, cell.fb, cell.fg), select_f(rb, cell.fb, cell.fr));
+                    __m256 f_mid = select_f(rg, select_f(rb, select_f(gb, cell.fg, cell.fb), cell.fr),
+                        select_f(gb, select_f(rb, cell.fr, cell.fb), cell.fg));
+                    __m256i i1 = _mm256_add_epi32(cell.base, d_max);
+                    __m256i i3 = _mm256_add_epi32(cell.base, d_all);
+                    __m256i i2 = _mm256_sub_epi32(i3, d_min);
+                    __m256 result[3];
+                    for (int c = 0; c < 3; ++c) {
+                        __m256 v0 = _mm256_i32gather_ps(table + c, cell.base, 4);
+                        __m256 v1 = _mm256_i32gather_ps(table + c, i1, 4);
+                        __m256 v2 = _mm256_i32gather_ps(table + c, i2, 4);
+                        __m256 v3 = _mm256_i32gather_ps(table + c, i3, 4);
+                        __m256 x = _mm256_add_ps(v0, _mm256_mul_ps(_mm256_sub_ps(v1, v0), f_max));
+                        x = _mm256_add_ps(x, _mm256_mul_ps(_mm256_sub_ps(v2, v1), f_mid));
+                        result[c] = _mm256_add_ps(x, _mm256_mul_ps(_mm256_sub_ps(v3, v2), f_min));
+                    }
+                    lut_store_avx2(result, out + 3 * i);
+                }
+                return i;
+            }
+
+        #endif
+
+    }
+
+    size_t lut_trilinear_simd(const float* table, int size, const float* in, float* out, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return simd_padded<8>(in, 3, out, 3, n, [=] (const float* p, float* q, size_t m) {
+                                             return lut_trilinear_avx2(table, size, p, q, m);
+                                         });
+                default:                 break;
+            }
+        #else
+            (void)table;
+            (void)size;
+            (void)in;
+            (void)out;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t lut_tetrahedral_simd(const float* table, int size, const float* in, float* out, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return simd_padded<8>(in, 3, out, 3, n, [=] (const float* p, float* q, size_t m) {
+                                             return lut_tetrahedral_avx2(table, size, p, q, m);
+                                         });
+                default:                 break;
+            }
+        #else
+            (void)table;
+            (void)size;
+            (void)in;
+            (void)out;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/colour-space.hpp"
+#include "rs-graphics-core/linear-map.hpp"
+#include "rs-graphics-core/maths.hpp"
+#include "rs-graphics-core/multi-array.hpp"
+#include "rs-graphics-core/parallel.hpp"
+#include "rs-graphics-core/simd.hpp"
+#include "rs-graphics-core/vector.hpp"
+#include "rs-tl/enum.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace RS::Graphics::Core {
+
+    RS_DEFINE_ENUM_CLASS(LutInterpolation, int, 0,
+        trilinear,
+        tetrahedral
+    )
+
+    namespace Detail {
+
+        size_t lut_trilinear_simd(const float* table, int size, const float* in, float* out, size_t n) noexcept;
+        size_t lut_tetrahedral_simd(const float* table, int size, const float* in, float* out, size_t n) noexcept;
+
+    }
+
+    class ColourLut3D {
+
+    public:
+
+        using array_type = MultiArray<Float3, 3>;
+
+        static constexpr int max_size = 256;
+
+        ColourLut3D() = default;
+        explicit ColourLut3D(int size);
+        template <typename F> ColourLut3D(int size, F f): ColourLut3D(size, f, ThreadPool::global()) {}
+        template <typename F> ColourLut3D(int size, F f, ThreadPool& pool);
+
+        Float3 operator()(Float3 colour, LutInterpolation mode = LutInterpolation::trilinear) const noexcept;
+        void batch(const Float3* in, Float3* out, size_t n, LutInterpolation mode = LutInterpolation::trilinear) const noexcept;
+
+        bool empty() const noexcept { return table_.empty(); }
+        int size() const noexcept { return table_.shape()[0]; }
+        const array_type& table() const noexcept { return table_; }
+
+    private:
+
+        array_type table_;
+
+        template <typename F> void bake(F f, ThreadPool& pool);
+        int index(int r, int g, int b) const noexcept { return r + size() * (g + size() * b); }
+        static void check_size(int size);
+
+    };
+
+        inline ColourLut3D::ColourLut3D(int size) {
+            check_size(size);
+            table_.reset(size, size, size);
+            bake([] (Float3 c) { return c; }, ThreadPool::global());
+        }
+
+        template <typename F>
+        ColourLut3D::ColourLut3D(int size, F f, ThreadPool& pool) {
+            check_size(size);
+            table_.reset(size, size, size);
+            bake(f, pool);
+        }
+
+        // The grid coordinates and interpolation weights are computed the
+        // same way here and in the vector kernels in colour-lut.cpp, so
+        // batch() gives the same results as calling operator() on each
+        // colour. Inputs are clamped to the unit cube (NaN goes to zero).
+
+        inline Float3 ColourLut3D::operator()(Float3 colour, LutInterpolation mode) const noexcept {
+
+            if (empty())
+                return colour;
+
+            const float scale = float(size() - 1);
+            const int last = size() - 2;
+            Vector<int, 3> i;
+            Float3 f;
+
+            for (int k = 0; k < 3; ++k) {
+                float x = colour[k] > 0 ? colour[k] : 0.0f;
+                x = x < 1 ? x : 1.0f;
+                x *= scale;
+                i[k] = std::min(int(x), last);
+                f[k] = x - float(i[k]);
+            }
+
+            auto data = table_.data();
+            int base = index(i[0], i[1], i[2]);
+            int dr = 1;
+            int dg = size();
+            int db = size() * size();
+
+            if (mode == LutInterpolation::tetrahedral) {
+
+                // Walk from the lowest to the highest corner of the cell
+                // along the axes in decreasing order of fraction
+
+                bool rg = f[0] >= f[1];
+                bool gb = f[1] >= f[2];
+                bool rb = f[0] >= f[2];
+                int d_max = rg ? (rb ? dr : db) : (gb ? dg : db);
+                int d_min = rg ? (gb ? db : dg) : (rb ? db : dr);
+                float f_max = rg ? (rb ? f[0] : f[2]) : (gb ? f[1] : f[2]);
+                float f_min = rg ? (gb ? f[2] : f[1]) : (rb ? f[2] : f[0]);
+                float f_mid = rg ? (rb ? (gb ? f[1] : f[2]) : f[0]) : (gb ? (rb ? f[0] : f[2]) : f[1]);
+                auto& v0 = data[base];
+                auto& v1 = data[base + d_max];
+                auto& v2 = data[base + dr + dg + db - d_min];
+                auto& v3 = data[base + dr + dg + db];
+                return ((v0 + (v1 - v0) * f_max) + (v2 - v1) * f_mid) + (v3 - v2) * f_min;
+
+            } else {
+
+                auto& c000 = data[base];
+                auto& c100 = data[base + dr];
+                auto& c010 = data[base + dg];
+                auto& c110 = data[base + dr + dg];
+                auto& c001 = data[base + db];
+                auto& c101 = data[base + dr + db];
+                auto& c011 = data[base + dg + db];
+                auto& c111 = data[base + dr + dg + db];
+                auto c00 = c000 + (c100 - c000) * f[0];
+                auto c10 = c010 + (c110 - c010) * f[0];
+                auto c01 = c001 + (c101 - c001) * f[0];
+                auto c11 = c011 + (c111 - c011) * f[0];
+                auto c0 = c00 + (c10 - c00) * f[1];
+                auto c1 = c01 + (c11 - c01) * f[1];
+                return c0 + (c1 - c0) * f[2];
+
+            }
+
+        }
+
+        inline void ColourLut3D::batch(const Float3* in, Float3* out, size_t n, LutInterpolation mode) const noexcept {
+            size_t i = 0;
+            if (! empty()) {
+                auto table = table_.data()->begin();
+                if (mode == LutInterpolation::tetrahedral)
+                    i = Detail::lut_tetrahedral_simd(table, size(), in->begin(), out->begin(), n);
+                else
+                    i = Detail::lut_trilinear_simd(table, size(), in->begin(), out->begin(), n);
+            }
+            for (; i < n; ++i)
+                out[i] = (*this)(in[i], mode);
+        }
+
+        template <typename F>
+        void ColourLut3D::bake(F f, ThreadPool& pool) {
+            int n = size();
+            float scale = float(n - 1);
+            pool.for_each(size_t(n), [&] (size_t b) {
+                auto row = &table_(0, 0, int(b));
+                for (int g = 0; g < n; ++g)
+                    for (int r = 0; r < n; ++r, ++row)
+                        *row = f(Float3(float(r) / scale, float(g) / scale, float(b) / scale));
+            });
+        }
+
+        inline void ColourLut3D::check_size(int size) {
+            if (size < 2 || size > max_size)
+                throw std::invalid_argument("Colour LUT size must be between 2 and 256");
+        }
+
+    // Bake a colour ramp with interpolation between the control points
+    // done in another colour space, usually a perceptual one. In a polar
+    // space the hue takes the shorter way round between successive values.
+
+    template <typename IS, typename X, typename VT, typename CS, ColourLayout CL>
+    LinearRamp<X, Colour<VT, CS, CL>> perceptual_ramp(const LinearMap<X, Colour<VT, CS, CL>>& map,
+            int bits = LinearRamp<X, Colour<VT, CS, CL>>::default_bits) {
+
+        using C = Colour<VT, CS, CL>;
+        using IC = Colour<X, IS, C::has_alpha ? ColourLayout::forward_alpha : ColourLayout::forward>;
+        using IV = typename IC::vector_type;
+
+        auto is_map = map.transform([] (const C& c) {
+            IC ic;
+            convert_colour(c, ic);
+            return ic.as_vector();
+        });
+
+        // Unwrap the hue along the knots in key order, so that each value
+        // is within half a turn of the one before
+
+        if constexpr (cs_is_polar<IS>) {
+            LinearMap<X, IV> unwrapped;
+            X prev = 0;
+            bool first = true;
+            for (auto& k: is_map.knots()) {
+                for (auto v: {&k.left, &k.mid, &k.right}) {
+                    if (! first)
+                        (*v)[0] += std::round(prev - (*v)[0]);
+                    prev = (*v)[0];
+                    first = false;
+                }
+                unwrapped.insert(k.x, k.left, k.mid, k.right);
+            }
+            is_map = std::move(unwrapped);
+        }
+
+        return LinearRamp<X, C>(is_map, bits, [] (IV v) {
+            if constexpr (cs_is_polar<IS>)
+                v[0] = fraction(v[0]);
+            C c;
+            convert_colour(IC(v), c);
+            return c;
+        });
+
+    }
+
+    // Bake a conversion between colour spaces, calculated in double
+    // precision, over the unit cube of the input space
+
+    template <typename CS1, typename CS2>
+    ColourLut3D colour_space_lut(int size, ThreadPool& pool) {
+        static_assert(CS1::channels.size() == 3 && CS2::channels.size() == 3);
+        return ColourLut3D(size, [] (Float3 c) {
+            return Float3(convert_colour_space<CS1, CS2>(Double3(c)));
+        }, pool);
+    }
+
+    template <typename CS1, typename CS2>
+    ColourLut3D colour_space_lut(int size) {
+        return colour_space_lut<CS1, CS2>(size, ThreadPool::global());
+    }
+
+}
@@ -0,0 +1,407 @@
+#include "rs-graphics-core/colour-palette.hpp"
+#include <cmath>
+#include <numeric>
+
+namespace RS::Graphics::Core::Detail {
+
+    PaletteIndex::PaletteIndex(const std::vector<Float3>& points, PaletteSearch search, Float3 lo, Float3 hi):
+    points_(points), search_(search) {
+
+        tree_points_ = points_;
+        tree_index_.resize(points_.size());
+        std::iota(tree_index_.begin(), tree_index_.end(), 0u);
+        tree_axis_.resize(points_.size());
+        build_tree(0, points_.size());
+
+        if (search_ == PaletteSearch::grid) {
+            for (auto& p: points_) {
+                for (int k = 0; k < 3; ++k) {
+                    lo[k] = std::min(lo[k], p[k]);
+                    hi[k] = std::max(hi[k], p[k]);
+                }
+            }
+            build_grid(lo, hi);
+        }
+
+    }
+
+    uint32_t PaletteIndex::nearest(Float3 p) const noexcept {
+
+        uint32_t best = 0;
+        float best_d2 = distance2(p, points_[0]);
+
+        if (search_ == PaletteSearch::grid) {
+            bool inside = true;
+            int cell = 0;
+            for (int k = 2; k >= 0; --k) {
+                inside = inside && p[k] >= grid_lo_[k] && p[k] <= grid_hi_[k];
+                if (inside)
+                    cell = grid_size * cell + std::min(int((p[k] - grid_lo_[k]) * grid_scale_[k]), grid_size - 1);
+            }
+            if (inside) {
+                for (uint32_t j = cell_start_[cell]; j < cell_start_[cell + 1]; ++j) {
+                    uint32_t i = cell_items_[j];
+                    float d2 = distance2(p, points_[i]);
+                    if (d2 < best_d2) {
+                        best = i;
+                        best_d2 = d2;
+                    }
+                }
+                return best;
+            }
+        }
+
+        tree_search(p, 0, tree_points_.size(), best, best_d2);
+
+        return best;
+
+    }
+
+    void PaletteIndex::nearest(const Float3* in, uint32_t* out, size_t n) const noexcept {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = nearest(in[i]);
+    }
+
+    // Each subrange of the tree arrays holds its splitting point at the
+    // middle, with the points on the low side of it before, and the high
+    // side after. The split is along the axis of greatest extent.
+
+    void PaletteIndex::build_tree(size_t lo, size_t hi) {
+
+        if (hi - lo < 2) {
+            if (hi > lo)
+                tree_axis_[lo] = 0;
+            return;
+        }
+
+        Float3 min_point = tree_points_[lo];
+        Float3 max_point = min_point;
+
+        for (size_t i = lo + 1; i < hi; ++i) {
+            for (int k = 0; k < 3; ++k) {
+                min_point[k] = std::min(min_point[k], tree_points_[i][k]);
+                max_point[k] = std::max(max_point[k], tree_points_[i][k]);
+            }
+        }
+
+        auto extent = max_point - min_point;
+        int axis = extent[0] >= extent[1] ? (extent[0] >= extent[2] ? 0 : 2) : (extent[1] >= extent[2] ? 1 : 2);
+        size_t mid = (lo + hi) / 2;
+        std::vector<size_t> order(hi - lo);
+        std::iota(order.begin(), order.end(), lo);
+
+        std::nth_element(order.begin(), order.begin() + (mid - lo), order.end(), [this,axis] (size_t a, size_t b) {
+            return tree_points_[a][axis] < tree_points_[b][axis];
+        });
+
+        std::vector<Float3> points(hi - lo);
+        std::vector<uint32_t> index(hi - lo);
+
+        for (size_t i = 0; i < order.size(); ++i) {
+            points[i] = tree_points_[order[i]];
+            index[i] = tree_index_[order[i]];
+        }
+
+        std::copy(points.begin(), points.end(), tree_points_.begin() + ptrdiff_t(lo));
+        std::copy(index.begin(), index.end(), tree_index_.begin() + ptrdiff_t(lo));
+        tree_axis_[mid] = uint8_t(axis);
+        build_tree(lo, mid);
+        build_tree(mid + 1, hi);
+
+    }
+
+    // Each cell lists every point that could be nearest to some position
+    // in the cell: those whose minimum distance to the cell is no more
+    // than the smallest maximum distance of any point. The cells and the
+    // bound are padded slightly, so rounding in the query can only add
+    // candidates, never lose the nearest one.
+
+    void PaletteIndex::build_grid(Float3 lo, Float3 hi) {
+
+        static constexpr int cells = grid_size * grid_size * grid_size;
+
+        grid_lo_ = lo;
+        grid_hi_ = hi;
+        Double3 width;
+
+        for (int k = 0; k < 3; ++k) {
+            width[k] = std::max((double(hi[k]) - double(lo[k])) / grid_size, 1e-6);
+            grid_scale_[k] = float(1 / width[k]);
+        }
+
+        double slack = 1e-5 * grid_size * std::max({width[0], width[1], width[2]});
+        std::vector<double> dmin(points_.size());
+
+        cell_start_.assign(cells + 1, 0);
+        cell_items_.clear();
+
+        for (int cell = 0; cell < cells; ++cell) {
+
+            Vector<int, 3> c(cell % grid_size, cell / grid_size % grid_size, cell / (grid_size * grid_size));
+            Double3 clo, chi;
+
+            for (int k = 0; k < 3; ++k) {
+                clo[k] = double(lo[k]) + c[k] * width[k] - 1e-3 * width[k];
+                chi[k] = double(lo[k]) + (c[k] + 1) * width[k] + 1e-3 * width[k];
+            }
+
+            double bound = std::numeric_limits<double>::infinity();
+
+            for (size_t i = 0; i < points_.size(); ++i) {
+                double near = 0;
+                double far = 0;
+                for (int k = 0; k < 3; ++k) {
+                    double x = points_[i][k];
+                    double a = std::max({clo[k] - x, x - chi[k], 0.0});
+                    double b = std::max(std::abs(x - clo[k]), std::abs(x - chi[k]));
+                    near += a * a;
+                    far += b * b;
+                }
+                dmin[i] = std::sqrt(near);
+                bound = std::min(bound, std::sqrt(far));
+            }
+
+            bound = bound * (1 + 1e-4) + slack;
+
+            for (size_t i = 0; i < points_.size(); ++i)
+                if (dmin[i] <= bound)
+                    cell_items_.push_back(uint32_t(i));
+
+            cell_start_[cell + 1] = uint32_t(cell_items_.size());
+
+        }
+
+    }
+
+    // Points on the far side of the split are never closer than the
+    // distance along the split axis, which is computed with the same
+    // rounding as the full distance, so the pruning is exact
+
+    void PaletteIndex::tree_search(Float3 p, size_t lo, size_t hi, uint32_t& best, float& best_d2) const noexcept {
+
+        if (lo >= hi)
+            return;
+
+        size_t mid = (lo + hi) / 2;
+        float d2 = distance2(p, tree_points_[mid]);
+        uint32_t i = tree_index_[mid];
+
+        if (d2 < best_d2 || (d2 == best_d2 && i < best)) {
+            best = i;
+            best_d2 = d2;
+        }
+
+        if (hi - lo == 1)
+            return;
+
+        int axis = tree_axis_[mid];
+        float diff = p[axis] - tree_points_[mid][axis];
+
+        if (diff < 0) {
+            tree_search(p, lo, mid, best, best_d2);
+            if (diff * diff <= best_d2)
+                tree_search(p, mid + 1, hi, best, best_d2);
+        } else {
+            tree_search(p, mid + 1, hi, best, best_d2);
+            if (diff * diff <= best_d2)
+                tree_search(p, lo, mid, best, best_d2);
+        }
+
+    }
+
+    namespace {
+
+        constexpr size_t palette_block = 16384;
+        constexpr int histogram_bits = 5;
+        constexpr int histogram_size = 1 << histogram_bits;
+
+        struct HistogramBin {
+            Double3 sum;
+            double count = 0;
+            Vector<int, 3> key;
+        };
+
+        struct MedianBox {
+            size_t begin;
+            size_t end;
+            int axis;
+            double extent;
+        };
+
+        MedianBox make_box(const std::vector<HistogramBin>& bins, size_t begin, size_t end, Float3 width) {
+            Vector<int, 3> lo = bins[begin].key;
+            Vector<int, 3> hi = lo;
+            for (size_t i = begin + 1; i < end; ++i) {
+                for (int k = 0; k < 3; ++k) {
+                    lo[k] = std::min(lo[k], bins[i].key[k]);
+                    hi[k] = std::max(hi[k], bins[i].key[k]);
+                }
+            }
+            MedianBox box = {begin, end, 0, -1};
+            for (int k = 0; k < 3; ++k) {
+                double extent = (hi[k] - lo[k]) * double(width[k]);
+                if (hi[k] > lo[k] && extent > box.extent) {
+                    box.axis = k;
+                    box.extent = extent;
+                }
+            }
+            return box;
+        }
+
+    }
+
+    std::vector<Float3> palette_median_cut(const std::vector<Float3>& points, size_t size, ThreadPool& pool) {
+
+        if (points.empty())
+            return {};
+
+        Float3 lo = points[0];
+        Float3 hi = lo;
+
+        for (auto& p: points) {
+            for (int k = 0; k < 3; ++k) {
+                lo[k] = std::min(lo[k], p[k]);
+                hi[k] = std::max(hi[k], p[k]);
+            }
+        }
+
+        Float3 width = (hi - lo) / float(histogram_size);
+        Float3 scale;
+
+        for (int k = 0; k < 3; ++k)
+            scale[k] = width[k] > 0 ? 1 / width[k] : 0.0f;
+
+        std::vector<uint16_t> keys(points.size());
+
+        pool.for_each((points.size() + palette_block - 1) / palette_block, [&] (size_t b) {
+            size_t end = std::min(points.size(), (b + 1) * palette_block);
+            for (size_t i = b * palette_block; i < end; ++i) {
+                int key = 0;
+                for (int k = 2; k >= 0; --k)
+                    key = histogram_size * key + std::min(int((points[i][k] - lo[k]) * scale[k]), histogram_size - 1);
+                keys[i] = uint16_t(key);
+            }
+        });
+
+        std::vector<HistogramBin> histogram(histogram_size * histogram_size * histogram_size);
+
+        for (size_t i = 0; i < points.size(); ++i) {
+            auto& bin = histogram[keys[i]];
+            bin.sum += Double3(points[i]);
+            bin.count += 1;
+        }
+
+        std::vector<HistogramBin> bins;
+
+        for (int key = 0; key < int(histogram.size()); ++key) {
+            if (histogram[key].count > 0) {
+                bins.push_back(histogram[key]);
+                bins.back().key = {key % histogram_size, key / histogram_size % histogram_size,
+                    key / (histogram_size * histogram_size)};
+            }
+        }
+
+        // Split the box with the longest side at the weighted median of
+        // its bins along that side, until there are enough boxes or no box
+        // holds more than one bin
+
+        std::vector<MedianBox> boxes = {make_box(bins, 0, bins.size(), width)};
+
+        while (boxes.size() < size) {
+
+            auto it = std::max_element(boxes.begin(), boxes.end(), [] (const MedianBox& a, const MedianBox& b) {
+                return a.extent < b.extent;
+            });
+
+            if (it->extent < 0)
+                break;
+
+            auto box = *it;
+            auto first = bins.begin() + ptrdiff_t(box.begin);
+            auto last = bins.begin() + ptrdiff_t(box.end);
+
+            std::sort(first, last, [axis = box.axis] (const HistogramBin& a, const HistogramBin& b) {
+                return a.key[axis] < b.key[axis];
+            });
+
+            double total = 0;
+            for (auto i = first; i != last; ++i)
+                total += i->count;
+
+            size_t split = box.begin + 1;
+            double count = bins[box.begin].count;
+            while (split < box.end - 1 && 2 * (count + bins[split].count) <= total)
+                count += bins[split++].count;
+
+            *it = make_box(bins, box.begin, split, width);
+            boxes.push_back(make_box(bins, split, box.end, width));
+
+        }
+
+        std::vector<Float3> palette;
+
+        for (auto& box: boxes) {
+            Double3 sum;
+            double count = 0;
+            for (size_t i = box.begin; i < box.end; ++i) {
+                sum += bins[i].sum;
+                count += bins[i].count;
+            }
+            palette.push_back(Float3(sum / count));
+        }
+
+        return palette;
+
+    }
+
+    std::vector<Float3> palette_k_means(const std::vector<Float3>& points, std::vector<Float3> centres,
+            int iterations, ThreadPool& pool) {
+
+        size_t k = centres.size();
+        size_t blocks = (points.size() + palette_block - 1) / palette_block;
+        std::vector<Double3> sums(blocks * k);
+        std::vector<double> counts(blocks * k);
+
+        for (int iter = 0; iter < iterations && k > 0; ++iter) {
+
+            PaletteIndex index(centres, PaletteSearch::kd_tree, centres[0], centres[0]);
+
+            pool.for_each(blocks, [&] (size_t b) {
+                auto block_sums = sums.data() + b * k;
+                auto block_counts = counts.data() + b * k;
+                std::fill(block_sums, block_sums + k, Double3());
+                std::fill(block_counts, block_counts + k, 0.0);
+                size_t end = std::min(points.size(), (b + 1) * palette_block);
+                for (size_t i = b * palette_block; i < end; ++i) {
+                    uint32_t j = index.nearest(points[i]);
+                    block_sums[j] += Double3(points[i]);
+                    block_counts[j] += 1;
+                }
+            });
+
+            bool changed = false;
+
+            for (size_t j = 0; j < k; ++j) {
+                Double3 sum;
+                double count = 0;
+                for (size_t b = 0; b < blocks; ++b) {
+                    sum += sums[b * k + j];
+                    count += counts[b * k + j];
+                }
+                if (count > 0) {
+                    Float3 centre(sum / count);
+                    changed = changed || centre != centres[j];
+                    centres[j] = centre;
+                }
+            }
+
+            if (! changed)
+                break;
+
+        }
+
+        return centres;
+
+    }
+
+}
@@ -0,0 +1,275 @@
+#pragma once
+
+#include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/colour-space.hpp"
+#include "rs-graphics-core/parallel.hpp"
+#include "rs-graphics-core/vector.hpp"
+#include "rs-tl/enum.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace RS::Graphics::Core {
+
+    RS_DEFINE_ENUM_CLASS(PaletteSearch, int, 0,
+        kd_tree,
+        grid
+    )
+
+    namespace Detail {
+
+        // Nearest neighbour index over a set of points, by squared
+        // Euclidean distance, with ties going to the lowest index. The k-d
+        // tree and the grid give exactly the same answers as a linear scan
+        // using distance2(). The grid covers the box from lo to hi (extended
+        // to include all the points); queries outside it, or with NaN
+        // coordinates, fall back on the tree.
+
+        class PaletteIndex {
+
+        public:
+
+            PaletteIndex() = default;
+            PaletteIndex(const std::vector<Float3>& points, PaletteSearch search, Float3 lo, Float3 hi);
+
+            uint32_t nearest(Float3 p) const noexcept;
+            void nearest(const Float3* in, uint32_t* out, size_t n) const noexcept;
+            const std::vector<Float3>& points() const noexcept { return points_; }
+            PaletteSearch search() const noexcept { return search_; }
+
+            static float distance2(Float3 a, Float3 b) noexcept {
+                Float3 d = a - b;
+                return d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+            }
+
+        private:
+
+            static constexpr int grid_size = 16;
+
+            std::vector<Float3> points_;
+            std::vector<Float3> tree_points_;
+            std::vector<uint32_t> tree_index_;
+            std::vector<uint8_t> tree_axis_;
+            PaletteSearch search_ = PaletteSearch::kd_tree;
+            Float3 grid_lo_;
+            Float3 grid_hi_;
+            Float3 grid_scale_;
+            std::vector<uint32_t> cell_start_;
+            std::vector<uint32_t> cell_items_;
+
+            void build_tree(size_t lo, size_t hi);
+            void build_grid(Float3 lo, Float3 hi);
+            void tree_search(Float3 p, size_t lo, size_t hi, uint32_t& best, float& best_d2) const noexcept;
+
+        };
+
+        // Palette generation in metric space coordinates. Median cut splits
+        // a histogram of the points (32 bins per axis over their bounding
+        // box); k-means refines a set of centres by Lloyd iteration, stopping
+        // early if nothing changes. Both are parallel over blocks of points
+        // of a fixed size, so the results do not depend on the pool.
+
+        std::vector<Float3> palette_median_cut(const std::vector<Float3>& points, size_t size, ThreadPool& pool);
+        std::vector<Float3> palette_k_means(const std::vector<Float3>& points, std::vector<Float3> centres,
+            int iterations, ThreadPool& pool);
+
+        // Bounding box of the sRGB unit cube in a metric space, from the
+        // corners and edges of the cube
+
+        template <typename MS>
+        std::pair<Float3, Float3> palette_domain() {
+            static const auto domain = [] {
+                static constexpr int n = 8;
+                Double3 lo(std::numeric_limits<double>::infinity());
+                Double3 hi = - lo;
+                for (int r = 0; r <= n; ++r) {
+                    for (int g = 0; g <= n; ++g) {
+                        for (int b = 0; b <= n; ++b) {
+                            auto c = convert_colour_space<sRGB, MS>(Double3(r, g, b) / double(n));
+                            for (int k = 0; k < 3; ++k) {
+                                lo[k] = std::min(lo[k], c[k]);
+                                hi[k] = std::max(hi[k], c[k]);
+                            }
+                        }
+                    }
+                }
+                return std::make_pair(Float3(lo), Float3(hi));
+            }();
+            return domain;
+        }
+
+    }
+
+    template <typename MS = CIELab>
+    class ColourPalette {
+
+    public:
+
+        static_assert(MS::channels.size() == 3 && ! cs_is_polar<MS>);
+
+        using metric_space = MS;
+        using metric_colour = Colour<float, MS, ColourLayout::forward>;
+
+        ColourPalette() = default;
+        template <typename C> explicit ColourPalette(const std::vector<C>& colours,
+            PaletteSearch search = PaletteSearch::kd_tree):
+            ColourPalette(colours.data(), colours.size(), search) {}
+        template <typename C> ColourPalette(const C* colours, size_t n,
+            PaletteSearch search = PaletteSearch::kd_tree);
+
+        template <typename C> C colour(size_t i) const noexcept;
+        Float3 metric(size_t i) const noexcept { return index_.points()[i]; }
+        bool empty() const noexcept { return index_.points().empty(); }
+        size_t size() const noexcept { return index_.points().size(); }
+        PaletteSearch search() const noexcept { return index_.search(); }
+
+        template <typename C> size_t nearest(const C& colour,
+            ColourPrecision precision = ColourPrecision::exact) const;
+        template <typename C, typename IT> void nearest(const C* in, IT* out, size_t n,
+            ColourPrecision precision = ColourPrecision::exact) const {
+                nearest(in, out, n, precision, ThreadPool::global());
+            }
+        template <typename C, typename IT> void nearest(const C* in, IT* out, size_t n,
+            ColourPrecision precision, ThreadPool& pool) const;
+
+        template <typename C> static ColourPalette median_cut(const C* pixels, size_t n, size_t size,
+            PaletteSearch search = PaletteSearch::kd_tree) {
+                return median_cut(pixels, n, size, search, ThreadPool::global());
+            }
+        template <typename C> static ColourPalette median_cut(const C* pixels, size_t n, size_t size,
+            PaletteSearch search, ThreadPool& pool);
+        template <typename C> static ColourPalette k_means(const C* pixels, size_t n, size_t size,
+            int iterations = 8, PaletteSearch search = PaletteSearch::kd_tree) {
+                return k_means(pixels, n, size, iterations, search, ThreadPool::global());
+            }
+        template <typename C> static ColourPalette k_means(const C* pixels, size_t n, size_t size,
+            int iterations, PaletteSearch search, ThreadPool& pool);
+
+    private:
+
+        static constexpr size_t block = 256;
+
+        Detail::PaletteIndex index_;
+
+        template <typename C> static void to_metric(const C* in, Float3* out, size_t n, ColourPrecision precision) noexcept;
+        template <typename C> static std::vector<Float3> to_metric(const C* in, size_t n, ThreadPool& pool);
+        static ColourPalette from_metric(const std::vector<Float3>& points, PaletteSearch search);
+        static void check_size(size_t size);
+
+    };
+
+        template <typename MS>
+        template <typename C>
+        ColourPalette<MS>::ColourPalette(const C* colours, size_t n, PaletteSearch search) {
+            std::vector<Float3> points(n);
+            to_metric(colours, points.data(), n, ColourPrecision::exact);
+            *this = from_metric(points, search);
+        }
+
+        template <typename MS>
+        template <typename C>
+        C ColourPalette<MS>::colour(size_t i) const noexcept {
+            C out;
+            convert_colour(metric_colour(metric(i)), out);
+            return out;
+        }
+
+        template <typename MS>
+        template <typename C>
+        size_t ColourPalette<MS>::nearest(const C& colour, ColourPrecision precision) const {
+            if (empty())
+                throw std::invalid_argument("Palette is empty");
+            Float3 p;
+            to_metric(&colour, &p, 1, precision);
+            return index_.nearest(p);
+        }
+
+        template <typename MS>
+        template <typename C, typename IT>
+        void ColourPalette<MS>::nearest(const C* in, IT* out, size_t n, ColourPrecision precision, ThreadPool& pool) const {
+            static_assert(std::is_integral_v<IT>);
+            if (empty())
+                throw std::invalid_argument("Palette is empty");
+            if (size() - 1 > size_t(std::numeric_limits<IT>::max()))
+                throw std::invalid_argument("Palette is too large for the index type");
+            pool.for_each((n + block - 1) / block, [&] (size_t b) {
+                std::array<Float3, block> points;
+                std::array<uint32_t, block> index;
+                size_t i0 = b * block;
+                size_t m = std::min(block, n - i0);
+                to_metric(in + i0, points.data(), m, precision);
+                index_.nearest(points.data(), index.data(), m);
+                for (size_t i = 0; i < m; ++i)
+                    out[i0 + i] = IT(index[i]);
+            });
+        }
+
+        template <typename MS>
+        template <typename C>
+        ColourPalette<MS> ColourPalette<MS>::median_cut(const C* pixels, size_t n, size_t size,
+                PaletteSearch search, ThreadPool& pool) {
+            check_size(size);
+            auto points = to_metric(pixels, n, pool);
+            return from_metric(Detail::palette_median_cut(points, size, pool), search);
+        }
+
+        template <typename MS>
+        template <typename C>
+        ColourPalette<MS> ColourPalette<MS>::k_means(const C* pixels, size_t n, size_t size,
+                int iterations, PaletteSearch search, ThreadPool& pool) {
+            check_size(size);
+            auto points = to_metric(pixels, n, pool);
+            auto centres = Detail::palette_median_cut(points, size, pool);
+            return from_metric(Detail::palette_k_means(points, std::move(centres), iterations, pool), search);
+        }
+
+        template <typename MS>
+        template <typename C>
+        void ColourPalette<MS>::to_metric(const C* in, Float3* out, size_t n, ColourPrecision precision) noexcept {
+            std::array<metric_colour, block> buf;
+            for (size_t i0 = 0; i0 < n; i0 += block) {
+                size_t m = std::min(block, n - i0);
+                convert_colour(in + i0, buf.data(), m, precision);
+                for (size_t i = 0; i < m; ++i)
+                    out[i0 + i] = buf[i].as_vector();
+            }
+        }
+
+        // Palette generation uses fast mode for the conversion, which is
+        // well within the accuracy that matters here
+
+        template <typename MS>
+        template <typename C>
+        std::vector<Float3> ColourPalette<MS>::to_metric(const C* in, size_t n, ThreadPool& pool) {
+            std::vector<Float3> points(n);
+            pool.for_each((n + block - 1) / block, [&] (size_t b) {
+                size_t i0 = b * block;
+                to_metric(in + i0, points.data() + i0, std::min(block, n - i0), ColourPrecision::fast);
+            });
+            return points;
+        }
+
+        template <typename MS>
+        ColourPalette<MS> ColourPalette<MS>::from_metric(const std::vector<Float3>& points, PaletteSearch search) {
+            check_size(points.size());
+            auto domain = Detail::palette_domain<MS>();
+            ColourPalette palette;
+            palette.index_ = Detail::PaletteIndex(points, search, domain.first, domain.second);
+            return palette;
+        }
+
+        template <typename MS>
+        void ColourPalette<MS>::check_size(size_t size) {
+            if (size == 0)
+                throw std::invalid_argument("Palette must not be empty");
+            if (size > size_t(std::numeric_limits<uint32_t>::max()))
+                throw std::invalid_argument("Palette is too large");
+        }
+
+}
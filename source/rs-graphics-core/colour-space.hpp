@@ -2,12 +2,15 @@
 
 #include "rs-graphics-core/maths.hpp"
 #include "rs-graphics-core/matrix.hpp"
+#include "rs-graphics-core/simd.hpp"
 #include "rs-graphics-core/transform.hpp"
 #include "rs-graphics-core/vector.hpp"
 #include "rs-tl/enum.hpp"
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <type_traits>
 
 namespace RS::Graphics::Core {
@@ -264,12 +267,11 @@ namespace RS::Graphics::Core {
         using base = CIEXYZ;
         static constexpr std::array<char, 3> channels = {{ 'R', 'G', 'B' }};
         static constexpr Csp properties = Csp::linear | Csp::rgb | Csp::unit;
-        template <typename T> static constexpr Vector<T, 3> from_base(Vector<T, 3> colour) noexcept { return xyz_to_rgb_matrix<T> * colour; }
-        template <typename T> static constexpr Vector<T, 3> to_base(Vector<T, 3> colour) noexcept { return rgb_to_xyz_matrix<T> * colour; }
-    private:
-        template <typename T> static constexpr auto rgb_to_xyz_matrix = Matrix<T, 3, MatrixLayout::row>
+        template <typename T> static constexpr auto to_base_matrix = Matrix<T, 3, MatrixLayout::row>
             (T(M00), T(M01), T(M02), T(M10), T(M11), T(M12), T(M20), T(M21), T(M22)) / T(Divisor);
-        template <typename T> static constexpr auto xyz_to_rgb_matrix = rgb_to_xyz_matrix<T>.inverse();
+        template <typename T> static constexpr auto from_base_matrix = to_base_matrix<T>.inverse();
+        template <typename T> static constexpr Vector<T, 3> from_base(Vector<T, 3> colour) noexcept { return from_base_matrix<T> * colour; }
+        template <typename T> static constexpr Vector<T, 3> to_base(Vector<T, 3> colour) noexcept { return to_base_matrix<T> * colour; }
     };
 
     template <typename WorkingSpace, int64_t GammaNumerator, int64_t GammaDenominator>
@@ -353,6 +355,163 @@ namespace RS::Graphics::Core {
                 return std::pow((t + c) * d, g);
         }
 
+        // Single precision approximations of the transfer functions, for
+        // ColourPrecision::fast. The vector kernels in colour.cpp mirror
+        // these operation for operation, and give identical results.
+
+        // log2(x) for positive normal x. The mantissa is reduced to
+        // [sqrt(1/2),sqrt(2)), and log2(m) = 2 atanh(r) / ln(2) where
+        // r = (m-1)/(m+1), |r| < 0.172. The series is cut off after r^7,
+        // leaving an error below 5e-8.
+
+        inline float fast_log2(float x) noexcept {
+            static constexpr uint32_t sqrt_half = 0x3f35'04f3;
+            uint32_t bits;
+            std::memcpy(&bits, &x, 4);
+            bits -= sqrt_half;
+            float e = float(int32_t(bits) >> 23);
+            bits = (bits & 0x7f'ffff) + sqrt_half;
+            float m;
+            std::memcpy(&m, &bits, 4);
+            float r = (m - 1) / (m + 1);
+            float r2 = r * r;
+            return e + r * (2.885'390'08f + r2 * (0.961'796'69f + r2 * (0.577'078'02f + r2 * 0.412'198'57f)));
+        }
+
+        // 2^z, using the Taylor series for 2^f = e^(f ln 2) up to f^7 on
+        // [-1/2,1/2] (error below 6e-9). Adding and subtracting 1.5*2^23
+        // rounds z to the nearest integer. Results below 2^-126 are
+        // flushed to zero.
+
+        inline float fast_exp2(float z) noexcept {
+            static constexpr float round_const = 12'582'912.0f;
+            if (z < -126.0f)
+                return 0;
+            if (z > 128.0f)
+                z = 128.0f;
+            float n = (z + round_const) - round_const;
+            float f = z - n;
+            float p = 1.0f + f * (0.693'147'18f + f * (0.240'226'51f + f * (0.055'504'109f
+                + f * (0.009'618'129'1f + f * (0.001'333'355'8f + f * (0.000'154'035'3f + f * 0.000'015'252'734f))))));
+            uint32_t bits = uint32_t(int32_t(n) + 127) << 23;
+            float scale;
+            std::memcpy(&scale, &bits, 4);
+            return p * scale;
+        }
+
+        // x^y for x>=0, y>0
+
+        inline float fast_pow(float x, float y) noexcept {
+            static constexpr float min_normal = 1.175'494'35e-38f;
+            if (x < min_normal)
+                return 0;
+            return fast_exp2(y * fast_log2(x));
+        }
+
+        inline float sRGB_function_fast(float t) noexcept {
+            static constexpr float a = 0.003'130'8f;
+            static constexpr float b = 12.92f;
+            static constexpr float c = 0.055f;
+            static constexpr float d = c + 1;
+            static constexpr float ig = 1 / 2.4f;
+            if (t < a)
+                return t * b;
+            else
+                return d * fast_pow(t, ig) - c;
+        }
+
+        inline float sRGB_inverse_fast(float t) noexcept {
+            static constexpr float a = 0.040'45f;
+            static constexpr float b = 1 / 12.92f;
+            static constexpr float c = 0.055f;
+            static constexpr float d = 1 / (c + 1);
+            static constexpr float g = 2.4f;
+            if (t < a)
+                return t * b;
+            else
+                return fast_pow((t + c) * d, g);
+        }
+
+        // Single precision approximations used by the perceptual colour
+        // spaces in ColourPrecision::fast. Again the vector kernels in
+        // colour.cpp give identical results.
+
+        // Cube root for positive x. The initial estimate divides the
+        // exponent by 3 in the bit pattern (relative error below 4%); two
+        // Halley steps, y *= (y^3+2x)/(2y^3+x), each cube the error, leaving
+        // a relative error below 2.5e-7 (two ulp) for x in [1e-6,1e6].
+        // Precision degrades for x below about 1e-25, where y^3 underflows.
+
+        inline float fast_cbrt(float x) noexcept {
+            static constexpr int32_t magic = 0x2a50'8935;
+            int32_t bits;
+            std::memcpy(&bits, &x, 4);
+            bits = int32_t(float(bits) * (1.0f / 3.0f)) + magic;
+            float y;
+            std::memcpy(&y, &bits, 4);
+            for (int i = 0; i < 2; ++i) {
+                float y3 = y * y * y;
+                y = y * (y3 + 2 * x) / (2 * y3 + x);
+            }
+            return y;
+        }
+
+        // Hue angle in turns, i.e. atan2(y,x)/2pi reduced to [0,1). The
+        // arctangent of min/max on [0,1] uses an odd polynomial of degree
+        // 11, and is then reflected into the right octant. The absolute
+        // error is below 4e-6 radians (7e-7 turns).
+
+        inline float fast_atan2_turns(float y, float x) noexcept {
+            static constexpr float half_pi = 1.570'796'33f;
+            static constexpr float pi = 3.141'592'65f;
+            static constexpr float inverse_tau = 0.159'154'94f;
+            float ax = std::abs(x);
+            float ay = std::abs(y);
+            float mx = ax > ay ? ax : ay;
+            float mn = ax > ay ? ay : ax;
+            float z = mx > 0 ? mn / mx : 0;
+            float z2 = z * z;
+            float p = -0.013'480'470f;
+            p = p * z2 + 0.057'477'314f;
+            p = p * z2 - 0.121'239'071f;
+            p = p * z2 + 0.195'635'925f;
+            p = p * z2 - 0.332'994'597f;
+            p = p * z2 + 0.999'995'630f;
+            p = p * z;
+            if (ay > ax)
+                p = half_pi - p;
+            if (x < 0)
+                p = pi - p;
+            if (y < 0)
+                p = - p;
+            float h = p * inverse_tau;
+            if (h < 0)
+                h += 1;
+            return h;
+        }
+
+        // Sine and cosine of an angle in turns. The angle is reduced to
+        // the nearest quarter turn (|t| < 2^20 is required), leaving
+        // [-pi/4,pi/4] for the Taylor series to theta^7 and theta^8
+        // (absolute error below 4e-7), then the quadrant is applied.
+
+        inline void fast_sincos_turns(float t, float& s, float& c) noexcept {
+            static constexpr float round_const = 12'582'912.0f;
+            static constexpr float tau = 6.283'185'31f;
+            float q = (4 * t + round_const) - round_const;
+            float theta = (t - q * 0.25f) * tau;
+            float t2 = theta * theta;
+            float sp = theta + theta * t2 * (-0.166'666'667f + t2 * (0.008'333'333'3f + t2 * -0.000'198'412'7f));
+            float cp = 1 + t2 * (-0.5f + t2 * (0.041'666'667f + t2 * (-0.001'388'888'9f + t2 * 0.000'024'801'587f)));
+            int quadrant = int(q);
+            s = quadrant & 1 ? cp : sp;
+            c = quadrant & 1 ? sp : cp;
+            if (quadrant & 2)
+                s = - s;
+            if ((quadrant + 1) & 2)
+                c = - c;
+        }
+
     }
 
     class sRGB {
@@ -562,17 +721,193 @@ namespace RS::Graphics::Core {
 
     // Conversion functions
 
+    namespace Detail {
+
+        // A linear chain is a three channel linear space that is either CIE
+        // XYZ, or supplies constant matrices for conversion to and from a
+        // base space that is itself a linear chain. Any conversion between
+        // two such spaces reduces to a single matrix, which is computed at
+        // compile time in extended precision.
+
+        template <typename CS, typename = void>
+        struct LinearChain {
+            static constexpr bool value = false;
+        };
+
+        template <>
+        struct LinearChain<CIEXYZ> {
+            static constexpr bool value = true;
+            static constexpr auto to_xyz = Matrix<long double, 3>::identity();
+            static constexpr auto from_xyz = Matrix<long double, 3>::identity();
+        };
+
+        template <typename CS>
+        struct LinearChain<CS, std::void_t<decltype(CS::template to_base_matrix<long double>),
+                decltype(CS::template from_base_matrix<long double>)>> {
+            static constexpr bool value = cs_is_linear<CS> && CS::channels.size() == 3
+                && LinearChain<typename CS::base>::value;
+            static constexpr Matrix<long double, 3> to_xyz =
+                LinearChain<typename CS::base>::to_xyz * Matrix<long double, 3>(CS::template to_base_matrix<long double>);
+            static constexpr Matrix<long double, 3> from_xyz =
+                Matrix<long double, 3>(CS::template from_base_matrix<long double>) * LinearChain<typename CS::base>::from_xyz;
+        };
+
+        template <typename CS> constexpr bool is_linear_chain = LinearChain<CS>::value;
+
+        template <typename CS1, typename CS2, typename T>
+        constexpr Matrix<T, 3> linear_conversion_matrix = [] {
+            auto product = LinearChain<CS2>::from_xyz * LinearChain<CS1>::to_xyz;
+            Matrix<T, 3> m;
+            for (int r = 0; r < 3; ++r)
+                for (int c = 0; c < 3; ++c)
+                    m(r, c) = T(product(r, c));
+            return m;
+        }();
+
+    }
+
+    // Direct conversions between colour spaces, bypassing the base space
+    // graph. A specialisation must supply a static convert() function
+    // template with the same signature as from_base() and to_base().
+
+    template <typename CS1, typename CS2>
+    struct ColourSpaceShortcut {};
+
+    template <>
+    struct ColourSpaceShortcut<HSL, HSV> {
+        template <typename T>
+        static constexpr Vector<T, 3> convert(Vector<T, 3> colour) noexcept {
+            using namespace Detail;
+            T c = (T(1) - const_abs(T(2) * colour[2] - T(1))) * colour[1];
+            Vector<T, 3> out;
+            out[2] = colour[2] + c / T(2);
+            if (c != 0) {
+                out[0] = euclidean_remainder(colour[0], T(1));
+                out[1] = c / out[2];
+            }
+            return out;
+        }
+    };
+
+    template <>
+    struct ColourSpaceShortcut<HSV, HSL> {
+        template <typename T>
+        static constexpr Vector<T, 3> convert(Vector<T, 3> colour) noexcept {
+            using namespace Detail;
+            T c = colour[2] * colour[1];
+            Vector<T, 3> out;
+            out[2] = (T(2) * colour[2] - c) / T(2);
+            if (c != 0) {
+                out[0] = euclidean_remainder(colour[0], T(1));
+                out[1] = c / (T(1) - const_abs(T(2) * out[2] - T(1)));
+            }
+            return out;
+        }
+    };
+
+    namespace Detail {
+
+        template <typename CS1, typename CS2, typename = void>
+        constexpr bool has_colour_space_shortcut = false;
+
+        template <typename CS1, typename CS2>
+        constexpr bool has_colour_space_shortcut<CS1, CS2,
+            std::void_t<decltype(ColourSpaceShortcut<CS1, CS2>::convert(Vector<double, int(CS1::channels.size())>()))>> = true;
+
+        // Routing between colour spaces. A route climbs from the source
+        // space through its base spaces and descends through the base
+        // spaces of the target, meeting where the two chains share a space,
+        // where both sides are in the same linear chain (one fused matrix),
+        // or where a shortcut is registered. Every step costs one; the
+        // cheapest meeting point is chosen at compile time, preferring to
+        // climb the source chain on ties.
+
+        enum class RouteStep: int {
+            none,
+            shortcut,
+            matrix,
+            up,
+            down,
+        };
+
+        constexpr int no_route = 1'000'000;
+
+        template <typename CS1, typename CS2> constexpr RouteStep route_step() noexcept;
+        template <typename CS1, typename CS2> constexpr int route_cost() noexcept;
+
+        template <typename CS1, typename CS2>
+        constexpr int route_up_cost() noexcept {
+            using BCS1 = typename CS1::base;
+            if constexpr (std::is_same_v<CS1, BCS1>)
+                return no_route;
+            else
+                return 1 + route_cost<BCS1, CS2>();
+        }
+
+        template <typename CS1, typename CS2>
+        constexpr int route_down_cost() noexcept {
+            using BCS2 = typename CS2::base;
+            if constexpr (std::is_same_v<CS2, BCS2>)
+                return no_route;
+            else
+                return 1 + route_cost<CS1, BCS2>();
+        }
+
+        template <typename CS1, typename CS2>
+        constexpr RouteStep route_step() noexcept {
+            if constexpr (std::is_same_v<CS1, CS2>)
+                return RouteStep::none;
+            else if constexpr (has_colour_space_shortcut<CS1, CS2>)
+                return RouteStep::shortcut;
+            else if constexpr (is_linear_chain<CS1> && is_linear_chain<CS2>)
+                return RouteStep::matrix;
+            else if constexpr (route_up_cost<CS1, CS2>() <= route_down_cost<CS1, CS2>())
+                return RouteStep::up;
+            else
+                return RouteStep::down;
+        }
+
+        template <typename CS1, typename CS2>
+        constexpr int route_cost() noexcept {
+            constexpr auto step = route_step<CS1, CS2>();
+            if constexpr (step == RouteStep::none)
+                return 0;
+            else if constexpr (step == RouteStep::up)
+                return route_up_cost<CS1, CS2>();
+            else if constexpr (step == RouteStep::down)
+                return route_down_cost<CS1, CS2>();
+            else
+                return 1;
+        }
+
+        // True if the route's last step is CS2::from_base()
+
+        template <typename CS1, typename CS2>
+        constexpr bool route_ends_with_from_base() noexcept {
+            constexpr auto step = route_step<CS1, CS2>();
+            if constexpr (step == RouteStep::down)
+                return true;
+            else if constexpr (step == RouteStep::up)
+                return route_ends_with_from_base<typename CS1::base, CS2>();
+            else
+                return false;
+        }
+
+    }
+
     template <typename CS1, typename CS2, typename T>
     Vector<T, CS2::channels.size()> convert_colour_space(Vector<T, int(CS1::channels.size())> colour) {
         using BCS1 = typename CS1::base;
         using BCS2 = typename CS2::base;
-        if constexpr (std::is_same_v<CS1, CS2>)
+        using Detail::RouteStep;
+        constexpr auto step = Detail::route_step<CS1, CS2>();
+        if constexpr (step == RouteStep::none)
             return colour;
-        else if constexpr (std::is_same_v<CS1, CIEXYZ> && std::is_same_v<CS2, LinearRGB>)
-            return CS2::from_base(colour);
-        else if constexpr (std::is_same_v<CS1, LinearRGB> && std::is_same_v<CS2, CIEXYZ>)
-            return CS1::to_base(colour);
-        else if constexpr (! std::is_same_v<CS1, BCS1>)
+        else if constexpr (step == RouteStep::shortcut)
+            return ColourSpaceShortcut<CS1, CS2>::convert(colour);
+        else if constexpr (step == RouteStep::matrix)
+            return Detail::linear_conversion_matrix<CS1, CS2, T> * colour;
+        else if constexpr (step == RouteStep::up)
             return convert_colour_space<BCS1, CS2>(CS1::to_base(colour));
         else
             return CS2::from_base(convert_colour_space<CS1, BCS2>(colour));
@@ -1,21 +1,1113 @@
 #include "rs-graphics-core/colour.hpp"
-#include <unordered_map>
+#include "rs-graphics-core/colour-difference.hpp"
+#include "rs-graphics-core/simd.hpp"
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define RS_GRAPHICS_X86 1
+    #include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+    #define RS_GRAPHICS_TARGET(isa)
+#else
+    #define RS_GRAPHICS_TARGET(isa) __attribute__((target(isa)))
+#endif
 
 using namespace RS::Format;
 
 namespace RS::Graphics::Core::Detail {
 
-    std::optional<sRgba8> get_css_colour(const std::string& str) {
+    namespace {
+
+        #ifdef RS_GRAPHICS_X86
+
+            // Channel scaling kernels for bulk conversion between 8-bit and
+            // single precision channels. These mirror channel_to_working_type()
+            // and working_type_to_channel() in colour.hpp, including the
+            // rounding adjustments in const_round() and the wraparound of
+            // out-of-range values (truncated to 8 bits before rounding, as
+            // the scalar conversion does), so the results are bit-for-bit
+            // identical.
+
+            RS_GRAPHICS_TARGET("sse2")
+            size_t unorm8_to_float_sse2(const uint8_t* in, float* out, size_t n) noexcept {
+                const __m128 scale = _mm_set1_ps(255.0f);
+                const __m128i zero = _mm_setzero_si128();
+                size_t i = 0;
+                for (; i + 16 <= n; i += 16) {
+                    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                    __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+                    __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+                    _mm_storeu_ps(out + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+                    _mm_storeu_ps(out + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+                    _mm_storeu_ps(out + i + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+                    _mm_storeu_ps(out + i + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("sse2")
+            __m128i round_unorm8_sse2(__m128 x) noexcept {
+                const __m128 half = _mm_set1_ps(0.5f);
+                const __m128 minus_half = _mm_set1_ps(-0.5f);
+                const __m128i mask = _mm_set1_epi32(0xff);
+                __m128i y = _mm_and_si128(_mm_cvttps_epi32(x), mask);
+                __m128 d = _mm_sub_ps(_mm_cvtepi32_ps(y), x);
+                y = _mm_sub_epi32(y, _mm_castps_si128(_mm_cmple_ps(d, minus_half)));
+                y = _mm_add_epi32(y, _mm_castps_si128(_mm_cmpgt_ps(d, half)));
+                return _mm_and_si128(y, mask);
+            }
+
+            RS_GRAPHICS_TARGET("sse2")
+            size_t float_to_unorm8_sse2(const float* in, uint8_t* out, size_t n) noexcept {
+                const __m128 scale = _mm_set1_ps(255.0f);
+                size_t i = 0;
+                for (; i + 16 <= n; i += 16) {
+                    __m128i a = round_unorm8_sse2(_mm_mul_ps(_mm_loadu_ps(in + i), scale));
+                    __m128i b = round_unorm8_sse2(_mm_mul_ps(_mm_loadu_ps(in + i + 4), scale));
+                    __m128i c = round_unorm8_sse2(_mm_mul_ps(_mm_loadu_ps(in + i + 8), scale));
+                    __m128i d = round_unorm8_sse2(_mm_mul_ps(_mm_loadu_ps(in + i + 12), scale));
+                    __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), bytes);
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t unorm8_to_float_avx2(const uint8_t* in, float* out, size_t n) noexcept {
+                const __m256 scale = _mm256_set1_ps(255.0f);
+                size_t i = 0;
+                for (; i + 16 <= n; i += 16) {
+                    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                    _mm256_storeu_ps(out + i, _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes)), scale));
+                    _mm256_storeu_ps(out + i + 8, _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8))), scale));
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            __m256i round_unorm8_avx2(__m256 x) noexcept {
+                const __m256 half = _mm256_set1_ps(0.5f);
+                const __m256 minus_half = _mm256_set1_ps(-0.5f);
+                const __m256i mask = _mm256_set1_epi32(0xff);
+                __m256i y = _mm256_and_si256(_mm256_cvttps_epi32(x), mask);
+                __m256 d = _mm256_sub_ps(_mm256_cvtepi32_ps(y), x);
+                y = _mm256_sub_epi32(y, _mm256_castps_si256(_mm256_cmp_ps(d, minus_half, _CMP_LE_OQ)));
+                y = _mm256_add_epi32(y, _mm256_castps_si256(_mm256_cmp_ps(d, half, _CMP_GT_OQ)));
+                return _mm256_and_si256(y, mask);
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t float_to_unorm8_avx2(const float* in, uint8_t* out, size_t n) noexcept {
+                const __m256 scale = _mm256_set1_ps(255.0f);
+                size_t i = 0;
+                for (; i + 32 <= n; i += 32) {
+                    __m256i a = round_unorm8_avx2(_mm256_mul_ps(_mm256_loadu_ps(in + i), scale));
+                    __m256i b = round_unorm8_avx2(_mm256_mul_ps(_mm256_loadu_ps(in + i + 8), scale));
+                    __m256i c = round_unorm8_avx2(_mm256_mul_ps(_mm256_loadu_ps(in + i + 16), scale));
+                    __m256i d = round_unorm8_avx2(_mm256_mul_ps(_mm256_loadu_ps(in + i + 24), scale));
+                    // The 256-bit packs work within 128-bit lanes, so the
+                    // result needs its 32-bit groups put back in order
+                    __m256i bytes = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+                    bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), bytes);
+                }
+                return i;
+            }
+
+            // Vector version of the sRGB encoding table search in
+            // TransferEncodeTable, for flat arrays of 3 or 4 channel colours.
+            // Colour channels start from the bucket table and step up through
+            // the thresholds, exactly as the scalar search does. Lanes outside
+            // [0,1] (including NaN) are searched as zero, and patched
+            // afterwards with the direct conversion; alpha lanes are scaled
+            // and rounded as in float_to_unorm8_avx2().
+
+            RS_GRAPHICS_TARGET("avx2")
+            __m256i linear_to_srgb8_vector_avx2(__m256 x, __m256i alpha_mask, const float* thresholds,
+                    const uint8_t* starts, int& fallback) noexcept {
+                const __m256 zero = _mm256_setzero_ps();
+                const __m256 one = _mm256_set1_ps(1.0f);
+                const __m256 buckets = _mm256_set1_ps(float(TransferEncodeTable<sRGB, float>::buckets));
+                const __m256i byte_mask = _mm256_set1_epi32(0xff);
+                const __m256i last = _mm256_set1_epi32(255);
+                const __m256i step_one = _mm256_set1_epi32(1);
+                __m256 is_alpha = _mm256_castsi256_ps(alpha_mask);
+                __m256 in_range = _mm256_and_ps(_mm256_cmp_ps(x, zero, _CMP_GE_OQ), _mm256_cmp_ps(x, one, _CMP_LE_OQ));
+                fallback = ~ _mm256_movemask_ps(_mm256_or_ps(in_range, is_alpha)) & 0xff;
+                __m256 xs = _mm256_and_ps(x, _mm256_andnot_ps(is_alpha, in_range));
+                __m256i bucket = _mm256_cvttps_epi32(_mm256_mul_ps(xs, buckets));
+                __m256i code = _mm256_and_si256(_mm256_i32gather_epi32(reinterpret_cast<const int*>(starts), bucket, 1), byte_mask);
+                for (;;) {
+                    __m256i next = _mm256_min_epi32(_mm256_add_epi32(code, step_one), last);
+                    __m256 t = _mm256_i32gather_ps(thresholds, next, 4);
+                    __m256i step = _mm256_and_si256(_mm256_cmpgt_epi32(last, code), _mm256_castps_si256(_mm256_cmp_ps(xs, t, _CMP_GE_OQ)));
+                    if (_mm256_testz_si256(step, step))
+                        break;
+                    code = _mm256_sub_epi32(code, step);
+                }
+                __m256i alpha = round_unorm8_avx2(_mm256_mul_ps(x, _mm256_set1_ps(255.0f)));
+                return _mm256_blendv_epi8(code, alpha, alpha_mask);
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t linear_to_srgb8_avx2(const float* in, uint8_t* out, size_t n, int alpha_index) noexcept {
+                const auto& table = TransferEncodeTable<sRGB, float>::get();
+                const float* thresholds = table.thresholds();
+                const uint8_t* starts = table.starts();
+                const __m256i alpha_mask = _mm256_cmpeq_epi32(_mm256_setr_epi32(0, 1, 2, 3, 0, 1, 2, 3),
+                    _mm256_set1_epi32(alpha_index));
+                size_t i = 0;
+                for (; i + 32 <= n; i += 32) {
+                    int fallback[4];
+                    __m256i a = linear_to_srgb8_vector_avx2(_mm256_loadu_ps(in + i), alpha_mask, thresholds, starts, fallback[0]);
+                    __m256i b = linear_to_srgb8_vector_avx2(_mm256_loadu_ps(in + i + 8), alpha_mask, thresholds, starts, fallback[1]);
+                    __m256i c = linear_to_srgb8_vector_avx2(_mm256_loadu_ps(in + i + 16), alpha_mask, thresholds, starts, fallback[2]);
+                    __m256i d = linear_to_srgb8_vector_avx2(_mm256_loadu_ps(in + i + 24), alpha_mask, thresholds, starts, fallback[3]);
+                    __m256i bytes = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+                    bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), bytes);
+                    if ((fallback[0] | fallback[1] | fallback[2] | fallback[3]) != 0)
+                        for (size_t j = 0; j < 32; ++j)
+                            if ((fallback[j / 8] >> (j % 8)) & 1)
+                                out[i + j] = TransferEncodeTable<sRGB, float>::direct(in[i + j]);
+                }
+                return i;
+            }
+
+            // Vector versions of fast_pow(), sRGB_function_fast() and
+            // sRGB_inverse_fast() in colour-space.hpp, with the same
+            // constants and the same order of operations. The branches
+            // become masks; the unused side is computed and discarded.
+
+            RS_GRAPHICS_TARGET("sse2")
+            __m128 fast_pow_sse2(__m128 x, __m128 y) noexcept {
+                const __m128i sqrt_half = _mm_set1_epi32(0x3f35'04f3);
+                const __m128i mantissa = _mm_set1_epi32(0x7f'ffff);
+                const __m128 one = _mm_set1_ps(1.0f);
+                const __m128 round_const = _mm_set1_ps(12'582'912.0f);
+                __m128i bits = _mm_sub_epi32(_mm_castps_si128(x), sqrt_half);
+                __m128 e = _mm_cvtepi32_ps(_mm_srai_epi32(bits, 23));
+                __m128 m = _mm_castsi128_ps(_mm_add_epi32(_mm_and_si128(bits, mantissa), sqrt_half));
+                __m128 r = _mm_div_ps(_mm_sub_ps(m, one), _mm_add_ps(m, one));
+                __m128 r2 = _mm_mul_ps(r, r);
+                __m128 p = _mm_add_ps(_mm_set1_ps(0.577'078'02f), _mm_mul_ps(r2, _mm_set1_ps(0.412'198'57f)));
+                p = _mm_add_ps(_mm_set1_ps(0.961'796'69f), _mm_mul_ps(r2, p));
+                p = _mm_add_ps(_mm_set1_ps(2.885'390'08f), _mm_mul_ps(r2, p));
+                __m128 z = _mm_mul_ps(y, _mm_add_ps(e, _mm_mul_ps(r, p)));
+                __m128 zero_mask = _mm_or_ps(_mm_cmplt_ps(x, _mm_set1_ps(1.175'494'35e-38f)),
+                    _mm_cmplt_ps(z, _mm_set1_ps(-126.0f)));
+                z = _mm_min_ps(z, _mm_set1_ps(128.0f));
+                __m128 n = _mm_sub_ps(_mm_add_ps(z, round_const), round_const);
+                __m128 f = _mm_sub_ps(z, n);
+                p = _mm_add_ps(_mm_set1_ps(0.000'154'035'3f), _mm_mul_ps(f, _mm_set1_ps(0.000'015'252'734f)));
+                p = _mm_add_ps(_mm_set1_ps(0.001'333'355'8f), _mm_mul_ps(f, p));
+                p = _mm_add_ps(_mm_set1_ps(0.009'618'129'1f), _mm_mul_ps(f, p));
+                p = _mm_add_ps(_mm_set1_ps(0.055'504'109f), _mm_mul_ps(f, p));
+                p = _mm_add_ps(_mm_set1_ps(0.240'226'51f), _mm_mul_ps(f, p));
+                p = _mm_add_ps(_mm_set1_ps(0.693'147'18f), _mm_mul_ps(f, p));
+                p = _mm_add_ps(one, _mm_mul_ps(f, p));
+                __m128i scale = _mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(n), _mm_set1_epi32(127)), 23);
+                return _mm_andnot_ps(zero_mask, _mm_mul_ps(p, _mm_castsi128_ps(scale)));
+            }
+
+            RS_GRAPHICS_TARGET("sse2")
+            __m128 select_sse2(__m128 mask, __m128 a, __m128 b) noexcept {
+                return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+            }
+
+            RS_GRAPHICS_TARGET("sse2")
+            size_t srgb_decode_fast_sse2(const float* in, float* out, size_t n) noexcept {
+                static constexpr float c = 0.055f;
+                const __m128 a = _mm_set1_ps(0.040'45f);
+                const __m128 b = _mm_set1_ps(1 / 12.92f);
+                const __m128 d = _mm_set1_ps(1 / (c + 1));
+                const __m128 g = _mm_set1_ps(2.4f);
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    __m128 t = _mm_loadu_ps(in + i);
+                    __m128 curve = fast_pow_sse2(_mm_mul_ps(_mm_add_ps(t, _mm_set1_ps(c)), d), g);
+                    _mm_storeu_ps(out + i, select_sse2(_mm_cmplt_ps(t, a), _mm_mul_ps(t, b), curve));
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("sse2")
+            size_t srgb_encode_fast_sse2(const float* in, float* out, size_t n) noexcept {
+                static constexpr float c = 0.055f;
+                const __m128 a = _mm_set1_ps(0.003'130'8f);
+                const __m128 b = _mm_set1_ps(12.92f);
+                const __m128 d = _mm_set1_ps(c + 1);
+                const __m128 ig = _mm_set1_ps(1 / 2.4f);
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    __m128 t = _mm_loadu_ps(in + i);
+                    __m128 curve = _mm_sub_ps(_mm_mul_ps(d, fast_pow_sse2(t, ig)), _mm_set1_ps(c));
+                    _mm_storeu_ps(out + i, select_sse2(_mm_cmplt_ps(t, a), _mm_mul_ps(t, b), curve));
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("sse2")
+            size_t power_fast_sse2(const float* in, float* out, size_t n, float y) noexcept {
+                const __m128 vy = _mm_set1_ps(y);
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                    _mm_storeu_ps(out + i, fast_pow_sse2(_mm_loadu_ps(in + i), vy));
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            __m256 fast_pow_avx2(__m256 x, __m256 y) noexcept {
+                const __m256i sqrt_half = _mm256_set1_epi32(0x3f35'04f3);
+                const __m256i mantissa = _mm256_set1_epi32(0x7f'ffff);
+                const __m256 one = _mm256_set1_ps(1.0f);
+                const __m256 round_const = _mm256_set1_ps(12'582'912.0f);
+                __m256i bits = _mm256_sub_epi32(_mm256_castps_si256(x), sqrt_half);
+                __m256 e = _mm256_cvtepi32_ps(_mm256_srai_epi32(bits, 23));
+                __m256 m = _mm256_castsi256_ps(_mm256_add_epi32(_mm256_and_si256(bits, mantissa), sqrt_half));
+                __m256 r = _mm256_div_ps(_mm256_sub_ps(m, one), _mm256_add_ps(m, one));
+                __m256 r2 = _mm256_mul_ps(r, r);
+                __m256 p = _mm256_add_ps(_mm256_set1_ps(0.577'078'02f), _mm256_mul_ps(r2, _mm256_set1_ps(0.412'198'57f)));
+                p = _mm256_add_ps(_mm256_set1_ps(0.961'796'69f), _mm256_mul_ps(r2, p));
+                p = _mm256_add_ps(_mm256_set1_ps(2.885'390'08f), _mm256_mul_ps(r2, p));
+                __m256 z = _mm256_mul_ps(y, _mm256_add_ps(e, _mm256_mul_ps(r, p)));
+                __m256 zero_mask = _mm256_or_ps(_mm256_cmp_ps(x, _mm256_set1_ps(1.175'494'35e-38f), _CMP_LT_OQ),
+                    _mm256_cmp_ps(z, _mm256_set1_ps(-126.0f), _CMP_LT_OQ));
+                z = _mm256_min_ps(z, _mm256_set1_ps(128.0f));
+                __m256 n = _mm256_sub_ps(_mm256_add_ps(z, round_const), round_const);
+                __m256 f = _mm256_sub_ps(z, n);
+                p = _mm256_add_ps(_mm256_set1_ps(0.000'154'035'3f), _mm256_mul_ps(f, _mm256_set1_ps(0.000'015'252'734f)));
+                p = _mm256_add_ps(_mm256_set1_ps(0.001'333'355'8f), _mm256_mul_ps(f, p));
+                p = _mm256_add_ps(_mm256_set1_ps(0.009'618'129'1f), _mm256_mul_ps(f, p));
+                p = _mm256_add_ps(_mm256_set1_ps(0.055'504'109f), _mm256_mul_ps(f, p));
+                p = _mm256_add_ps(_mm256_set1_ps(0.240'226'51f), _mm256_mul_ps(f, p));
+                p = _mm256_add_ps(_mm256_set1_ps(0.693'147'18f), _mm256_mul_ps(f, p));
+                p = _mm256_add_ps(one, _mm256_mul_ps(f, p));
+                __m256i scale = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(n), _mm256_set1_epi32(127)), 23);
+                return _mm256_andnot_ps(zero_mask, _mm256_mul_ps(p, _mm256_castsi256_ps(scale)));
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t srgb_decode_fast_avx2(const float* in, float* out, size_t n) noexcept {
+                static constexpr float c = 0.055f;
+                const __m256 a = _mm256_set1_ps(0.040'45f);
+                const __m256 b = _mm256_set1_ps(1 / 12.92f);
+                const __m256 d = _mm256_set1_ps(1 / (c + 1));
+                const __m256 g = _mm256_set1_ps(2.4f);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    __m256 t = _mm256_loadu_ps(in + i);
+                    __m256 curve = fast_pow_avx2(_mm256_mul_ps(_mm256_add_ps(t, _mm256_set1_ps(c)), d), g);
+                    _mm256_storeu_ps(out + i, _mm256_blendv_ps(curve, _mm256_mul_ps(t, b), _mm256_cmp_ps(t, a, _CMP_LT_OQ)));
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t srgb_encode_fast_avx2(const float* in, float* out, size_t n) noexcept {
+                static constexpr float c = 0.055f;
+                const __m256 a = _mm256_set1_ps(0.003'130'8f);
+                const __m256 b = _mm256_set1_ps(12.92f);
+                const __m256 d = _mm256_set1_ps(c + 1);
+                const __m256 ig = _mm256_set1_ps(1 / 2.4f);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    __m256 t = _mm256_loadu_ps(in + i);
+                    __m256 curve = _mm256_sub_ps(_mm256_mul_ps(d, fast_pow_avx2(t, ig)), _mm256_set1_ps(c));
+                    _mm256_storeu_ps(out + i, _mm256_blendv_ps(curve, _mm256_mul_ps(t, b), _mm256_cmp_ps(t, a, _CMP_LT_OQ)));
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t power_fast_avx2(const float* in, float* out, size_t n, float y) noexcept {
+                const __m256 vy = _mm256_set1_ps(y);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                    _mm256_storeu_ps(out + i, fast_pow_avx2(_mm256_loadu_ps(in + i), vy));
+                return i;
+            }
+
+            // Vector versions of fast_cbrt(), fast_atan2_turns() and
+            // fast_sincos_turns() in colour-space.hpp, and of the FastSpace
+            // steps in colour.hpp, 8 colours at a time. As above, these use
+            // the same constants and order of operations as the scalar code,
+            // and branches become masks. There is no SSE2 version.
+
+            RS_GRAPHICS_TARGET("avx2")
+            void load_colours_avx2(const float* in, __m256& x, __m256& y, __m256& z) noexcept {
+                const __m256i index = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+                x = _mm256_i32gather_ps(in, index, 4);
+                y = _mm256_i32gather_ps(in + 1, index, 4);
+                z = _mm256_i32gather_ps(in + 2, index, 4);
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            void store_colours_avx2(float* out, __m256 x, __m256 y, __m256 z) noexcept {
+                alignas(32) float buf[24];
+                _mm256_store_ps(buf, x);
+                _mm256_store_ps(buf + 8, y);
+                _mm256_store_ps(buf + 16, z);
+                for (int i = 0; i < 8; ++i) {
+                    out[3 * i] = buf[i];
+                    out[3 * i + 1] = buf[i + 8];
+                    out[3 * i + 2] = buf[i + 16];
+                }
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            __m256 fast_cbrt_avx2(__m256 x) noexcept {
+                const __m256 two = _mm256_set1_ps(2.0f);
+                __m256 e = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_castps_si256(x)), _mm256_set1_ps(1.0f / 3.0f));
+                __m256 y = _mm256_castsi256_ps(_mm256_add_epi32(_mm256_cvttps_epi32(e), _mm256_set1_epi32(0x2a50'8935)));
+                for (int i = 0; i < 2; ++i) {
+                    __m256 y3 = _mm256_mul_ps(_mm256_mul_ps(y, y), y);
+                    y = _mm256_div_ps(_mm256_mul_ps(y, _mm256_add_ps(y3, _mm256_mul_ps(two, x))),
+                        _mm256_add_ps(_mm256_mul_ps(two, y3), x));
+                }
+                return y;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            __m256 fast_atan2_turns_avx2(__m256 y, __m256 x) noexcept {
+                const __m256 sign = _mm256_set1_ps(-0.0f);
+                const __m256 zero = _mm256_setzero_ps();
+                __m256 ax = _mm256_andnot_ps(sign, x);
+                __m256 ay = _mm256_andnot_ps(sign, y);
+                __m256 x_larger = _mm256_cmp_ps(ax, ay, _CMP_GT_OQ);
+                __m256 mx = _mm256_blendv_ps(ay, ax, x_larger);
+                __m256 mn = _mm256_blendv_ps(ax, ay, x_larger);
+                __m256 z = _mm256_and_ps(_mm256_div_ps(mn, mx), _mm256_cmp_ps(mx, zero, _CMP_GT_OQ));
+                __m256 z2 = _mm256_mul_ps(z, z);
+                __m256 p = _mm256_set1_ps(-0.013'480'470f);
+                p = _mm256_add_ps(_mm256_mul_ps(p, z2), _mm256_set1_ps(0.057'477'314f));
+                p = _mm256_sub_ps(_mm256_mul_ps(p, z2), _mm256_set1_ps(0.121'239'071f));
+                p = _mm256_add_ps(_mm256_mul_ps(p, z2), _mm256_set1_ps(0.195'635'925f));
+                p = _mm256_sub_ps(_mm256_mul_ps(p, z2), _mm256_set1_ps(0.332'994'597f));
+                p = _mm256_add_ps(_mm256_mul_ps(p, z2), _mm256_set1_ps(0.999'995'630f));
+                p = _mm256_mul_ps(p, z);
+                p = _mm256_blendv_ps(p, _mm256_sub_ps(_mm256_set1_ps(1.570'796'33f), p), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+                p = _mm256_blendv_ps(p, _mm256_sub_ps(_mm256_set1_ps(3.141'592'65f), p), _mm256_cmp_ps(x, zero, _CMP_LT_OQ));
+                p = _mm256_blendv_ps(p, _mm256_xor_ps(p, sign), _mm256_cmp_ps(y, zero, _CMP_LT_OQ));
+                __m256 h = _mm256_mul_ps(p, _mm256_set1_ps(0.159'154'94f));
+                return _mm256_blendv_ps(h, _mm256_add_ps(h, _mm256_set1_ps(1.0f)), _mm256_cmp_ps(h, zero, _CMP_LT_OQ));
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            void fast_sincos_turns_avx2(__m256 t, __m256& s, __m256& c) noexcept {
+                const __m256 round_const = _mm256_set1_ps(12'582'912.0f);
+                const __m256 sign = _mm256_set1_ps(-0.0f);
+                const __m256i one = _mm256_set1_epi32(1);
+                const __m256i two = _mm256_set1_epi32(2);
+                __m256 q = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(4.0f), t), round_const), round_const);
+                __m256 theta = _mm256_mul_ps(_mm256_sub_ps(t, _mm256_mul_ps(q, _mm256_set1_ps(0.25f))),
+                    _mm256_set1_ps(6.283'185'31f));
+                __m256 t2 = _mm256_mul_ps(theta, theta);
+                __m256 sp = _mm256_add_ps(_mm256_set1_ps(0.008'333'333'3f), _mm256_mul_ps(t2, _mm256_set1_ps(-0.000'198'412'7f)));
+                sp = _mm256_add_ps(_mm256_set1_ps(-0.166'666'667f), _mm256_mul_ps(t2, sp));
+                sp = _mm256_add_ps(theta, _mm256_mul_ps(_mm256_mul_ps(theta, t2), sp));
+                __m256 cp = _mm256_add_ps(_mm256_set1_ps(-0.001'388'888'9f), _mm256_mul_ps(t2, _mm256_set1_ps(0.000'024'801'587f)));
+                cp = _mm256_add_ps(_mm256_set1_ps(0.041'666'667f), _mm256_mul_ps(t2, cp));
+                cp = _mm256_add_ps(_mm256_set1_ps(-0.5f), _mm256_mul_ps(t2, cp));
+                cp = _mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(t2, cp));
+                __m256i quadrant = _mm256_cvttps_epi32(q);
+                __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, one), one));
+                __m256 neg_s = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, two), two));
+                __m256 neg_c = _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+                    _mm256_and_si256(_mm256_add_epi32(quadrant, one), two), two));
+                s = _mm256_xor_ps(_mm256_blendv_ps(sp, cp, swap), _mm256_and_ps(neg_s, sign));
+                c = _mm256_xor_ps(_mm256_blendv_ps(cp, sp, swap), _mm256_and_ps(neg_c, sign));
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            __m256 lab_f_avx2(__m256 t) noexcept {
+                __m256 linear = _mm256_add_ps(_mm256_div_ps(t, _mm256_set1_ps(FastLab::c2)), _mm256_set1_ps(FastLab::c3));
+                return _mm256_blendv_ps(fast_cbrt_avx2(t), linear, _mm256_cmp_ps(t, _mm256_set1_ps(FastLab::c1), _CMP_LE_OQ));
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            __m256 lab_inverse_f_avx2(__m256 t) noexcept {
+                __m256 linear = _mm256_mul_ps(_mm256_set1_ps(FastLab::c2), _mm256_sub_ps(t, _mm256_set1_ps(FastLab::c3)));
+                __m256 cube = _mm256_mul_ps(_mm256_mul_ps(t, t), t);
+                return _mm256_blendv_ps(cube, linear, _mm256_cmp_ps(t, _mm256_set1_ps(FastLab::delta), _CMP_LE_OQ));
+            }
+
+            // D65 has Y=1, so the Y channel is not scaled
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t lab_from_base_fast_avx2(const float* in, float* out, size_t n) noexcept {
+                const __m256 wx = _mm256_set1_ps(D65<float>.x());
+                const __m256 wz = _mm256_set1_ps(D65<float>.z());
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8, in += 24, out += 24) {
+                    __m256 x, y, z;
+                    load_colours_avx2(in, x, y, z);
+                    __m256 fx = lab_f_avx2(_mm256_div_ps(x, wx));
+                    __m256 fy = lab_f_avx2(y);
+                    __m256 fz = lab_f_avx2(_mm256_div_ps(z, wz));
+                    store_colours_avx2(out,
+                        _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(116.0f), fy), _mm256_set1_ps(16.0f)),
+                        _mm256_mul_ps(_mm256_set1_ps(500.0f), _mm256_sub_ps(fx, fy)),
+                        _mm256_mul_ps(_mm256_set1_ps(200.0f), _mm256_sub_ps(fy, fz)));
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t lab_to_base_fast_avx2(const float* in, float* out, size_t n) noexcept {
+                const __m256 wx = _mm256_set1_ps(D65<float>.x());
+                const __m256 wz = _mm256_set1_ps(D65<float>.z());
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8, in += 24, out += 24) {
+                    __m256 l, a, b;
+                    load_colours_avx2(in, l, a, b);
+                    __m256 lx = _mm256_div_ps(_mm256_add_ps(l, _mm256_set1_ps(16.0f)), _mm256_set1_ps(116.0f));
+                    __m256 x = lab_inverse_f_avx2(_mm256_add_ps(lx, _mm256_div_ps(a, _mm256_set1_ps(500.0f))));
+                    __m256 y = lab_inverse_f_avx2(lx);
+                    __m256 z = lab_inverse_f_avx2(_mm256_sub_ps(lx, _mm256_div_ps(b, _mm256_set1_ps(200.0f))));
+                    store_colours_avx2(out, _mm256_mul_ps(x, wx), y, _mm256_mul_ps(z, wz));
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t luv_from_base_fast_avx2(const float* in, float* out, size_t n) noexcept {
+                const __m256 k13 = _mm256_set1_ps(13.0f);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8, in += 24, out += 24) {
+                    __m256 x, y, z;
+                    load_colours_avx2(in, x, y, z);
+                    __m256 curve = _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(116.0f), fast_cbrt_avx2(y)), _mm256_set1_ps(16.0f));
+                    __m256 linear = _mm256_mul_ps(_mm256_set1_ps(FastLuv::c3), y);
+                    __m256 l = _mm256_blendv_ps(curve, linear, _mm256_cmp_ps(y, _mm256_set1_ps(FastLuv::c1), _CMP_LE_OQ));
+                    __m256 d = _mm256_add_ps(_mm256_add_ps(x, _mm256_mul_ps(_mm256_set1_ps(15.0f), y)),
+                        _mm256_mul_ps(_mm256_set1_ps(3.0f), z));
+                    __m256 u = _mm256_div_ps(_mm256_mul_ps(_mm256_set1_ps(4.0f), x), d);
+                    __m256 v = _mm256_div_ps(_mm256_mul_ps(_mm256_set1_ps(9.0f), y), d);
+                    __m256 l13 = _mm256_mul_ps(k13, l);
+                    store_colours_avx2(out, l,
+                        _mm256_mul_ps(l13, _mm256_sub_ps(u, _mm256_set1_ps(FastLuv::un))),
+                        _mm256_mul_ps(l13, _mm256_sub_ps(v, _mm256_set1_ps(FastLuv::vn))));
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t luv_to_base_fast_avx2(const float* in, float* out, size_t n) noexcept {
+                const __m256 four = _mm256_set1_ps(4.0f);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8, in += 24, out += 24) {
+                    __m256 l, a, b;
+                    load_colours_avx2(in, l, a, b);
+                    __m256 black = _mm256_cmp_ps(l, _mm256_setzero_ps(), _CMP_EQ_OQ);
+                    __m256 l13 = _mm256_mul_ps(_mm256_set1_ps(13.0f), l);
+                    __m256 u = _mm256_add_ps(_mm256_div_ps(a, l13), _mm256_set1_ps(FastLuv::un));
+                    __m256 v = _mm256_add_ps(_mm256_div_ps(b, l13), _mm256_set1_ps(FastLuv::vn));
+                    __m256 p = _mm256_div_ps(_mm256_add_ps(l, _mm256_set1_ps(16.0f)), _mm256_set1_ps(116.0f));
+                    __m256 y = _mm256_blendv_ps(_mm256_mul_ps(_mm256_mul_ps(p, p), p), _mm256_mul_ps(_mm256_set1_ps(FastLuv::c4), l),
+                        _mm256_cmp_ps(l, _mm256_set1_ps(8.0f), _CMP_LE_OQ));
+                    __m256 v4 = _mm256_mul_ps(four, v);
+                    __m256 x = _mm256_div_ps(_mm256_mul_ps(_mm256_mul_ps(y, _mm256_set1_ps(9.0f)), u), v4);
+                    __m256 w = _mm256_sub_ps(_mm256_sub_ps(_mm256_set1_ps(12.0f), _mm256_mul_ps(_mm256_set1_ps(3.0f), u)),
+                        _mm256_mul_ps(_mm256_set1_ps(20.0f), v));
+                    __m256 z = _mm256_div_ps(_mm256_mul_ps(y, w), v4);
+                    store_colours_avx2(out, _mm256_andnot_ps(black, x), _mm256_andnot_ps(black, y), _mm256_andnot_ps(black, z));
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t hcl_from_base_fast_avx2(const float* in, float* out, size_t n) noexcept {
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8, in += 24, out += 24) {
+                    __m256 l, a, b;
+                    load_colours_avx2(in, l, a, b);
+                    __m256 c = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(b, b)));
+                    store_colours_avx2(out, fast_atan2_turns_avx2(b, a), c, l);
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t hcl_to_base_fast_avx2(const float* in, float* out, size_t n) noexcept {
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8, in += 24, out += 24) {
+                    __m256 h, c, l, s, co;
+                    load_colours_avx2(in, h, c, l);
+                    fast_sincos_turns_avx2(h, s, co);
+                    store_colours_avx2(out, l, _mm256_mul_ps(c, co), _mm256_mul_ps(c, s));
+                }
+                return i;
+            }
+
+            // Colour difference kernels, mirroring delta_e_76(),
+            // delta_e_94() and delta_e_2000_fast() in colour-difference.hpp.
+            // These live here to share the fast maths kernels above.
+
+            RS_GRAPHICS_TARGET("avx2")
+            __m256 fast_exp2_avx2(__m256 z) noexcept {
+                const __m256 round_const = _mm256_set1_ps(12'582'912.0f);
+                __m256 zero_mask = _mm256_cmp_ps(z, _mm256_set1_ps(-126.0f), _CMP_LT_OQ);
+                z = _mm256_min_ps(z, _mm256_set1_ps(128.0f));
+                __m256 n = _mm256_sub_ps(_mm256_add_ps(z, round_const), round_const);
+                __m256 f = _mm256_sub_ps(z, n);
+                __m256 p = _mm256_add_ps(_mm256_set1_ps(0.000'154'035'3f), _mm256_mul_ps(f, _mm256_set1_ps(0.000'015'252'734f)));
+                p = _mm256_add_ps(_mm256_set1_ps(0.001'333'355'8f), _mm256_mul_ps(f, p));
+                p = _mm256_add_ps(_mm256_set1_ps(0.009'618'129'1f), _mm256_mul_ps(f, p));
+                p = _mm256_add_ps(_mm256_set1_ps(0.055'504'109f), _mm256_mul_ps(f, p));
+                p = _mm256_add_ps(_mm256_set1_ps(0.240'226'51f), _mm256_mul_ps(f, p));
+                p = _mm256_add_ps(_mm256_set1_ps(0.693'147'18f), _mm256_mul_ps(f, p));
+                p = _mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(f, p));
+                __m256i scale = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(n), _mm256_set1_epi32(127)), 23);
+                return _mm256_andnot_ps(zero_mask, _mm256_mul_ps(p, _mm256_castsi256_ps(scale)));
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            __m256 hypot_avx2(__m256 x, __m256 y) noexcept {
+                return _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)));
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            __m256 square_avx2(__m256 x) noexcept {
+                return _mm256_mul_ps(x, x);
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t delta_e_76_avx2(const float* lab1, const float* lab2, float* out, size_t n) noexcept {
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    __m256 l1, a1, b1, l2, a2, b2;
+                    load_colours_avx2(lab1 + 3 * i, l1, a1, b1);
+                    load_colours_avx2(lab2 + 3 * i, l2, a2, b2);
+                    __m256 e = _mm256_add_ps(square_avx2(_mm256_sub_ps(l1, l2)), square_avx2(_mm256_sub_ps(a1, a2)));
+                    e = _mm256_add_ps(e, square_avx2(_mm256_sub_ps(b1, b2)));
+                    _mm256_storeu_ps(out + i, _mm256_sqrt_ps(e));
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t delta_e_94_avx2(const float* lab1, const float* lab2, float* out, size_t n) noexcept {
+                const __m256 one = _mm256_set1_ps(1.0f);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    __m256 l1, a1, b1, l2, a2, b2;
+                    load_colours_avx2(lab1 + 3 * i, l1, a1, b1);
+                    load_colours_avx2(lab2 + 3 * i, l2, a2, b2);
+                    __m256 dl = _mm256_sub_ps(l1, l2);
+                    __m256 da = _mm256_sub_ps(a1, a2);
+                    __m256 db = _mm256_sub_ps(b1, b2);
+                    __m256 c1 = hypot_avx2(a1, b1);
+                    __m256 dc = _mm256_sub_ps(c1, hypot_avx2(a2, b2));
+                    __m256 dh2 = _mm256_sub_ps(_mm256_add_ps(square_avx2(da), square_avx2(db)), square_avx2(dc));
+                    dh2 = _mm256_max_ps(_mm256_setzero_ps(), dh2);
+                    __m256 sc = _mm256_add_ps(one, _mm256_mul_ps(_mm256_set1_ps(0.045f), c1));
+                    __m256 sh = _mm256_add_ps(one, _mm256_mul_ps(_mm256_set1_ps(0.015f), c1));
+                    __m256 e = _mm256_add_ps(square_avx2(dl), square_avx2(_mm256_div_ps(dc, sc)));
+                    e = _mm256_add_ps(e, _mm256_div_ps(dh2, square_avx2(sh)));
+                    _mm256_storeu_ps(out + i, _mm256_sqrt_ps(e));
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            __m256 pow7_ratio_avx2(__m256 c) noexcept {
+                __m256 c2 = square_avx2(c);
+                __m256 c7 = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(c2, c2), c2), c);
+                return _mm256_sqrt_ps(_mm256_div_ps(c7, _mm256_add_ps(c7, _mm256_set1_ps(6'103'515'625.0f))));
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            __m256 cos_turns_avx2(__m256 t) noexcept {
+                __m256 s, c;
+                fast_sincos_turns_avx2(t, s, c);
+                return c;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t delta_e_2000_avx2(const float* lab1, const float* lab2, float* out, size_t n) noexcept {
+                const __m256 zero = _mm256_setzero_ps();
+                const __m256 one = _mm256_set1_ps(1.0f);
+                const __m256 two = _mm256_set1_ps(2.0f);
+                const __m256 half = _mm256_set1_ps(0.5f);
+                const __m256 sign = _mm256_set1_ps(-0.0f);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    __m256 l1, a1, b1, l2, a2, b2;
+                    load_colours_avx2(lab1 + 3 * i, l1, a1, b1);
+                    load_colours_avx2(lab2 + 3 * i, l2, a2, b2);
+                    __m256 cm = _mm256_mul_ps(_mm256_add_ps(hypot_avx2(a1, b1), hypot_avx2(a2, b2)), half);
+                    __m256 g1 = _mm256_add_ps(one, _mm256_mul_ps(half, _mm256_sub_ps(one, pow7_ratio_avx2(cm))));
+                    a1 = _mm256_mul_ps(g1, a1);
+                    a2 = _mm256_mul_ps(g1, a2);
+                    __m256 cp1 = hypot_avx2(a1, b1);
+                    __m256 cp2 = hypot_avx2(a2, b2);
+                    __m256 h1 = fast_atan2_turns_avx2(b1, a1);
+                    __m256 h2 = fast_atan2_turns_avx2(b2, a2);
+                    __m256 cc = _mm256_mul_ps(cp1, cp2);
+                    __m256 achromatic = _mm256_cmp_ps(cc, zero, _CMP_EQ_OQ);
+                    __m256 dh = _mm256_sub_ps(h2, h1);
+                    dh = _mm256_blendv_ps(dh, _mm256_sub_ps(dh, one), _mm256_cmp_ps(dh, half, _CMP_GT_OQ));
+                    dh = _mm256_blendv_ps(dh, _mm256_add_ps(dh, one), _mm256_cmp_ps(dh, _mm256_set1_ps(-0.5f), _CMP_LT_OQ));
+                    dh = _mm256_blendv_ps(dh, zero, achromatic);
+                    __m256 s, c;
+                    fast_sincos_turns_avx2(_mm256_mul_ps(dh, half), s, c);
+                    __m256 dhh = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sqrt_ps(cc)), s);
+                    __m256 hs = _mm256_add_ps(h1, h2);
+                    __m256 wrapped = _mm256_blendv_ps(_mm256_sub_ps(hs, one), _mm256_add_ps(hs, one),
+                        _mm256_cmp_ps(hs, one, _CMP_LT_OQ));
+                    __m256 wide = _mm256_cmp_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(h1, h2)), half, _CMP_GT_OQ);
+                    __m256 hm = _mm256_blendv_ps(_mm256_mul_ps(_mm256_blendv_ps(hs, wrapped, wide), half), hs, achromatic);
+                    __m256 t = _mm256_sub_ps(one, _mm256_mul_ps(_mm256_set1_ps(0.17f),
+                        cos_turns_avx2(_mm256_sub_ps(hm, _mm256_set1_ps(0.083'333'333f)))));
+                    t = _mm256_add_ps(t, _mm256_mul_ps(_mm256_set1_ps(0.24f), cos_turns_avx2(_mm256_mul_ps(two, hm))));
+                    t = _mm256_add_ps(t, _mm256_mul_ps(_mm256_set1_ps(0.32f),
+                        cos_turns_avx2(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(3.0f), hm), _mm256_set1_ps(0.016'666'667f)))));
+                    t = _mm256_sub_ps(t, _mm256_mul_ps(_mm256_set1_ps(0.20f),
+                        cos_turns_avx2(_mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(4.0f), hm), _mm256_set1_ps(0.175f)))));
+                    __m256 x = _mm256_div_ps(_mm256_sub_ps(_mm256_mul_ps(hm, _mm256_set1_ps(360.0f)), _mm256_set1_ps(275.0f)),
+                        _mm256_set1_ps(25.0f));
+                    __m256 z = _mm256_mul_ps(_mm256_xor_ps(square_avx2(x), sign), _mm256_set1_ps(1.442'695'04f));
+                    __m256 dtheta = _mm256_mul_ps(_mm256_set1_ps(0.083'333'333f), fast_exp2_avx2(z));
+                    __m256 cpm = _mm256_mul_ps(_mm256_add_ps(cp1, cp2), half);
+                    __m256 rc = _mm256_mul_ps(two, pow7_ratio_avx2(cpm));
+                    __m256 l2m = square_avx2(_mm256_sub_ps(_mm256_mul_ps(_mm256_add_ps(l1, l2), half), _mm256_set1_ps(50.0f)));
+                    __m256 sl = _mm256_add_ps(one, _mm256_div_ps(_mm256_mul_ps(_mm256_set1_ps(0.015f), l2m),
+                        _mm256_sqrt_ps(_mm256_add_ps(_mm256_set1_ps(20.0f), l2m))));
+                    __m256 sc = _mm256_add_ps(one, _mm256_mul_ps(_mm256_set1_ps(0.045f), cpm));
+                    __m256 sh = _mm256_add_ps(one, _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.015f), cpm), t));
+                    fast_sincos_turns_avx2(_mm256_mul_ps(two, dtheta), s, c);
+                    __m256 rt = _mm256_mul_ps(_mm256_xor_ps(s, sign), rc);
+                    __m256 xl = _mm256_div_ps(_mm256_sub_ps(l2, l1), sl);
+                    __m256 xc = _mm256_div_ps(_mm256_sub_ps(cp2, cp1), sc);
+                    __m256 xh = _mm256_div_ps(dhh, sh);
+                    __m256 e = _mm256_add_ps(_mm256_add_ps(square_avx2(xl), square_avx2(xc)), square_avx2(xh));
+                    e = _mm256_add_ps(e, _mm256_mul_ps(_mm256_mul_ps(rt, xc), xh));
+                    _mm256_storeu_ps(out + i, _mm256_sqrt_ps(_mm256_max_ps(zero, e)));
+                }
+                return i;
+            }
+
+            // Alpha blending kernels, two pixels per 256 bit register for
+            // floating point channels. The single precision kernel mirrors
+            // the scalar alpha_blend() in colour.hpp, including the restored
+            // alpha after multiply_alpha() and unmultiply_alpha(); the
+            // integer kernels mirror alpha_blend_unorm(). AI is the index of
+            // the alpha channel (0 or 3).
+
+            template <int AI>
+            RS_GRAPHICS_TARGET("avx2")
+            size_t alpha_blend_float_avx2(const float* a, const float* b, float* out, size_t n, Pma flags) noexcept {
+                constexpr int shuffle = _MM_SHUFFLE(AI, AI, AI, AI);
+                const __m256 one = _mm256_set1_ps(1);
+                const __m256 mask = _mm256_castsi256_ps(AI == 0 ?
+                    _mm256_setr_epi32(-1, 0, 0, 0, -1, 0, 0, 0) : _mm256_setr_epi32(0, 0, 0, -1, 0, 0, 0, -1));
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2) {
+                    __m256 x = _mm256_loadu_ps(a + 4 * i);
+                    __m256 y = _mm256_loadu_ps(b + 4 * i);
+                    if (! (flags & Pma::first))
+                        x = _mm256_blendv_ps(_mm256_mul_ps(_mm256_permute_ps(x, shuffle), x), x, mask);
+                    if (! (flags & Pma::second))
+                        y = _mm256_blendv_ps(_mm256_mul_ps(_mm256_permute_ps(y, shuffle), y), y, mask);
+                    __m256 z = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_sub_ps(one, _mm256_permute_ps(x, shuffle))));
+                    if (! (flags & Pma::result)) {
+                        __m256 k = _mm256_div_ps(one, _mm256_permute_ps(z, shuffle));
+                        z = _mm256_blendv_ps(_mm256_mul_ps(k, z), z, mask);
+                    }
+                    _mm256_storeu_ps(out + 4 * i, z);
+                }
+                return i;
+            }
+
+            // Integer arithmetic on 32 bit lanes, one pixel per 128 bit lane
+
+            template <int Bits>
+            RS_GRAPHICS_TARGET("avx2")
+            __m256i div_unorm_avx2(__m256i x) noexcept {
+                x = _mm256_add_epi32(x, _mm256_set1_epi32(1 << (Bits - 1)));
+                return _mm256_srli_epi32(_mm256_add_epi32(x, _mm256_srli_epi32(x, Bits)), Bits);
+            }
+
+            template <int AI, int Bits>
+            RS_GRAPHICS_TARGET("avx2")
+            __m256i alpha_blend_unorm_avx2(__m256i x, __m256i y, Pma flags) noexcept {
+                constexpr int shuffle = _MM_SHUFFLE(AI, AI, AI, AI);
+                const __m256i max = _mm256_set1_epi32((1 << Bits) - 1);
+                const __m256i mask = AI == 0 ?
+                    _mm256_setr_epi32(-1, 0, 0, 0, -1, 0, 0, 0) : _mm256_setr_epi32(0, 0, 0, -1, 0, 0, 0, -1);
+                __m256i ax = _mm256_shuffle_epi32(x, shuffle);
+                __m256i ay = _mm256_shuffle_epi32(y, shuffle);
+                if (! (flags & Pma::first))
+                    x = _mm256_blendv_epi8(div_unorm_avx2<Bits>(_mm256_mullo_epi32(x, ax)), x, mask);
+                if (! (flags & Pma::second))
+                    y = _mm256_blendv_epi8(div_unorm_avx2<Bits>(_mm256_mullo_epi32(y, ay)), y, mask);
+                __m256i z = _mm256_add_epi32(x, div_unorm_avx2<Bits>(_mm256_mullo_epi32(y, _mm256_sub_epi32(max, ax))));
+                z = _mm256_min_epu32(z, max);
+                if (! (flags & Pma::result)) {
+                    __m256i az = _mm256_shuffle_epi32(z, shuffle);
+                    __m256 k = _mm256_div_ps(_mm256_cvtepi32_ps(max), _mm256_cvtepi32_ps(az));
+                    __m256 t = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(z), k), _mm256_set1_ps(0.5f));
+                    __m256i u = _mm256_cvttps_epi32(_mm256_min_ps(t, _mm256_cvtepi32_ps(max)));
+                    u = _mm256_andnot_si256(_mm256_cmpeq_epi32(az, _mm256_setzero_si256()), u);
+                    z = _mm256_blendv_epi8(u, z, mask);
+                }
+                return z;
+            }
+
+            template <int AI>
+            RS_GRAPHICS_TARGET("avx2")
+            size_t alpha_blend_unorm8_avx2(const uint8_t* a, const uint8_t* b, uint8_t* out, size_t n, Pma flags) noexcept {
+                const __m256i zero = _mm256_setzero_si256();
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + 4 * i));
+                    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + 4 * i));
+                    __m256i x16[2] = {_mm256_unpacklo_epi8(x, zero), _mm256_unpackhi_epi8(x, zero)};
+                    __m256i y16[2] = {_mm256_unpacklo_epi8(y, zero), _mm256_unpackhi_epi8(y, zero)};
+                    __m256i z16[2];
+                    for (int j = 0; j < 2; ++j) {
+                        __m256i lo = alpha_blend_unorm_avx2<AI, 8>(_mm256_unpacklo_epi16(x16[j], zero),
+                            _mm256_unpacklo_epi16(y16[j], zero), flags);
+                        __m256i hi = alpha_blend_unorm_avx2<AI, 8>(_mm256_unpackhi_epi16(x16[j], zero),
+                            _mm256_unpackhi_epi16(y16[j], zero), flags);
+                        z16[j] = _mm256_packus_epi32(lo, hi);
+                    }
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4 * i), _mm256_packus_epi16(z16[0], z16[1]));
+                }
+                return i;
+            }
+
+            template <int AI>
+            RS_GRAPHICS_TARGET("avx2")
+            size_t alpha_blend_unorm16_avx2(const uint16_t* a, const uint16_t* b, uint16_t* out, size_t n, Pma flags) noexcept {
+                const __m256i zero = _mm256_setzero_si256();
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + 4 * i));
+                    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + 4 * i));
+                    __m256i lo = alpha_blend_unorm_avx2<AI, 16>(_mm256_unpacklo_epi16(x, zero),
+                        _mm256_unpacklo_epi16(y, zero), flags);
+                    __m256i hi = alpha_blend_unorm_avx2<AI, 16>(_mm256_unpackhi_epi16(x, zero),
+                        _mm256_unpackhi_epi16(y, zero), flags);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4 * i), _mm256_packus_epi32(lo, hi));
+                }
+                return i;
+            }
+
+        #endif
+
+    }
+
+    size_t unorm8_to_float_simd(const uint8_t* in, float* out, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return unorm8_to_float_avx2(in, out, n);
+                case SimdLevel::sse2:    return unorm8_to_float_sse2(in, out, n);
+                default:                 break;
+            }
+        #else
+            (void)in;
+            (void)out;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t float_to_unorm8_simd(const float* in, uint8_t* out, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return float_to_unorm8_avx2(in, out, n);
+                case SimdLevel::sse2:    return float_to_unorm8_sse2(in, out, n);
+                default:                 break;
+            }
+        #else
+            (void)in;
+            (void)out;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t linear_to_srgb8_simd(const float* in, uint8_t* out, size_t n, int alpha_index) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            if (simd_level() >= SimdLevel::avx2)
+                return linear_to_srgb8_avx2(in, out, n, alpha_index);
+        #else
+            (void)in;
+            (void)out;
+            (void)n;
+            (void)alpha_index;
+        #endif
+        return 0;
+    }
+
+    size_t srgb_decode_fast_simd(const float* in, float* out, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return simd_padded<8>(in, 1, out, 1, n,
+                                             [] (const float* p, float* q, size_t m) { return srgb_decode_fast_avx2(p, q, m); });
+                case SimdLevel::sse2:    return simd_padded<4>(in, 1, out, 1, n,
+                                             [] (const float* p, float* q, size_t m) { return srgb_decode_fast_sse2(p, q, m); });
+                default:                 break;
+            }
+        #else
+            (void)in;
+            (void)out;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t srgb_encode_fast_simd(const float* in, float* out, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return simd_padded<8>(in, 1, out, 1, n,
+                                             [] (const float* p, float* q, size_t m) { return srgb_encode_fast_avx2(p, q, m); });
+                case SimdLevel::sse2:    return simd_padded<4>(in, 1, out, 1, n,
+                                             [] (const float* p, float* q, size_t m) { return srgb_encode_fast_sse2(p, q, m); });
+                default:                 break;
+            }
+        #else
+            (void)in;
+            (void)out;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t power_fast_simd(const float* in, float* out, size_t n, float y) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return simd_padded<8>(in, 1, out, 1, n,
+                                             [&] (const float* p, float* q, size_t m) { return power_fast_avx2(p, q, m, y); });
+                case SimdLevel::sse2:    return simd_padded<4>(in, 1, out, 1, n,
+                                             [&] (const float* p, float* q, size_t m) { return power_fast_sse2(p, q, m, y); });
+                default:                 break;
+            }
+        #else
+            (void)in;
+            (void)out;
+            (void)n;
+            (void)y;
+        #endif
+        return 0;
+    }
+
+    size_t lab_from_base_fast_simd(const float* in, float* out, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return simd_padded<8>(in, 3, out, 3, n,
+                                             [] (const float* p, float* q, size_t m) { return lab_from_base_fast_avx2(p, q, m); });
+                default:                 break;
+            }
+        #else
+            (void)in;
+            (void)out;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t lab_to_base_fast_simd(const float* in, float* out, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return simd_padded<8>(in, 3, out, 3, n,
+                                             [] (const float* p, float* q, size_t m) { return lab_to_base_fast_avx2(p, q, m); });
+                default:                 break;
+            }
+        #else
+            (void)in;
+            (void)out;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t luv_from_base_fast_simd(const float* in, float* out, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return simd_padded<8>(in, 3, out, 3, n,
+                                             [] (const float* p, float* q, size_t m) { return luv_from_base_fast_avx2(p, q, m); });
+                default:                 break;
+            }
+        #else
+            (void)in;
+            (void)out;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t luv_to_base_fast_simd(const float* in, float* out, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return simd_padded<8>(in, 3, out, 3, n,
+                                             [] (const float* p, float* q, size_t m) { return luv_to_base_fast_avx2(p, q, m); });
+                default:                 break;
+            }
+        #else
+            (void)in;
+            (void)out;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t hcl_from_base_fast_simd(const float* in, float* out, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return simd_padded<8>(in, 3, out, 3, n,
+                                             [] (const float* p, float* q, size_t m) { return hcl_from_base_fast_avx2(p, q, m); });
+                default:                 break;
+            }
+        #else
+            (void)in;
+            (void)out;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t hcl_to_base_fast_simd(const float* in, float* out, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return simd_padded<8>(in, 3, out, 3, n,
+                                             [] (const float* p, float* q, size_t m) { return hcl_to_base_fast_avx2(p, q, m); });
+                default:                 break;
+            }
+        #else
+            (void)in;
+            (void)out;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t delta_e_simd(const float* lab1, const float* lab2, float* out, size_t n, DeltaE metric) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            if (simd_level() >= SimdLevel::avx2) {
+                switch (metric) {
+                    case DeltaE::cie76:  return simd_padded<8>(lab1, lab2, 3, out, 1, n,
+                                             [] (const float* p, const float* q, float* r, size_t m) { return delta_e_76_avx2(p, q, r, m); });
+                    case DeltaE::cie94:  return simd_padded<8>(lab1, lab2, 3, out, 1, n,
+                                             [] (const float* p, const float* q, float* r, size_t m) { return delta_e_94_avx2(p, q, r, m); });
+                    default:             return simd_padded<8>(lab1, lab2, 3, out, 1, n,
+                                             [] (const float* p, const float* q, float* r, size_t m) { return delta_e_2000_avx2(p, q, r, m); });
+                }
+            }
+        #else
+            (void)lab1;
+            (void)lab2;
+            (void)out;
+            (void)n;
+            (void)metric;
+        #endif
+        return 0;
+    }
+
+    size_t alpha_blend_float_simd(const float* a, const float* b, float* out, size_t n,
+            int alpha_index, Pma flags) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            if (simd_level() >= SimdLevel::avx2)
+                return simd_padded<2>(a, b, 4, out, 4, n, [=] (const float* p, const float* q, float* r, size_t m) {
+                    return alpha_index == 0 ? alpha_blend_float_avx2<0>(p, q, r, m, flags)
+                        : alpha_blend_float_avx2<3>(p, q, r, m, flags);
+                });
+        #else
+            (void)a;
+            (void)b;
+            (void)out;
+            (void)n;
+            (void)alpha_index;
+            (void)flags;
+        #endif
+        return 0;
+    }
+
+    size_t alpha_blend_unorm8_simd(const uint8_t* a, const uint8_t* b, uint8_t* out, size_t n,
+            int alpha_index, Pma flags) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            if (simd_level() >= SimdLevel::avx2)
+                return simd_padded<8>(a, b, 4, out, 4, n, [=] (const uint8_t* p, const uint8_t* q, uint8_t* r, size_t m) {
+                    return alpha_index == 0 ? alpha_blend_unorm8_avx2<0>(p, q, r, m, flags)
+                        : alpha_blend_unorm8_avx2<3>(p, q, r, m, flags);
+                });
+        #else
+            (void)a;
+            (void)b;
+            (void)out;
+            (void)n;
+            (void)alpha_index;
+            (void)flags;
+        #endif
+        return 0;
+    }
+
+    size_t alpha_blend_unorm16_simd(const uint16_t* a, const uint16_t* b, uint16_t* out, size_t n,
+            int alpha_index, Pma flags) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            if (simd_level() >= SimdLevel::avx2)
+                return simd_padded<4>(a, b, 4, out, 4, n, [=] (const uint16_t* p, const uint16_t* q, uint16_t* r, size_t m) {
+                    return alpha_index == 0 ? alpha_blend_unorm16_avx2<0>(p, q, r, m, flags)
+                        : alpha_blend_unorm16_avx2<3>(p, q, r, m, flags);
+                });
+        #else
+            (void)a;
+            (void)b;
+            (void)out;
+            (void)n;
+            (void)alpha_index;
+            (void)flags;
+        #endif
+        return 0;
+    }
+
+    bool parse_hex_bytes(std::string_view str, Byte4& bytes) noexcept {
+
+        static constexpr auto hex_value = [] (char c) noexcept {
+            return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+        };
+
+        size_t i, j, k;
+        for (i = 0; i < str.size() && (ascii_ispunct(str[i]) || ascii_isspace(str[i])); ++i) {}
+        for (j = i; j < str.size() && ascii_isxdigit(str[j]); ++j) {}
+        for (k = j; k < str.size() && (ascii_ispunct(str[k]) || ascii_isspace(str[k])); ++k) {}
+        size_t digits = j - i;
 
-        static const auto simplify = [] (const std::string& s) {
-            std::string t;
-            for (char c: s)
-                if (! ascii_isspace(c) && ! ascii_ispunct(c))
-                    t += ascii_tolower(c);
-            return t;
+        if (k != str.size() || (digits != 6 && digits != 8))
+            return false;
+
+        for (size_t n = 0; n < digits / 2; ++n)
+            bytes[int(n)] = uint8_t(16 * hex_value(str[i + 2 * n]) + hex_value(str[i + 2 * n + 1]));
+
+        return true;
+
+    }
+
+    namespace {
+
+        struct CssColour {
+            std::string_view name;
+            sRgba8 colour;
         };
 
-        static const std::unordered_map<std::string, sRgba8> map = {
+        constexpr CssColour css_colours[] = {
 
             { "aliceblue",             { 0xf0, 0xf8, 0xff, 0xff }},
             { "antiquewhite",          { 0xfa, 0xeb, 0xd7, 0xff }},
@@ -169,11 +1261,123 @@ namespace RS::Graphics::Core::Detail {
 
         };
 
-        auto it = map.find(simplify(str));
-        if (it == map.end())
+        // CSS names are looked up through a perfect hash table, built at
+        // compile time by hash and displace: the names are sorted into
+        // buckets by one hash, then each bucket is given a seed for a
+        // second hash that sends all of its names to empty slots.
+
+        constexpr size_t css_max_name = 20;  // lightgoldenrodyellow
+        constexpr size_t css_colour_count = std::size(css_colours);
+        constexpr uint32_t css_buckets = 64;
+        constexpr uint32_t css_slots = 256;
+
+        constexpr uint32_t css_hash(std::string_view str, uint32_t seed) noexcept {
+            uint32_t h = 2'166'136'261u ^ (seed * 0x9e37'79b9u);
+            for (char c: str)
+                h = (h ^ uint8_t(c)) * 16'777'619u;
+            h ^= h >> 15;
+            h *= 0x2c1b'3c6du;
+            h ^= h >> 12;
+            return h;
+        }
+
+        struct CssTable {
+            std::array<uint32_t, css_buckets> seeds = {};
+            std::array<int16_t, css_slots> slots = {};
+        };
+
+        constexpr CssTable make_css_table() noexcept {
+
+            CssTable table;
+            std::array<uint32_t, css_colour_count> bucket_of = {};
+            std::array<uint32_t, css_buckets> bucket_size = {};
+            std::array<bool, css_buckets> done = {};
+
+            for (auto& slot: table.slots)
+                slot = -1;
+
+            for (size_t i = 0; i < css_colour_count; ++i) {
+                bucket_of[i] = css_hash(css_colours[i].name, 0) % css_buckets;
+                ++bucket_size[bucket_of[i]];
+            }
+
+            // Place the largest buckets first, while there is most room
+
+            for (uint32_t step = 0; step < css_buckets; ++step) {
+
+                uint32_t b = 0;
+                for (uint32_t x = 0; x < css_buckets; ++x)
+                    if (! done[x] && (done[b] || bucket_size[x] > bucket_size[b]))
+                        b = x;
+                done[b] = true;
+                if (bucket_size[b] == 0)
+                    continue;
+
+                for (uint32_t seed = 1;; ++seed) {
+                    std::array<uint32_t, css_colour_count> trial = {};
+                    size_t n = 0;
+                    bool ok = true;
+                    for (size_t i = 0; i < css_colour_count && ok; ++i) {
+                        if (bucket_of[i] != b)
+                            continue;
+                        uint32_t slot = css_hash(css_colours[i].name, seed) % css_slots;
+                        ok = table.slots[slot] == -1;
+                        for (size_t t = 0; t < n && ok; ++t)
+                            ok = trial[t] != slot;
+                        trial[n++] = slot;
+                    }
+                    if (ok) {
+                        table.seeds[b] = seed;
+                        for (size_t i = 0, t = 0; i < css_colour_count; ++i)
+                            if (bucket_of[i] == b)
+                                table.slots[trial[t++]] = int16_t(i);
+                        break;
+                    }
+                }
+
+            }
+
+            return table;
+
+        }
+
+        constexpr CssTable css_table = make_css_table();
+
+        constexpr int find_css_colour(std::string_view name) noexcept {
+            uint32_t seed = css_table.seeds[css_hash(name, 0) % css_buckets];
+            int index = css_table.slots[css_hash(name, seed) % css_slots];
+            return index >= 0 && css_colours[index].name == name ? index : -1;
+        }
+
+        constexpr bool check_css_table() noexcept {
+            for (size_t i = 0; i < css_colour_count; ++i)
+                if (find_css_colour(css_colours[i].name) != int(i) || css_colours[i].name.size() > css_max_name)
+                    return false;
+            return true;
+        }
+
+        static_assert(check_css_table());
+
+    }
+
+    std::optional<sRgba8> get_css_colour(std::string_view str) noexcept {
+
+        char buf[css_max_name];
+        size_t len = 0;
+
+        for (char c: str) {
+            if (ascii_isspace(c) || ascii_ispunct(c))
+                continue;
+            if (len == css_max_name)
+                return {};
+            buf[len++] = ascii_tolower(c);
+        }
+
+        int index = find_css_colour(std::string_view(buf, len));
+        if (index == -1)
             return {};
         else
-            return it->second;
+            return css_colours[index].colour;
 
     }
 
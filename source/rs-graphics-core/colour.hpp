@@ -2,18 +2,28 @@
 
 #include "rs-graphics-core/colour-space.hpp"
 #include "rs-graphics-core/maths.hpp"
+#include "rs-graphics-core/multi-array.hpp"
+#include "rs-graphics-core/simd.hpp"
 #include "rs-graphics-core/vector.hpp"
 #include "rs-format/format.hpp"
 #include "rs-format/string.hpp"
 #include "rs-tl/enum.hpp"
 #include "rs-tl/types.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <limits>
 #include <optional>
 #include <ostream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
 namespace RS::Graphics::Core {
 
@@ -26,6 +36,17 @@ namespace RS::Graphics::Core {
         alpha_reverse
     )
 
+    RS_DEFINE_ENUM_CLASS(ColourPrecision, int, 0,
+        exact,
+        fast
+    )
+
+    RS_DEFINE_ENUM_CLASS(ColourParseError, int, 0,
+        none,
+        invalid_hex,
+        unknown_name
+    )
+
     enum class Pma: int {
         none    = 0,
         first   = 1,
@@ -57,6 +78,10 @@ namespace RS::Graphics::Core {
 
     namespace Detail {
 
+        bool parse_hex_bytes(std::string_view str, Byte4& bytes) noexcept;
+        template <typename C> constexpr void colour_from_bytes(Byte4 bytes, C& colour) noexcept;
+        template <typename C> constexpr Byte4 colour_to_bytes(const C& colour) noexcept;
+
         template <typename CS, char CH, int Offset = 0>
         struct ColourSpaceChannelIndex {
             static constexpr int cs_channels = int(CS::channels.size());
@@ -165,6 +190,145 @@ namespace RS::Graphics::Core {
                 return T2(t);
         }
 
+        // Nonlinear spaces whose conversion to their base space applies the
+        // same transfer function independently to each channel
+
+        template <typename CS> constexpr bool cs_is_transfer = false;
+        template <> constexpr bool cs_is_transfer<sRGB> = true;
+        template <> constexpr bool cs_is_transfer<sGreyscale> = true;
+        template <> constexpr bool cs_is_transfer<ProPhoto> = true;
+        template <typename WS, int64_t GN, int64_t GD> constexpr bool cs_is_transfer<NonlinearSpace<WS, GN, GD>> = true;
+
+        template <typename CS, typename T>
+        T transfer_decode(T x) noexcept {
+            using vector_type = Vector<T, int(CS::channels.size())>;
+            return CS::to_base(vector_type(x))[0];
+        }
+
+        template <typename CS, typename T>
+        T transfer_encode(T x) noexcept {
+            using vector_type = Vector<T, int(CS::channels.size())>;
+            return CS::from_base(vector_type(x))[0];
+        }
+
+        // Lookup tables for the transfer functions, built on first use by
+        // calling the same functions as the direct conversion, so results
+        // are identical.
+
+        // The decoding table maps every value of an 8 or 16 bit channel to
+        // the corresponding linear value.
+
+        template <typename CS, typename VT, typename WT>
+        constexpr bool use_decode_table = cs_is_transfer<CS>
+            && (std::is_same_v<VT, uint8_t> || std::is_same_v<VT, uint16_t>)
+            && (std::is_same_v<WT, float> || std::is_same_v<WT, double>);
+
+        template <typename CS, typename VT, typename WT>
+        const WT* transfer_decode_table() {
+            static constexpr VT max = std::numeric_limits<VT>::max();
+            static const std::vector<WT> table = [] {
+                std::vector<WT> t(size_t(max) + 1);
+                for (size_t i = 0; i < t.size(); ++i)
+                    t[i] = transfer_decode<CS>(channel_to_working_type<WT>(VT(i), max));
+                return t;
+            }();
+            return table.data();
+        }
+
+        // The encoding table handles linear values in [0,1] going to an 8 bit
+        // channel. The encoded and rounded value is a nondecreasing function
+        // of the linear value, so it can be found by comparison with the
+        // smallest input giving each output code, which is located exactly
+        // by bisection over the representable values. A coarse table of
+        // uniform buckets gives the first candidate; the bucket width is a
+        // power of 2 so the bucket index is computed exactly.
+
+        template <typename CS, typename VT, typename WT>
+        constexpr bool use_encode_table = cs_is_transfer<CS> && std::is_same_v<VT, uint8_t>
+            && (std::is_same_v<WT, float> || std::is_same_v<WT, double>);
+
+        template <typename CS, typename WT>
+        class TransferEncodeTable {
+
+        public:
+
+            static constexpr int buckets = 4096;
+
+            TransferEncodeTable();
+
+            uint8_t operator()(WT x) const noexcept {
+                int code = start_[size_t(x * WT(buckets))];
+                while (code < 255 && x >= thresholds_[code + 1])
+                    ++code;
+                return uint8_t(code);
+            }
+
+            static const TransferEncodeTable& get() {
+                static const TransferEncodeTable table;
+                return table;
+            }
+
+            static uint8_t direct(WT x) noexcept {
+                return working_type_to_channel(transfer_encode<CS>(x), uint8_t(255));
+            }
+
+            const WT* thresholds() const noexcept { return thresholds_.data(); }
+            const uint8_t* starts() const noexcept { return start_.data(); }
+
+        private:
+
+            using bits_type = std::conditional_t<sizeof(WT) == 4, uint32_t, uint64_t>;
+
+            std::array<WT, 256> thresholds_;
+            std::array<uint8_t, buckets + 4> start_; // Padded for 32-bit vector gathers
+
+            static bits_type to_bits(WT x) noexcept { bits_type b; std::memcpy(&b, &x, sizeof(b)); return b; }
+            static WT from_bits(bits_type b) noexcept { WT x; std::memcpy(&x, &b, sizeof(x)); return x; }
+
+        };
+
+            template <typename CS, typename WT>
+            TransferEncodeTable<CS, WT>::TransferEncodeTable() {
+
+                // Positive floating point values sort in the same order as
+                // their bit patterns
+
+                thresholds_[0] = 0;
+
+                for (int code = 1; code < 256; ++code) {
+                    bits_type lo = to_bits(thresholds_[code - 1]);
+                    bits_type hi = to_bits(1);
+                    while (lo < hi) {
+                        bits_type mid = lo + (hi - lo) / 2;
+                        if (direct(from_bits(mid)) >= code)
+                            hi = mid;
+                        else
+                            lo = mid + 1;
+                    }
+                    thresholds_[code] = from_bits(lo);
+                }
+
+                for (int i = 0; i <= buckets; ++i)
+                    start_[i] = direct(WT(i) / WT(buckets));
+                for (int i = buckets + 1; i < int(start_.size()); ++i)
+                    start_[i] = 255;
+
+            }
+
+        // Mirrors convert_colour_space<CS1,CS2>() where CS2 is a transfer
+        // space, stopping short of the final encoding step. Only valid if
+        // route_ends_with_from_base<CS1,CS2>() is true.
+
+        template <typename CS1, typename CS2, typename T>
+        Vector<T, CS2::channels.size()> convert_colour_space_to_encoding(Vector<T, int(CS1::channels.size())> colour) {
+            using BCS1 = typename CS1::base;
+            using BCS2 = typename CS2::base;
+            if constexpr (route_step<CS1, CS2>() == RouteStep::up)
+                return convert_colour_space_to_encoding<BCS1, CS2>(CS1::to_base(colour));
+            else
+                return convert_colour_space<CS1, BCS2>(colour);
+        }
+
     }
 
     // Don't use single letter template parameters here
@@ -257,7 +421,7 @@ namespace RS::Graphics::Core {
 
         VT& operator[](int i) noexcept { return vec_[i]; }
         const VT& operator[](int i) const noexcept { return vec_[i]; }
-        template <typename V2 = VT> constexpr VT& alpha(std::enable_if<TL::SfinaeTrue<V2, has_alpha>::value>* = nullptr) noexcept;
+        template <typename V2 = VT> constexpr VT& alpha(std::enable_if_t<TL::SfinaeTrue<V2, has_alpha>::value>* = nullptr) noexcept;
         constexpr const VT& alpha() const noexcept;
         constexpr VT& cs(int i) noexcept { return vec_[space_to_layout_index(i)]; }
         constexpr const VT& cs(int i) const noexcept { return vec_[space_to_layout_index(i)]; }
@@ -273,6 +437,7 @@ namespace RS::Graphics::Core {
         constexpr bool empty() const noexcept { return false; }
         size_t hash() const noexcept { return vec_.hash(); }
         std::string hex() const;
+        char* hex(char* out) const noexcept;
         template <typename V2 = VT> constexpr Colour
             multiply_alpha(std::enable_if<TL::SfinaeTrue<V2, can_premultiply>::value>* = nullptr) const noexcept;
         template <typename V2 = VT> constexpr Colour
@@ -316,61 +481,16 @@ namespace RS::Graphics::Core {
 
         template <typename VT, typename CS, ColourLayout CL>
         Colour<VT, CS, CL>::Colour(const std::string& str) {
-
             static_assert(cs_is_rgb<CS>);
-
-            using namespace Format;
-
             Byte4 bytes = {0,0,0,255};
-
-            size_t i, j, k;
-            for (i = 0; i < str.size() && (ascii_ispunct(str[i]) || ascii_isspace(str[i])); ++i) {}
-            for (j = i; j < str.size() && ascii_isxdigit(str[j]); ++j) {}
-            for (k = j; k < str.size() && (ascii_ispunct(str[k]) || ascii_isspace(str[k])); ++k) {}
-            size_t digits = j - i;
-
-            if (k != str.size() || (digits != 6 && digits != 8))
-                throw std::invalid_argument("Invalid colour: " + quote(str));
-
-            bytes[0] = to_uint8(str.substr(i, 2), 16);
-            bytes[1] = to_uint8(str.substr(i + 2, 2), 16);
-            bytes[2] = to_uint8(str.substr(i + 4, 2), 16);
-
-            if (digits == 8)
-                bytes[3] = to_uint8(str.substr(i + 6, 2), 16);
-
-            Vector<VT, 4> vts;
-
-            if constexpr (std::is_same_v<VT, uint8_t>) {
-
-                vts = bytes;
-
-            } else if constexpr (std::is_integral_v<VT> && std::is_signed_v<VT>) {
-
-                static constexpr double s = double(scale) / 255;
-                for (int x = 0; x < channels; ++x)
-                    vts[x] = const_round<VT>(s * double(bytes[x]));
-
-            } else {
-
-                static constexpr VT s = scale / 255;
-                for (int x = 0; x < channels; ++x)
-                    vts[x] = s * VT(bytes[x]);
-
-            }
-
-            R() = vts[0];
-            G() = vts[1];
-            B() = vts[2];
-
-            if constexpr (has_alpha)
-                alpha() = vts[3];
-
+            if (! Detail::parse_hex_bytes(str, bytes))
+                throw std::invalid_argument("Invalid colour: " + Format::quote(str));
+            Detail::colour_from_bytes(bytes, *this);
         }
 
         template <typename VT, typename CS, ColourLayout CL>
         template <typename V2>
-        constexpr VT& Colour<VT, CS, CL>::alpha(std::enable_if<TL::SfinaeTrue<V2, has_alpha>::value>*) noexcept {
+        constexpr VT& Colour<VT, CS, CL>::alpha(std::enable_if_t<TL::SfinaeTrue<V2, has_alpha>::value>*) noexcept {
             return vec_[alpha_index];
         }
 
@@ -424,19 +544,23 @@ namespace RS::Graphics::Core {
 
         template <typename VT, typename CS, ColourLayout CL>
         std::string Colour<VT, CS, CL>::hex() const {
+            char buf[8];
+            return std::string(buf, hex(buf));
+        }
+
+        // Writes 6 or 8 lowercase hex digits (no terminating null) and
+        // returns the end of the written range
+
+        template <typename VT, typename CS, ColourLayout CL>
+        char* Colour<VT, CS, CL>::hex(char* out) const noexcept {
             static_assert(cs_is_rgb<CS>);
-            using namespace RS::Format::Literals;
-            static const auto format = has_alpha ? "{0:x2}{1:x2}{2:x2}{3:x2}"_fmt : "{0:x2}{1:x2}{2:x2}"_fmt;
-            Vector<VT, 4> vts = {R(), G(), B(), alpha()};
-            Byte4 bytes;
-            if constexpr (std::is_same_v<VT, uint8_t>) {
-                bytes = vts;
-            } else {
-                static constexpr double k = 255 / double(scale);
-                for (int i = 0; i < channels; ++i)
-                    bytes[i] = const_round<uint8_t>(k * double(vts[i]));
+            static constexpr const char* digits = "0123456789abcdef";
+            auto bytes = Detail::colour_to_bytes(*this);
+            for (int i = 0; i < (has_alpha ? 4 : 3); ++i) {
+                *out++ = digits[bytes[i] >> 4];
+                *out++ = digits[bytes[i] & 15];
             }
-            return format(bytes[0], bytes[1], bytes[2], bytes[3]);
+            return out;
         }
 
         template <typename VT, typename CS, ColourLayout CL>
@@ -477,49 +601,704 @@ namespace RS::Graphics::Core {
                 return channels - cs - 1;
         }
 
+    namespace Detail {
+
+        // Conversions between channel values and the bytes of a hex code
+
+        template <typename C>
+        constexpr void colour_from_bytes(Byte4 bytes, C& colour) noexcept {
+
+            using VT = typename C::value_type;
+            Vector<VT, 4> vts;
+
+            if constexpr (std::is_same_v<VT, uint8_t>) {
+
+                vts = bytes;
+
+            } else if constexpr (std::is_integral_v<VT> && std::is_signed_v<VT>) {
+
+                constexpr double s = double(C::scale) / 255;
+                for (int x = 0; x < 4; ++x)
+                    vts[x] = const_round<VT>(s * double(bytes[x]));
+
+            } else {
+
+                constexpr VT s = C::scale / 255;
+                for (int x = 0; x < 4; ++x)
+                    vts[x] = s * VT(bytes[x]);
+
+            }
+
+            colour.R() = vts[0];
+            colour.G() = vts[1];
+            colour.B() = vts[2];
+
+            if constexpr (C::has_alpha)
+                colour.alpha() = vts[3];
+
+        }
+
+        template <typename C>
+        constexpr Byte4 colour_to_bytes(const C& colour) noexcept {
+            using VT = typename C::value_type;
+            Vector<VT, 4> vts = {colour.R(), colour.G(), colour.B(), colour.alpha()};
+            Byte4 bytes;
+            if constexpr (std::is_same_v<VT, uint8_t>) {
+                bytes = vts;
+            } else {
+                constexpr double k = 255 / double(C::scale);
+                for (int i = 0; i < C::channels; ++i)
+                    bytes[i] = const_round<uint8_t>(k * double(vts[i]));
+            }
+            return bytes;
+        }
+
+        size_t srgb_decode_fast_simd(const float* in, float* out, size_t n) noexcept;
+        size_t srgb_encode_fast_simd(const float* in, float* out, size_t n) noexcept;
+        size_t power_fast_simd(const float* in, float* out, size_t n, float y) noexcept;
+
+        // Polynomial approximations to the transfer functions, used in single
+        // precision when ColourPrecision::fast is requested. The bulk
+        // versions give the same results as the scalar ones.
+
+        template <typename CS>
+        struct FastTransfer {
+            static constexpr bool value = false;
+        };
+
+        struct FastSrgbTransfer {
+            static constexpr bool value = true;
+            static float decode(float x) noexcept { return sRGB_inverse_fast(x); }
+            static float encode(float x) noexcept { return sRGB_function_fast(x); }
+            static void decode(const float* in, float* out, size_t n) noexcept {
+                for (size_t i = srgb_decode_fast_simd(in, out, n); i < n; ++i)
+                    out[i] = decode(in[i]);
+            }
+            static void encode(const float* in, float* out, size_t n) noexcept {
+                for (size_t i = srgb_encode_fast_simd(in, out, n); i < n; ++i)
+                    out[i] = encode(in[i]);
+            }
+        };
+
+        template <> struct FastTransfer<sRGB>: FastSrgbTransfer {};
+        template <> struct FastTransfer<sGreyscale>: FastSrgbTransfer {};
+
+        template <typename WS, int64_t GN, int64_t GD>
+        struct FastTransfer<NonlinearSpace<WS, GN, GD>> {
+            static constexpr bool value = true;
+            static constexpr float gamma = float(GN) / float(GD);
+            static constexpr float inverse_gamma = float(GD) / float(GN);
+            static float decode(float x) noexcept { return fast_pow(x, gamma); }
+            static float encode(float x) noexcept { return fast_pow(x, inverse_gamma); }
+            static void decode(const float* in, float* out, size_t n) noexcept {
+                for (size_t i = power_fast_simd(in, out, n, gamma); i < n; ++i)
+                    out[i] = decode(in[i]);
+            }
+            static void encode(const float* in, float* out, size_t n) noexcept {
+                for (size_t i = power_fast_simd(in, out, n, inverse_gamma); i < n; ++i)
+                    out[i] = encode(in[i]);
+            }
+        };
+
+        size_t lab_from_base_fast_simd(const float* in, float* out, size_t n) noexcept;
+        size_t lab_to_base_fast_simd(const float* in, float* out, size_t n) noexcept;
+        size_t luv_from_base_fast_simd(const float* in, float* out, size_t n) noexcept;
+        size_t luv_to_base_fast_simd(const float* in, float* out, size_t n) noexcept;
+        size_t hcl_from_base_fast_simd(const float* in, float* out, size_t n) noexcept;
+        size_t hcl_to_base_fast_simd(const float* in, float* out, size_t n) noexcept;
+
+        // Single precision versions of the from_base() and to_base() steps
+        // of the perceptual colour spaces, used when ColourPrecision::fast
+        // is requested, built on fast_cbrt(), fast_atan2_turns() and
+        // fast_sincos_turns(). The bulk versions work on contiguous arrays
+        // of 3-channel colours (in and out may be the same), and give the
+        // same results as the scalar ones.
+
+        template <typename CS>
+        struct FastSpace {
+            static constexpr bool value = false;
+        };
+
+        template <size_t (*FromKernel)(const float*, float*, size_t) noexcept,
+            size_t (*ToKernel)(const float*, float*, size_t) noexcept, typename Space>
+        struct FastSpaceBulk {
+            static void from_base(const float* in, float* out, size_t n) noexcept {
+                for (size_t i = FromKernel(in, out, n); i < n; ++i) {
+                    auto c = Space::from_base(Vector<float, 3>(in + 3 * i));
+                    std::copy_n(c.begin(), 3, out + 3 * i);
+                }
+            }
+            static void to_base(const float* in, float* out, size_t n) noexcept {
+                for (size_t i = ToKernel(in, out, n); i < n; ++i) {
+                    auto c = Space::to_base(Vector<float, 3>(in + 3 * i));
+                    std::copy_n(c.begin(), 3, out + 3 * i);
+                }
+            }
+        };
+
+        struct FastLab {
+            static constexpr float delta = 6.0f / 29.0f;
+            static constexpr float c1 = delta * delta * delta;
+            static constexpr float c2 = 3 * delta * delta;
+            static constexpr float c3 = 4.0f / 29.0f;
+            static float f(float t) noexcept {
+                return t <= c1 ? t / c2 + c3 : fast_cbrt(t);
+            }
+            static float inverse_f(float t) noexcept {
+                return t <= delta ? c2 * (t - c3) : t * t * t;
+            }
+            static Vector<float, 3> from_base(Vector<float, 3> colour) noexcept {
+                colour /= D65<float>;
+                float fx = f(colour.x());
+                float fy = f(colour.y());
+                float fz = f(colour.z());
+                return {116 * fy - 16, 500 * (fx - fy), 200 * (fy - fz)};
+            }
+            static Vector<float, 3> to_base(Vector<float, 3> colour) noexcept {
+                float lx = (colour[0] + 16) / 116;
+                Vector<float, 3> out = {
+                    inverse_f(lx + colour[1] / 500),
+                    inverse_f(lx),
+                    inverse_f(lx - colour[2] / 200),
+                };
+                return out * D65<float>;
+            }
+        };
+
+        // D65 has Y=1, so the scaling of the Y channel is left out
+
+        struct FastLuv {
+            static constexpr float delta = 6.0f / 29.0f;
+            static constexpr float c1 = delta * delta * delta;
+            static constexpr float c2 = 29.0f / 3.0f;
+            static constexpr float c3 = c2 * c2 * c2;
+            static constexpr float c4 = 1 / c3;
+            static constexpr float un = 4 * D65<float>.x() / (D65<float>.x() + 15 * D65<float>.y() + 3 * D65<float>.z());
+            static constexpr float vn = 9 * D65<float>.y() / (D65<float>.x() + 15 * D65<float>.y() + 3 * D65<float>.z());
+            static Vector<float, 3> from_base(Vector<float, 3> colour) noexcept {
+                float y = colour.y();
+                float l = y <= c1 ? c3 * y : 116 * fast_cbrt(y) - 16;
+                float d = colour.x() + 15 * y + 3 * colour.z();
+                float u = 4 * colour.x() / d;
+                float v = 9 * y / d;
+                return {l, 13 * l * (u - un), 13 * l * (v - vn)};
+            }
+            static Vector<float, 3> to_base(Vector<float, 3> colour) noexcept {
+                if (colour[0] == 0)
+                    return {0, 0, 0};
+                float u = colour[1] / (13 * colour[0]) + un;
+                float v = colour[2] / (13 * colour[0]) + vn;
+                float p = (colour[0] + 16) / 116;
+                float y = colour[0] <= 8 ? c4 * colour[0] : p * p * p;
+                return {y * 9 * u / (4 * v), y, y * (12 - 3 * u - 20 * v) / (4 * v)};
+            }
+        };
+
+        struct FastHcl {
+            static Vector<float, 3> from_base(Vector<float, 3> colour) noexcept {
+                float c = std::sqrt(colour[1] * colour[1] + colour[2] * colour[2]);
+                return {fast_atan2_turns(colour[2], colour[1]), c, colour[0]};
+            }
+            static Vector<float, 3> to_base(Vector<float, 3> colour) noexcept {
+                float s, c;
+                fast_sincos_turns(colour[0], s, c);
+                return {colour[2], colour[1] * c, colour[1] * s};
+            }
+        };
+
+        template <> struct FastSpace<CIELab>:
+        FastLab, FastSpaceBulk<lab_from_base_fast_simd, lab_to_base_fast_simd, FastLab> {
+            static constexpr bool value = true;
+            using FastLab::from_base;
+            using FastLab::to_base;
+            using FastSpaceBulk::from_base;
+            using FastSpaceBulk::to_base;
+        };
+
+        template <> struct FastSpace<CIELuv>:
+        FastLuv, FastSpaceBulk<luv_from_base_fast_simd, luv_to_base_fast_simd, FastLuv> {
+            static constexpr bool value = true;
+            using FastLuv::from_base;
+            using FastLuv::to_base;
+            using FastSpaceBulk::from_base;
+            using FastSpaceBulk::to_base;
+        };
+
+        template <typename Base> struct FastSpace<HCLSpace<Base>>:
+        FastHcl, FastSpaceBulk<hcl_from_base_fast_simd, hcl_to_base_fast_simd, FastHcl> {
+            static constexpr bool value = true;
+            using FastHcl::from_base;
+            using FastHcl::to_base;
+            using FastSpaceBulk<hcl_from_base_fast_simd, hcl_to_base_fast_simd, FastHcl>::from_base;
+            using FastSpaceBulk<hcl_from_base_fast_simd, hcl_to_base_fast_simd, FastHcl>::to_base;
+        };
+
+        // Fast mode versions of convert_colour_space() and
+        // convert_colour_space_to_encoding(), following the same route but
+        // replacing each step into or out of a perceptual space with its
+        // FastSpace version. The bulk versions apply the replaced steps to
+        // whole arrays, and the rest of the route colour by colour.
+
+        template <typename CS1, typename CS2>
+        constexpr bool route_has_fast_space() noexcept {
+            constexpr auto step = route_step<CS1, CS2>();
+            if constexpr (FastSpace<CS2>::value && route_ends_with_from_base<CS1, CS2>())
+                return true;
+            else if constexpr (step == RouteStep::up)
+                return FastSpace<CS1>::value || route_has_fast_space<typename CS1::base, CS2>();
+            else if constexpr (step == RouteStep::down)
+                return route_has_fast_space<CS1, typename CS2::base>();
+            else
+                return false;
+        }
+
+        template <typename CS1, typename CS2>
+        Vector<float, CS2::channels.size()> convert_colour_space_fast(Vector<float, int(CS1::channels.size())> colour) noexcept {
+            using BCS1 = typename CS1::base;
+            using BCS2 = typename CS2::base;
+            constexpr auto step = route_step<CS1, CS2>();
+            if constexpr (FastSpace<CS2>::value && route_ends_with_from_base<CS1, CS2>())
+                return FastSpace<CS2>::from_base(convert_colour_space_fast<CS1, BCS2>(colour));
+            else if constexpr (step == RouteStep::up && FastSpace<CS1>::value)
+                return convert_colour_space_fast<BCS1, CS2>(FastSpace<CS1>::to_base(colour));
+            else if constexpr (step == RouteStep::up)
+                return convert_colour_space_fast<BCS1, CS2>(CS1::to_base(colour));
+            else if constexpr (step == RouteStep::down)
+                return CS2::from_base(convert_colour_space_fast<CS1, BCS2>(colour));
+            else
+                return convert_colour_space<CS1, CS2>(colour);
+        }
+
+        template <typename CS1, typename CS2>
+        Vector<float, CS2::channels.size()> convert_colour_space_to_encoding_fast(Vector<float, int(CS1::channels.size())> colour) noexcept {
+            using BCS1 = typename CS1::base;
+            using BCS2 = typename CS2::base;
+            if constexpr (route_step<CS1, CS2>() != RouteStep::up)
+                return convert_colour_space_fast<CS1, BCS2>(colour);
+            else if constexpr (FastSpace<CS1>::value)
+                return convert_colour_space_to_encoding_fast<BCS1, CS2>(FastSpace<CS1>::to_base(colour));
+            else
+                return convert_colour_space_to_encoding_fast<BCS1, CS2>(CS1::to_base(colour));
+        }
+
+        template <typename CS1, typename CS2>
+        void convert_colour_space_fast(const float* in, float* out, size_t n) noexcept {
+            static_assert(CS1::channels.size() == 3 && CS2::channels.size() == 3);
+            using BCS1 = typename CS1::base;
+            using BCS2 = typename CS2::base;
+            if constexpr (FastSpace<CS2>::value && route_ends_with_from_base<CS1, CS2>()) {
+                convert_colour_space_fast<CS1, BCS2>(in, out, n);
+                FastSpace<CS2>::from_base(out, out, n);
+            } else if constexpr (route_step<CS1, CS2>() == RouteStep::up && FastSpace<CS1>::value) {
+                FastSpace<CS1>::to_base(in, out, n);
+                convert_colour_space_fast<BCS1, CS2>(out, out, n);
+            } else if constexpr (! std::is_same_v<CS1, CS2>) {
+                for (size_t i = 0; i < n; ++i) {
+                    auto c = convert_colour_space_fast<CS1, CS2>(Vector<float, 3>(in + 3 * i));
+                    std::copy_n(c.begin(), 3, out + 3 * i);
+                }
+            } else if (in != out) {
+                std::copy_n(in, 3 * n, out);
+            }
+        }
+
+        template <typename CS1, typename CS2>
+        void convert_colour_space_to_encoding_fast(const float* in, float* out, size_t n) noexcept {
+            static_assert(CS1::channels.size() == 3 && CS2::channels.size() == 3);
+            using BCS1 = typename CS1::base;
+            using BCS2 = typename CS2::base;
+            if constexpr (route_step<CS1, CS2>() != RouteStep::up) {
+                convert_colour_space_fast<CS1, BCS2>(in, out, n);
+            } else if constexpr (FastSpace<CS1>::value) {
+                FastSpace<CS1>::to_base(in, out, n);
+                convert_colour_space_to_encoding_fast<BCS1, CS2>(out, out, n);
+            } else {
+                for (size_t i = 0; i < n; ++i) {
+                    auto c = convert_colour_space_to_encoding_fast<CS1, CS2>(Vector<float, 3>(in + 3 * i));
+                    std::copy_n(c.begin(), 3, out + 3 * i);
+                }
+            }
+        }
+
+        // The steps of a conversion between colour spaces: decoding the
+        // input channels to the working type, converting the colour space,
+        // and encoding the output channels. If the input space is a transfer
+        // space, decoding can apply its transfer function, either through a
+        // lookup table (integer channels) or an approximation (fast mode);
+        // likewise for the output space.
+
+        // Decoding is only replaced when the route between the spaces
+        // starts with the input space's to_base(), and encoding when it
+        // ends with the output space's from_base(); in particular the tables
+        // are skipped when the colour space is unchanged. WT is always
+        // floating point, so the scale of the working colours is always 1.
+
+        template <typename C1, typename C2, bool Fast>
+        struct ColourPipeline {
+
+            using VT1 = typename C1::value_type;
+            using VT2 = typename C2::value_type;
+            using CS1 = typename C1::colour_space;
+            using CS2 = typename C2::colour_space;
+            using WT = WorkingChannelType<VT1, VT2>;
+
+            static constexpr bool starts_decoded = route_step<CS1, CS2>() == RouteStep::up;
+            static constexpr bool single = std::is_same_v<WT, float>;
+            static constexpr bool decode_table = starts_decoded && use_decode_table<CS1, VT1, WT>
+                && C1::scale == std::numeric_limits<VT1>::max();
+            static constexpr bool fast_decode = Fast && starts_decoded && single
+                && FastTransfer<CS1>::value && ! decode_table;
+
+            using CSW = std::conditional_t<decode_table || fast_decode, typename CS1::base, CS1>;
+
+            static constexpr bool ends_encoded = route_ends_with_from_base<CSW, CS2>();
+            static constexpr bool encode_table = ends_encoded && use_encode_table<CS2, VT2, WT>
+                && C2::scale == 255;
+            static constexpr bool fast_encode = Fast && ends_encoded && single
+                && FastTransfer<CS2>::value && ! encode_table;
+            static constexpr int in_channels = C1::colour_space_channels;
+            static constexpr int out_channels = C2::colour_space_channels;
+            static constexpr bool fast_space = Fast && single && in_channels == 3 && out_channels == 3
+                && route_has_fast_space<CSW, CS2>();
+            using in_vector = Vector<WT, in_channels>;
+            using out_vector = Vector<WT, out_channels>;
+
+            static WT decode(VT1 x) noexcept {
+                if constexpr (decode_table)
+                    return transfer_decode_table<CS1, VT1, WT>()[x];
+                else if constexpr (fast_decode)
+                    return FastTransfer<CS1>::decode(channel_to_working_type<WT>(x, C1::scale));
+                else
+                    return channel_to_working_type<WT>(x, C1::scale);
+            }
+
+            static out_vector convert(in_vector colour) noexcept {
+                if constexpr (fast_space && (encode_table || fast_encode))
+                    return convert_colour_space_to_encoding_fast<CSW, CS2>(colour);
+                else if constexpr (fast_space)
+                    return convert_colour_space_fast<CSW, CS2>(colour);
+                else if constexpr (encode_table || fast_encode)
+                    return convert_colour_space_to_encoding<CSW, CS2>(colour);
+                else
+                    return convert_colour_space<CSW, CS2>(colour);
+            }
+
+            static VT2 encode(WT x) noexcept {
+                if constexpr (encode_table) {
+                    using table_type = TransferEncodeTable<CS2, WT>;
+                    return x >= 0 && x <= 1 ? table_type::get()(x) : table_type::direct(x);
+                } else if constexpr (fast_encode) {
+                    return working_type_to_channel(FastTransfer<CS2>::encode(x), C2::scale);
+                } else {
+                    return working_type_to_channel(x, C2::scale);
+                }
+            }
+
+            static VT2 alpha(VT1 x) noexcept {
+                return working_type_to_channel(channel_to_working_type<WT>(x, C1::scale), C2::scale);
+            }
+
+        };
+
+        template <bool Fast, typename VT1, typename CS1, ColourLayout CL1,
+            typename VT2, typename CS2, ColourLayout CL2>
+        void convert_colour_pixel(Colour<VT1, CS1, CL1> in, Colour<VT2, CS2, CL2>& out) noexcept {
+
+            using C1 = Colour<VT1, CS1, CL1>;
+            using C2 = Colour<VT2, CS2, CL2>;
+
+            if constexpr (std::is_same_v<VT1, VT2> && std::is_same_v<CS1, CS2> && CL1 == CL2) {
+
+                out = in;
+
+            } else if constexpr (std::is_same_v<VT1, VT2> && std::is_same_v<CS1, CS2>) {
+
+                for (int i = 0; i < C1::colour_space_channels; ++i)
+                    out.cs(i) = in.cs(i);
+                if constexpr (C2::has_alpha)
+                    out.alpha() = in.alpha();
+
+            } else {
+
+                using P = ColourPipeline<C1, C2, Fast>;
+
+                typename P::in_vector wc1;
+                for (int i = 0; i < P::in_channels; ++i)
+                    wc1[i] = P::decode(in.cs(i));
+
+                auto wc2 = P::convert(wc1);
+                for (int i = 0; i < P::out_channels; ++i)
+                    out.cs(i) = P::encode(wc2[i]);
+
+                if constexpr (C2::has_alpha)
+                    out.alpha() = P::alpha(in.alpha());
+
+            }
+
+        }
+
+    }
+
     template <typename VT1, typename CS1, ColourLayout CL1,
         typename VT2, typename CS2, ColourLayout CL2>
     void convert_colour(Colour<VT1, CS1, CL1> in, Colour<VT2, CS2, CL2>& out) noexcept {
+        Detail::convert_colour_pixel<false>(in, out);
+    }
 
-        using C1 = Colour<VT1, CS1, CL1>;
-        using C2 = Colour<VT2, CS2, CL2>;
+    template <typename VT1, typename CS1, ColourLayout CL1,
+        typename VT2, typename CS2, ColourLayout CL2>
+    void convert_colour(Colour<VT1, CS1, CL1> in, Colour<VT2, CS2, CL2>& out, ColourPrecision precision) noexcept {
+        if (precision == ColourPrecision::fast)
+            Detail::convert_colour_pixel<true>(in, out);
+        else
+            Detail::convert_colour_pixel<false>(in, out);
+    }
 
-        if constexpr (std::is_same_v<VT1, VT2> && std::is_same_v<CS1, CS2> && CL1 == CL2) {
+    namespace Detail {
 
-            out = in;
+        size_t unorm8_to_float_simd(const uint8_t* in, float* out, size_t n) noexcept;
+        size_t float_to_unorm8_simd(const float* in, uint8_t* out, size_t n) noexcept;
+        size_t linear_to_srgb8_simd(const float* in, uint8_t* out, size_t n, int alpha_index) noexcept;
+
+        // Bulk conversion between two colour types. The primary template
+        // handles the cases that can bypass the general per-pixel path;
+        // specialisations can supply faster loops for particular pairs, but
+        // must give exactly the same results as the scalar convert_colour().
+
+        template <typename C1, typename C2>
+        struct ColourConverter {
+
+            using VT1 = typename C1::value_type;
+            using VT2 = typename C2::value_type;
+            using CS1 = typename C1::colour_space;
+            using CS2 = typename C2::colour_space;
+            using WT = WorkingChannelType<VT1, VT2>;
+
+            static constexpr ColourLayout CL1 = C1::layout;
+            static constexpr ColourLayout CL2 = C2::layout;
+
+            void operator()(const C1* in, ptrdiff_t in_stride, C2* out, ptrdiff_t out_stride, size_t n,
+                    ColourPrecision precision = ColourPrecision::exact) const noexcept {
+
+                using FP = ColourPipeline<C1, C2, true>;
+
+                if constexpr (std::is_same_v<C1, C2>) {
+
+                    if (in_stride == 1 && out_stride == 1)
+                        std::copy_n(in, n, out);
+                    else
+                        for (size_t i = 0; i < n; ++i, in += in_stride, out += out_stride)
+                            *out = *in;
+
+                } else if constexpr (std::is_same_v<CS1, CS2> && ! std::is_same_v<VT1, VT2>) {
+
+                    // Same colour space, so only the channel type changes.
+                    // This is the same arithmetic as the scalar function with
+                    // the identity space conversion left out. If the layouts
+                    // also match, contiguous buffers can be treated as flat
+                    // arrays of channels.
+
+                    if constexpr (CL1 == CL2) {
+                        if (in_stride == 1 && out_stride == 1) {
+                            auto flat_in = in->begin();
+                            auto flat_out = out->begin();
+                            size_t m = n * size_t(C1::channels);
+                            size_t i = 0;
+                            if constexpr (std::is_same_v<VT1, uint8_t> && std::is_same_v<VT2, float>
+                                    && C1::scale == 255 && C2::scale == 1)
+                                i = unorm8_to_float_simd(flat_in, flat_out, m);
+                            else if constexpr (std::is_same_v<VT1, float> && std::is_same_v<VT2, uint8_t>
+                                    && C1::scale == 1 && C2::scale == 255)
+                                i = float_to_unorm8_simd(flat_in, flat_out, m);
+                            for (; i < m; ++i)
+                                flat_out[i] = working_type_to_channel(channel_to_working_type<WT>(flat_in[i], C1::scale), C2::scale);
+                            return;
+                        }
+                    }
+
+                    for (size_t i = 0; i < n; ++i, in += in_stride, out += out_stride) {
+                        for (int j = 0; j < C2::colour_space_channels; ++j)
+                            out->cs(j) = working_type_to_channel(channel_to_working_type<WT>(in->cs(j), C1::scale), C2::scale);
+                        if constexpr (C2::has_alpha)
+                            out->alpha() = working_type_to_channel(channel_to_working_type<WT>(in->alpha(), C1::scale), C2::scale);
+                    }
+
+                } else if constexpr (FP::fast_decode || FP::fast_encode || FP::fast_space) {
+
+                    if (precision == ColourPrecision::fast)
+                        fast_blocks(in, in_stride, out, out_stride, n);
+                    else
+                        for (size_t i = 0; i < n; ++i, in += in_stride, out += out_stride)
+                            convert_colour(*in, *out);
+
+                } else {
+
+                    for (size_t i = 0; i < n; ++i, in += in_stride, out += out_stride)
+                        convert_colour(*in, *out);
+
+                }
 
-        } else if constexpr (std::is_same_v<VT1, VT2> && std::is_same_v<CS1, CS2>) {
+            }
+
+        private:
 
-            for (int i = 0; i < C1::colour_space_channels; ++i)
-                out.cs(i) = in.cs(i);
-            if constexpr (C2::has_alpha)
-                out.alpha() = in.alpha();
+            // Fast mode works through blocks of pixels, so the approximate
+            // transfer functions can be applied to whole arrays of channels
+            // before and after the colour space conversion, and the steps
+            // into and out of perceptual spaces to whole arrays of colours
 
-        } else {
+            static void fast_blocks(const C1* in, ptrdiff_t in_stride, C2* out, ptrdiff_t out_stride, size_t n) noexcept {
 
-            using WT = Detail::WorkingChannelType<VT1, VT2>;
-            using WC1 = Colour<WT, CS1, ColourLayout::forward_alpha>;
-            using WC2 = Colour<WT, CS2, ColourLayout::forward_alpha>;
+                using P = ColourPipeline<C1, C2, true>;
 
-            // WT is always floating point, so the scale of WC1/2 is always 1
+                static constexpr size_t block = 64;
+                static constexpr size_t n1 = P::in_channels;
+                static constexpr size_t n2 = P::out_channels;
 
-            WC1 wc1;
-            for (int i = 0; i < C1::colour_space_channels; ++i)
-                wc1.cs(i) = Detail::channel_to_working_type<WT>(in.cs(i), C1::scale);
-            wc1.alpha() = Detail::channel_to_working_type<WT>(in.alpha(), C1::scale);
+                std::array<float, block * n1> decoded;
+                std::array<float, block * n2> linear;
 
-            auto pvec2 = convert_colour_space<CS1, CS2>(wc1.partial_vector());
+                while (n > 0) {
 
-            WC2 wc2;
-            for (int i = 0; i < C2::colour_space_channels; ++i)
-                wc2[i] = pvec2[i];
-            wc2.alpha() = wc1.alpha();
+                    size_t m = std::min(n, block);
+                    auto p = in;
 
-            for (int i = 0; i < C2::channels; ++i)
-                out.cs(i) = Detail::working_type_to_channel(wc2.cs(i), C2::scale);
+                    for (size_t i = 0; i < m; ++i, p += in_stride)
+                        for (size_t j = 0; j < n1; ++j)
+                            decoded[i * n1 + j] = P::fast_decode ? channel_to_working_type<float>(p->cs(int(j)), C1::scale)
+                                : P::decode(p->cs(int(j)));
 
-        }
+                    if constexpr (P::fast_decode)
+                        FastTransfer<CS1>::decode(decoded.data(), decoded.data(), m * n1);
+
+                    if constexpr (P::fast_space && (P::encode_table || P::fast_encode)) {
+                        convert_colour_space_to_encoding_fast<typename P::CSW, CS2>(decoded.data(), linear.data(), m);
+                    } else if constexpr (P::fast_space) {
+                        convert_colour_space_fast<typename P::CSW, CS2>(decoded.data(), linear.data(), m);
+                    } else {
+                        for (size_t i = 0; i < m; ++i) {
+                            auto colour = P::convert(typename P::in_vector(decoded.data() + i * n1));
+                            for (size_t j = 0; j < n2; ++j)
+                                linear[i * n2 + j] = colour[int(j)];
+                        }
+                    }
+
+                    if constexpr (P::fast_encode)
+                        FastTransfer<CS2>::encode(linear.data(), linear.data(), m * n2);
+
+                    for (size_t i = 0; i < m; ++i, in += in_stride, out += out_stride) {
+                        for (size_t j = 0; j < n2; ++j)
+                            out->cs(int(j)) = P::fast_encode ? working_type_to_channel(linear[i * n2 + j], C2::scale)
+                                : P::encode(linear[i * n2 + j]);
+                        if constexpr (C2::has_alpha)
+                            out->alpha() = P::alpha(in->alpha());
+                    }
+
+                    n -= m;
+
+                }
+
+            }
+
+        };
 
+        // 8-bit sRGB and single precision linear RGB with the same layout.
+        // The pipeline already uses the transfer function tables for this
+        // pair, but going through it one pixel at a time costs far more than
+        // the table lookups. Decoding reads the 256 entry table directly;
+        // encoding uses a vector version of the threshold table search on
+        // contiguous buffers. Both directions are exact, so the precision
+        // is ignored, as it is by the general path for this pair.
+
+        template <ColourLayout CL>
+        struct ColourConverter<Colour<uint8_t, sRGB, CL>, Colour<float, LinearRGB, CL>> {
+
+            using C1 = Colour<uint8_t, sRGB, CL>;
+            using C2 = Colour<float, LinearRGB, CL>;
+
+            void operator()(const C1* in, ptrdiff_t in_stride, C2* out, ptrdiff_t out_stride, size_t n,
+                    ColourPrecision = ColourPrecision::exact) const noexcept {
+                const float* table = transfer_decode_table<sRGB, uint8_t, float>();
+                const float* alpha_table = unorm8_table();
+                for (size_t i = 0; i < n; ++i, in += in_stride, out += out_stride) {
+                    for (int j = 0; j < 3; ++j)
+                        out->cs(j) = table[in->cs(j)];
+                    if constexpr (C2::has_alpha)
+                        out->alpha() = alpha_table[in->alpha()];
+                }
+            }
+
+        private:
+
+            // The alpha channel is only scaled, but a table avoids a
+            // division per pixel
+
+            static const float* unorm8_table() {
+                static const std::array<float, 256> table = [] {
+                    std::array<float, 256> t;
+                    for (size_t i = 0; i < t.size(); ++i)
+                        t[i] = channel_to_working_type<float>(uint8_t(i), uint8_t(255));
+                    return t;
+                }();
+                return table.data();
+            }
+
+        };
+
+        template <ColourLayout CL>
+        struct ColourConverter<Colour<float, LinearRGB, CL>, Colour<uint8_t, sRGB, CL>> {
+
+            using C1 = Colour<float, LinearRGB, CL>;
+            using C2 = Colour<uint8_t, sRGB, CL>;
+            using table_type = TransferEncodeTable<sRGB, float>;
+
+            void operator()(const C1* in, ptrdiff_t in_stride, C2* out, ptrdiff_t out_stride, size_t n,
+                    ColourPrecision = ColourPrecision::exact) const noexcept {
+
+                const auto& table = table_type::get();
+
+                if (in_stride == 1 && out_stride == 1) {
+                    auto flat_in = in->begin();
+                    auto flat_out = out->begin();
+                    size_t m = n * size_t(C1::channels);
+                    for (size_t i = linear_to_srgb8_simd(flat_in, flat_out, m, C1::alpha_index); i < m; ++i)
+                        flat_out[i] = int(i % size_t(C1::channels)) == C1::alpha_index
+                            ? working_type_to_channel(flat_in[i], uint8_t(255)) : encode(table, flat_in[i]);
+                    return;
+                }
+
+                for (size_t i = 0; i < n; ++i, in += in_stride, out += out_stride) {
+                    for (int j = 0; j < 3; ++j)
+                        out->cs(j) = encode(table, in->cs(j));
+                    if constexpr (C2::has_alpha)
+                        out->alpha() = working_type_to_channel(in->alpha(), uint8_t(255));
+                }
+
+            }
+
+        private:
+
+            static uint8_t encode(const table_type& table, float x) noexcept {
+                return x >= 0 && x <= 1 ? table(x) : table_type::direct(x);
+            }
+
+        };
+
+    }
+
+    template <typename VT1, typename CS1, ColourLayout CL1,
+        typename VT2, typename CS2, ColourLayout CL2>
+    void convert_colour(const Colour<VT1, CS1, CL1>* in, Colour<VT2, CS2, CL2>* out, size_t n,
+            ColourPrecision precision = ColourPrecision::exact) noexcept {
+        Detail::ColourConverter<Colour<VT1, CS1, CL1>, Colour<VT2, CS2, CL2>>()(in, 1, out, 1, n, precision);
+    }
+
+    template <typename VT1, typename CS1, ColourLayout CL1,
+        typename VT2, typename CS2, ColourLayout CL2>
+    void convert_colour(const Colour<VT1, CS1, CL1>* in, ptrdiff_t in_stride,
+            Colour<VT2, CS2, CL2>* out, ptrdiff_t out_stride, size_t n,
+            ColourPrecision precision = ColourPrecision::exact) noexcept {
+        Detail::ColourConverter<Colour<VT1, CS1, CL1>, Colour<VT2, CS2, CL2>>()(in, in_stride, out, out_stride, n, precision);
     }
 
     template <typename VT, typename CS, ColourLayout CL>
@@ -554,6 +1333,110 @@ namespace RS::Graphics::Core {
 
     }
 
+    namespace Detail {
+
+        size_t alpha_blend_float_simd(const float* a, const float* b, float* out, size_t n,
+            int alpha_index, Pma flags) noexcept;
+        size_t alpha_blend_unorm8_simd(const uint8_t* a, const uint8_t* b, uint8_t* out, size_t n,
+            int alpha_index, Pma flags) noexcept;
+        size_t alpha_blend_unorm16_simd(const uint16_t* a, const uint16_t* b, uint16_t* out, size_t n,
+            int alpha_index, Pma flags) noexcept;
+
+        // Integer alpha blending, used for 8 and 16 bit channels in fast
+        // mode. Premultiplication and the over operator use the exact
+        // rounded division by 255 or 65535 (the x+(x>>8) trick); only
+        // unpremultiplying the result needs a (single precision) division.
+        // The vector kernels in colour.cpp mirror this exactly.
+
+        template <typename VT>
+        uint32_t div_unorm(uint32_t x) noexcept {
+            static constexpr int bits = 8 * sizeof(VT);
+            x += 1u << (bits - 1);
+            return (x + (x >> bits)) >> bits;
+        }
+
+        template <typename VT>
+        void alpha_blend_unorm(const VT* a, const VT* b, VT* out, int alpha_index, Pma flags) noexcept {
+
+            static constexpr uint32_t max = std::numeric_limits<VT>::max();
+
+            uint32_t aa = a[alpha_index];
+            uint32_t ab = b[alpha_index];
+            uint32_t c[4];
+
+            for (int i = 0; i < 4; ++i) {
+                uint32_t x = a[i];
+                uint32_t y = b[i];
+                if (i != alpha_index) {
+                    if (! (flags & Pma::first))
+                        x = div_unorm<VT>(x * aa);
+                    if (! (flags & Pma::second))
+                        y = div_unorm<VT>(y * ab);
+                }
+                c[i] = std::min(x + div_unorm<VT>(y * (max - aa)), max);
+            }
+
+            uint32_t ac = c[alpha_index];
+
+            if (! (flags & Pma::result)) {
+                float k = float(max) / float(ac);
+                for (int i = 0; i < 4; ++i)
+                    if (i != alpha_index)
+                        c[i] = ac == 0 ? 0 : uint32_t(std::min(float(c[i]) * k + 0.5f, float(max)));
+            }
+
+            for (int i = 0; i < 4; ++i)
+                out[i] = VT(c[i]);
+
+        }
+
+    }
+
+    // Blend a span of colours over another; the output may be the same
+    // array as either input
+
+    template <typename VT, typename CS, ColourLayout CL>
+    void alpha_blend(const Colour<VT, CS, CL>* a, const Colour<VT, CS, CL>* b, Colour<VT, CS, CL>* out, size_t n,
+            Pma flags = {}, ColourPrecision precision = ColourPrecision::exact) noexcept {
+
+        using C = Colour<VT, CS, CL>;
+
+        static_assert(C::can_premultiply);
+
+        size_t i = 0;
+
+        if constexpr (std::is_same_v<VT, float>) {
+            i = Detail::alpha_blend_float_simd(a->begin(), b->begin(), out->begin(), n, C::alpha_index, flags);
+        } else if constexpr ((std::is_same_v<VT, uint8_t> || std::is_same_v<VT, uint16_t>) && C::channels == 4) {
+            if (precision == ColourPrecision::fast) {
+                if constexpr (std::is_same_v<VT, uint8_t>)
+                    i = Detail::alpha_blend_unorm8_simd(a->begin(), b->begin(), out->begin(), n, C::alpha_index, flags);
+                else
+                    i = Detail::alpha_blend_unorm16_simd(a->begin(), b->begin(), out->begin(), n, C::alpha_index, flags);
+                for (; i < n; ++i)
+                    Detail::alpha_blend_unorm(a[i].begin(), b[i].begin(), out[i].begin(), C::alpha_index, flags);
+            }
+        }
+
+        for (; i < n; ++i)
+            out[i] = alpha_blend(a[i], b[i], flags);
+
+    }
+
+    template <typename VT, typename CS, ColourLayout CL>
+    void alpha_blend(const Colour<VT, CS, CL>* src, Colour<VT, CS, CL>* dst, size_t n,
+            Pma flags = {}, ColourPrecision precision = ColourPrecision::exact) noexcept {
+        alpha_blend(src, dst, dst, n, flags, precision);
+    }
+
+    template <typename VT, typename CS, ColourLayout CL, int N>
+    void alpha_blend(const MultiArray<Colour<VT, CS, CL>, N>& src, MultiArray<Colour<VT, CS, CL>, N>& dst,
+            Pma flags = {}, ColourPrecision precision = ColourPrecision::exact) {
+        if (src.shape() != dst.shape())
+            throw std::invalid_argument("Alpha blending arrays do not match in shape");
+        alpha_blend(src.data(), dst.data(), dst.size(), flags, precision);
+    }
+
     template <typename VT, typename CS, ColourLayout CL, typename U>
     constexpr Colour<VT, CS, CL> lerp(const Colour<VT, CS, CL>& c1,
             const std::enable_if_t<TL::SfinaeTrue<VT, Colour<VT, CS, CL>::is_linear>::value, Colour<VT, CS, CL>>& c2,
@@ -566,33 +1449,43 @@ namespace RS::Graphics::Core {
         return C(v3);
     }
 
+    // Allocation-free parsing. These report failure through the return
+    // value instead of throwing, and leave the colour unchanged on failure.
+
     namespace Detail {
 
-        std::optional<sRgba8> get_css_colour(const std::string& str);
+        std::optional<sRgba8> get_css_colour(std::string_view str) noexcept;
 
-        template <typename ColourType>
-        struct GetCssColour;
+    }
 
-        template <typename VT, typename CS, ColourLayout CL>
-        struct GetCssColour<Colour<VT, CS, CL>> {
-            Colour<VT, CS, CL> operator()(const std::string& str) const {
-                sRgba8 srgb;
-                auto opt_srgb = get_css_colour(str);
-                if (opt_srgb)
-                    srgb = *opt_srgb;
-                else
-                    srgb = sRgba8(str);
-                Colour<VT, CS, CL> colour;
-                convert_colour(srgb, colour);
-                return colour;
-            }
-        };
+    template <typename VT, typename CS, ColourLayout CL>
+    ColourParseError parse_hex_colour(std::string_view str, Colour<VT, CS, CL>& colour) noexcept {
+        static_assert(cs_is_rgb<CS>);
+        Byte4 bytes = {0,0,0,255};
+        if (! Detail::parse_hex_bytes(str, bytes))
+            return ColourParseError::invalid_hex;
+        Detail::colour_from_bytes(bytes, colour);
+        return ColourParseError::none;
+    }
 
+    template <typename VT, typename CS, ColourLayout CL>
+    ColourParseError parse_css_colour(std::string_view str, Colour<VT, CS, CL>& colour) noexcept {
+        auto opt_srgb = Detail::get_css_colour(str);
+        sRgba8 srgb;
+        if (opt_srgb)
+            srgb = *opt_srgb;
+        else if (parse_hex_colour(str, srgb) != ColourParseError::none)
+            return ColourParseError::unknown_name;
+        convert_colour(srgb, colour);
+        return ColourParseError::none;
     }
 
     template <typename ColourType>
-    ColourType css_colour(const std::string& str) {
-        return Detail::GetCssColour<ColourType>()(str);
+    ColourType css_colour(std::string_view str) {
+        ColourType colour;
+        if (parse_css_colour(str, colour) != ColourParseError::none)
+            throw std::invalid_argument("Invalid colour: " + Format::quote(std::string(str)));
+        return colour;
     }
 
     static_assert(std::is_standard_layout_v<Rgb8>);
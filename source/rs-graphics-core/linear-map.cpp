@@ -0,0 +1,107 @@
+#include "rs-graphics-core/linear-map.hpp"
+#include "rs-graphics-core/simd.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define RS_GRAPHICS_X86 1
+    #include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+    #define RS_GRAPHICS_TARGET(isa)
+#else
+    #define RS_GRAPHICS_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace RS::Graphics::Core::Detail {
+
+    namespace {
+
+        #ifdef RS_GRAPHICS_X86
+
+            RS_GRAPHICS_TARGET("avx2")
+            __m256 ramp_lerp_avx2(__m256 a, __m256 b, __m256 f) noexcept {
+                return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), f));
+            }
+
+            // Ramp kernel, mirroring LinearRamp::operator() in
+            // linear-map.hpp, interpolating each channel of the two
+            // neighbouring table entries. Four channel values are read
+            // directly as two pixels per register; other sizes gather one
+            // channel at a time.
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t ramp_lookup_avx2(const float* table, int channels, int size, float min, float scale,
+                    const float* in, float* out, size_t n) noexcept {
+                const __m256 vmin = _mm256_set1_ps(min);
+                const __m256 vscale = _mm256_set1_ps(scale);
+                const __m256 top = _mm256_set1_ps(float(size));
+                const __m256i last = _mm256_set1_epi32(size - 1);
+                const __m256i stride = _mm256_set1_epi32(channels);
+                alignas(32) float buf[8];
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    __m256 t = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(in + i), vmin), vscale);
+                    t = _mm256_max_ps(t, _mm256_setzero_ps());
+                    t = _mm256_min_ps(t, top);
+                    __m256i k = _mm256_min_epi32(_mm256_cvttps_epi32(t), last);
+                    __m256 f = _mm256_sub_ps(t, _mm256_cvtepi32_ps(k));
+                    if (channels == 4) {
+                        // Two pixels per register, straight from the table
+                        alignas(32) int32_t index[8];
+                        _mm256_store_si256(reinterpret_cast<__m256i*>(index), k);
+                        _mm256_store_ps(buf, f);
+                        for (int j = 0; j < 8; j += 2) {
+                            const float* p = table + 4 * index[j];
+                            const float* q = table + 4 * index[j + 1];
+                            __m256 a = _mm256_loadu2_m128(q, p);
+                            __m256 b = _mm256_loadu2_m128(q + 4, p + 4);
+                            __m256 w = _mm256_setr_m128(_mm_set1_ps(buf[j]), _mm_set1_ps(buf[j + 1]));
+                            _mm256_storeu_ps(out + 4 * (i + size_t(j)), ramp_lerp_avx2(a, b, w));
+                        }
+                        continue;
+                    }
+                    __m256i base = _mm256_mullo_epi32(k, stride);
+                    for (int c = 0; c < channels; ++c) {
+                        __m256 a = _mm256_i32gather_ps(table + c, base, 4);
+                        __m256 b = _mm256_i32gather_ps(table + c + channels, base, 4);
+                        __m256 y = ramp_lerp_avx2(a, b, f);
+                        if (channels == 1) {
+                            _mm256_storeu_ps(out + i, y);
+                        } else {
+                            _mm256_store_ps(buf, y);
+                            for (int j = 0; j < 8; ++j)
+                                out[channels * (i + size_t(j)) + size_t(c)] = buf[j];
+                        }
+                    }
+                }
+                return i;
+            }
+
+        #endif
+
+    }
+
+    size_t ramp_lookup_simd(const float* table, int channels, int size, float min, float scale,
+            const float* in, float* out, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return simd_padded<8>(in, 1, out, size_t(channels), n, [=] (const float* p, float* q, size_t m) {
+                                             return ramp_lookup_avx2(table, channels, size, min, scale, p, q, m);
+                                         });
+                default:                 break;
+            }
+        #else
+            (void)table;
+            (void)channels;
+            (void)size;
+            (void)min;
+            (void)scale;
+            (void)in;
+            (void)out;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+}
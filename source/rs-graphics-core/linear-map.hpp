@@ -1,13 +1,69 @@
 #pragma once
 
 #include "rs-graphics-core/maths.hpp"
+#include "rs-graphics-core/vector.hpp"
+#include <algorithm>
+#include <cstddef>
 #include <initializer_list>
 #include <iterator>
 #include <map>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace RS::Graphics::Core {
 
+    namespace Detail {
+
+        size_t ramp_lookup_simd(const float* table, int channels, int size, float min, float scale,
+            const float* in, float* out, size_t n) noexcept;
+
+        // Types with an as_vector() function, such as colours, are
+        // interpolated through their vector, whether or not they support
+        // arithmetic themselves
+
+        template <typename Y, typename = void>
+        struct RampVector {
+            using type = Y;
+        };
+
+        template <typename Y>
+        struct RampVector<Y, std::void_t<decltype(std::declval<const Y&>().as_vector())>> {
+            using type = decltype(std::declval<const Y&>().as_vector());
+        };
+
+        template <typename Y, typename X>
+        Y ramp_lerp(const Y& a, const Y& b, X f) noexcept {
+            using V = typename RampVector<Y>::type;
+            if constexpr (std::is_same_v<V, Y>) {
+                return a + (b - a) * f;
+            } else {
+                auto u = a.as_vector();
+                return Y(u + (b.as_vector() - u) * typename V::scalar_type(f));
+            }
+        }
+
+        // Number of single precision channels in a ramp value, if it can
+        // go through the vector kernel, otherwise zero
+
+        template <typename V> struct RampFloats { static constexpr int value = 0; };
+        template <> struct RampFloats<float> { static constexpr int value = 1; };
+        template <int N> struct RampFloats<Vector<float, N>> { static constexpr int value = N; };
+
+        template <typename Y, typename V = typename RampVector<Y>::type>
+        constexpr int ramp_channels = sizeof(Y) == sizeof(V) ? RampFloats<V>::value : 0;
+
+        template <typename Y>
+        auto ramp_floats(Y* p) noexcept {
+            if constexpr (std::is_same_v<std::remove_const_t<Y>, float>)
+                return p;
+            else
+                return p->begin();
+        }
+
+    }
+
     template <typename X, typename Y = X>
     class LinearMap {
 
@@ -28,19 +84,29 @@ namespace RS::Graphics::Core {
         using key_type = X;
         using mapped_type = Y;
 
+        struct knot_type {
+            X x;
+            Y left, mid, right;
+        };
+
         LinearMap() = default;
         LinearMap(std::initializer_list<init_type> list);
 
         Y operator[](X x) const;
-        void clear() noexcept { map_.clear(); }
+        void batch(const X* in, Y* out, size_t n) const;
+        void clear() noexcept { map_.clear(); thaw(); }
         bool empty() const noexcept { return map_.empty(); }
-        void insert(X x, Y y) { map_[x] = {y, y, y}; }
-        void insert(X x, Y yl, Y yr) { map_[x] = {yl, midpoint(yl, yr), yr}; }
-        void insert(X x, Y yl, Y y, Y yr) { map_[x] = {yl, y, yr}; }
-        void erase(X x) noexcept { map_.erase(x); }
+        std::vector<knot_type> knots() const;
+        void insert(X x, Y y) { map_[x] = {y, y, y}; thaw(); }
+        void insert(X x, Y yl, Y yr) { map_[x] = {yl, midpoint(yl, yr), yr}; thaw(); }
+        void insert(X x, Y yl, Y y, Y yr) { map_[x] = {yl, y, yr}; thaw(); }
+        void erase(X x) noexcept { map_.erase(x); thaw(); }
         void erase(X x1, X x2) noexcept;
+        void freeze();
+        bool frozen() const noexcept { return frozen_; }
         X min() const noexcept { return map_.empty() ? X(0) : map_.begin()->first; }
         X max() const noexcept { return map_.empty() ? X(0) : std::prev(map_.end())->first; }
+        template <typename F> LinearMap<X, std::invoke_result_t<F, const Y&>> transform(F f) const;
 
     private:
 
@@ -52,6 +118,19 @@ namespace RS::Graphics::Core {
 
         map_type map_;
 
+        // Flat copy of the map made by freeze(), with keys and values in
+        // separate arrays
+
+        std::vector<X> keys_;
+        std::vector<Y> left_;
+        std::vector<Y> mid_;
+        std::vector<Y> right_;
+        bool frozen_ = false;
+
+        Y flat_value(X x, size_t i) const;
+        size_t flat_search(X x, size_t lo) const noexcept;
+        void thaw() noexcept;
+
         inline static Y midpoint(Y y1, Y y2) noexcept { return y1 + X(0.5) * (y2 - y1); }
 
     };
@@ -66,6 +145,8 @@ namespace RS::Graphics::Core {
         Y LinearMap<X, Y>::operator[](X x) const {
             if (map_.empty())
                 return Y();
+            if (frozen_)
+                return flat_value(x, flat_search(x, 0));
             auto i = map_.lower_bound(x);
             if (i == map_.end())
                 return std::prev(i)->second.right;
@@ -77,11 +158,206 @@ namespace RS::Graphics::Core {
             return interpolate(j->first, j->second.right, i->first, i->second.left, x);
         }
 
+        template <typename X, typename Y>
+        std::vector<typename LinearMap<X, Y>::knot_type> LinearMap<X, Y>::knots() const {
+            std::vector<knot_type> list;
+            list.reserve(map_.size());
+            for (auto& [x, y]: map_)
+                list.push_back({x, y.left, y.mid, y.right});
+            return list;
+        }
+
         template <typename X, typename Y>
         void LinearMap<X, Y>::erase(X x1, X x2) noexcept {
             auto i = map_.lower_bound(x1);
             auto j = map_.upper_bound(x2);
             map_.erase(i, j);
+            thaw();
+        }
+
+        // If the inputs are in ascending order, each search continues from
+        // the previous result, first stepping through a few keys, and
+        // otherwise searching only the rest of the array. Checking the
+        // order first keeps the branches predictable either way.
+
+        template <typename X, typename Y>
+        void LinearMap<X, Y>::batch(const X* in, Y* out, size_t n) const {
+            static constexpr size_t max_steps = 4;
+            if (! frozen_ || map_.empty()) {
+                for (size_t k = 0; k < n; ++k)
+                    out[k] = (*this)[in[k]];
+                return;
+            }
+            if (! std::is_sorted(in, in + n)) {
+                for (size_t k = 0; k < n; ++k)
+                    out[k] = flat_value(in[k], flat_search(in[k], 0));
+                return;
+            }
+            size_t size = keys_.size();
+            size_t i = 0;
+            for (size_t k = 0; k < n; ++k) {
+                X x = in[k];
+                if (k > 0 && x >= in[k - 1]) {
+                    size_t stop = std::min(i + max_steps, size);
+                    while (i < stop && keys_[i] < x)
+                        ++i;
+                    if (i == stop && i < size)
+                        i = flat_search(x, i);
+                } else {
+                    i = flat_search(x, 0);
+                }
+                out[k] = flat_value(x, i);
+            }
+        }
+
+        template <typename X, typename Y>
+        void LinearMap<X, Y>::freeze() {
+            if (frozen_)
+                return;
+            thaw();
+            keys_.reserve(map_.size());
+            left_.reserve(map_.size());
+            mid_.reserve(map_.size());
+            right_.reserve(map_.size());
+            for (auto& [x, y]: map_) {
+                keys_.push_back(x);
+                left_.push_back(y.left);
+                mid_.push_back(y.mid);
+                right_.push_back(y.right);
+            }
+            frozen_ = true;
+        }
+
+        // Same logic as the tree lookup in operator[], given the index of
+        // the lower bound of x in the key array
+
+        template <typename X, typename Y>
+        Y LinearMap<X, Y>::flat_value(X x, size_t i) const {
+            if (i == keys_.size())
+                return right_[i - 1];
+            if (keys_[i] == x)
+                return mid_[i];
+            if (i == 0)
+                return left_[0];
+            return interpolate(keys_[i - 1], right_[i - 1], keys_[i], left_[i], x);
+        }
+
+        // Branchless lower bound: each step halves the range with a
+        // conditional move instead of a branch. Returns the index of the
+        // first key not less than x, starting from lo.
+
+        template <typename X, typename Y>
+        size_t LinearMap<X, Y>::flat_search(X x, size_t lo) const noexcept {
+            const X* base = keys_.data() + lo;
+            size_t len = keys_.size() - lo;
+            if (len == 0)
+                return lo;
+            while (len > 1) {
+                size_t half = len / 2;
+                base += size_t(base[half] < x) * half;
+                len -= half;
+            }
+            return size_t(base - keys_.data()) + size_t(*base < x);
+        }
+
+        template <typename X, typename Y>
+        void LinearMap<X, Y>::thaw() noexcept {
+            keys_.clear();
+            left_.clear();
+            mid_.clear();
+            right_.clear();
+            frozen_ = false;
+        }
+
+        template <typename X, typename Y>
+        template <typename F>
+        LinearMap<X, std::invoke_result_t<F, const Y&>> LinearMap<X, Y>::transform(F f) const {
+            LinearMap<X, std::invoke_result_t<F, const Y&>> result;
+            for (auto& [x, y]: map_)
+                result.insert(x, f(y.left), f(y.mid), f(y.right));
+            return result;
+        }
+
+    // Ramp baked from a LinearMap into a table of 2^bits+1 evenly spaced
+    // samples over its domain
+
+    template <typename X, typename Y = X>
+    class LinearRamp {
+
+    public:
+
+        static_assert(std::is_floating_point_v<X>);
+
+        using key_type = X;
+        using mapped_type = Y;
+
+        static constexpr int default_bits = 8;
+
+        LinearRamp() = default;
+        explicit LinearRamp(const LinearMap<X, Y>& map, int bits = default_bits):
+            LinearRamp(map, bits, [] (const Y& y) { return y; }) {}
+        template <typename Y2, typename F> LinearRamp(const LinearMap<X, Y2>& map, int bits, F f);
+
+        Y operator()(X x) const noexcept;
+        void batch(const X* in, Y* out, size_t n) const noexcept;
+
+        bool empty() const noexcept { return table_.empty(); }
+        size_t size() const noexcept { return table_.empty() ? 0 : table_.size() - 1; }
+        X min() const noexcept { return min_; }
+        X max() const noexcept { return max_; }
+        const std::vector<Y>& table() const noexcept { return table_; }
+
+    private:
+
+        std::vector<Y> table_;
+        X min_ = 0;
+        X max_ = 0;
+        X scale_ = 0;
+
+    };
+
+        template <typename X, typename Y>
+        template <typename Y2, typename F>
+        LinearRamp<X, Y>::LinearRamp(const LinearMap<X, Y2>& map, int bits, F f):
+        min_(map.min()), max_(map.max()) {
+            if (bits < 1 || bits > 20)
+                throw std::invalid_argument("Ramp size must be between 2^1 and 2^20");
+            int n = 1 << bits;
+            X range = max_ - min_;
+            scale_ = range > 0 ? X(n) / range : X(0);
+            table_.resize(size_t(n) + 1);
+            for (int i = 0; i <= n; ++i) {
+                X x = i == n ? max_ : min_ + range * (X(i) / X(n));
+                table_[size_t(i)] = f(map[x]);
+            }
+        }
+
+        // The vector kernel in linear-map.cpp mirrors this, so batch() gives
+        // the same results as calling operator() on each input. Inputs are
+        // clamped to the domain (NaN goes to the bottom).
+
+        template <typename X, typename Y>
+        Y LinearRamp<X, Y>::operator()(X x) const noexcept {
+            if (empty())
+                return Y();
+            int n = int(size());
+            X t = (x - min_) * scale_;
+            t = t > 0 ? t : X(0);
+            t = t < X(n) ? t : X(n);
+            int i = std::min(int(t), n - 1);
+            return Detail::ramp_lerp(table_[size_t(i)], table_[size_t(i) + 1], t - X(i));
+        }
+
+        template <typename X, typename Y>
+        void LinearRamp<X, Y>::batch(const X* in, Y* out, size_t n) const noexcept {
+            static constexpr int channels = Detail::ramp_channels<Y>;
+            size_t i = 0;
+            if constexpr (std::is_same_v<X, float> && channels > 0)
+                if (! empty())
+                    i = Detail::ramp_lookup_simd(Detail::ramp_floats(table_.data()), channels, int(size()),
+                        min_, scale_, in, Detail::ramp_floats(out), n);
+            for (; i < n; ++i)
+                out[i] = (*this)(in[i]);
         }
 
 }
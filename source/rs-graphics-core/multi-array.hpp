@@ -97,7 +97,7 @@ namespace RS::Graphics::Core {
         const_iterator begin() const noexcept { return const_iterator(*this, 0); }
         iterator end() noexcept { return iterator(*this, int(size())); }
         const_iterator end() const noexcept { return const_iterator(*this, int(size())); }
-        T* data() noexcept { return data_.ref(); }
+        T* data() noexcept { return data_.get(); }
         const T* data() const noexcept { return data_.get(); }
 
         iterator locate(const position& p) noexcept { return iterator(*this, position_to_index(p)); }
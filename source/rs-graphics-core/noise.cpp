@@ -0,0 +1,1231 @@
+#include "rs-graphics-core/noise.hpp"
+#include "rs-graphics-core/simd.hpp"
+#include <algorithm>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define RS_GRAPHICS_X86 1
+    #if defined(__GNUC__) && ! defined(__clang__)
+        // GCC 12 reports spurious uninitialized variables inside the AVX-512 headers
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    #endif
+    #include <immintrin.h>
+    #if defined(__GNUC__) && ! defined(__clang__)
+        #pragma GCC diagnostic pop
+    #endif
+#endif
+
+#ifdef _MSC_VER
+    #define RS_GRAPHICS_TARGET(isa)
+#else
+    #define RS_GRAPHICS_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+// The vector kernels mirror the scalar code in noise.hpp operation for
+// operation, so that the results are bit-for-bit identical to the scalar
+// code compiled without floating point contraction (as this file is). The
+// attn>0 branch is replaced by masking each contribution; the table indices
+// are always in range, so lookups for masked lanes are harmless.
+//
+// The 3D scalar code walks the lattice table through the fail/succ links,
+// which skip some candidates depending on earlier results. The kernels here
+// evaluate all 14 candidates and reproduce the walk with masks: candidates
+// 2-5, 6-9, and 10-13 form groups of four (b,b+1,b+2,b+3), where b+1 and b+2
+// are visited only if b failed, and b+3 is skipped only if b failed and b+2
+// succeeded.
+
+namespace RS::Graphics::Core::Detail {
+
+    namespace {
+
+        static_assert(sizeof(Float2) == 2 * sizeof(float));
+
+        constexpr int noise_pmask = 2047;
+
+        // Compact permutation entries are {uint16_t perm, grad}, read here as
+        // 32-bit integers. Standard entries are plain indices below 2048, so
+        // masking the low half gives the permutation in either layout.
+
+        constexpr int entry_mask = 0xffff;
+        constexpr float noise2_radius = 2.0f / 3.0f;
+
+        // Lattice table entries are {int xsv, int ysv, float dx, float dy}
+
+        constexpr int lattice2_fields = 4;
+
+        static_assert(sizeof(Float3) == 3 * sizeof(float));
+
+        constexpr float noise3_rotate = 2.0f / 3.0f;
+        constexpr float noise3_radius = 0.75f;
+
+        // Lattice table entries are {float dxr, dyr, dzr, int xrv, yrv, zrv, fail, succ}
+
+        constexpr int lattice3_fields = 8;
+        constexpr int lattice3_stride = 14;
+
+        // Role of each candidate in the 3D walk:
+        //   0 = always visited
+        //   1 = group head (b)
+        //   2 = visited if b failed (b+1)
+        //   3 = visited if b failed (b+2)
+        //   4 = visited unless b failed and b+2 succeeded (b+3)
+
+        constexpr int noise3_role[lattice3_stride] = {0, 0, 1, 2, 3, 4, 1, 2, 3, 4, 1, 2, 3, 4};
+
+        #ifdef RS_GRAPHICS_X86
+
+            RS_GRAPHICS_TARGET("sse2")
+            size_t noise2f_sse2(const NoiseSimdTables& tables, const Float2* points, float* values, size_t n) noexcept {
+
+                const float* src = reinterpret_cast<const float*>(points);
+                const int* lat = static_cast<const int*>(tables.lattice);
+                const float* latf = static_cast<const float*>(tables.lattice);
+                const int* table = tables.perm;
+
+                const __m128 skew = _mm_set1_ps(noise2_skew<float>);
+                const __m128 unskew = _mm_set1_ps(noise2_unskew<float>);
+                const __m128 radius = _mm_set1_ps(noise2_radius);
+                const __m128 zero = _mm_setzero_ps();
+                const __m128 half = _mm_set1_ps(0.5f);
+                const __m128 one = _mm_set1_ps(1.0f);
+                const __m128 sign = _mm_set1_ps(-0.0f);
+                const __m128i pmask = _mm_set1_epi32(noise_pmask);
+
+                size_t i = 0;
+
+                for (; i + 4 <= n; i += 4) {
+
+                    __m128 a = _mm_loadu_ps(src + 2 * i);
+                    __m128 b = _mm_loadu_ps(src + 2 * i + 4);
+                    __m128 x = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                    __m128 y = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+
+                    __m128 s = _mm_mul_ps(skew, _mm_add_ps(x, y));
+                    __m128 xs = _mm_add_ps(x, s);
+                    __m128 ys = _mm_add_ps(y, s);
+
+                    __m128i xsb = _mm_cvttps_epi32(xs);
+                    __m128i ysb = _mm_cvttps_epi32(ys);
+                    xsb = _mm_add_epi32(xsb, _mm_castps_si128(_mm_cmplt_ps(xs, _mm_cvtepi32_ps(xsb))));
+                    ysb = _mm_add_epi32(ysb, _mm_castps_si128(_mm_cmplt_ps(ys, _mm_cvtepi32_ps(ysb))));
+                    __m128 xsi = _mm_sub_ps(xs, _mm_cvtepi32_ps(xsb));
+                    __m128 ysi = _mm_sub_ps(ys, _mm_cvtepi32_ps(ysb));
+
+                    __m128i ai = _mm_cvttps_epi32(_mm_add_ps(xsi, ysi));
+                    __m128 ah = _mm_mul_ps(_mm_cvtepi32_ps(ai), half);
+                    __m128i bx = _mm_cvttps_epi32(_mm_sub_ps(_mm_add_ps(_mm_sub_ps(xsi, _mm_mul_ps(ysi, half)), one), ah));
+                    __m128i by = _mm_cvttps_epi32(_mm_sub_ps(_mm_add_ps(_mm_sub_ps(ysi, _mm_mul_ps(xsi, half)), one), ah));
+                    __m128i index = _mm_or_si128(_mm_slli_epi32(ai, 2),
+                        _mm_or_si128(_mm_slli_epi32(bx, 3), _mm_slli_epi32(by, 4)));
+
+                    __m128 ssi = _mm_mul_ps(_mm_xor_ps(_mm_add_ps(xsi, ysi), sign), unskew);
+                    __m128 xi = _mm_add_ps(xsi, ssi);
+                    __m128 yi = _mm_add_ps(ysi, ssi);
+                    __m128 value = zero;
+
+                    alignas(16) int lidx[4];
+                    alignas(16) int px[4];
+                    alignas(16) int py[4];
+                    alignas(16) int cv[8];
+                    alignas(16) float cd[8];
+                    alignas(16) float gd[8];
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(lidx), index);
+
+                    for (int k = 0; k < 4; ++k) {
+
+                        for (int j = 0; j < 4; ++j) {
+                            int c = lattice2_fields * (lidx[j] + k);
+                            cv[j] = lat[c];
+                            cv[j + 4] = lat[c + 1];
+                            cd[j] = latf[c + 2];
+                            cd[j + 4] = latf[c + 3];
+                        }
+
+                        __m128 dx = _mm_add_ps(xi, _mm_load_ps(cd));
+                        __m128 dy = _mm_add_ps(yi, _mm_load_ps(cd + 4));
+                        __m128 attn = _mm_sub_ps(_mm_sub_ps(radius, _mm_mul_ps(dx, dx)), _mm_mul_ps(dy, dy));
+                        __m128 mask = _mm_cmpgt_ps(attn, zero);
+
+                        __m128i pxm = _mm_and_si128(_mm_add_epi32(xsb, _mm_load_si128(reinterpret_cast<const __m128i*>(cv))), pmask);
+                        __m128i pym = _mm_and_si128(_mm_add_epi32(ysb, _mm_load_si128(reinterpret_cast<const __m128i*>(cv + 4))), pmask);
+                        _mm_store_si128(reinterpret_cast<__m128i*>(px), pxm);
+                        _mm_store_si128(reinterpret_cast<__m128i*>(py), pym);
+
+                        for (int j = 0; j < 4; ++j) {
+                            int q = (table[px[j]] & entry_mask) ^ py[j];
+                            int g = 2 * (tables.compact ? table[q] >> 16 : q);
+                            gd[j] = tables.grads[g];
+                            gd[j + 4] = tables.grads[g + 1];
+                        }
+
+                        __m128 extrapolation = _mm_add_ps(_mm_mul_ps(_mm_load_ps(gd), dx), _mm_mul_ps(_mm_load_ps(gd + 4), dy));
+                        attn = _mm_mul_ps(attn, attn);
+                        value = _mm_add_ps(value, _mm_and_ps(mask, _mm_mul_ps(_mm_mul_ps(attn, attn), extrapolation)));
+
+                    }
+
+                    _mm_storeu_ps(values + i, value);
+
+                }
+
+                return i;
+
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t noise2f_avx2(const NoiseSimdTables& tables, const Float2* points, float* values, size_t n) noexcept {
+
+                const float* src = reinterpret_cast<const float*>(points);
+                const int* lat = static_cast<const int*>(tables.lattice);
+                const float* latf = static_cast<const float*>(tables.lattice);
+                const int* table = tables.perm;
+
+                const __m256 skew = _mm256_set1_ps(noise2_skew<float>);
+                const __m256 unskew = _mm256_set1_ps(noise2_unskew<float>);
+                const __m256 radius = _mm256_set1_ps(noise2_radius);
+                const __m256 zero = _mm256_setzero_ps();
+                const __m256 half = _mm256_set1_ps(0.5f);
+                const __m256 one = _mm256_set1_ps(1.0f);
+                const __m256 sign = _mm256_set1_ps(-0.0f);
+                const __m256i pmask = _mm256_set1_epi32(noise_pmask);
+                const __m256i emask = _mm256_set1_epi32(entry_mask);
+
+                size_t i = 0;
+
+                for (; i + 8 <= n; i += 8) {
+
+                    __m256 a = _mm256_loadu_ps(src + 2 * i);
+                    __m256 b = _mm256_loadu_ps(src + 2 * i + 8);
+                    __m256 x = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(
+                        _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0)));
+                    __m256 y = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(
+                        _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))), _MM_SHUFFLE(3, 1, 2, 0)));
+
+                    __m256 s = _mm256_mul_ps(skew, _mm256_add_ps(x, y));
+                    __m256 xs = _mm256_add_ps(x, s);
+                    __m256 ys = _mm256_add_ps(y, s);
+
+                    __m256i xsb = _mm256_cvttps_epi32(xs);
+                    __m256i ysb = _mm256_cvttps_epi32(ys);
+                    xsb = _mm256_add_epi32(xsb, _mm256_castps_si256(_mm256_cmp_ps(xs, _mm256_cvtepi32_ps(xsb), _CMP_LT_OQ)));
+                    ysb = _mm256_add_epi32(ysb, _mm256_castps_si256(_mm256_cmp_ps(ys, _mm256_cvtepi32_ps(ysb), _CMP_LT_OQ)));
+                    __m256 xsi = _mm256_sub_ps(xs, _mm256_cvtepi32_ps(xsb));
+                    __m256 ysi = _mm256_sub_ps(ys, _mm256_cvtepi32_ps(ysb));
+
+                    __m256i ai = _mm256_cvttps_epi32(_mm256_add_ps(xsi, ysi));
+                    __m256 ah = _mm256_mul_ps(_mm256_cvtepi32_ps(ai), half);
+                    __m256i bx = _mm256_cvttps_epi32(_mm256_sub_ps(_mm256_add_ps(_mm256_sub_ps(xsi, _mm256_mul_ps(ysi, half)), one), ah));
+                    __m256i by = _mm256_cvttps_epi32(_mm256_sub_ps(_mm256_add_ps(_mm256_sub_ps(ysi, _mm256_mul_ps(xsi, half)), one), ah));
+                    __m256i index = _mm256_or_si256(_mm256_slli_epi32(ai, 2),
+                        _mm256_or_si256(_mm256_slli_epi32(bx, 3), _mm256_slli_epi32(by, 4)));
+
+                    __m256 ssi = _mm256_mul_ps(_mm256_xor_ps(_mm256_add_ps(xsi, ysi), sign), unskew);
+                    __m256 xi = _mm256_add_ps(xsi, ssi);
+                    __m256 yi = _mm256_add_ps(ysi, ssi);
+                    __m256 value = zero;
+
+                    for (int k = 0; k < 4; ++k) {
+
+                        __m256i c = _mm256_slli_epi32(_mm256_add_epi32(index, _mm256_set1_epi32(k)), 2);
+                        __m256 dx = _mm256_add_ps(xi, _mm256_i32gather_ps(latf + 2, c, 4));
+                        __m256 dy = _mm256_add_ps(yi, _mm256_i32gather_ps(latf + 3, c, 4));
+                        __m256 attn = _mm256_sub_ps(_mm256_sub_ps(radius, _mm256_mul_ps(dx, dx)), _mm256_mul_ps(dy, dy));
+                        __m256 mask = _mm256_cmp_ps(attn, zero, _CMP_GT_OQ);
+
+                        __m256i pxm = _mm256_and_si256(_mm256_add_epi32(xsb, _mm256_i32gather_epi32(lat, c, 4)), pmask);
+                        __m256i pym = _mm256_and_si256(_mm256_add_epi32(ysb, _mm256_i32gather_epi32(lat + 1, c, 4)), pmask);
+                        __m256i q = _mm256_xor_si256(_mm256_and_si256(_mm256_i32gather_epi32(table, pxm, 4), emask), pym);
+                        __m256i g = tables.compact ? _mm256_srli_epi32(_mm256_i32gather_epi32(table, q, 4), 16) : q;
+                        g = _mm256_slli_epi32(g, 1);
+
+                        __m256 extrapolation = _mm256_add_ps(_mm256_mul_ps(_mm256_i32gather_ps(tables.grads, g, 4), dx),
+                            _mm256_mul_ps(_mm256_i32gather_ps(tables.grads + 1, g, 4), dy));
+                        attn = _mm256_mul_ps(attn, attn);
+                        value = _mm256_add_ps(value, _mm256_and_ps(mask, _mm256_mul_ps(_mm256_mul_ps(attn, attn), extrapolation)));
+
+                    }
+
+                    _mm256_storeu_ps(values + i, value);
+
+                }
+
+                return i;
+
+            }
+
+            RS_GRAPHICS_TARGET("avx512f")
+            size_t noise2f_avx512(const NoiseSimdTables& tables, const Float2* points, float* values, size_t n) noexcept {
+
+                const float* src = reinterpret_cast<const float*>(points);
+                const int* lat = static_cast<const int*>(tables.lattice);
+                const float* latf = static_cast<const float*>(tables.lattice);
+                const int* table = tables.perm;
+
+                const __m512 skew = _mm512_set1_ps(noise2_skew<float>);
+                const __m512 unskew = _mm512_set1_ps(noise2_unskew<float>);
+                const __m512 radius = _mm512_set1_ps(noise2_radius);
+                const __m512 zero = _mm512_setzero_ps();
+                const __m512 half = _mm512_set1_ps(0.5f);
+                const __m512 one = _mm512_set1_ps(1.0f);
+                const __m512i sign = _mm512_set1_epi32(int(0x8000'0000u));
+                const __m512i ione = _mm512_set1_epi32(1);
+                const __m512i pmask = _mm512_set1_epi32(noise_pmask);
+                const __m512i emask = _mm512_set1_epi32(entry_mask);
+                const __m512i even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+                const __m512i odd = _mm512_add_epi32(even, ione);
+
+                size_t i = 0;
+
+                for (; i + 16 <= n; i += 16) {
+
+                    __m512 a = _mm512_loadu_ps(src + 2 * i);
+                    __m512 b = _mm512_loadu_ps(src + 2 * i + 16);
+                    __m512 x = _mm512_permutex2var_ps(a, even, b);
+                    __m512 y = _mm512_permutex2var_ps(a, odd, b);
+
+                    __m512 s = _mm512_mul_ps(skew, _mm512_add_ps(x, y));
+                    __m512 xs = _mm512_add_ps(x, s);
+                    __m512 ys = _mm512_add_ps(y, s);
+
+                    __m512i xsb = _mm512_cvttps_epi32(xs);
+                    __m512i ysb = _mm512_cvttps_epi32(ys);
+                    xsb = _mm512_mask_sub_epi32(xsb, _mm512_cmp_ps_mask(xs, _mm512_cvtepi32_ps(xsb), _CMP_LT_OQ), xsb, ione);
+                    ysb = _mm512_mask_sub_epi32(ysb, _mm512_cmp_ps_mask(ys, _mm512_cvtepi32_ps(ysb), _CMP_LT_OQ), ysb, ione);
+                    __m512 xsi = _mm512_sub_ps(xs, _mm512_cvtepi32_ps(xsb));
+                    __m512 ysi = _mm512_sub_ps(ys, _mm512_cvtepi32_ps(ysb));
+
+                    __m512i ai = _mm512_cvttps_epi32(_mm512_add_ps(xsi, ysi));
+                    __m512 ah = _mm512_mul_ps(_mm512_cvtepi32_ps(ai), half);
+                    __m512i bx = _mm512_cvttps_epi32(_mm512_sub_ps(_mm512_add_ps(_mm512_sub_ps(xsi, _mm512_mul_ps(ysi, half)), one), ah));
+                    __m512i by = _mm512_cvttps_epi32(_mm512_sub_ps(_mm512_add_ps(_mm512_sub_ps(ysi, _mm512_mul_ps(xsi, half)), one), ah));
+                    __m512i index = _mm512_or_si512(_mm512_slli_epi32(ai, 2),
+                        _mm512_or_si512(_mm512_slli_epi32(bx, 3), _mm512_slli_epi32(by, 4)));
+
+                    __m512 ssi = _mm512_mul_ps(_mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(_mm512_add_ps(xsi, ysi)), sign)), unskew);
+                    __m512 xi = _mm512_add_ps(xsi, ssi);
+                    __m512 yi = _mm512_add_ps(ysi, ssi);
+                    __m512 value = zero;
+
+                    for (int k = 0; k < 4; ++k) {
+
+                        __m512i c = _mm512_slli_epi32(_mm512_add_epi32(index, _mm512_set1_epi32(k)), 2);
+                        __m512 dx = _mm512_add_ps(xi, _mm512_i32gather_ps(c, latf + 2, 4));
+                        __m512 dy = _mm512_add_ps(yi, _mm512_i32gather_ps(c, latf + 3, 4));
+                        __m512 attn = _mm512_sub_ps(_mm512_sub_ps(radius, _mm512_mul_ps(dx, dx)), _mm512_mul_ps(dy, dy));
+                        __mmask16 mask = _mm512_cmp_ps_mask(attn, zero, _CMP_GT_OQ);
+
+                        __m512i pxm = _mm512_and_si512(_mm512_add_epi32(xsb, _mm512_i32gather_epi32(c, lat, 4)), pmask);
+                        __m512i pym = _mm512_and_si512(_mm512_add_epi32(ysb, _mm512_i32gather_epi32(c, lat + 1, 4)), pmask);
+                        __m512i q = _mm512_xor_si512(_mm512_and_si512(_mm512_i32gather_epi32(pxm, table, 4), emask), pym);
+                        __m512i g = tables.compact ? _mm512_srli_epi32(_mm512_i32gather_epi32(q, table, 4), 16) : q;
+                        g = _mm512_slli_epi32(g, 1);
+
+                        __m512 extrapolation = _mm512_add_ps(_mm512_mul_ps(_mm512_i32gather_ps(g, tables.grads, 4), dx),
+                            _mm512_mul_ps(_mm512_i32gather_ps(g, tables.grads + 1, 4), dy));
+                        attn = _mm512_mul_ps(attn, attn);
+                        value = _mm512_mask_add_ps(value, mask, value, _mm512_mul_ps(_mm512_mul_ps(attn, attn), extrapolation));
+
+                    }
+
+                    _mm512_storeu_ps(values + i, value);
+
+                }
+
+                return i;
+
+            }
+
+            RS_GRAPHICS_TARGET("sse2")
+            size_t noise3f_sse2(const NoiseSimdTables& tables, const Float3* points, float* values, size_t n) noexcept {
+
+                const float* src = reinterpret_cast<const float*>(points);
+                const int* lat = static_cast<const int*>(tables.lattice);
+                const float* latf = static_cast<const float*>(tables.lattice);
+                const int* table = tables.perm;
+
+                const __m128 rotate = _mm_set1_ps(noise3_rotate);
+                const __m128 radius = _mm_set1_ps(noise3_radius);
+                const __m128 zero = _mm_setzero_ps();
+                const __m128 half = _mm_set1_ps(0.5f);
+                const __m128 ones = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                const __m128i pmask = _mm_set1_epi32(noise_pmask);
+
+                size_t i = 0;
+
+                for (; i + 4 <= n; i += 4) {
+
+                    const float* p = src + 3 * i;
+                    __m128 x = _mm_setr_ps(p[0], p[3], p[6], p[9]);
+                    __m128 y = _mm_setr_ps(p[1], p[4], p[7], p[10]);
+                    __m128 z = _mm_setr_ps(p[2], p[5], p[8], p[11]);
+
+                    __m128 r = _mm_mul_ps(rotate, _mm_add_ps(_mm_add_ps(x, y), z));
+                    __m128 xr = _mm_sub_ps(r, x);
+                    __m128 yr = _mm_sub_ps(r, y);
+                    __m128 zr = _mm_sub_ps(r, z);
+
+                    __m128i xrb = _mm_cvttps_epi32(xr);
+                    __m128i yrb = _mm_cvttps_epi32(yr);
+                    __m128i zrb = _mm_cvttps_epi32(zr);
+                    xrb = _mm_add_epi32(xrb, _mm_castps_si128(_mm_cmplt_ps(xr, _mm_cvtepi32_ps(xrb))));
+                    yrb = _mm_add_epi32(yrb, _mm_castps_si128(_mm_cmplt_ps(yr, _mm_cvtepi32_ps(yrb))));
+                    zrb = _mm_add_epi32(zrb, _mm_castps_si128(_mm_cmplt_ps(zr, _mm_cvtepi32_ps(zrb))));
+                    __m128 xri = _mm_sub_ps(xr, _mm_cvtepi32_ps(xrb));
+                    __m128 yri = _mm_sub_ps(yr, _mm_cvtepi32_ps(yrb));
+                    __m128 zri = _mm_sub_ps(zr, _mm_cvtepi32_ps(zrb));
+
+                    __m128i xht = _mm_cvttps_epi32(_mm_add_ps(xri, half));
+                    __m128i yht = _mm_cvttps_epi32(_mm_add_ps(yri, half));
+                    __m128i zht = _mm_cvttps_epi32(_mm_add_ps(zri, half));
+                    __m128i index = _mm_or_si128(xht, _mm_or_si128(_mm_slli_epi32(yht, 1), _mm_slli_epi32(zht, 2)));
+
+                    __m128 value = zero;
+                    __m128 okb = zero;
+                    __m128 okb2 = zero;
+
+                    alignas(16) int lidx[4];
+                    alignas(16) int px[4];
+                    alignas(16) int py[4];
+                    alignas(16) int pz[4];
+                    alignas(16) int cv[12];
+                    alignas(16) float cd[12];
+                    alignas(16) float gd[12];
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(lidx), index);
+
+                    for (int k = 0; k < lattice3_stride; ++k) {
+
+                        for (int j = 0; j < 4; ++j) {
+                            int c = lattice3_fields * (lattice3_stride * lidx[j] + k);
+                            cd[j] = latf[c];
+                            cd[j + 4] = latf[c + 1];
+                            cd[j + 8] = latf[c + 2];
+                            cv[j] = lat[c + 3];
+                            cv[j + 4] = lat[c + 4];
+                            cv[j + 8] = lat[c + 5];
+                        }
+
+                        __m128 dx = _mm_add_ps(xri, _mm_load_ps(cd));
+                        __m128 dy = _mm_add_ps(yri, _mm_load_ps(cd + 4));
+                        __m128 dz = _mm_add_ps(zri, _mm_load_ps(cd + 8));
+                        __m128 attn = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(radius, _mm_mul_ps(dx, dx)), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+                        __m128 ok = _mm_cmpnlt_ps(attn, zero);
+                        __m128 mask = ok;
+
+                        switch (noise3_role[k]) {
+                            case 1:  okb = ok; break;
+                            case 2:  mask = _mm_andnot_ps(okb, ok); break;
+                            case 3:  mask = _mm_andnot_ps(okb, ok); okb2 = ok; break;
+                            case 4:  mask = _mm_and_ps(ok, _mm_or_ps(okb, _mm_andnot_ps(okb2, ones))); break;
+                            default: break;
+                        }
+
+                        __m128i pxm = _mm_and_si128(_mm_add_epi32(xrb, _mm_load_si128(reinterpret_cast<const __m128i*>(cv))), pmask);
+                        __m128i pym = _mm_and_si128(_mm_add_epi32(yrb, _mm_load_si128(reinterpret_cast<const __m128i*>(cv + 4))), pmask);
+                        __m128i pzm = _mm_and_si128(_mm_add_epi32(zrb, _mm_load_si128(reinterpret_cast<const __m128i*>(cv + 8))), pmask);
+                        _mm_store_si128(reinterpret_cast<__m128i*>(px), pxm);
+                        _mm_store_si128(reinterpret_cast<__m128i*>(py), pym);
+                        _mm_store_si128(reinterpret_cast<__m128i*>(pz), pzm);
+
+                        for (int j = 0; j < 4; ++j) {
+                            int q = (table[px[j]] & entry_mask) ^ py[j];
+                            q = (table[q] & entry_mask) ^ pz[j];
+                            int g = 3 * (tables.compact ? table[q] >> 16 : q);
+                            gd[j] = tables.grads[g];
+                            gd[j + 4] = tables.grads[g + 1];
+                            gd[j + 8] = tables.grads[g + 2];
+                        }
+
+                        __m128 extrapolation = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_load_ps(gd), dx),
+                            _mm_mul_ps(_mm_load_ps(gd + 4), dy)), _mm_mul_ps(_mm_load_ps(gd + 8), dz));
+                        attn = _mm_mul_ps(attn, attn);
+                        value = _mm_add_ps(value, _mm_and_ps(mask, _mm_mul_ps(_mm_mul_ps(attn, attn), extrapolation)));
+
+                    }
+
+                    _mm_storeu_ps(values + i, value);
+
+                }
+
+                return i;
+
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t noise3f_avx2(const NoiseSimdTables& tables, const Float3* points, float* values, size_t n) noexcept {
+
+                const float* src = reinterpret_cast<const float*>(points);
+                const int* lat = static_cast<const int*>(tables.lattice);
+                const float* latf = static_cast<const float*>(tables.lattice);
+                const int* table = tables.perm;
+
+                const __m256 rotate = _mm256_set1_ps(noise3_rotate);
+                const __m256 radius = _mm256_set1_ps(noise3_radius);
+                const __m256 zero = _mm256_setzero_ps();
+                const __m256 half = _mm256_set1_ps(0.5f);
+                const __m256 ones = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+                const __m256i pmask = _mm256_set1_epi32(noise_pmask);
+                const __m256i emask = _mm256_set1_epi32(entry_mask);
+                const __m256i stride = _mm256_set1_epi32(lattice3_fields * lattice3_stride);
+                const __m256i triple = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+
+                size_t i = 0;
+
+                for (; i + 8 <= n; i += 8) {
+
+                    const float* p = src + 3 * i;
+                    __m256 x = _mm256_i32gather_ps(p, triple, 4);
+                    __m256 y = _mm256_i32gather_ps(p + 1, triple, 4);
+                    __m256 z = _mm256_i32gather_ps(p + 2, triple, 4);
+
+                    __m256 r = _mm256_mul_ps(rotate, _mm256_add_ps(_mm256_add_ps(x, y), z));
+                    __m256 xr = _mm256_sub_ps(r, x);
+                    __m256 yr = _mm256_sub_ps(r, y);
+                    __m256 zr = _mm256_sub_ps(r, z);
+
+                    __m256i xrb = _mm256_cvttps_epi32(xr);
+                    __m256i yrb = _mm256_cvttps_epi32(yr);
+                    __m256i zrb = _mm256_cvttps_epi32(zr);
+                    xrb = _mm256_add_epi32(xrb, _mm256_castps_si256(_mm256_cmp_ps(xr, _mm256_cvtepi32_ps(xrb), _CMP_LT_OQ)));
+                    yrb = _mm256_add_epi32(yrb, _mm256_castps_si256(_mm256_cmp_ps(yr, _mm256_cvtepi32_ps(yrb), _CMP_LT_OQ)));
+                    zrb = _mm256_add_epi32(zrb, _mm256_castps_si256(_mm256_cmp_ps(zr, _mm256_cvtepi32_ps(zrb), _CMP_LT_OQ)));
+                    __m256 xri = _mm256_sub_ps(xr, _mm256_cvtepi32_ps(xrb));
+                    __m256 yri = _mm256_sub_ps(yr, _mm256_cvtepi32_ps(yrb));
+                    __m256 zri = _mm256_sub_ps(zr, _mm256_cvtepi32_ps(zrb));
+
+                    __m256i xht = _mm256_cvttps_epi32(_mm256_add_ps(xri, half));
+                    __m256i yht = _mm256_cvttps_epi32(_mm256_add_ps(yri, half));
+                    __m256i zht = _mm256_cvttps_epi32(_mm256_add_ps(zri, half));
+                    __m256i index = _mm256_or_si256(xht, _mm256_or_si256(_mm256_slli_epi32(yht, 1), _mm256_slli_epi32(zht, 2)));
+                    __m256i base = _mm256_mullo_epi32(index, stride);
+
+                    __m256 value = zero;
+                    __m256 okb = zero;
+                    __m256 okb2 = zero;
+
+                    for (int k = 0; k < lattice3_stride; ++k) {
+
+                        __m256i c = _mm256_add_epi32(base, _mm256_set1_epi32(lattice3_fields * k));
+                        __m256 dx = _mm256_add_ps(xri, _mm256_i32gather_ps(latf, c, 4));
+                        __m256 dy = _mm256_add_ps(yri, _mm256_i32gather_ps(latf + 1, c, 4));
+                        __m256 dz = _mm256_add_ps(zri, _mm256_i32gather_ps(latf + 2, c, 4));
+                        __m256 attn = _mm256_sub_ps(_mm256_sub_ps(_mm256_sub_ps(radius, _mm256_mul_ps(dx, dx)),
+                            _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+                        __m256 ok = _mm256_cmp_ps(attn, zero, _CMP_NLT_UQ);
+                        __m256 mask = ok;
+
+                        switch (noise3_role[k]) {
+                            case 1:  okb = ok; break;
+                            case 2:  mask = _mm256_andnot_ps(okb, ok); break;
+                            case 3:  mask = _mm256_andnot_ps(okb, ok); okb2 = ok; break;
+                            case 4:  mask = _mm256_and_ps(ok, _mm256_or_ps(okb, _mm256_andnot_ps(okb2, ones))); break;
+                            default: break;
+                        }
+
+                        __m256i pxm = _mm256_and_si256(_mm256_add_epi32(xrb, _mm256_i32gather_epi32(lat + 3, c, 4)), pmask);
+                        __m256i pym = _mm256_and_si256(_mm256_add_epi32(yrb, _mm256_i32gather_epi32(lat + 4, c, 4)), pmask);
+                        __m256i pzm = _mm256_and_si256(_mm256_add_epi32(zrb, _mm256_i32gather_epi32(lat + 5, c, 4)), pmask);
+                        __m256i q = _mm256_xor_si256(_mm256_and_si256(_mm256_i32gather_epi32(table, pxm, 4), emask), pym);
+                        q = _mm256_xor_si256(_mm256_and_si256(_mm256_i32gather_epi32(table, q, 4), emask), pzm);
+                        __m256i g = tables.compact ? _mm256_srli_epi32(_mm256_i32gather_epi32(table, q, 4), 16) : q;
+                        g = _mm256_add_epi32(g, _mm256_slli_epi32(g, 1));
+
+                        __m256 extrapolation = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_i32gather_ps(tables.grads, g, 4), dx),
+                            _mm256_mul_ps(_mm256_i32gather_ps(tables.grads + 1, g, 4), dy)),
+                            _mm256_mul_ps(_mm256_i32gather_ps(tables.grads + 2, g, 4), dz));
+                        attn = _mm256_mul_ps(attn, attn);
+                        value = _mm256_add_ps(value, _mm256_and_ps(mask, _mm256_mul_ps(_mm256_mul_ps(attn, attn), extrapolation)));
+
+                    }
+
+                    _mm256_storeu_ps(values + i, value);
+
+                }
+
+                return i;
+
+            }
+
+            RS_GRAPHICS_TARGET("avx512f")
+            size_t noise3f_avx512(const NoiseSimdTables& tables, const Float3* points, float* values, size_t n) noexcept {
+
+                const float* src = reinterpret_cast<const float*>(points);
+                const int* lat = static_cast<const int*>(tables.lattice);
+                const float* latf = static_cast<const float*>(tables.lattice);
+                const int* table = tables.perm;
+
+                const __m512 rotate = _mm512_set1_ps(noise3_rotate);
+                const __m512 radius = _mm512_set1_ps(noise3_radius);
+                const __m512 zero = _mm512_setzero_ps();
+                const __m512 half = _mm512_set1_ps(0.5f);
+                const __m512i ione = _mm512_set1_epi32(1);
+                const __m512i pmask = _mm512_set1_epi32(noise_pmask);
+                const __m512i emask = _mm512_set1_epi32(entry_mask);
+                const __m512i stride = _mm512_set1_epi32(lattice3_fields * lattice3_stride);
+                const __m512i triple = _mm512_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 33, 36, 39, 42, 45);
+
+                size_t i = 0;
+
+                for (; i + 16 <= n; i += 16) {
+
+                    const float* p = src + 3 * i;
+                    __m512 x = _mm512_i32gather_ps(triple, p, 4);
+                    __m512 y = _mm512_i32gather_ps(triple, p + 1, 4);
+                    __m512 z = _mm512_i32gather_ps(triple, p + 2, 4);
+
+                    __m512 r = _mm512_mul_ps(rotate, _mm512_add_ps(_mm512_add_ps(x, y), z));
+                    __m512 xr = _mm512_sub_ps(r, x);
+                    __m512 yr = _mm512_sub_ps(r, y);
+                    __m512 zr = _mm512_sub_ps(r, z);
+
+                    __m512i xrb = _mm512_cvttps_epi32(xr);
+                    __m512i yrb = _mm512_cvttps_epi32(yr);
+                    __m512i zrb = _mm512_cvttps_epi32(zr);
+                    xrb = _mm512_mask_sub_epi32(xrb, _mm512_cmp_ps_mask(xr, _mm512_cvtepi32_ps(xrb), _CMP_LT_OQ), xrb, ione);
+                    yrb = _mm512_mask_sub_epi32(yrb, _mm512_cmp_ps_mask(yr, _mm512_cvtepi32_ps(yrb), _CMP_LT_OQ), yrb, ione);
+                    zrb = _mm512_mask_sub_epi32(zrb, _mm512_cmp_ps_mask(zr, _mm512_cvtepi32_ps(zrb), _CMP_LT_OQ), zrb, ione);
+                    __m512 xri = _mm512_sub_ps(xr, _mm512_cvtepi32_ps(xrb));
+                    __m512 yri = _mm512_sub_ps(yr, _mm512_cvtepi32_ps(yrb));
+                    __m512 zri = _mm512_sub_ps(zr, _mm512_cvtepi32_ps(zrb));
+
+                    __m512i xht = _mm512_cvttps_epi32(_mm512_add_ps(xri, half));
+                    __m512i yht = _mm512_cvttps_epi32(_mm512_add_ps(yri, half));
+                    __m512i zht = _mm512_cvttps_epi32(_mm512_add_ps(zri, half));
+                    __m512i index = _mm512_or_si512(xht, _mm512_or_si512(_mm512_slli_epi32(yht, 1), _mm512_slli_epi32(zht, 2)));
+                    __m512i base = _mm512_mullo_epi32(index, stride);
+
+                    __m512 value = zero;
+                    __mmask16 okb = 0;
+                    __mmask16 okb2 = 0;
+
+                    for (int k = 0; k < lattice3_stride; ++k) {
+
+                        __m512i c = _mm512_add_epi32(base, _mm512_set1_epi32(lattice3_fields * k));
+                        __m512 dx = _mm512_add_ps(xri, _mm512_i32gather_ps(c, latf, 4));
+                        __m512 dy = _mm512_add_ps(yri, _mm512_i32gather_ps(c, latf + 1, 4));
+                        __m512 dz = _mm512_add_ps(zri, _mm512_i32gather_ps(c, latf + 2, 4));
+                        __m512 attn = _mm512_sub_ps(_mm512_sub_ps(_mm512_sub_ps(radius, _mm512_mul_ps(dx, dx)),
+                            _mm512_mul_ps(dy, dy)), _mm512_mul_ps(dz, dz));
+                        __mmask16 ok = _mm512_cmp_ps_mask(attn, zero, _CMP_NLT_UQ);
+                        __mmask16 mask = ok;
+
+                        switch (noise3_role[k]) {
+                            case 1:  okb = ok; break;
+                            case 2:  mask = __mmask16(ok & ~ okb); break;
+                            case 3:  mask = __mmask16(ok & ~ okb); okb2 = ok; break;
+                            case 4:  mask = __mmask16(ok & (okb | ~ okb2)); break;
+                            default: break;
+                        }
+
+                        __m512i pxm = _mm512_and_si512(_mm512_add_epi32(xrb, _mm512_i32gather_epi32(c, lat + 3, 4)), pmask);
+                        __m512i pym = _mm512_and_si512(_mm512_add_epi32(yrb, _mm512_i32gather_epi32(c, lat + 4, 4)), pmask);
+                        __m512i pzm = _mm512_and_si512(_mm512_add_epi32(zrb, _mm512_i32gather_epi32(c, lat + 5, 4)), pmask);
+                        __m512i q = _mm512_xor_si512(_mm512_and_si512(_mm512_i32gather_epi32(pxm, table, 4), emask), pym);
+                        q = _mm512_xor_si512(_mm512_and_si512(_mm512_i32gather_epi32(q, table, 4), emask), pzm);
+                        __m512i g = tables.compact ? _mm512_srli_epi32(_mm512_i32gather_epi32(q, table, 4), 16) : q;
+                        g = _mm512_add_epi32(g, _mm512_slli_epi32(g, 1));
+
+                        __m512 extrapolation = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(_mm512_i32gather_ps(g, tables.grads, 4), dx),
+                            _mm512_mul_ps(_mm512_i32gather_ps(g, tables.grads + 1, 4), dy)),
+                            _mm512_mul_ps(_mm512_i32gather_ps(g, tables.grads + 2, 4), dz));
+                        attn = _mm512_mul_ps(attn, attn);
+                        value = _mm512_mask_add_ps(value, mask, value, _mm512_mul_ps(_mm512_mul_ps(attn, attn), extrapolation));
+
+                    }
+
+                    _mm512_storeu_ps(values + i, value);
+
+                }
+
+                return i;
+
+            }
+
+            // Scanline kernels. Each block of points is located as in the
+            // batch kernels, then evaluated once for each distinct cell state
+            // in the block, with that state's offsets and gradients broadcast
+            // instead of gathered. Along a row most blocks lie in one state,
+            // and the last state is cached, so prepare() is only called when
+            // the row moves into another one. The final partial block repeats
+            // the last point in its spare lanes. Lane indices are converted
+            // from int, which limits a call to INT_MAX points. There are no
+            // SSE2 versions.
+
+            constexpr size_t scanline_limit = size_t(std::numeric_limits<int>::max());
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t noise2f_scanline_avx2(const NoiseScanline<float, 2>& scan, float* values, size_t n) noexcept {
+
+                const __m256 skew = _mm256_set1_ps(noise2_skew<float>);
+                const __m256 unskew = _mm256_set1_ps(noise2_unskew<float>);
+                const __m256 radius = _mm256_set1_ps(noise2_radius);
+                const __m256 zero = _mm256_setzero_ps();
+                const __m256 half = _mm256_set1_ps(0.5f);
+                const __m256 one = _mm256_set1_ps(1.0f);
+                const __m256 sign = _mm256_set1_ps(-0.0f);
+                const __m256 ox = _mm256_set1_ps(scan.origin.x());
+                const __m256 oy = _mm256_set1_ps(scan.origin.y());
+                const __m256 sx = _mm256_set1_ps(scan.step.x());
+                const __m256 sy = _mm256_set1_ps(scan.step.y());
+                const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+                alignas(32) int state[3][8];
+                int cell[3] = {0, 0, -1};
+                float data[16];
+                size_t i = 0;
+                n = std::min(n, scanline_limit);
+                const __m256i last = _mm256_set1_epi32(int(n) - 1);
+
+                for (; i < n; i += 8) {
+
+                    __m256 t = _mm256_cvtepi32_ps(_mm256_min_epi32(_mm256_add_epi32(_mm256_set1_epi32(int(i)), lanes), last));
+                    __m256 x = _mm256_add_ps(ox, _mm256_mul_ps(t, sx));
+                    __m256 y = _mm256_add_ps(oy, _mm256_mul_ps(t, sy));
+
+                    __m256 s = _mm256_mul_ps(skew, _mm256_add_ps(x, y));
+                    __m256 xs = _mm256_add_ps(x, s);
+                    __m256 ys = _mm256_add_ps(y, s);
+
+                    __m256i xsb = _mm256_cvttps_epi32(xs);
+                    __m256i ysb = _mm256_cvttps_epi32(ys);
+                    xsb = _mm256_add_epi32(xsb, _mm256_castps_si256(_mm256_cmp_ps(xs, _mm256_cvtepi32_ps(xsb), _CMP_LT_OQ)));
+                    ysb = _mm256_add_epi32(ysb, _mm256_castps_si256(_mm256_cmp_ps(ys, _mm256_cvtepi32_ps(ysb), _CMP_LT_OQ)));
+                    __m256 xsi = _mm256_sub_ps(xs, _mm256_cvtepi32_ps(xsb));
+                    __m256 ysi = _mm256_sub_ps(ys, _mm256_cvtepi32_ps(ysb));
+
+                    __m256i ai = _mm256_cvttps_epi32(_mm256_add_ps(xsi, ysi));
+                    __m256 ah = _mm256_mul_ps(_mm256_cvtepi32_ps(ai), half);
+                    __m256i bx = _mm256_cvttps_epi32(_mm256_sub_ps(_mm256_add_ps(_mm256_sub_ps(xsi, _mm256_mul_ps(ysi, half)), one), ah));
+                    __m256i by = _mm256_cvttps_epi32(_mm256_sub_ps(_mm256_add_ps(_mm256_sub_ps(ysi, _mm256_mul_ps(xsi, half)), one), ah));
+                    __m256i index = _mm256_or_si256(_mm256_slli_epi32(ai, 2),
+                        _mm256_or_si256(_mm256_slli_epi32(bx, 3), _mm256_slli_epi32(by, 4)));
+
+                    __m256 ssi = _mm256_mul_ps(_mm256_xor_ps(_mm256_add_ps(xsi, ysi), sign), unskew);
+                    __m256 xi = _mm256_add_ps(xsi, ssi);
+                    __m256 yi = _mm256_add_ps(ysi, ssi);
+
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(state[0]), xsb);
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(state[1]), ysb);
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(state[2]), index);
+
+                    __m256 value = zero;
+                    int pending = 0xff;
+
+                    while (pending != 0) {
+
+                        int j = 0;
+                        while ((pending & (1 << j)) == 0)
+                            ++j;
+
+                        if (state[0][j] != cell[0] || state[1][j] != cell[1] || state[2][j] != cell[2]) {
+                            for (int k = 0; k < 3; ++k)
+                                cell[k] = state[k][j];
+                            scan.prepare(scan.noise, cell, data);
+                        }
+
+                        __m256i same = _mm256_and_si256(_mm256_and_si256(_mm256_cmpeq_epi32(xsb, _mm256_set1_epi32(cell[0])),
+                            _mm256_cmpeq_epi32(ysb, _mm256_set1_epi32(cell[1]))), _mm256_cmpeq_epi32(index, _mm256_set1_epi32(cell[2])));
+                        __m256 match = _mm256_castsi256_ps(same);
+                        __m256 part = zero;
+
+                        for (int k = 0; k < 4; ++k) {
+                            const float* d = data + 4 * k;
+                            __m256 dx = _mm256_add_ps(xi, _mm256_set1_ps(d[0]));
+                            __m256 dy = _mm256_add_ps(yi, _mm256_set1_ps(d[1]));
+                            __m256 attn = _mm256_sub_ps(_mm256_sub_ps(radius, _mm256_mul_ps(dx, dx)), _mm256_mul_ps(dy, dy));
+                            __m256 mask = _mm256_cmp_ps(attn, zero, _CMP_GT_OQ);
+                            __m256 extrapolation = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(d[2]), dx),
+                                _mm256_mul_ps(_mm256_set1_ps(d[3]), dy));
+                            attn = _mm256_mul_ps(attn, attn);
+                            part = _mm256_add_ps(part, _mm256_and_ps(mask, _mm256_mul_ps(_mm256_mul_ps(attn, attn), extrapolation)));
+                        }
+
+                        value = _mm256_blendv_ps(value, part, match);
+                        pending &= ~ _mm256_movemask_ps(match);
+
+                    }
+
+                    if (i + 8 <= n) {
+                        _mm256_storeu_ps(values + i, value);
+                    } else {
+                        alignas(32) float tail[8];
+                        _mm256_store_ps(tail, value);
+                        std::copy_n(tail, n - i, values + i);
+                    }
+
+                }
+
+                return n;
+
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t noise2d_scanline_avx2(const NoiseScanline<double, 2>& scan, double* values, size_t n) noexcept {
+
+                const __m256d skew = _mm256_set1_pd(noise2_skew<double>);
+                const __m256d unskew = _mm256_set1_pd(noise2_unskew<double>);
+                const __m256d radius = _mm256_set1_pd(2.0 / 3.0);
+                const __m256d zero = _mm256_setzero_pd();
+                const __m256d half = _mm256_set1_pd(0.5);
+                const __m256d one = _mm256_set1_pd(1.0);
+                const __m256d sign = _mm256_set1_pd(-0.0);
+                const __m256d ox = _mm256_set1_pd(scan.origin.x());
+                const __m256d oy = _mm256_set1_pd(scan.origin.y());
+                const __m256d sx = _mm256_set1_pd(scan.step.x());
+                const __m256d sy = _mm256_set1_pd(scan.step.y());
+                const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+
+                alignas(16) int state[3][4];
+                int cell[3] = {0, 0, -1};
+                double data[16];
+                size_t i = 0;
+                n = std::min(n, scanline_limit);
+                const __m128i last = _mm_set1_epi32(int(n) - 1);
+
+                for (; i < n; i += 4) {
+
+                    __m256d t = _mm256_cvtepi32_pd(_mm_min_epi32(_mm_add_epi32(_mm_set1_epi32(int(i)), lanes), last));
+                    __m256d x = _mm256_add_pd(ox, _mm256_mul_pd(t, sx));
+                    __m256d y = _mm256_add_pd(oy, _mm256_mul_pd(t, sy));
+
+                    __m256d s = _mm256_mul_pd(skew, _mm256_add_pd(x, y));
+                    __m256d xs = _mm256_add_pd(x, s);
+                    __m256d ys = _mm256_add_pd(y, s);
+
+                    __m256d xsf = _mm256_cvtepi32_pd(_mm256_cvttpd_epi32(xs));
+                    __m256d ysf = _mm256_cvtepi32_pd(_mm256_cvttpd_epi32(ys));
+                    xsf = _mm256_sub_pd(xsf, _mm256_and_pd(_mm256_cmp_pd(xs, xsf, _CMP_LT_OQ), one));
+                    ysf = _mm256_sub_pd(ysf, _mm256_and_pd(_mm256_cmp_pd(ys, ysf, _CMP_LT_OQ), one));
+                    __m128i xsb = _mm256_cvttpd_epi32(xsf);
+                    __m128i ysb = _mm256_cvttpd_epi32(ysf);
+                    __m256d xsi = _mm256_sub_pd(xs, xsf);
+                    __m256d ysi = _mm256_sub_pd(ys, ysf);
+
+                    __m128i ai = _mm256_cvttpd_epi32(_mm256_add_pd(xsi, ysi));
+                    __m256d ah = _mm256_mul_pd(_mm256_cvtepi32_pd(ai), half);
+                    __m128i bx = _mm256_cvttpd_epi32(_mm256_sub_pd(_mm256_add_pd(_mm256_sub_pd(xsi, _mm256_mul_pd(ysi, half)), one), ah));
+                    __m128i by = _mm256_cvttpd_epi32(_mm256_sub_pd(_mm256_add_pd(_mm256_sub_pd(ysi, _mm256_mul_pd(xsi, half)), one), ah));
+                    __m128i index = _mm_or_si128(_mm_slli_epi32(ai, 2), _mm_or_si128(_mm_slli_epi32(bx, 3), _mm_slli_epi32(by, 4)));
+
+                    __m256d ssi = _mm256_mul_pd(_mm256_xor_pd(_mm256_add_pd(xsi, ysi), sign), unskew);
+                    __m256d xi = _mm256_add_pd(xsi, ssi);
+                    __m256d yi = _mm256_add_pd(ysi, ssi);
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(state[0]), xsb);
+                    _mm_store_si128(reinterpret_cast<__m128i*>(state[1]), ysb);
+                    _mm_store_si128(reinterpret_cast<__m128i*>(state[2]), index);
+
+                    __m256d value = zero;
+                    int pending = 0xf;
+
+                    while (pending != 0) {
+
+                        int j = 0;
+                        while ((pending & (1 << j)) == 0)
+                            ++j;
+
+                        if (state[0][j] != cell[0] || state[1][j] != cell[1] || state[2][j] != cell[2]) {
+                            for (int k = 0; k < 3; ++k)
+                                cell[k] = state[k][j];
+                            scan.prepare(scan.noise, cell, data);
+                        }
+
+                        __m128i same = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi32(xsb, _mm_set1_epi32(cell[0])),
+                            _mm_cmpeq_epi32(ysb, _mm_set1_epi32(cell[1]))), _mm_cmpeq_epi32(index, _mm_set1_epi32(cell[2])));
+                        __m256d match = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(same));
+                        __m256d part = zero;
+
+                        for (int k = 0; k < 4; ++k) {
+                            const double* d = data + 4 * k;
+                            __m256d dx = _mm256_add_pd(xi, _mm256_set1_pd(d[0]));
+                            __m256d dy = _mm256_add_pd(yi, _mm256_set1_pd(d[1]));
+                            __m256d attn = _mm256_sub_pd(_mm256_sub_pd(radius, _mm256_mul_pd(dx, dx)), _mm256_mul_pd(dy, dy));
+                            __m256d mask = _mm256_cmp_pd(attn, zero, _CMP_GT_OQ);
+                            __m256d extrapolation = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(d[2]), dx),
+                                _mm256_mul_pd(_mm256_set1_pd(d[3]), dy));
+                            attn = _mm256_mul_pd(attn, attn);
+                            part = _mm256_add_pd(part, _mm256_and_pd(mask, _mm256_mul_pd(_mm256_mul_pd(attn, attn), extrapolation)));
+                        }
+
+                        value = _mm256_blendv_pd(value, part, match);
+                        pending &= ~ _mm256_movemask_pd(match);
+
+                    }
+
+                    if (i + 4 <= n) {
+                        _mm256_storeu_pd(values + i, value);
+                    } else {
+                        alignas(32) double tail[4];
+                        _mm256_store_pd(tail, value);
+                        std::copy_n(tail, n - i, values + i);
+                    }
+
+                }
+
+                return n;
+
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t noise3f_scanline_avx2(const NoiseScanline<float, 3>& scan, float* values, size_t n) noexcept {
+
+                const __m256 rotate = _mm256_set1_ps(noise3_rotate);
+                const __m256 radius = _mm256_set1_ps(noise3_radius);
+                const __m256 zero = _mm256_setzero_ps();
+                const __m256 half = _mm256_set1_ps(0.5f);
+                const __m256 ones = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+                const __m256 ox = _mm256_set1_ps(scan.origin.x());
+                const __m256 oy = _mm256_set1_ps(scan.origin.y());
+                const __m256 oz = _mm256_set1_ps(scan.origin.z());
+                const __m256 sx = _mm256_set1_ps(scan.step.x());
+                const __m256 sy = _mm256_set1_ps(scan.step.y());
+                const __m256 sz = _mm256_set1_ps(scan.step.z());
+                const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+                alignas(32) int state[4][8];
+                int cell[4] = {0, 0, 0, -1};
+                float data[6 * lattice3_stride];
+                size_t i = 0;
+                n = std::min(n, scanline_limit);
+                const __m256i last = _mm256_set1_epi32(int(n) - 1);
+
+                for (; i < n; i += 8) {
+
+                    __m256 t = _mm256_cvtepi32_ps(_mm256_min_epi32(_mm256_add_epi32(_mm256_set1_epi32(int(i)), lanes), last));
+                    __m256 x = _mm256_add_ps(ox, _mm256_mul_ps(t, sx));
+                    __m256 y = _mm256_add_ps(oy, _mm256_mul_ps(t, sy));
+                    __m256 z = _mm256_add_ps(oz, _mm256_mul_ps(t, sz));
+
+                    __m256 r = _mm256_mul_ps(rotate, _mm256_add_ps(_mm256_add_ps(x, y), z));
+                    __m256 xr = _mm256_sub_ps(r, x);
+                    __m256 yr = _mm256_sub_ps(r, y);
+                    __m256 zr = _mm256_sub_ps(r, z);
+
+                    __m256i xrb = _mm256_cvttps_epi32(xr);
+                    __m256i yrb = _mm256_cvttps_epi32(yr);
+                    __m256i zrb = _mm256_cvttps_epi32(zr);
+                    xrb = _mm256_add_epi32(xrb, _mm256_castps_si256(_mm256_cmp_ps(xr, _mm256_cvtepi32_ps(xrb), _CMP_LT_OQ)));
+                    yrb = _mm256_add_epi32(yrb, _mm256_castps_si256(_mm256_cmp_ps(yr, _mm256_cvtepi32_ps(yrb), _CMP_LT_OQ)));
+                    zrb = _mm256_add_epi32(zrb, _mm256_castps_si256(_mm256_cmp_ps(zr, _mm256_cvtepi32_ps(zrb), _CMP_LT_OQ)));
+                    __m256 xri = _mm256_sub_ps(xr, _mm256_cvtepi32_ps(xrb));
+                    __m256 yri = _mm256_sub_ps(yr, _mm256_cvtepi32_ps(yrb));
+                    __m256 zri = _mm256_sub_ps(zr, _mm256_cvtepi32_ps(zrb));
+
+                    __m256i xht = _mm256_cvttps_epi32(_mm256_add_ps(xri, half));
+                    __m256i yht = _mm256_cvttps_epi32(_mm256_add_ps(yri, half));
+                    __m256i zht = _mm256_cvttps_epi32(_mm256_add_ps(zri, half));
+                    __m256i index = _mm256_or_si256(xht, _mm256_or_si256(_mm256_slli_epi32(yht, 1), _mm256_slli_epi32(zht, 2)));
+
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(state[0]), xrb);
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(state[1]), yrb);
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(state[2]), zrb);
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(state[3]), index);
+
+                    __m256 value = zero;
+                    int pending = 0xff;
+
+                    while (pending != 0) {
+
+                        int j = 0;
+                        while ((pending & (1 << j)) == 0)
+                            ++j;
+
+                        if (state[0][j] != cell[0] || state[1][j] != cell[1] || state[2][j] != cell[2] || state[3][j] != cell[3]) {
+                            for (int k = 0; k < 4; ++k)
+                                cell[k] = state[k][j];
+                            scan.prepare(scan.noise, cell, data);
+                        }
+
+                        __m256i same = _mm256_and_si256(_mm256_and_si256(_mm256_cmpeq_epi32(xrb, _mm256_set1_epi32(cell[0])),
+                            _mm256_cmpeq_epi32(yrb, _mm256_set1_epi32(cell[1]))), _mm256_and_si256(
+                            _mm256_cmpeq_epi32(zrb, _mm256_set1_epi32(cell[2])), _mm256_cmpeq_epi32(index, _mm256_set1_epi32(cell[3]))));
+                        __m256 match = _mm256_castsi256_ps(same);
+                        __m256 part = zero;
+                        __m256 okb = zero;
+                        __m256 okb2 = zero;
+
+                        for (int k = 0; k < lattice3_stride; ++k) {
+
+                            const float* d = data + 6 * k;
+                            __m256 dx = _mm256_add_ps(xri, _mm256_set1_ps(d[0]));
+                            __m256 dy = _mm256_add_ps(yri, _mm256_set1_ps(d[1]));
+                            __m256 dz = _mm256_add_ps(zri, _mm256_set1_ps(d[2]));
+                            __m256 attn = _mm256_sub_ps(_mm256_sub_ps(_mm256_sub_ps(radius, _mm256_mul_ps(dx, dx)),
+                                _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+                            __m256 ok = _mm256_cmp_ps(attn, zero, _CMP_NLT_UQ);
+                            __m256 mask = ok;
+
+                            switch (noise3_role[k]) {
+                                case 1:  okb = ok; break;
+                                case 2:  mask = _mm256_andnot_ps(okb, ok); break;
+                                case 3:  mask = _mm256_andnot_ps(okb, ok); okb2 = ok; break;
+                                case 4:  mask = _mm256_and_ps(ok, _mm256_or_ps(okb, _mm256_andnot_ps(okb2, ones))); break;
+                                default: break;
+                            }
+
+                            __m256 extrapolation = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(d[3]), dx),
+                                _mm256_mul_ps(_mm256_set1_ps(d[4]), dy)), _mm256_mul_ps(_mm256_set1_ps(d[5]), dz));
+                            attn = _mm256_mul_ps(attn, attn);
+                            part = _mm256_add_ps(part, _mm256_and_ps(mask, _mm256_mul_ps(_mm256_mul_ps(attn, attn), extrapolation)));
+
+                        }
+
+                        value = _mm256_blendv_ps(value, part, match);
+                        pending &= ~ _mm256_movemask_ps(match);
+
+                    }
+
+                    if (i + 8 <= n) {
+                        _mm256_storeu_ps(values + i, value);
+                    } else {
+                        alignas(32) float tail[8];
+                        _mm256_store_ps(tail, value);
+                        std::copy_n(tail, n - i, values + i);
+                    }
+
+                }
+
+                return n;
+
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t noise3d_scanline_avx2(const NoiseScanline<double, 3>& scan, double* values, size_t n) noexcept {
+
+                const __m256d rotate = _mm256_set1_pd(2.0 / 3.0);
+                const __m256d radius = _mm256_set1_pd(0.75);
+                const __m256d zero = _mm256_setzero_pd();
+                const __m256d half = _mm256_set1_pd(0.5);
+                const __m256d one = _mm256_set1_pd(1.0);
+                const __m256d ones = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+                const __m256d ox = _mm256_set1_pd(scan.origin.x());
+                const __m256d oy = _mm256_set1_pd(scan.origin.y());
+                const __m256d oz = _mm256_set1_pd(scan.origin.z());
+                const __m256d sx = _mm256_set1_pd(scan.step.x());
+                const __m256d sy = _mm256_set1_pd(scan.step.y());
+                const __m256d sz = _mm256_set1_pd(scan.step.z());
+                const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+
+                alignas(16) int state[4][4];
+                int cell[4] = {0, 0, 0, -1};
+                double data[6 * lattice3_stride];
+                size_t i = 0;
+                n = std::min(n, scanline_limit);
+                const __m128i last = _mm_set1_epi32(int(n) - 1);
+
+                for (; i < n; i += 4) {
+
+                    __m256d t = _mm256_cvtepi32_pd(_mm_min_epi32(_mm_add_epi32(_mm_set1_epi32(int(i)), lanes), last));
+                    __m256d x = _mm256_add_pd(ox, _mm256_mul_pd(t, sx));
+                    __m256d y = _mm256_add_pd(oy, _mm256_mul_pd(t, sy));
+                    __m256d z = _mm256_add_pd(oz, _mm256_mul_pd(t, sz));
+
+                    __m256d r = _mm256_mul_pd(rotate, _mm256_add_pd(_mm256_add_pd(x, y), z));
+                    __m256d xr = _mm256_sub_pd(r, x);
+                    __m256d yr = _mm256_sub_pd(r, y);
+                    __m256d zr = _mm256_sub_pd(r, z);
+
+                    __m256d xrf = _mm256_cvtepi32_pd(_mm256_cvttpd_epi32(xr));
+                    __m256d yrf = _mm256_cvtepi32_pd(_mm256_cvttpd_epi32(yr));
+                    __m256d zrf = _mm256_cvtepi32_pd(_mm256_cvttpd_epi32(zr));
+                    xrf = _mm256_sub_pd(xrf, _mm256_and_pd(_mm256_cmp_pd(xr, xrf, _CMP_LT_OQ), one));
+                    yrf = _mm256_sub_pd(yrf, _mm256_and_pd(_mm256_cmp_pd(yr, yrf, _CMP_LT_OQ), one));
+                    zrf = _mm256_sub_pd(zrf, _mm256_and_pd(_mm256_cmp_pd(zr, zrf, _CMP_LT_OQ), one));
+                    __m128i xrb = _mm256_cvttpd_epi32(xrf);
+                    __m128i yrb = _mm256_cvttpd_epi32(yrf);
+                    __m128i zrb = _mm256_cvttpd_epi32(zrf);
+                    __m256d xri = _mm256_sub_pd(xr, xrf);
+                    __m256d yri = _mm256_sub_pd(yr, yrf);
+                    __m256d zri = _mm256_sub_pd(zr, zrf);
+
+                    __m128i xht = _mm256_cvttpd_epi32(_mm256_add_pd(xri, half));
+                    __m128i yht = _mm256_cvttpd_epi32(_mm256_add_pd(yri, half));
+                    __m128i zht = _mm256_cvttpd_epi32(_mm256_add_pd(zri, half));
+                    __m128i index = _mm_or_si128(xht, _mm_or_si128(_mm_slli_epi32(yht, 1), _mm_slli_epi32(zht, 2)));
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(state[0]), xrb);
+                    _mm_store_si128(reinterpret_cast<__m128i*>(state[1]), yrb);
+                    _mm_store_si128(reinterpret_cast<__m128i*>(state[2]), zrb);
+                    _mm_store_si128(reinterpret_cast<__m128i*>(state[3]), index);
+
+                    __m256d value = zero;
+                    int pending = 0xf;
+
+                    while (pending != 0) {
+
+                        int j = 0;
+                        while ((pending & (1 << j)) == 0)
+                            ++j;
+
+                        if (state[0][j] != cell[0] || state[1][j] != cell[1] || state[2][j] != cell[2] || state[3][j] != cell[3]) {
+                            for (int k = 0; k < 4; ++k)
+                                cell[k] = state[k][j];
+                            scan.prepare(scan.noise, cell, data);
+                        }
+
+                        __m128i same = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi32(xrb, _mm_set1_epi32(cell[0])),
+                            _mm_cmpeq_epi32(yrb, _mm_set1_epi32(cell[1]))), _mm_and_si128(
+                            _mm_cmpeq_epi32(zrb, _mm_set1_epi32(cell[2])), _mm_cmpeq_epi32(index, _mm_set1_epi32(cell[3]))));
+                        __m256d match = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(same));
+                        __m256d part = zero;
+                        __m256d okb = zero;
+                        __m256d okb2 = zero;
+
+                        for (int k = 0; k < lattice3_stride; ++k) {
+
+                            const double* d = data + 6 * k;
+                            __m256d dx = _mm256_add_pd(xri, _mm256_set1_pd(d[0]));
+                            __m256d dy = _mm256_add_pd(yri, _mm256_set1_pd(d[1]));
+                            __m256d dz = _mm256_add_pd(zri, _mm256_set1_pd(d[2]));
+                            __m256d attn = _mm256_sub_pd(_mm256_sub_pd(_mm256_sub_pd(radius, _mm256_mul_pd(dx, dx)),
+                                _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz));
+                            __m256d ok = _mm256_cmp_pd(attn, zero, _CMP_NLT_UQ);
+                            __m256d mask = ok;
+
+                            switch (noise3_role[k]) {
+                                case 1:  okb = ok; break;
+                                case 2:  mask = _mm256_andnot_pd(okb, ok); break;
+                                case 3:  mask = _mm256_andnot_pd(okb, ok); okb2 = ok; break;
+                                case 4:  mask = _mm256_and_pd(ok, _mm256_or_pd(okb, _mm256_andnot_pd(okb2, ones))); break;
+                                default: break;
+                            }
+
+                            __m256d extrapolation = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(d[3]), dx),
+                                _mm256_mul_pd(_mm256_set1_pd(d[4]), dy)), _mm256_mul_pd(_mm256_set1_pd(d[5]), dz));
+                            attn = _mm256_mul_pd(attn, attn);
+                            part = _mm256_add_pd(part, _mm256_and_pd(mask, _mm256_mul_pd(_mm256_mul_pd(attn, attn), extrapolation)));
+
+                        }
+
+                        value = _mm256_blendv_pd(value, part, match);
+                        pending &= ~ _mm256_movemask_pd(match);
+
+                    }
+
+                    if (i + 4 <= n) {
+                        _mm256_storeu_pd(values + i, value);
+                    } else {
+                        alignas(32) double tail[4];
+                        _mm256_store_pd(tail, value);
+                        std::copy_n(tail, n - i, values + i);
+                    }
+
+                }
+
+                return n;
+
+            }
+
+        #endif
+
+    }
+
+    size_t noise2f_simd(const NoiseSimdTables& tables, const Float2* points, float* values, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  return simd_padded<16>(points, 1, values, 1, n, [&] (const Float2* p, float* q, size_t m) {
+                                             return noise2f_avx512(tables, p, q, m);
+                                         });
+                case SimdLevel::avx2:    return simd_padded<8>(points, 1, values, 1, n, [&] (const Float2* p, float* q, size_t m) {
+                                             return noise2f_avx2(tables, p, q, m);
+                                         });
+                case SimdLevel::sse2:    return simd_padded<4>(points, 1, values, 1, n, [&] (const Float2* p, float* q, size_t m) {
+                                             return noise2f_sse2(tables, p, q, m);
+                                         });
+                default:                 break;
+            }
+        #else
+            (void)tables;
+            (void)points;
+            (void)values;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t noise3f_simd(const NoiseSimdTables& tables, const Float3* points, float* values, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  return simd_padded<16>(points, 1, values, 1, n, [&] (const Float3* p, float* q, size_t m) {
+                                             return noise3f_avx512(tables, p, q, m);
+                                         });
+                case SimdLevel::avx2:    return simd_padded<8>(points, 1, values, 1, n, [&] (const Float3* p, float* q, size_t m) {
+                                             return noise3f_avx2(tables, p, q, m);
+                                         });
+                case SimdLevel::sse2:    return simd_padded<4>(points, 1, values, 1, n, [&] (const Float3* p, float* q, size_t m) {
+                                             return noise3f_sse2(tables, p, q, m);
+                                         });
+                default:                 break;
+            }
+        #else
+            (void)tables;
+            (void)points;
+            (void)values;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t noise2f_scanline_simd(const NoiseScanline<float, 2>& scan, float* values, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return noise2f_scanline_avx2(scan, values, n);
+                default:                 break;
+            }
+        #else
+            (void)scan;
+            (void)values;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t noise2d_scanline_simd(const NoiseScanline<double, 2>& scan, double* values, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return noise2d_scanline_avx2(scan, values, n);
+                default:                 break;
+            }
+        #else
+            (void)scan;
+            (void)values;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t noise3f_scanline_simd(const NoiseScanline<float, 3>& scan, float* values, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return noise3f_scanline_avx2(scan, values, n);
+                default:                 break;
+            }
+        #else
+            (void)scan;
+            (void)values;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t noise3d_scanline_simd(const NoiseScanline<double, 3>& scan, double* values, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return noise3d_scanline_avx2(scan, values, n);
+                default:                 break;
+            }
+        #else
+            (void)scan;
+            (void)values;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+}
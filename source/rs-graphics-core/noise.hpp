@@ -1,15 +1,31 @@
 #pragma once
 
+#include "rs-graphics-core/geometry.hpp"
 #include "rs-graphics-core/maths.hpp"
+#include "rs-graphics-core/multi-array.hpp"
+#include "rs-graphics-core/parallel.hpp"
+#include "rs-graphics-core/simd.hpp"
 #include "rs-graphics-core/vector.hpp"
+#include "rs-tl/enum.hpp"
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace RS::Graphics::Core {
 
+    RS_DEFINE_ENUM_CLASS(NoiseLayout, int, 0, standard, compact)
+    RS_DEFINE_ENUM_CLASS(NoiseSeeding, int, 0, standard, fast)
+
     namespace Detail {
 
         template <typename T>
@@ -26,16 +42,92 @@ namespace RS::Graphics::Core {
             return x * 3'935'559'000'370'003'845ull + 8'831'144'850'135'198'739ull;
         }
 
+        constexpr int noise_psize = 2048;
+
+        // Fisher-Yates shuffle of 0..2047 driven by a 64-bit LCG, calling
+        // f(i,p) as each element is placed. The standard mode reduces each
+        // step with a 64-bit modulo; the fast mode takes a bounded value from
+        // the high bits by multiply and shift, which gives a different (but
+        // equally reproducible) permutation.
+
+        template <typename F>
+        void noise_shuffle(uint64_t s, NoiseSeeding mode, F f) noexcept {
+
+            int source[noise_psize];
+
+            for (int i = 0; i < noise_psize; ++i)
+                source[i] = i;
+
+            if (mode == NoiseSeeding::fast) {
+                for (int i = noise_psize - 1; i >= 0; --i) {
+                    s = lcg64_1(s);
+                    int r = int(((s >> 32) * uint64_t(i + 1)) >> 32);
+                    f(i, source[r]);
+                    source[r] = source[i];
+                }
+            } else {
+                for (int i = noise_psize - 1; i >= 0; --i) {
+                    s = lcg64_1(s);
+                    int r = int((s + 31) % uint64_t(i + 1));
+                    f(i, source[r]);
+                    source[r] = source[i];
+                }
+            }
+
+        }
+
+        template <typename T> constexpr T noise2_skew = T(0.366'025'403'8);
+        template <typename T> constexpr T noise2_unskew = T(0.211'324'865'4);
+
+        // Vectorised kernels for single precision noise (see noise.cpp).
+        // These return the number of points evaluated: all of them if a
+        // kernel is available at the current SIMD level, otherwise zero.
+
+        // In the compact layout, perm holds {uint16_t perm, grad} pairs and
+        // grads is the shared gradient set; otherwise grads is indexed by the
+        // permuted index directly.
+
+        struct NoiseSimdTables {
+            const int* perm;
+            const float* grads;
+            const void* lattice;
+            bool compact;
+        };
+
+        size_t noise2f_simd(const NoiseSimdTables& tables, const Float2* points, float* values, size_t n) noexcept;
+        size_t noise3f_simd(const NoiseSimdTables& tables, const Float3* points, float* values, size_t n) noexcept;
+
+        // Scanline kernels (see noise.cpp), evaluating origin+i*step for i
+        // in [0,n). These locate each point themselves, and call prepare()
+        // whenever a point falls in a different cell state {xb,yb,[zb,]index}
+        // from the last one, to fetch the candidate lattice points for that
+        // state as {dx,dy,[dz,]gx,gy,[gz]} (offset and gradient) for each,
+        // in lattice table order.
+
+        template <typename T, int N>
+        struct NoiseScanline {
+            Vector<T, N> origin;
+            Vector<T, N> step;
+            const void* noise;
+            void (*prepare)(const void* noise, const int* cell, T* data) noexcept;
+        };
+
+        size_t noise2f_scanline_simd(const NoiseScanline<float, 2>& scan, float* values, size_t n) noexcept;
+        size_t noise2d_scanline_simd(const NoiseScanline<double, 2>& scan, double* values, size_t n) noexcept;
+        size_t noise3f_scanline_simd(const NoiseScanline<float, 3>& scan, float* values, size_t n) noexcept;
+        size_t noise3d_scanline_simd(const NoiseScanline<double, 3>& scan, double* values, size_t n) noexcept;
+
     }
 
     // Noise class template
 
-    template <typename T, int N> class Noise;
+    template <typename T, int N, NoiseLayout L = NoiseLayout::standard> class Noise;
+    template <typename T, int DimIn, int DimOut, NoiseLayout L = NoiseLayout::standard> class NoiseSource;
 
     // 2D noise
 
-    template <typename T>
-    class Noise<T, 2> {
+    template <typename T, NoiseLayout L>
+    class Noise<T, 2, L> {
 
     public:
 
@@ -46,25 +138,56 @@ namespace RS::Graphics::Core {
         using vector_type = Vector<T, 2>;
 
         static constexpr int dim = 2;
+        static constexpr NoiseLayout layout = L;
 
         Noise() = default;
-        explicit Noise(uint64_t s) noexcept { seed(s); }
+        explicit Noise(uint64_t s, NoiseSeeding mode = NoiseSeeding::standard) noexcept { seed(s, mode); }
 
         T operator()(const vector_type& point) const noexcept;
-        void seed(uint64_t s) noexcept;
+        std::pair<T, vector_type> eval_with_gradient(const vector_type& point) const noexcept;
+        void batch(const vector_type* points, T* values, size_t n) const noexcept;
+        void scanline(const vector_type& origin, const vector_type& step, T* values, size_t n) const noexcept;
+        void seed(uint64_t s, NoiseSeeding mode = NoiseSeeding::standard) noexcept;
 
     private:
 
-        static constexpr int psize = 2048;
+        template <typename U, int DimIn, int DimOut, NoiseLayout M> friend class NoiseSource;
+
+        static constexpr int psize = Detail::noise_psize;
         static constexpr int pmask = psize - 1;
-        static constexpr T scale1 = T(0.366'025'403'8);
-        static constexpr T scale2 = T(0.211'324'865'4);
+        static constexpr T scale1 = Detail::noise2_skew<T>;
+        static constexpr T scale2 = Detail::noise2_unskew<T>;
+
+        static constexpr int ngrads = 24;
 
         struct grad { T dx, dy; };
 
-        struct grad_table {
-            std::array<grad, psize> grads;
-            grad_table() noexcept;
+        static constexpr bool compact = L == NoiseLayout::compact;
+
+        // In the compact layout each permutation entry also holds the index
+        // of its gradient in the shared set (perm % ngrads); in the standard
+        // layout the gradients are copied into a second table
+
+        struct compact_entry { uint16_t perm, grad; };
+
+        using perm_type = std::conditional_t<compact, compact_entry, int>;
+
+        template <int Size> struct standard_tables { std::array<int, Size> perm; std::array<grad, Size> grads; };
+        template <int Size> struct compact_tables { std::array<compact_entry, Size> perm; };
+        template <int Size> using table_storage = std::conditional_t<compact, compact_tables<Size>, standard_tables<Size>>;
+
+        // Table contents for each permutation value, built once so that
+        // seeding needs no arithmetic beyond the shuffle
+
+        using seed_entry = std::conditional_t<compact, compact_entry, grad>;
+        using seed_table_type = std::array<seed_entry, psize>;
+
+        struct table_ref {
+            const perm_type* perm;
+            const grad* grads;
+            int stride;
+            int index(int i) const noexcept;
+            const grad& gradient(int i) const noexcept;
         };
 
         struct lattice_point {
@@ -89,78 +212,250 @@ namespace RS::Graphics::Core {
             lattice_table() noexcept;
         };
 
-        std::array<int, psize> perm_;
-        std::array<grad, psize> grads_;
+        struct cell_state {
+            int xsb, ysb, index;
+            T xi, yi;
+        };
+
+        table_storage<psize> tables_;
+
+        table_ref table() const noexcept { return make_table_ref(tables_, 0, 1); }
+
+        T evaluate(const vector_type& point, const lattice_table& lut) const noexcept;
+
+        static T accumulate(const cell_state& cell, const lattice_table& lut, table_ref table) noexcept;
+        static void accumulate_batch(table_ref table, const lattice_table& lut, const vector_type* points, T* values,
+            size_t n) noexcept;
+        static T accumulate_gradient(const cell_state& cell, const lattice_table& lut, table_ref table, vector_type& derivative) noexcept;
+        static const grad& gradient(const cell_state& cell, const lattice_point& c, table_ref table) noexcept;
+        static const grad* gradient_set() noexcept;
+        static const lattice_table& lattice() noexcept;
+        static const seed_table_type& seed_table() noexcept;
+        static cell_state locate(const vector_type& point) noexcept;
+        static void scanline_prepare(const void* noise, const int* cell, T* data) noexcept;
+
+        template <typename Tables>
+        static table_ref make_table_ref(const Tables& tables, int offset, int stride) noexcept {
+            if constexpr (compact)
+                return {tables.perm.data() + offset, nullptr, stride};
+            else
+                return {tables.perm.data() + offset, tables.grads.data() + offset, stride};
+        }
 
     };
 
-        template <typename T>
-        void Noise<T, 2>::seed(uint64_t s) noexcept {
+        template <typename T, NoiseLayout L>
+        void Noise<T, 2, L>::seed(uint64_t s, NoiseSeeding mode) noexcept {
+            auto& entries = seed_table();
+            Detail::noise_shuffle(s, mode, [this,&entries] (int i, int p) {
+                if constexpr (compact) {
+                    tables_.perm[i] = entries[p];
+                } else {
+                    tables_.perm[i] = p;
+                    tables_.grads[i] = entries[p];
+                }
+            });
+        }
 
-            using namespace Detail;
+        template <typename T, NoiseLayout L>
+        T Noise<T, 2, L>::operator()(const vector_type& point) const noexcept {
+            return evaluate(point, lattice());
+        }
 
-            static const grad_table gtable;
+        template <typename T, NoiseLayout L>
+        std::pair<T, typename Noise<T, 2, L>::vector_type> Noise<T, 2, L>::eval_with_gradient(const vector_type& point) const noexcept {
+            std::pair<T, vector_type> result;
+            result.first = accumulate_gradient(locate(point), lattice(), table(), result.second);
+            return result;
+        }
 
-            int source[psize];
+        template <typename T, NoiseLayout L>
+        void Noise<T, 2, L>::batch(const vector_type* points, T* values, size_t n) const noexcept {
+            accumulate_batch(table(), lattice(), points, values, n);
+        }
 
-            for (int i = 0; i < psize; i++)
-                source[i] = i;
+        template <typename T, NoiseLayout L>
+        void Noise<T, 2, L>::scanline(const vector_type& origin, const vector_type& step, T* values, size_t n) const noexcept {
 
-            for (int i = psize - 1; i >= 0; i--) {
-                s = lcg64_1(s);
-                int r = int((s + 31) % (i + 1));
-                perm_[i] = source[r];
-                grads_[i] = gtable.grads[perm_[i]];
-                source[r] = source[i];
+            // Rows go through the scanline kernels where available; failing
+            // that, single precision rows are faster through the batch kernels
+
+            size_t i = 0;
+
+            if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+                Detail::NoiseScanline<T, 2> scan = {origin, step, this, &scanline_prepare};
+                if constexpr (std::is_same_v<T, float>)
+                    i = Detail::noise2f_scanline_simd(scan, values, n);
+                else
+                    i = Detail::noise2d_scanline_simd(scan, values, n);
+            }
+
+            if constexpr (std::is_same_v<T, float>) {
+                if (i == 0 && simd_level() != SimdLevel::none) {
+                    static constexpr size_t chunk = 256;
+                    vector_type points[chunk];
+                    for (; i < n; i += chunk) {
+                        size_t m = std::min(chunk, n - i);
+                        for (size_t j = 0; j < m; ++j)
+                            points[j] = origin + T(i + j) * step;
+                        batch(points, values + i, m);
+                    }
+                    return;
+                }
             }
 
-            (*this)(vector_type(T(0)));
+            const auto& lut = lattice();
+            cell_state current = {0, 0, -1, T(0), T(0)};
+            grad grads[4];
+
+            for (; i < n; ++i) {
+
+                auto cell = locate(origin + T(i) * step);
+
+                if (cell.index != current.index || cell.xsb != current.xsb || cell.ysb != current.ysb)
+                    for (int j = 0; j < 4; ++j)
+                        grads[j] = gradient(cell, lut.points[cell.index + j], table());
+
+                current = cell;
+                T value = T(0);
+
+                for (int j = 0; j < 4; ++j) {
+
+                    auto& c = lut.points[cell.index + j];
+
+                    T dx = cell.xi + c.dx;
+                    T dy = cell.yi + c.dy;
+                    T attn = T(2) / T(3) - dx * dx - dy * dy;
+
+                    if (attn > 0) {
+                        auto& g = grads[j];
+                        T extrapolation = g.dx * dx + g.dy * dy;
+                        attn *= attn;
+                        value += attn * attn * extrapolation;
+                    }
+
+                }
+
+                values[i] = value;
+
+            }
 
         }
 
-        template <typename T>
-        T Noise<T, 2>::operator()(const vector_type& point) const noexcept {
+        template <typename T, NoiseLayout L>
+        void Noise<T, 2, L>::scanline_prepare(const void* noise, const int* cell, T* data) noexcept {
+            auto table = static_cast<const Noise*>(noise)->table();
+            const auto& lut = lattice();
+            cell_state state = {cell[0], cell[1], cell[2], T(0), T(0)};
+            for (int j = 0; j < 4; ++j) {
+                auto& c = lut.points[state.index + j];
+                auto& g = gradient(state, c, table);
+                T* d = data + 4 * j;
+                d[0] = c.dx;
+                d[1] = c.dy;
+                d[2] = g.dx;
+                d[3] = g.dy;
+            }
+        }
 
-            using namespace Detail;
+        template <typename T, NoiseLayout L>
+        T Noise<T, 2, L>::evaluate(const vector_type& point, const lattice_table& lut) const noexcept {
+            return accumulate(locate(point), lut, table());
+        }
 
-            static const lattice_table lut;
+        template <typename T, NoiseLayout L>
+        int Noise<T, 2, L>::table_ref::index(int i) const noexcept {
+            if constexpr (compact)
+                return perm[stride * i].perm;
+            else
+                return perm[stride * i];
+        }
 
-            T s = scale1 * (point.x() + point.y());
-            T xs = point.x() + s;
-            T ys = point.y() + s;
-            T value = T(0);
+        template <typename T, NoiseLayout L>
+        const typename Noise<T, 2, L>::grad& Noise<T, 2, L>::table_ref::gradient(int i) const noexcept {
+            if constexpr (compact)
+                return gradient_set()[perm[stride * i].grad];
+            else
+                return grads[stride * i];
+        }
 
-            int xsb = fast_floor(xs);
-            int ysb = fast_floor(ys);
-            T xsi = xs - T(xsb);
-            T ysi = ys - T(ysb);
-            int a = int(xsi + ysi);
+        // The vector kernels need the table for a single noise function,
+        // with no interleaving
+
+        template <typename T, NoiseLayout L>
+        void Noise<T, 2, L>::accumulate_batch(table_ref table, const lattice_table& lut, const vector_type* points,
+                T* values, size_t n) noexcept {
+            size_t i = 0;
+            if constexpr (std::is_same_v<T, float>) {
+                static_assert(sizeof(lattice_point) == 4 * sizeof(int));
+                static_assert(sizeof(grad) == 2 * sizeof(float));
+                static_assert(sizeof(perm_type) == sizeof(int));
+                if (table.stride == 1) {
+                    auto grads = compact ? gradient_set() : table.grads;
+                    Detail::NoiseSimdTables tables = {reinterpret_cast<const int*>(table.perm),
+                        reinterpret_cast<const float*>(grads), lut.points.data(), compact};
+                    i = Detail::noise2f_simd(tables, points, values, n);
+                }
+            }
+            for (; i < n; ++i)
+                values[i] = accumulate(locate(points[i]), lut, table);
+        }
 
-            int index = (a << 2)
-                | (int(xsi - ysi / 2 + 1 - T(a) / 2) << 3)
-                | (int(ysi - xsi / 2 + 1 - T(a) / 2) << 4);
+        template <typename T, NoiseLayout L>
+        T Noise<T, 2, L>::accumulate(const cell_state& cell, const lattice_table& lut, table_ref table) noexcept {
 
-            T ssi = - (xsi + ysi) * scale2;
-            T xi = xsi + ssi, yi = ysi + ssi;
+            T value = T(0);
 
             for (int i = 0; i < 4; i++) {
 
-                auto& c = lut.points[index + i];
+                auto& c = lut.points[cell.index + i];
 
-                T dx = xi + c.dx;
-                T dy = yi + c.dy;
+                T dx = cell.xi + c.dx;
+                T dy = cell.yi + c.dy;
                 T attn = T(2) / T(3) - dx * dx - dy * dy;
 
                 if (attn > 0) {
-
-                    int pxm = (xsb + c.xsv) & pmask;
-                    int pym = (ysb + c.ysv) & pmask;
-
-                    grad g = grads_[perm_[pxm] ^ pym];
+                    auto& g = gradient(cell, c, table);
                     T extrapolation = g.dx * dx + g.dy * dy;
                     attn *= attn;
                     value += attn * attn * extrapolation;
+                }
+
+            }
 
+            return value;
+
+        }
+
+        template <typename T, NoiseLayout L>
+        T Noise<T, 2, L>::accumulate_gradient(const cell_state& cell, const lattice_table& lut, table_ref table,
+                vector_type& derivative) noexcept {
+
+            // Each contribution is attn^4*(g.d), where attn = 2/3-|d|^2 and d is
+            // the offset from the lattice point, so its derivative with respect
+            // to d is attn^4*g-8*attn^3*(g.d)*d. The skew and unskew transforms
+            // cancel, so this is also the derivative with respect to the point.
+
+            T value = T(0);
+            derivative = vector_type();
+
+            for (int i = 0; i < 4; i++) {
+
+                auto& c = lut.points[cell.index + i];
+
+                T dx = cell.xi + c.dx;
+                T dy = cell.yi + c.dy;
+                T attn = T(2) / T(3) - dx * dx - dy * dy;
+
+                if (attn > 0) {
+                    auto& g = gradient(cell, c, table);
+                    T extrapolation = g.dx * dx + g.dy * dy;
+                    T attn2 = attn * attn;
+                    T attn4 = attn2 * attn2;
+                    T k = T(8) * attn2 * attn * extrapolation;
+                    value += attn4 * extrapolation;
+                    derivative.x() += attn4 * g.dx - k * dx;
+                    derivative.y() += attn4 * g.dy - k * dy;
                 }
 
             }
@@ -169,10 +464,45 @@ namespace RS::Graphics::Core {
 
         }
 
-        template <typename T>
-        Noise<T, 2>::grad_table::grad_table() noexcept {
+        template <typename T, NoiseLayout L>
+        const typename Noise<T, 2, L>::grad& Noise<T, 2, L>::gradient(const cell_state& cell, const lattice_point& c,
+                table_ref table) noexcept {
+            int pxm = (cell.xsb + c.xsv) & pmask;
+            int pym = (cell.ysb + c.ysv) & pmask;
+            return table.gradient(table.index(pxm) ^ pym);
+        }
+
+        template <typename T, NoiseLayout L>
+        typename Noise<T, 2, L>::cell_state Noise<T, 2, L>::locate(const vector_type& point) noexcept {
+
+            using namespace Detail;
+
+            T s = scale1 * (point.x() + point.y());
+            T xs = point.x() + s;
+            T ys = point.y() + s;
+
+            cell_state cell;
+            cell.xsb = fast_floor(xs);
+            cell.ysb = fast_floor(ys);
+            T xsi = xs - T(cell.xsb);
+            T ysi = ys - T(cell.ysb);
+            int a = int(xsi + ysi);
+
+            cell.index = (a << 2)
+                | (int(xsi - ysi / 2 + 1 - T(a) / 2) << 3)
+                | (int(ysi - xsi / 2 + 1 - T(a) / 2) << 4);
+
+            T ssi = - (xsi + ysi) * scale2;
+            cell.xi = xsi + ssi;
+            cell.yi = ysi + ssi;
+
+            return cell;
+
+        }
+
+        template <typename T, NoiseLayout L>
+        const typename Noise<T, 2, L>::grad* Noise<T, 2, L>::gradient_set() noexcept {
 
-            static constexpr int n = 24;
             static constexpr T g1 = T(2.381'053'830);
             static constexpr T g2 = T(6.980'896'609);
             static constexpr T g3 = T(11.105'002'818);
@@ -180,20 +510,43 @@ namespace RS::Graphics::Core {
             static constexpr T g5 = T(16.853'375'269);
             static constexpr T g6 = T(18.085'899'427);
 
-            grad table[n] = {
+            static constexpr grad set[ngrads] = {
                 { + g1, + g6 }, { + g2, + g5 }, { + g3, + g4 }, { + g4, + g3 }, { + g5, + g2 }, { + g6, + g1 },
                 { + g6, - g1 }, { + g5, - g2 }, { + g4, - g3 }, { + g3, - g4 }, { + g2, - g5 }, { + g1, - g6 },
                 { - g1, - g6 }, { - g2, - g5 }, { - g3, - g4 }, { - g4, - g3 }, { - g5, - g2 }, { - g6, - g1 },
                 { - g6, + g1 }, { - g5, + g2 }, { - g4, + g3 }, { - g3, + g4 }, { - g2, + g5 }, { - g1, + g6 },
             };
 
-            for (int i = 0; i < psize; i++)
-                grads[i] = table[i % n];
+            return set;
 
         }
 
-        template <typename T>
-        Noise<T, 2>::lattice_table::lattice_table() noexcept {
+        template <typename T, NoiseLayout L>
+        const typename Noise<T, 2, L>::lattice_table& Noise<T, 2, L>::lattice() noexcept {
+            static const lattice_table lut;
+            return lut;
+        }
+
+        template <typename T, NoiseLayout L>
+        const typename Noise<T, 2, L>::seed_table_type& Noise<T, 2, L>::seed_table() noexcept {
+
+            static const seed_table_type table = [] {
+                seed_table_type t;
+                for (int p = 0; p < psize; ++p) {
+                    if constexpr (compact)
+                        t[p] = {uint16_t(p), uint16_t(p % ngrads)};
+                    else
+                        t[p] = gradient_set()[p % ngrads];
+                }
+                return t;
+            }();
+
+            return table;
+
+        }
+
+        template <typename T, NoiseLayout L>
+        Noise<T, 2, L>::lattice_table::lattice_table() noexcept {
 
             int i1, j1, i2, j2;
 
@@ -242,8 +595,8 @@ namespace RS::Graphics::Core {
 
     // 3D noise
 
-    template <typename T>
-    class Noise<T, 3> {
+    template <typename T, NoiseLayout L>
+    class Noise<T, 3, L> {
 
     public:
 
@@ -254,20 +607,56 @@ namespace RS::Graphics::Core {
         using vector_type = Vector<T, 3>;
 
         static constexpr int dim = 3;
+        static constexpr NoiseLayout layout = L;
 
         Noise() = default;
-        explicit Noise(uint64_t s) noexcept { seed(s); }
+        explicit Noise(uint64_t s, NoiseSeeding mode = NoiseSeeding::standard) noexcept { seed(s, mode); }
 
         T operator()(const vector_type& point) const noexcept;
-        void seed(uint64_t s) noexcept;
+        std::pair<T, vector_type> eval_with_gradient(const vector_type& point) const noexcept;
+        void batch(const vector_type* points, T* values, size_t n) const noexcept;
+        void scanline(const vector_type& origin, const vector_type& step, T* values, size_t n) const noexcept;
+        void seed(uint64_t s, NoiseSeeding mode = NoiseSeeding::standard) noexcept;
 
     private:
 
-        static constexpr int psize = 2048;
+        template <typename U, int DimIn, int DimOut, NoiseLayout M> friend class NoiseSource;
+
+        static constexpr int psize = Detail::noise_psize;
         static constexpr int pmask = psize - 1;
 
+        static constexpr int ngrads = 48;
+
         struct grad { T dx, dy, dz; };
 
+        static constexpr bool compact = L == NoiseLayout::compact;
+
+        // In the compact layout each permutation entry also holds the index
+        // of its gradient in the shared set (perm % ngrads); in the standard
+        // layout the gradients are copied into a second table
+
+        struct compact_entry { uint16_t perm, grad; };
+
+        using perm_type = std::conditional_t<compact, compact_entry, int>;
+
+        template <int Size> struct standard_tables { std::array<int, Size> perm; std::array<grad, Size> grads; };
+        template <int Size> struct compact_tables { std::array<compact_entry, Size> perm; };
+        template <int Size> using table_storage = std::conditional_t<compact, compact_tables<Size>, standard_tables<Size>>;
+
+        // Table contents for each permutation value, built once so that
+        // seeding needs no arithmetic beyond the shuffle
+
+        using seed_entry = std::conditional_t<compact, compact_entry, grad>;
+        using seed_table_type = std::array<seed_entry, psize>;
+
+        struct table_ref {
+            const perm_type* perm;
+            const grad* grads;
+            int stride;
+            int index(int i) const noexcept;
+            const grad& gradient(int i) const noexcept;
+        };
+
         struct lattice_point {
 
             T dxr, dyr, dzr;
@@ -287,80 +676,235 @@ namespace RS::Graphics::Core {
 
         };
 
-        struct grad_table {
-            std::array<grad, psize> grads;
-            grad_table() noexcept;
-        };
-
         struct lattice_table {
             std::array<lattice_point, 112> points;
             lattice_table() noexcept;
         };
 
-        std::array<int, psize> perm_;
-        std::array<grad, psize> grads_;
+        struct cell_state {
+            int xrb, yrb, zrb, index;
+            T xri, yri, zri;
+        };
+
+        table_storage<psize> tables_;
+
+        table_ref table() const noexcept { return make_table_ref(tables_, 0, 1); }
+
+        T evaluate(const vector_type& point, const lattice_table& lut) const noexcept;
+
+        static T accumulate(const cell_state& cell, const lattice_table& lut, table_ref table) noexcept;
+        static void accumulate_batch(table_ref table, const lattice_table& lut, const vector_type* points, T* values,
+            size_t n) noexcept;
+        static T accumulate_gradient(const cell_state& cell, const lattice_table& lut, table_ref table, vector_type& derivative) noexcept;
+        static const grad& gradient(const cell_state& cell, const lattice_point& c, table_ref table) noexcept;
+        static const grad* gradient_set() noexcept;
+        static const lattice_table& lattice() noexcept;
+        static const seed_table_type& seed_table() noexcept;
+        static cell_state locate(const vector_type& point) noexcept;
+        static void scanline_prepare(const void* noise, const int* cell, T* data) noexcept;
+
+        template <typename Tables>
+        static table_ref make_table_ref(const Tables& tables, int offset, int stride) noexcept {
+            if constexpr (compact)
+                return {tables.perm.data() + offset, nullptr, stride};
+            else
+                return {tables.perm.data() + offset, tables.grads.data() + offset, stride};
+        }
 
     };
 
-        template <typename T>
-        void Noise<T, 3>::seed(uint64_t s) noexcept {
+        template <typename T, NoiseLayout L>
+        void Noise<T, 3, L>::seed(uint64_t s, NoiseSeeding mode) noexcept {
+            auto& entries = seed_table();
+            Detail::noise_shuffle(s, mode, [this,&entries] (int i, int p) {
+                if constexpr (compact) {
+                    tables_.perm[i] = entries[p];
+                } else {
+                    tables_.perm[i] = p;
+                    tables_.grads[i] = entries[p];
+                }
+            });
+        }
 
-            using namespace Detail;
+        template <typename T, NoiseLayout L>
+        T Noise<T, 3, L>::operator()(const vector_type& point) const noexcept {
+            return evaluate(point, lattice());
+        }
+
+        template <typename T, NoiseLayout L>
+        std::pair<T, typename Noise<T, 3, L>::vector_type> Noise<T, 3, L>::eval_with_gradient(const vector_type& point) const noexcept {
+            std::pair<T, vector_type> result;
+            result.first = accumulate_gradient(locate(point), lattice(), table(), result.second);
+            return result;
+        }
 
-            static const grad_table gtable;
+        template <typename T, NoiseLayout L>
+        void Noise<T, 3, L>::batch(const vector_type* points, T* values, size_t n) const noexcept {
+            accumulate_batch(table(), lattice(), points, values, n);
+        }
 
-            int source[psize];
+        template <typename T, NoiseLayout L>
+        void Noise<T, 3, L>::scanline(const vector_type& origin, const vector_type& step, T* values, size_t n) const noexcept {
 
-            for (int i = 0; i < psize; i++)
-                source[i] = i;
+            // Rows go through the scanline kernels where available; failing
+            // that, single precision rows are faster through the batch kernels
+
+            size_t i = 0;
 
-            for (int i = psize - 1; i >= 0; i--) {
-                s = lcg64_1(s);
-                int r = int((s + 31) % (i + 1));
-                perm_[i] = source[r];
-                grads_[i] = gtable.grads[perm_[i]];
-                source[r] = source[i];
+            if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+                Detail::NoiseScanline<T, 3> scan = {origin, step, this, &scanline_prepare};
+                if constexpr (std::is_same_v<T, float>)
+                    i = Detail::noise3f_scanline_simd(scan, values, n);
+                else
+                    i = Detail::noise3d_scanline_simd(scan, values, n);
             }
 
-            (*this)(vector_type(T(0)));
+            if constexpr (std::is_same_v<T, float>) {
+                if (i == 0 && simd_level() != SimdLevel::none) {
+                    static constexpr size_t chunk = 256;
+                    vector_type points[chunk];
+                    for (; i < n; i += chunk) {
+                        size_t m = std::min(chunk, n - i);
+                        for (size_t j = 0; j < m; ++j)
+                            points[j] = origin + T(i + j) * step;
+                        batch(points, values + i, m);
+                    }
+                    return;
+                }
+            }
 
-        }
+            // Gradients are looked up only when a candidate is first visited
+            // in the current cell; bit k of valid marks candidate k as cached
 
-        template <typename T>
-        T Noise<T, 3>::operator()(const vector_type& point) const noexcept {
+            const auto& lut = lattice();
+            cell_state current = {0, 0, 0, -1, T(0), T(0), T(0)};
+            grad grads[14];
+            int valid = 0;
 
-            using namespace Detail;
+            for (; i < n; ++i) {
 
-            static const lattice_table lut;
+                auto cell = locate(origin + T(i) * step);
 
-            T r = T(2) / T(3) * (point.x() + point.y() + point.z());
-            T xr = r - point.x();
-            T yr = r - point.y();
-            T zr = r - point.z();
+                if (cell.index != current.index || cell.xrb != current.xrb
+                        || cell.yrb != current.yrb || cell.zrb != current.zrb)
+                    valid = 0;
+
+                current = cell;
+                T value = T(0);
+                int base = 14 * cell.index;
+                int ci = base;
 
-            int xrb = fast_floor(xr);
-            int yrb = fast_floor(yr);
-            int zrb = fast_floor(zr);
+                while (ci != -1) {
 
-            T xri = xr - T(xrb);
-            T yri = yr - T(yrb);
-            T zri = zr - T(zrb);
+                    auto& c = lut.points[ci];
+
+                    T dxr = cell.xri + c.dxr;
+                    T dyr = cell.yri + c.dyr;
+                    T dzr = cell.zri + c.dzr;
+                    T attn = T(0.75) - dxr * dxr - dyr * dyr - dzr * dzr;
+
+                    if (attn < T(0)) {
+
+                        ci = c.fail;
+
+                    } else {
 
-            int xht = int(xri + T(0.5));
-            int yht = int(yri + T(0.5));
-            int zht = int(zri + T(0.5));
+                        int k = ci - base;
+                        if ((valid & (1 << k)) == 0) {
+                            grads[k] = gradient(cell, c, table());
+                            valid |= 1 << k;
+                        }
+
+                        auto& g = grads[k];
+                        T extrapolation = g.dx * dxr + g.dy * dyr + g.dz * dzr;
+                        attn *= attn;
+                        value += attn * attn * extrapolation;
+                        ci = c.succ;
+
+                    }
+
+                }
+
+                values[i] = value;
+
+            }
+
+        }
+
+        template <typename T, NoiseLayout L>
+        void Noise<T, 3, L>::scanline_prepare(const void* noise, const int* cell, T* data) noexcept {
+            auto table = static_cast<const Noise*>(noise)->table();
+            const auto& lut = lattice();
+            cell_state state = {cell[0], cell[1], cell[2], cell[3], T(0), T(0), T(0)};
+            for (int j = 0; j < 14; ++j) {
+                auto& c = lut.points[14 * state.index + j];
+                auto& g = gradient(state, c, table);
+                T* d = data + 6 * j;
+                d[0] = c.dxr;
+                d[1] = c.dyr;
+                d[2] = c.dzr;
+                d[3] = g.dx;
+                d[4] = g.dy;
+                d[5] = g.dz;
+            }
+        }
+
+        template <typename T, NoiseLayout L>
+        T Noise<T, 3, L>::evaluate(const vector_type& point, const lattice_table& lut) const noexcept {
+            return accumulate(locate(point), lut, table());
+        }
+
+        template <typename T, NoiseLayout L>
+        int Noise<T, 3, L>::table_ref::index(int i) const noexcept {
+            if constexpr (compact)
+                return perm[stride * i].perm;
+            else
+                return perm[stride * i];
+        }
+
+        template <typename T, NoiseLayout L>
+        const typename Noise<T, 3, L>::grad& Noise<T, 3, L>::table_ref::gradient(int i) const noexcept {
+            if constexpr (compact)
+                return gradient_set()[perm[stride * i].grad];
+            else
+                return grads[stride * i];
+        }
+
+        // The vector kernels need the table for a single noise function,
+        // with no interleaving
+
+        template <typename T, NoiseLayout L>
+        void Noise<T, 3, L>::accumulate_batch(table_ref table, const lattice_table& lut, const vector_type* points,
+                T* values, size_t n) noexcept {
+            size_t i = 0;
+            if constexpr (std::is_same_v<T, float>) {
+                static_assert(sizeof(lattice_point) == 8 * sizeof(int));
+                static_assert(sizeof(grad) == 3 * sizeof(float));
+                static_assert(sizeof(perm_type) == sizeof(int));
+                if (table.stride == 1) {
+                    auto grads = compact ? gradient_set() : table.grads;
+                    Detail::NoiseSimdTables tables = {reinterpret_cast<const int*>(table.perm),
+                        reinterpret_cast<const float*>(grads), lut.points.data(), compact};
+                    i = Detail::noise3f_simd(tables, points, values, n);
+                }
+            }
+            for (; i < n; ++i)
+                values[i] = accumulate(locate(points[i]), lut, table);
+        }
+
+        template <typename T, NoiseLayout L>
+        T Noise<T, 3, L>::accumulate(const cell_state& cell, const lattice_table& lut, table_ref table) noexcept {
 
-            int index = xht | (yht << 1) | (zht << 2);
             T value = T(0);
-            int ci = 14 * index;
+            int ci = 14 * cell.index;
 
             while (ci != -1) {
 
                 auto& c = lut.points[ci];
 
-                T dxr = xri + c.dxr;
-                T dyr = yri + c.dyr;
-                T dzr = zri + c.dzr;
+                T dxr = cell.xri + c.dxr;
+                T dyr = cell.yri + c.dyr;
+                T dzr = cell.zri + c.dzr;
                 T attn = T(0.75) - dxr * dxr - dyr * dyr - dzr * dzr;
 
                 if (attn < T(0)) {
@@ -369,11 +913,7 @@ namespace RS::Graphics::Core {
 
                 } else {
 
-                    int pxm = (xrb + c.xrv) & pmask;
-                    int pym = (yrb + c.yrv) & pmask;
-                    int pzm = (zrb + c.zrv) & pmask;
-
-                    grad g = grads_[perm_[perm_[pxm] ^ pym] ^ pzm];
+                    auto& g = gradient(cell, c, table);
                     T extrapolation = g.dx * dxr + g.dy * dyr + g.dz * dzr;
                     attn *= attn;
                     value += attn * attn * extrapolation;
@@ -387,16 +927,103 @@ namespace RS::Graphics::Core {
 
         }
 
-        template <typename T>
-        Noise<T, 3>::grad_table::grad_table() noexcept {
+        template <typename T, NoiseLayout L>
+        T Noise<T, 3, L>::accumulate_gradient(const cell_state& cell, const lattice_table& lut, table_ref table,
+                vector_type& derivative) noexcept {
+
+            // Each contribution is attn^4*(g.d), where attn = 3/4-|d|^2 and d is
+            // the offset from the lattice point, so its derivative with respect
+            // to d is attn^4*g-8*attn^3*(g.d)*d. The offsets are in rotated
+            // coordinates, r = (2/3)(x+y+z)-p, whose Jacobian is J = (2/3)*ones-I;
+            // J is symmetric, so the gradient with respect to the point is J*v,
+            // with components (2/3)(vx+vy+vz)-v.
+
+            T value = T(0);
+            vector_type v;
+            int ci = 14 * cell.index;
+
+            while (ci != -1) {
+
+                auto& c = lut.points[ci];
+
+                T dxr = cell.xri + c.dxr;
+                T dyr = cell.yri + c.dyr;
+                T dzr = cell.zri + c.dzr;
+                T attn = T(0.75) - dxr * dxr - dyr * dyr - dzr * dzr;
+
+                if (attn < T(0)) {
+
+                    ci = c.fail;
+
+                } else {
+
+                    auto& g = gradient(cell, c, table);
+                    T extrapolation = g.dx * dxr + g.dy * dyr + g.dz * dzr;
+                    T attn2 = attn * attn;
+                    T attn4 = attn2 * attn2;
+                    T k = T(8) * attn2 * attn * extrapolation;
+                    value += attn4 * extrapolation;
+                    v.x() += attn4 * g.dx - k * dxr;
+                    v.y() += attn4 * g.dy - k * dyr;
+                    v.z() += attn4 * g.dz - k * dzr;
+                    ci = c.succ;
+
+                }
+
+            }
+
+            T sum = T(2) / T(3) * (v.x() + v.y() + v.z());
+            derivative = vector_type(sum) - v;
+
+            return value;
+
+        }
+
+        template <typename T, NoiseLayout L>
+        const typename Noise<T, 3, L>::grad& Noise<T, 3, L>::gradient(const cell_state& cell, const lattice_point& c,
+                table_ref table) noexcept {
+            int pxm = (cell.xrb + c.xrv) & pmask;
+            int pym = (cell.yrb + c.yrv) & pmask;
+            int pzm = (cell.zrb + c.zrv) & pmask;
+            return table.gradient(table.index(table.index(pxm) ^ pym) ^ pzm);
+        }
+
+        template <typename T, NoiseLayout L>
+        typename Noise<T, 3, L>::cell_state Noise<T, 3, L>::locate(const vector_type& point) noexcept {
+
+            using namespace Detail;
+
+            T r = T(2) / T(3) * (point.x() + point.y() + point.z());
+            T xr = r - point.x();
+            T yr = r - point.y();
+            T zr = r - point.z();
+
+            cell_state cell;
+            cell.xrb = fast_floor(xr);
+            cell.yrb = fast_floor(yr);
+            cell.zrb = fast_floor(zr);
+            cell.xri = xr - T(cell.xrb);
+            cell.yri = yr - T(cell.yrb);
+            cell.zri = zr - T(cell.zrb);
+
+            int xht = int(cell.xri + T(0.5));
+            int yht = int(cell.yri + T(0.5));
+            int zht = int(cell.zri + T(0.5));
+            cell.index = xht | (yht << 1) | (zht << 2);
+
+            return cell;
+
+        }
+
+        template <typename T, NoiseLayout L>
+        const typename Noise<T, 3, L>::grad* Noise<T, 3, L>::gradient_set() noexcept {
 
-            static constexpr int n = 48;
             static constexpr T g1 = T(3.594'631'769);
             static constexpr T g2 = T(4.213'452'452);
             static constexpr T g3 = T(7.997'138'591);
             static constexpr T g4 = T(11.093'991'497);
 
-            static constexpr grad table[n] = {
+            static constexpr grad set[ngrads] = {
                 { - g3, - g3, - g1 }, { - g3, - g3, + g1 }, { - g4, - g2, T(0) }, { - g2, - g4, T(0) },
                 { - g3, - g1, - g3 }, { - g3, + g1, - g3 }, { - g2, T(0), - g4 }, { - g4, T(0), - g2 },
                 { - g3, - g1, + g3 }, { - g3, + g1, + g3 }, { - g4, T(0), + g2 }, { - g2, T(0), + g4 },
@@ -411,13 +1038,36 @@ namespace RS::Graphics::Core {
                 { + g3, + g3, - g1 }, { + g3, + g3, + g1 }, { + g4, + g2, T(0) }, { + g2, + g4, T(0) },
             };
 
-            for (int i = 0; i < psize; i++)
-                grads[i] = table[i % n];
+            return set;
 
         }
 
-        template <typename T>
-        Noise<T, 3>::lattice_table::lattice_table() noexcept {
+        template <typename T, NoiseLayout L>
+        const typename Noise<T, 3, L>::lattice_table& Noise<T, 3, L>::lattice() noexcept {
+            static const lattice_table lut;
+            return lut;
+        }
+
+        template <typename T, NoiseLayout L>
+        const typename Noise<T, 3, L>::seed_table_type& Noise<T, 3, L>::seed_table() noexcept {
+
+            static const seed_table_type table = [] {
+                seed_table_type t;
+                for (int p = 0; p < psize; ++p) {
+                    if constexpr (compact)
+                        t[p] = {uint16_t(p), uint16_t(p % ngrads)};
+                    else
+                        t[p] = gradient_set()[p % ngrads];
+                }
+                return t;
+            }();
+
+            return table;
+
+        }
+
+        template <typename T, NoiseLayout L>
+        Noise<T, 3, L>::lattice_table::lattice_table() noexcept {
 
             for (int i = 0; i < 8; i++) {
 
@@ -473,9 +1123,101 @@ namespace RS::Graphics::Core {
 
         }
 
+    // Shared noise generators
+
+    template <typename T, int N, NoiseLayout L = NoiseLayout::standard>
+    class NoiseCache {
+
+    public:
+
+        using noise_type = Noise<T, N, L>;
+        using pointer = std::shared_ptr<const noise_type>;
+
+        NoiseCache() = default;
+        explicit NoiseCache(NoiseSeeding mode) noexcept: mode_(mode) {}
+        NoiseCache(const NoiseCache&) = delete;
+        NoiseCache(NoiseCache&&) = delete;
+        NoiseCache& operator=(const NoiseCache&) = delete;
+        NoiseCache& operator=(NoiseCache&&) = delete;
+
+        pointer operator()(uint64_t s);
+        void clear() noexcept;
+        NoiseSeeding mode() const noexcept { return mode_; }
+        size_t size() const noexcept;
+
+    private:
+
+        // Entries are weak so a generator is released when its last user
+        // lets go; expired entries are swept when the map doubles in size
+
+        mutable std::mutex mutex_;
+        std::unordered_map<uint64_t, std::weak_ptr<const noise_type>> map_;
+        size_t sweep_at_ = 64;
+        NoiseSeeding mode_ = NoiseSeeding::standard;
+
+        void sweep() noexcept;
+
+    };
+
+        template <typename T, int N, NoiseLayout L>
+        typename NoiseCache<T, N, L>::pointer NoiseCache<T, N, L>::operator()(uint64_t s) {
+
+            {
+                std::unique_lock lock(mutex_);
+                auto it = map_.find(s);
+                if (it != map_.end())
+                    if (auto ptr = it->second.lock())
+                        return ptr;
+            }
+
+            // Seed outside the lock; if another thread got there first, use
+            // its generator instead
+
+            auto ptr = std::make_shared<const noise_type>(s, mode_);
+            std::unique_lock lock(mutex_);
+            auto& entry = map_[s];
+
+            if (auto prev = entry.lock())
+                return prev;
+
+            entry = ptr;
+            if (map_.size() >= sweep_at_)
+                sweep();
+
+            return ptr;
+
+        }
+
+        template <typename T, int N, NoiseLayout L>
+        void NoiseCache<T, N, L>::clear() noexcept {
+            std::unique_lock lock(mutex_);
+            map_.clear();
+            sweep_at_ = 64;
+        }
+
+        template <typename T, int N, NoiseLayout L>
+        size_t NoiseCache<T, N, L>::size() const noexcept {
+            std::unique_lock lock(mutex_);
+            size_t n = 0;
+            for (auto& [s,ptr]: map_)
+                n += size_t(! ptr.expired());
+            return n;
+        }
+
+        template <typename T, int N, NoiseLayout L>
+        void NoiseCache<T, N, L>::sweep() noexcept {
+            for (auto it = map_.begin(); it != map_.end();) {
+                if (it->second.expired())
+                    it = map_.erase(it);
+                else
+                    ++it;
+            }
+            sweep_at_ = std::max(size_t(64), 2 * map_.size());
+        }
+
     // Generalised noise source
 
-    template <typename T, int DimIn, int DimOut>
+    template <typename T, int DimIn, int DimOut, NoiseLayout L>
     class NoiseSource {
 
     public:
@@ -488,14 +1230,23 @@ namespace RS::Graphics::Core {
         using seed_type = uint64_t;
         using domain_type = std::conditional_t<DimIn == 1, T, Vector<T, DimIn>>;
         using result_type = std::conditional_t<DimOut == 1, T, Vector<T, DimOut>>;
+        using gradient_type = std::conditional_t<DimOut == 1, domain_type, std::array<domain_type, DimOut>>;
+        using array_type = MultiArray<result_type, DimIn>;
+        using box_type = Box<int, DimIn>;
 
         static constexpr int dim_in = DimIn;
         static constexpr int dim_out = DimOut;
+        static constexpr NoiseLayout layout = L;
 
         NoiseSource() = default;
-        NoiseSource(T cell, T scale, int octaves, uint64_t seed) noexcept;
+        NoiseSource(T cell, T scale, int octaves, uint64_t seed, NoiseSeeding mode = NoiseSeeding::standard) noexcept;
 
         result_type operator()(domain_type point) const noexcept;
+        std::pair<result_type, gradient_type> eval_with_gradient(domain_type point) const noexcept;
+        void batch(const domain_type* points, result_type* values, size_t n) const noexcept;
+        void fill(array_type& array) const;
+        void fill(array_type& array, const box_type& box) const;
+        void fill(array_type& array, const box_type& box, ThreadPool& pool) const;
 
         T cell() const noexcept { return cell_; }
         void cell(T size) noexcept { cell_ = std::abs(size); }
@@ -503,29 +1254,57 @@ namespace RS::Graphics::Core {
         void octaves(int n) noexcept { octaves_ = n; }
         T scale() const noexcept { return scale_; }
         void scale(T factor) noexcept { scale_ = std::abs(factor); }
-        void seed(uint64_t s) noexcept;
+        void seed(uint64_t s, NoiseSeeding mode = NoiseSeeding::standard) noexcept;
 
     private:
 
-        using noise_type = Noise<T, std::max(DimIn, 2)>;
+        using noise_type = Noise<T, std::max(DimIn, 2), L>;
         using input_vector = typename noise_type::vector_type;
+        using table_ref = typename noise_type::table_ref;
+        using lattice_table = typename noise_type::lattice_table;
+        using position = typename array_type::position;
 
-        std::array<noise_type, DimOut> generators_;
+        static constexpr int psize = noise_type::psize;
+        static constexpr bool compact = noise_type::compact;
+
+        // Tile edge for fill(), chosen so a tile holds about 4k elements
+
+        static constexpr int tile_edge = DimIn == 1 ? 4096 : DimIn == 2 ? 64 : DimIn == 3 ? 16 : 8;
+
+        // Permutation tables for all output channels, interleaved so that
+        // the channels' entries for each index are adjacent (element i of
+        // channel j is at i*DimOut+j)
+
+        typename noise_type::template table_storage<psize * DimOut> tables_;
         T cell_ = 1;
         T scale_ = 1;
         int octaves_ = 1;
 
+        table_ref channel(int j) const noexcept { return noise_type::make_table_ref(tables_, j, DimOut); }
+        result_type evaluate(domain_type point, const lattice_table& lut) const noexcept;
+
     };
 
-        template <typename T, int DimIn, int DimOut>
-        NoiseSource<T, DimIn, DimOut>::NoiseSource(T cell, T scale, int octaves, uint64_t s) noexcept:
-        generators_(), cell_(std::abs(cell)), scale_(std::abs(scale)), octaves_(octaves) {
-            seed(s);
+        template <typename T, int DimIn, int DimOut, NoiseLayout L>
+        NoiseSource<T, DimIn, DimOut, L>::NoiseSource(T cell, T scale, int octaves, uint64_t s, NoiseSeeding mode) noexcept:
+        tables_(), cell_(std::abs(cell)), scale_(std::abs(scale)), octaves_(octaves) {
+            seed(s, mode);
         }
 
-        template <typename T, int DimIn, int DimOut>
-        typename NoiseSource<T, DimIn, DimOut>::result_type NoiseSource<T, DimIn, DimOut>::operator()(domain_type point) const noexcept {
+        template <typename T, int DimIn, int DimOut, NoiseLayout L>
+        typename NoiseSource<T, DimIn, DimOut, L>::result_type NoiseSource<T, DimIn, DimOut, L>::operator()(domain_type point) const noexcept {
+            return evaluate(point, noise_type::lattice());
+        }
 
+        template <typename T, int DimIn, int DimOut, NoiseLayout L>
+        std::pair<typename NoiseSource<T, DimIn, DimOut, L>::result_type, typename NoiseSource<T, DimIn, DimOut, L>::gradient_type>
+        NoiseSource<T, DimIn, DimOut, L>::eval_with_gradient(domain_type point) const noexcept {
+
+            // Octave i samples the noise at 2^i*point/cell and scales it by
+            // scale/2^i, so every octave's gradient is multiplied by the same
+            // factor, scale/cell
+
+            const auto& lut = noise_type::lattice();
             point /= cell_;
 
             input_vector in;
@@ -534,29 +1313,220 @@ namespace RS::Graphics::Core {
             else
                 in = point;
 
-            result_type out(T(0));
+            std::pair<result_type, gradient_type> result;
+            auto& [out, grad] = result;
+            out = result_type(T(0));
             T s = scale_;
+            T f = scale_ / cell_;
+
+            auto add_gradient = [f] (domain_type& g, const input_vector& d) {
+                if constexpr (DimIn == 1)
+                    g += f * d.x();
+                else
+                    g += f * d;
+            };
+
+            if constexpr (DimOut == 1)
+                grad = domain_type(T(0));
+            else
+                for (auto& g: grad)
+                    g = domain_type(T(0));
 
             for (int i = 0; i < octaves_; ++i, in *= 2, s /= 2) {
+                auto cell = noise_type::locate(in);
+                input_vector d;
                 if constexpr (DimOut == 1) {
-                    out += s * generators_[0](in);
+                    out += s * noise_type::accumulate_gradient(cell, lut, channel(0), d);
+                    add_gradient(grad, d);
                 } else {
-                    for (int j = 0; j < DimOut; ++j)
-                        out[j] += s * generators_[j](in);
+                    for (int j = 0; j < DimOut; ++j) {
+                        out[j] += s * noise_type::accumulate_gradient(cell, lut, channel(j), d);
+                        add_gradient(grad[j], d);
+                    }
                 }
             }
 
-            return out;
+            return result;
+
+        }
 
+        template <typename T, int DimIn, int DimOut, NoiseLayout L>
+        void NoiseSource<T, DimIn, DimOut, L>::batch(const domain_type* points, result_type* values, size_t n) const noexcept {
+            const auto& lut = noise_type::lattice();
+            for (size_t i = 0; i < n; ++i)
+                values[i] = evaluate(points[i], lut);
         }
 
-        template <typename T, int DimIn, int DimOut>
-        void NoiseSource<T, DimIn, DimOut>::seed(uint64_t s) noexcept {
+        template <typename T, int DimIn, int DimOut, NoiseLayout L>
+        void NoiseSource<T, DimIn, DimOut, L>::fill(array_type& array) const {
+            fill(array, box_type(position(0), array.shape()), ThreadPool::global());
+        }
+
+        template <typename T, int DimIn, int DimOut, NoiseLayout L>
+        void NoiseSource<T, DimIn, DimOut, L>::fill(array_type& array, const box_type& box) const {
+            fill(array, box, ThreadPool::global());
+        }
+
+        template <typename T, int DimIn, int DimOut, NoiseLayout L>
+        void NoiseSource<T, DimIn, DimOut, L>::fill(array_type& array, const box_type& box, ThreadPool& pool) const {
+
+            if (! box_type(position(0), array.shape()).contains(box))
+                throw std::invalid_argument("Noise fill region is not inside the array");
+            if (box.empty())
+                return;
+
+            position base = box.base();
+            position apex = box.apex();
+            position tiles;
+            size_t n_tiles = 1;
+
+            for (int i = 0; i < DimIn; ++i) {
+                tiles[i] = (apex[i] - base[i] + tile_edge - 1) / tile_edge;
+                n_tiles *= size_t(tiles[i]);
+            }
+
+            // Each tile row is evaluated an octave and a channel at a time
+            // through the batch path, which uses the vector kernels for
+            // single precision. The kernels need each channel's tables to be
+            // contiguous, so the interleaved tables are split first. The
+            // points are scaled exactly as evaluate() scales them, so the
+            // results are the same as calling operator() on each point.
+
+            const auto& lut = noise_type::lattice();
+            std::array<table_ref, DimOut> refs;
+            std::vector<typename noise_type::template table_storage<psize>> split;
+
+            if constexpr (DimOut > 1 && std::is_same_v<T, float>) {
+                split.resize(DimOut);
+                for (int i = 0; i < psize; ++i) {
+                    for (int j = 0; j < DimOut; ++j) {
+                        split[size_t(j)].perm[size_t(i)] = tables_.perm[size_t(i * DimOut + j)];
+                        if constexpr (! compact)
+                            split[size_t(j)].grads[size_t(i)] = tables_.grads[size_t(i * DimOut + j)];
+                    }
+                }
+                for (int j = 0; j < DimOut; ++j)
+                    refs[size_t(j)] = noise_type::make_table_ref(split[size_t(j)], 0, 1);
+            } else {
+                for (int j = 0; j < DimOut; ++j)
+                    refs[size_t(j)] = channel(j);
+            }
+
+            pool.for_each(n_tiles, [&] (size_t t) {
+
+                position lo, hi;
+
+                for (int i = 0; i < DimIn; ++i) {
+                    lo[i] = base[i] + int(t % size_t(tiles[i])) * tile_edge;
+                    hi[i] = std::min(lo[i] + tile_edge, apex[i]);
+                    t /= size_t(tiles[i]);
+                }
+
+                size_t width = size_t(hi[0] - lo[0]);
+                std::vector<input_vector> points(width);
+                std::vector<T> values(width);
+                position p = lo;
+
+                for (;;) {
+
+                    auto row = &array[p];
+
+                    for (size_t k = 0; k < width; ++k) {
+                        domain_type point;
+                        if constexpr (DimIn == 1) {
+                            point = T(lo[0] + int(k));
+                        } else {
+                            point = domain_type(p);
+                            point[0] = T(lo[0] + int(k));
+                        }
+                        point /= cell_;
+                        if constexpr (DimIn == 1)
+                            points[k] = {point, T(0)};
+                        else
+                            points[k] = point;
+                        row[k] = result_type(T(0));
+                    }
+
+                    T s = scale_;
+
+                    for (int i = 0; i < octaves_; ++i, s /= 2) {
+                        for (int j = 0; j < DimOut; ++j) {
+                            noise_type::accumulate_batch(refs[size_t(j)], lut, points.data(), values.data(), width);
+                            for (size_t k = 0; k < width; ++k) {
+                                if constexpr (DimOut == 1)
+                                    row[k] += s * values[k];
+                                else
+                                    row[k][j] += s * values[k];
+                            }
+                        }
+                        for (auto& q: points)
+                            q *= 2;
+                    }
+
+                    int i = 1;
+                    for (; i < DimIn && ++p[i] == hi[i]; ++i)
+                        p[i] = lo[i];
+                    if (i == DimIn)
+                        break;
+
+                }
+
+            });
+
+        }
+
+        template <typename T, int DimIn, int DimOut, NoiseLayout L>
+        void NoiseSource<T, DimIn, DimOut, L>::seed(uint64_t s, NoiseSeeding mode) noexcept {
+
             using namespace Detail;
-            for (auto& gen: generators_) {
-                gen.seed(s);
+
+            auto& entries = noise_type::seed_table();
+
+            for (int j = 0; j < DimOut; ++j) {
+                noise_shuffle(s, mode, [this,&entries,j] (int i, int p) {
+                    int k = i * DimOut + j;
+                    if constexpr (compact) {
+                        tables_.perm[k] = entries[p];
+                    } else {
+                        tables_.perm[k] = p;
+                        tables_.grads[k] = entries[p];
+                    }
+                });
                 s = lcg64_2(s);
             }
+
+        }
+
+        template <typename T, int DimIn, int DimOut, NoiseLayout L>
+        typename NoiseSource<T, DimIn, DimOut, L>::result_type
+        NoiseSource<T, DimIn, DimOut, L>::evaluate(domain_type point, const lattice_table& lut) const noexcept {
+
+            // The lattice cell is located once per octave and shared by all
+            // output channels
+
+            point /= cell_;
+
+            input_vector in;
+            if constexpr (DimIn == 1)
+                in = {point, T(0)};
+            else
+                in = point;
+
+            result_type out(T(0));
+            T s = scale_;
+
+            for (int i = 0; i < octaves_; ++i, in *= 2, s /= 2) {
+                auto cell = noise_type::locate(in);
+                if constexpr (DimOut == 1) {
+                    out += s * noise_type::accumulate(cell, lut, channel(0));
+                } else {
+                    for (int j = 0; j < DimOut; ++j)
+                        out[j] += s * noise_type::accumulate(cell, lut, channel(j));
+                }
+            }
+
+            return out;
+
         }
 
 }
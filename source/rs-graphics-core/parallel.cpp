@@ -0,0 +1,128 @@
+#include "rs-graphics-core/parallel.hpp"
+#include <algorithm>
+
+namespace RS::Graphics::Core {
+
+    namespace {
+
+        // The pool whose tasks the current thread is running, if any. A
+        // nested call to for_each() from inside a task runs serially, instead
+        // of waiting for workers that are busy with the outer call.
+
+        thread_local const ThreadPool* current_pool = nullptr;
+
+    }
+
+    ThreadPool::ThreadPool(int threads) {
+        if (threads <= 0)
+            threads = std::max(int(std::thread::hardware_concurrency()), 1);
+        for (int i = 1; i < threads; ++i)
+            workers_.emplace_back([this] { worker(); });
+    }
+
+    ThreadPool::~ThreadPool() noexcept {
+        {
+            std::unique_lock lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto& t: workers_)
+            t.join();
+    }
+
+    void ThreadPool::for_each(size_t n, const std::function<void(size_t)>& f) {
+
+        if (n == 0)
+            return;
+
+        if (workers_.empty() || n == 1 || current_pool == this) {
+            for (size_t i = 0; i < n; ++i)
+                f(i);
+            return;
+        }
+
+        std::unique_lock call_lock(call_mutex_);
+
+        {
+            std::unique_lock lock(mutex_);
+            task_ = &f;
+            count_ = n;
+            next_ = 0;
+            active_ = int(workers_.size());
+            error_ = nullptr;
+            ++generation_;
+        }
+
+        start_.notify_all();
+        run_tasks();
+
+        std::exception_ptr error;
+
+        {
+            std::unique_lock lock(mutex_);
+            done_.wait(lock, [this] { return active_ == 0; });
+            task_ = nullptr;
+            std::swap(error, error_);
+        }
+
+        if (error)
+            std::rethrow_exception(error);
+
+    }
+
+    ThreadPool& ThreadPool::global() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    void ThreadPool::run_tasks() noexcept {
+
+        auto saved_pool = current_pool;
+        current_pool = this;
+
+        for (;;) {
+            size_t i = next_++;
+            if (i >= count_)
+                break;
+            try {
+                (*task_)(i);
+            }
+            catch (...) {
+                std::unique_lock lock(mutex_);
+                if (! error_)
+                    error_ = std::current_exception();
+                next_ = count_;
+            }
+        }
+
+        current_pool = saved_pool;
+
+    }
+
+    void ThreadPool::worker() noexcept {
+
+        uint64_t seen = 0;
+
+        for (;;) {
+
+            {
+                std::unique_lock lock(mutex_);
+                start_.wait(lock, [this,seen] { return stop_ || generation_ != seen; });
+                if (stop_)
+                    return;
+                seen = generation_;
+            }
+
+            run_tasks();
+
+            {
+                std::unique_lock lock(mutex_);
+                if (--active_ == 0)
+                    done_.notify_one();
+            }
+
+        }
+
+    }
+
+}
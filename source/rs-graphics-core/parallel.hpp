@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace RS::Graphics::Core {
+
+    class ThreadPool {
+
+    public:
+
+        ThreadPool(): ThreadPool(0) {}
+        explicit ThreadPool(int threads);
+        ~ThreadPool() noexcept;
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool(ThreadPool&&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        ThreadPool& operator=(ThreadPool&&) = delete;
+
+        void for_each(size_t n, const std::function<void(size_t)>& f);
+        int threads() const noexcept { return int(workers_.size()) + 1; }
+
+        static ThreadPool& global();
+
+    private:
+
+        std::vector<std::thread> workers_;
+        std::mutex call_mutex_;
+        std::mutex mutex_;
+        std::condition_variable start_;
+        std::condition_variable done_;
+        const std::function<void(size_t)>* task_ = nullptr;
+        size_t count_ = 0;
+        std::atomic<size_t> next_{0};
+        int active_ = 0;
+        uint64_t generation_ = 0;
+        std::exception_ptr error_;
+        bool stop_ = false;
+
+        void run_tasks() noexcept;
+        void worker() noexcept;
+
+    };
+
+}
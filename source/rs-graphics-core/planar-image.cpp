@@ -0,0 +1,223 @@
+#include "rs-graphics-core/planar-image.hpp"
+#include "rs-graphics-core/simd.hpp"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define RS_GRAPHICS_X86 1
+    #include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+    #define RS_GRAPHICS_TARGET(isa)
+#else
+    #define RS_GRAPHICS_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace RS::Graphics::Core::Detail {
+
+    namespace {
+
+        #ifdef RS_GRAPHICS_X86
+
+            // Interleaving kernels for 3 and 4 channel single precision
+            // colours, 4 pixels at a time. These are pure shuffles, limited
+            // by memory bandwidth rather than arithmetic, so the SSE2
+            // versions are used at every SIMD level.
+
+            RS_GRAPHICS_TARGET("sse2")
+            size_t deinterleave3_sse2(const float* in, float* const* out, size_t n) noexcept {
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4, in += 12) {
+                    __m128 a = _mm_loadu_ps(in);      // r0 g0 b0 r1
+                    __m128 b = _mm_loadu_ps(in + 4);  // g1 b1 r2 g2
+                    __m128 c = _mm_loadu_ps(in + 8);  // b2 r3 g3 b3
+                    __m128 r = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 3, 2)), _MM_SHUFFLE(3, 0, 3, 0));
+                    __m128 g = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                        _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+                    __m128 bl = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                        _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+                    _mm_storeu_ps(out[0] + i, r);
+                    _mm_storeu_ps(out[1] + i, g);
+                    _mm_storeu_ps(out[2] + i, bl);
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("sse2")
+            size_t interleave3_sse2(const float* const* in, float* out, size_t n) noexcept {
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4, out += 12) {
+                    __m128 r = _mm_loadu_ps(in[0] + i);
+                    __m128 g = _mm_loadu_ps(in[1] + i);
+                    __m128 b = _mm_loadu_ps(in[2] + i);
+                    __m128 x = _mm_shuffle_ps(_mm_unpacklo_ps(r, g), _mm_shuffle_ps(b, r, _MM_SHUFFLE(1, 1, 0, 0)),
+                        _MM_SHUFFLE(2, 0, 1, 0));
+                    __m128 y = _mm_shuffle_ps(_mm_shuffle_ps(g, b, _MM_SHUFFLE(1, 1, 1, 1)),
+                        _mm_shuffle_ps(r, g, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+                    __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(b, r, _MM_SHUFFLE(3, 3, 2, 2)),
+                        _mm_shuffle_ps(g, b, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+                    _mm_storeu_ps(out, x);
+                    _mm_storeu_ps(out + 4, y);
+                    _mm_storeu_ps(out + 8, z);
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("sse2")
+            size_t deinterleave4_sse2(const float* in, float* const* out, size_t n) noexcept {
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4, in += 16) {
+                    __m128 a = _mm_loadu_ps(in);
+                    __m128 b = _mm_loadu_ps(in + 4);
+                    __m128 c = _mm_loadu_ps(in + 8);
+                    __m128 d = _mm_loadu_ps(in + 12);
+                    _MM_TRANSPOSE4_PS(a, b, c, d);
+                    _mm_storeu_ps(out[0] + i, a);
+                    _mm_storeu_ps(out[1] + i, b);
+                    _mm_storeu_ps(out[2] + i, c);
+                    _mm_storeu_ps(out[3] + i, d);
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("sse2")
+            size_t interleave4_sse2(const float* const* in, float* out, size_t n) noexcept {
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4, out += 16) {
+                    __m128 a = _mm_loadu_ps(in[0] + i);
+                    __m128 b = _mm_loadu_ps(in[1] + i);
+                    __m128 c = _mm_loadu_ps(in[2] + i);
+                    __m128 d = _mm_loadu_ps(in[3] + i);
+                    _MM_TRANSPOSE4_PS(a, b, c, d);
+                    _mm_storeu_ps(out, a);
+                    _mm_storeu_ps(out + 4, b);
+                    _mm_storeu_ps(out + 8, c);
+                    _mm_storeu_ps(out + 12, d);
+                }
+                return i;
+            }
+
+            // Planar 3x3 matrix kernels. These mirror the Matrix * Vector
+            // product in matrix.hpp, summing the products in column order
+            // starting from zero, so the results are bit-for-bit identical.
+            // The output planes may be the same as the input planes.
+
+            RS_GRAPHICS_TARGET("sse2")
+            size_t planar_matrix_sse2(const float* const* in, float* const* out, const float* matrix, size_t n) noexcept {
+                __m128 m[9];
+                for (int k = 0; k < 9; ++k)
+                    m[k] = _mm_set1_ps(matrix[k]);
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    __m128 x[3] = {_mm_loadu_ps(in[0] + i), _mm_loadu_ps(in[1] + i), _mm_loadu_ps(in[2] + i)};
+                    __m128 y[3];
+                    for (int r = 0; r < 3; ++r) {
+                        y[r] = _mm_setzero_ps();
+                        for (int c = 0; c < 3; ++c)
+                            y[r] = _mm_add_ps(y[r], _mm_mul_ps(m[3 * r + c], x[c]));
+                    }
+                    for (int r = 0; r < 3; ++r)
+                        _mm_storeu_ps(out[r] + i, y[r]);
+                }
+                return i;
+            }
+
+            RS_GRAPHICS_TARGET("avx2")
+            size_t planar_matrix_avx2(const float* const* in, float* const* out, const float* matrix, size_t n) noexcept {
+                __m256 m[9];
+                for (int k = 0; k < 9; ++k)
+                    m[k] = _mm256_set1_ps(matrix[k]);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    __m256 x[3] = {_mm256_loadu_ps(in[0] + i), _mm256_loadu_ps(in[1] + i), _mm256_loadu_ps(in[2] + i)};
+                    __m256 y[3];
+                    for (int r = 0; r < 3; ++r) {
+                        y[r] = _mm256_setzero_ps();
+                        for (int c = 0; c < 3; ++c)
+                            y[r] = _mm256_add_ps(y[r], _mm256_mul_ps(m[3 * r + c], x[c]));
+                    }
+                    for (int r = 0; r < 3; ++r)
+                        _mm256_storeu_ps(out[r] + i, y[r]);
+                }
+                return i;
+            }
+
+            // Finishes the planes through a padded copy of the final
+            // partial block, as simd_padded() does for interleaved data
+
+            template <size_t Block, typename Kernel>
+            size_t planar_matrix_padded(const float* const* in, float* const* out, const float* matrix, size_t n,
+                    Kernel kernel) noexcept {
+                size_t i = kernel(in, out, matrix, n);
+                size_t m = n - i;
+                if (m == 0)
+                    return n;
+                float in_buf[3][Block];
+                float out_buf[3][Block];
+                for (int c = 0; c < 3; ++c)
+                    for (size_t j = 0; j < Block; ++j)
+                        in_buf[c][j] = in[c][i + std::min(j, m - 1)];
+                const float* in_planes[3] = {in_buf[0], in_buf[1], in_buf[2]};
+                float* out_planes[3] = {out_buf[0], out_buf[1], out_buf[2]};
+                kernel(in_planes, out_planes, matrix, Block);
+                for (int r = 0; r < 3; ++r)
+                    std::copy_n(out_buf[r], m, out[r] + i);
+                return n;
+            }
+
+        #endif
+
+    }
+
+    size_t deinterleave_float_simd(const float* in, float* const* out, int channels, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            if (simd_level() >= SimdLevel::sse2) {
+                if (channels == 3)
+                    return deinterleave3_sse2(in, out, n);
+                else if (channels == 4)
+                    return deinterleave4_sse2(in, out, n);
+            }
+        #else
+            (void)in;
+            (void)out;
+            (void)channels;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t interleave_float_simd(const float* const* in, float* out, int channels, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            if (simd_level() >= SimdLevel::sse2) {
+                if (channels == 3)
+                    return interleave3_sse2(in, out, n);
+                else if (channels == 4)
+                    return interleave4_sse2(in, out, n);
+            }
+        #else
+            (void)in;
+            (void)out;
+            (void)channels;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+    size_t planar_matrix_simd(const float* const* in, float* const* out, const float* matrix, size_t n) noexcept {
+        #ifdef RS_GRAPHICS_X86
+            switch (simd_level()) {
+                case SimdLevel::avx512:  // fall through
+                case SimdLevel::avx2:    return planar_matrix_padded<8>(in, out, matrix, n, planar_matrix_avx2);
+                case SimdLevel::sse2:    return planar_matrix_padded<4>(in, out, matrix, n, planar_matrix_sse2);
+                default:                 break;
+            }
+        #else
+            (void)in;
+            (void)out;
+            (void)matrix;
+            (void)n;
+        #endif
+        return 0;
+    }
+
+}
@@ -0,0 +1,472 @@
+#pragma once
+
+#include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/colour-space.hpp"
+#include "rs-graphics-core/multi-array.hpp"
+#include "rs-graphics-core/simd.hpp"
+#include "rs-graphics-core/vector.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+namespace RS::Graphics::Core {
+
+    // A planar image view refers to one plane per channel, all with the
+    // same shape and row stride. Planes are always in colour space channel
+    // order, with alpha (if any) last, whatever the layout of the
+    // corresponding interleaved colour type. VT may be const qualified.
+
+    template <typename VT, typename CS = LinearRGB, ColourLayout CL = ColourLayout::forward_alpha>
+    class PlanarView {
+
+    public:
+
+        using channel_type = std::remove_const_t<VT>;
+        using colour_type = Colour<channel_type, CS, CL>;
+        using value_type = VT;
+
+        static constexpr int colour_space_channels = colour_type::colour_space_channels;
+        static constexpr bool has_alpha = colour_type::has_alpha;
+        static constexpr int planes = colour_type::channels;
+
+        PlanarView() = default;
+        PlanarView(const std::array<VT*, planes>& ptrs, Int2 shape, ptrdiff_t stride) noexcept:
+            ptrs_(ptrs), shape_(shape), stride_(stride) {}
+        template <typename V2, typename = std::enable_if_t<std::is_same_v<VT, const V2>>>
+            PlanarView(const PlanarView<V2, CS, CL>& v) noexcept:
+            shape_(v.shape()), stride_(v.stride()) { for (int i = 0; i < planes; ++i) ptrs_[i] = v.plane(i); }
+
+        VT* plane(int i) const noexcept { return ptrs_[i]; }
+        VT* row(int i, int y) const noexcept { return ptrs_[i] + y * stride_; }
+        colour_type get(int x, int y) const noexcept;
+        template <typename V2 = VT> void set(int x, int y, colour_type c,
+            std::enable_if_t<! std::is_const_v<V2>>* = nullptr) const noexcept;
+
+        bool empty() const noexcept { return shape_.x() == 0 || shape_.y() == 0; }
+        Int2 shape() const noexcept { return shape_; }
+        int width() const noexcept { return shape_.x(); }
+        int height() const noexcept { return shape_.y(); }
+        size_t size() const noexcept { return size_t(shape_.x()) * size_t(shape_.y()); }
+        ptrdiff_t stride() const noexcept { return stride_; }
+        PlanarView subview(Int2 origin, Int2 shape) const;
+
+    private:
+
+        std::array<VT*, planes> ptrs_ = {};
+        Int2 shape_;
+        ptrdiff_t stride_ = 0;
+
+    };
+
+        template <typename VT, typename CS, ColourLayout CL>
+        typename PlanarView<VT, CS, CL>::colour_type PlanarView<VT, CS, CL>::get(int x, int y) const noexcept {
+            colour_type c;
+            ptrdiff_t offset = x + y * stride_;
+            for (int i = 0; i < colour_space_channels; ++i)
+                c.cs(i) = ptrs_[i][offset];
+            if constexpr (has_alpha)
+                c.alpha() = ptrs_[colour_space_channels][offset];
+            return c;
+        }
+
+        template <typename VT, typename CS, ColourLayout CL>
+        template <typename V2>
+        void PlanarView<VT, CS, CL>::set(int x, int y, colour_type c, std::enable_if_t<! std::is_const_v<V2>>*) const noexcept {
+            ptrdiff_t offset = x + y * stride_;
+            for (int i = 0; i < colour_space_channels; ++i)
+                ptrs_[i][offset] = c.cs(i);
+            if constexpr (has_alpha)
+                ptrs_[colour_space_channels][offset] = c.alpha();
+        }
+
+        template <typename VT, typename CS, ColourLayout CL>
+        PlanarView<VT, CS, CL> PlanarView<VT, CS, CL>::subview(Int2 origin, Int2 shape) const {
+            if (origin.x() < 0 || origin.y() < 0 || shape.x() < 0 || shape.y() < 0
+                    || origin.x() + shape.x() > shape_.x() || origin.y() + shape.y() > shape_.y())
+                throw std::invalid_argument("Planar image subview is out of bounds");
+            auto ptrs = ptrs_;
+            for (auto& p: ptrs)
+                p += origin.x() + origin.y() * stride_;
+            return {ptrs, shape, stride_};
+        }
+
+    // Planar image, holding one MultiArray per channel
+
+    template <typename VT, typename CS = LinearRGB, ColourLayout CL = ColourLayout::forward_alpha>
+    class PlanarImage {
+
+    public:
+
+        using colour_type = Colour<VT, CS, CL>;
+        using const_view_type = PlanarView<const VT, CS, CL>;
+        using plane_type = MultiArray<VT, 2>;
+        using value_type = VT;
+        using view_type = PlanarView<VT, CS, CL>;
+
+        static constexpr int colour_space_channels = colour_type::colour_space_channels;
+        static constexpr bool has_alpha = colour_type::has_alpha;
+        static constexpr int planes = colour_type::channels;
+
+        PlanarImage() = default;
+        explicit PlanarImage(Int2 shape);
+        PlanarImage(Int2 shape, colour_type c);
+        PlanarImage(Int2 shape, const colour_type* pixels);
+
+        plane_type& plane(int i) noexcept { return planes_[i]; }
+        const plane_type& plane(int i) const noexcept { return planes_[i]; }
+        colour_type get(int x, int y) const noexcept { return view().get(x, y); }
+        void set(int x, int y, colour_type c) noexcept { view().set(x, y, c); }
+        view_type view() noexcept;
+        const_view_type view() const noexcept;
+        view_type view(Int2 origin, Int2 shape) { return view().subview(origin, shape); }
+        const_view_type view(Int2 origin, Int2 shape) const { return view().subview(origin, shape); }
+
+        bool empty() const noexcept { return planes_[0].empty(); }
+        Int2 shape() const noexcept { return planes_[0].shape(); }
+        int width() const noexcept { return shape().x(); }
+        int height() const noexcept { return shape().y(); }
+        size_t size() const noexcept { return planes_[0].size(); }
+
+        void fill(colour_type c);
+        void reset(Int2 shape);
+
+    private:
+
+        std::array<plane_type, planes> planes_;
+
+    };
+
+        template <typename VT, typename CS, ColourLayout CL>
+        PlanarImage<VT, CS, CL>::PlanarImage(Int2 shape) {
+            reset(shape);
+        }
+
+        template <typename VT, typename CS, ColourLayout CL>
+        PlanarImage<VT, CS, CL>::PlanarImage(Int2 shape, colour_type c) {
+            reset(shape);
+            fill(c);
+        }
+
+        template <typename VT, typename CS, ColourLayout CL>
+        PlanarImage<VT, CS, CL>::PlanarImage(Int2 shape, const colour_type* pixels) {
+            reset(shape);
+            deinterleave(pixels, view());
+        }
+
+        template <typename VT, typename CS, ColourLayout CL>
+        typename PlanarImage<VT, CS, CL>::view_type PlanarImage<VT, CS, CL>::view() noexcept {
+            std::array<VT*, planes> ptrs;
+            for (int i = 0; i < planes; ++i)
+                ptrs[i] = planes_[i].data();
+            return {ptrs, shape(), shape().x()};
+        }
+
+        template <typename VT, typename CS, ColourLayout CL>
+        typename PlanarImage<VT, CS, CL>::const_view_type PlanarImage<VT, CS, CL>::view() const noexcept {
+            std::array<const VT*, planes> ptrs;
+            for (int i = 0; i < planes; ++i)
+                ptrs[i] = planes_[i].data();
+            return {ptrs, shape(), shape().x()};
+        }
+
+        template <typename VT, typename CS, ColourLayout CL>
+        void PlanarImage<VT, CS, CL>::fill(colour_type c) {
+            for (int i = 0; i < colour_space_channels; ++i)
+                planes_[i].fill(c.cs(i));
+            if constexpr (has_alpha)
+                planes_[colour_space_channels].fill(c.alpha());
+        }
+
+        template <typename VT, typename CS, ColourLayout CL>
+        void PlanarImage<VT, CS, CL>::reset(Int2 shape) {
+            if (shape.x() < 0 || shape.y() < 0)
+                throw std::invalid_argument("Invalid planar image shape");
+            for (auto& p: planes_)
+                p.reset(shape);
+        }
+
+    namespace Detail {
+
+        size_t deinterleave_float_simd(const float* in, float* const* out, int channels, size_t n) noexcept;
+        size_t interleave_float_simd(const float* const* in, float* out, int channels, size_t n) noexcept;
+        size_t planar_matrix_simd(const float* const* in, float* const* out, const float* matrix, size_t n) noexcept;
+
+        // Position of each planar channel within the interleaved colour
+
+        template <typename C>
+        std::array<int, C::channels> planar_channel_offsets() noexcept {
+            std::array<int, C::channels> offsets;
+            C c;
+            for (int i = 0; i < C::colour_space_channels; ++i)
+                offsets[i] = int(&c.cs(i) - c.begin());
+            if constexpr (C::has_alpha)
+                offsets[C::colour_space_channels] = int(&c.alpha() - c.begin());
+            return offsets;
+        }
+
+        template <typename VT, size_t N>
+        void deinterleave_row(const VT* in, const std::array<VT*, N>& out, const std::array<int, N>& offsets, size_t n) noexcept {
+            size_t i = 0;
+            if constexpr (std::is_same_v<VT, float> && (N == 3 || N == 4)) {
+                std::array<float*, N> ordered;
+                for (size_t j = 0; j < N; ++j)
+                    ordered[offsets[j]] = out[j];
+                i = deinterleave_float_simd(in, ordered.data(), int(N), n);
+            }
+            for (; i < n; ++i)
+                for (size_t j = 0; j < N; ++j)
+                    out[j][i] = in[N * i + offsets[j]];
+        }
+
+        template <typename VT, size_t N>
+        void interleave_row(const std::array<const VT*, N>& in, VT* out, const std::array<int, N>& offsets, size_t n) noexcept {
+            size_t i = 0;
+            if constexpr (std::is_same_v<VT, float> && (N == 3 || N == 4)) {
+                std::array<const float*, N> ordered;
+                for (size_t j = 0; j < N; ++j)
+                    ordered[offsets[j]] = in[j];
+                i = interleave_float_simd(ordered.data(), out, int(N), n);
+            }
+            for (; i < n; ++i)
+                for (size_t j = 0; j < N; ++j)
+                    out[N * i + offsets[j]] = in[j][i];
+        }
+
+        // Conversion of planar rows, following the same pipeline as
+        // convert_colour() so the results are identical, but applying each
+        // step to a block of every plane at a time. Channel scaling and
+        // transfer functions work on contiguous runs of one channel, and
+        // conversions that reduce to a single matrix (between linear RGB
+        // spaces, or from one to the linear base of a transfer space) use
+        // a planar matrix kernel.
+
+        template <bool Fast, typename C1, typename C2>
+        struct PlanarConverter {
+
+            using P = ColourPipeline<C1, C2, Fast>;
+            using VT1 = typename C1::value_type;
+            using VT2 = typename C2::value_type;
+            using CS1 = typename C1::colour_space;
+            using CS2 = typename C2::colour_space;
+            using CSW = typename P::CSW;
+            using WT = typename P::WT;
+
+            static constexpr bool encoding = P::encode_table || P::fast_encode;
+            using CST = std::conditional_t<encoding, typename CS2::base, CS2>;
+
+            static constexpr bool identity_step = std::is_same_v<CSW, CST>
+                && (! encoding || route_step<CSW, CS2>() != RouteStep::up);
+            static constexpr bool matrix_step = std::is_same_v<WT, float>
+                && route_step<CSW, CST>() == RouteStep::matrix
+                && (! encoding || route_step<CSW, CS2>() != RouteStep::up);
+            // Floating point channels with unit scale pass through the
+            // scaling steps unchanged, so the planes can be used directly
+
+            static constexpr bool direct_in = std::is_same_v<VT1, WT> && C1::scale == 1
+                && ! P::decode_table && ! P::fast_decode;
+            static constexpr bool direct_out = std::is_same_v<VT2, WT> && C2::scale == 1
+                && ! P::encode_table;
+            static constexpr bool scale_in = std::is_same_v<VT1, uint8_t> && std::is_same_v<WT, float>
+                && C1::scale == 255 && ! P::decode_table && ! P::fast_decode;
+            static constexpr bool scale_out = std::is_same_v<VT2, uint8_t> && std::is_same_v<WT, float>
+                && C2::scale == 255 && ! P::encode_table && ! P::fast_encode;
+
+            static constexpr int n1 = P::in_channels;
+            static constexpr int n2 = P::out_channels;
+            static constexpr size_t block = 64;
+
+            static void convert(const std::array<const VT1*, C1::channels>& in,
+                    const std::array<VT2*, C2::channels>& out, size_t n) noexcept {
+
+                std::array<std::array<WT, block>, n1> decoded;
+                std::array<std::array<WT, block>, n2> linear;
+                std::array<const WT*, n1> src;
+                std::array<WT*, n2> dst;
+
+                for (size_t i0 = 0; i0 < n; i0 += block) {
+
+                    size_t m = std::min(block, n - i0);
+
+                    for (int j = 0; j < n1; ++j) {
+                        auto p = in[j] + i0;
+                        if constexpr (direct_in) {
+                            src[j] = p;
+                        } else {
+                            auto q = decoded[j].data();
+                            src[j] = q;
+                            size_t k = 0;
+                            if constexpr (P::fast_decode) {
+                                for (; k < m; ++k)
+                                    q[k] = channel_to_working_type<float>(p[k], C1::scale);
+                                FastTransfer<CS1>::decode(q, q, m);
+                            } else {
+                                if constexpr (scale_in)
+                                    k = unorm8_to_float_simd(p, q, m);
+                                for (; k < m; ++k)
+                                    q[k] = P::decode(p[k]);
+                            }
+                        }
+                    }
+
+                    for (int j = 0; j < n2; ++j) {
+                        if constexpr (direct_out)
+                            dst[j] = out[j] + i0;
+                        else
+                            dst[j] = linear[j].data();
+                    }
+
+                    if constexpr (identity_step) {
+                        for (int j = 0; j < n2; ++j)
+                            if (dst[j] != src[j])
+                                std::copy_n(src[j], m, dst[j]);
+                    } else if constexpr (matrix_step) {
+                        static const auto matrix = [] {
+                            std::array<float, 9> a;
+                            for (int r = 0; r < 3; ++r)
+                                for (int c = 0; c < 3; ++c)
+                                    a[3 * r + c] = linear_conversion_matrix<CSW, CST, float>(r, c);
+                            return a;
+                        }();
+                        size_t k = planar_matrix_simd(src.data(), dst.data(), matrix.data(), m);
+                        for (; k < m; ++k) {
+                            float x[3] = {src[0][k], src[1][k], src[2][k]};
+                            for (int r = 0; r < 3; ++r) {
+                                float y = 0;
+                                for (int c = 0; c < 3; ++c)
+                                    y += matrix[3 * r + c] * x[c];
+                                dst[r][k] = y;
+                            }
+                        }
+                    } else {
+                        for (size_t k = 0; k < m; ++k) {
+                            typename P::in_vector colour;
+                            for (int j = 0; j < n1; ++j)
+                                colour[j] = src[j][k];
+                            auto result = P::convert(colour);
+                            for (int j = 0; j < n2; ++j)
+                                dst[j][k] = result[j];
+                        }
+                    }
+
+                    for (int j = 0; j < n2; ++j) {
+                        auto p = dst[j];
+                        if constexpr (direct_out) {
+                            if constexpr (P::fast_encode)
+                                FastTransfer<CS2>::encode(p, p, m);
+                        } else {
+                            auto q = out[j] + i0;
+                            size_t k = 0;
+                            if constexpr (P::fast_encode) {
+                                FastTransfer<CS2>::encode(p, p, m);
+                                for (; k < m; ++k)
+                                    q[k] = working_type_to_channel(p[k], C2::scale);
+                            } else {
+                                if constexpr (scale_out)
+                                    k = float_to_unorm8_simd(p, q, m);
+                                for (; k < m; ++k)
+                                    q[k] = P::encode(p[k]);
+                            }
+                        }
+                    }
+
+                }
+
+                if constexpr (C2::has_alpha) {
+                    auto q = out[n2];
+                    if constexpr (C1::has_alpha) {
+                        auto p = in[n1];
+                        size_t i = 0;
+                        if constexpr (std::is_same_v<VT1, VT2> && C1::scale == C2::scale && std::is_floating_point_v<VT1>)
+                            i = (std::copy_n(p, n, q), n);
+                        else if constexpr (std::is_same_v<VT1, uint8_t> && std::is_same_v<VT2, float>
+                                && C1::scale == 255 && C2::scale == 1)
+                            i = unorm8_to_float_simd(p, q, n);
+                        else if constexpr (std::is_same_v<VT1, float> && std::is_same_v<VT2, uint8_t>
+                                && C1::scale == 1 && C2::scale == 255)
+                            i = float_to_unorm8_simd(p, q, n);
+                        for (; i < n; ++i)
+                            q[i] = P::alpha(p[i]);
+                    } else {
+                        std::fill_n(q, n, P::alpha(C1::scale));
+                    }
+                }
+
+            }
+
+        };
+
+    }
+
+    template <typename VT, typename CS, ColourLayout CL>
+    void deinterleave(const Colour<VT, CS, CL>* in, const PlanarView<VT, CS, CL>& out) noexcept {
+        using C = Colour<VT, CS, CL>;
+        static const auto offsets = Detail::planar_channel_offsets<C>();
+        std::array<VT*, C::channels> ptrs;
+        for (int y = 0; y < out.height(); ++y, in += out.width()) {
+            for (int i = 0; i < C::channels; ++i)
+                ptrs[i] = out.row(i, y);
+            Detail::deinterleave_row(in->begin(), ptrs, offsets, size_t(out.width()));
+        }
+    }
+
+    template <typename VT, typename CS, ColourLayout CL>
+    void interleave(const PlanarView<VT, CS, CL>& in, Colour<std::remove_const_t<VT>, CS, CL>* out) noexcept {
+        using C = Colour<std::remove_const_t<VT>, CS, CL>;
+        using CT = const std::remove_const_t<VT>;
+        static const auto offsets = Detail::planar_channel_offsets<C>();
+        std::array<CT*, C::channels> ptrs;
+        for (int y = 0; y < in.height(); ++y, out += in.width()) {
+            for (int i = 0; i < C::channels; ++i)
+                ptrs[i] = in.row(i, y);
+            Detail::interleave_row(ptrs, out->begin(), offsets, size_t(in.width()));
+        }
+    }
+
+    template <typename VT1, typename CS1, ColourLayout CL1,
+        typename VT2, typename CS2, ColourLayout CL2>
+    void convert_colour(const PlanarView<VT1, CS1, CL1>& in, const PlanarView<VT2, CS2, CL2>& out,
+            ColourPrecision precision = ColourPrecision::exact) {
+
+        static_assert(! std::is_const_v<VT2>);
+
+        using C1 = Colour<std::remove_const_t<VT1>, CS1, CL1>;
+        using C2 = Colour<VT2, CS2, CL2>;
+        using CT1 = const std::remove_const_t<VT1>;
+
+        if (in.shape() != out.shape())
+            throw std::invalid_argument("Planar image shapes do not match");
+
+        std::array<CT1*, C1::channels> src;
+        std::array<VT2*, C2::channels> dst;
+        auto n = size_t(in.width());
+
+        for (int y = 0; y < in.height(); ++y) {
+
+            for (int i = 0; i < C1::channels; ++i)
+                src[i] = in.row(i, y);
+            for (int i = 0; i < C2::channels; ++i)
+                dst[i] = out.row(i, y);
+
+            if constexpr (std::is_same_v<std::remove_const_t<VT1>, VT2> && std::is_same_v<CS1, CS2>) {
+                for (int i = 0; i < C2::colour_space_channels; ++i)
+                    std::copy_n(src[i], n, dst[i]);
+                if constexpr (C2::has_alpha) {
+                    if constexpr (C1::has_alpha)
+                        std::copy_n(src[C1::colour_space_channels], n, dst[C2::colour_space_channels]);
+                    else
+                        std::fill_n(dst[C2::colour_space_channels], n, C1::scale);
+                }
+            } else if (precision == ColourPrecision::fast) {
+                Detail::PlanarConverter<true, C1, C2>::convert(src, dst, n);
+            } else {
+                Detail::PlanarConverter<false, C1, C2>::convert(src, dst, n);
+            }
+
+        }
+
+    }
+
+}
@@ -0,0 +1,81 @@
+#include "rs-graphics-core/simd.hpp"
+#include <algorithm>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define RS_GRAPHICS_X86 1
+    #ifdef _MSC_VER
+        #include <immintrin.h>
+        #include <intrin.h>
+    #endif
+#endif
+
+namespace RS::Graphics::Core {
+
+    namespace {
+
+        std::atomic<int> simd_limit(int(SimdLevel::avx512));
+
+        SimdLevel detect_simd_level() noexcept {
+
+            #if defined(RS_GRAPHICS_X86) && defined(_MSC_VER)
+
+                int info[4];
+                __cpuid(info, 0);
+                int max_leaf = info[0];
+                __cpuid(info, 1);
+                bool sse2 = (info[3] & (1 << 26)) != 0;
+                bool osxsave = (info[2] & (1 << 27)) != 0;
+                bool avx = (info[2] & (1 << 28)) != 0;
+                unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+                bool avx2 = false;
+                bool avx512 = false;
+
+                if (max_leaf >= 7) {
+                    __cpuidex(info, 7, 0);
+                    avx2 = (info[1] & (1 << 5)) != 0;
+                    avx512 = (info[1] & (1 << 16)) != 0;
+                }
+
+                // The OS must save the YMM (and for AVX-512 the ZMM and mask) registers
+
+                if (avx && avx512 && (xcr0 & 0xe6) == 0xe6)
+                    return SimdLevel::avx512;
+                if (avx && avx2 && (xcr0 & 0x6) == 0x6)
+                    return SimdLevel::avx2;
+                if (sse2)
+                    return SimdLevel::sse2;
+                return SimdLevel::none;
+
+            #elif defined(RS_GRAPHICS_X86)
+
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx512f"))
+                    return SimdLevel::avx512;
+                if (__builtin_cpu_supports("avx2"))
+                    return SimdLevel::avx2;
+                if (__builtin_cpu_supports("sse2"))
+                    return SimdLevel::sse2;
+                return SimdLevel::none;
+
+            #else
+
+                return SimdLevel::none;
+
+            #endif
+
+        }
+
+    }
+
+    SimdLevel simd_level() noexcept {
+        static const SimdLevel detected = detect_simd_level();
+        auto limit = SimdLevel(simd_limit.load(std::memory_order_relaxed));
+        return std::min(detected, limit);
+    }
+
+    void limit_simd_level(SimdLevel max) noexcept {
+        simd_limit.store(int(max), std::memory_order_relaxed);
+    }
+
+}
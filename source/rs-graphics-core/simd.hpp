@@ -0,0 +1,66 @@
+#pragma once
+
+#include "rs-tl/enum.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+namespace RS::Graphics::Core {
+
+    RS_DEFINE_ENUM_CLASS(SimdLevel, int, 0,
+        none,
+        sse2,
+        avx2,
+        avx512
+    )
+
+    SimdLevel simd_level() noexcept;
+    void limit_simd_level(SimdLevel max) noexcept;
+
+    namespace Detail {
+
+        // Finishes a batch by running a vector kernel over a copy of the
+        // final partial block, padded out by repeating the last item, so
+        // that every item in the batch is calculated by the same code. The
+        // kernel is called as kernel(in..., out, n) and returns the number of
+        // items it processed (a whole number of blocks). Widths are in
+        // elements per item, at most 4. Returns n.
+
+        template <size_t Block, typename In, typename Out, typename Kernel>
+        size_t simd_padded(const In* in, size_t in_width, Out* out, size_t out_width, size_t n, Kernel kernel) noexcept {
+            size_t i = kernel(in, out, n);
+            size_t m = n - i;
+            if (m == 0)
+                return n;
+            std::array<In, 4 * Block> in_buf;
+            std::array<Out, 4 * Block> out_buf;
+            for (size_t j = 0; j < Block; ++j)
+                std::copy_n(in + (i + std::min(j, m - 1)) * in_width, in_width, in_buf.data() + j * in_width);
+            kernel(in_buf.data(), out_buf.data(), Block);
+            std::copy_n(out_buf.data(), m * out_width, out + i * out_width);
+            return n;
+        }
+
+        template <size_t Block, typename In, typename Out, typename Kernel>
+        size_t simd_padded(const In* in1, const In* in2, size_t in_width, Out* out, size_t out_width, size_t n,
+                Kernel kernel) noexcept {
+            size_t i = kernel(in1, in2, out, n);
+            size_t m = n - i;
+            if (m == 0)
+                return n;
+            std::array<In, 4 * Block> in1_buf;
+            std::array<In, 4 * Block> in2_buf;
+            std::array<Out, 4 * Block> out_buf;
+            for (size_t j = 0; j < Block; ++j) {
+                size_t k = (i + std::min(j, m - 1)) * in_width;
+                std::copy_n(in1 + k, in_width, in1_buf.data() + j * in_width);
+                std::copy_n(in2 + k, in_width, in2_buf.data() + j * in_width);
+            }
+            kernel(in1_buf.data(), in2_buf.data(), out_buf.data(), Block);
+            std::copy_n(out_buf.data(), m * out_width, out + i * out_width);
+            return n;
+        }
+
+    }
+
+}
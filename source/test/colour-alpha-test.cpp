@@ -1,12 +1,86 @@
 #include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/multi-array.hpp"
+#include "rs-graphics-core/simd.hpp"
 #include "rs-graphics-core/vector.hpp"
 #include "rs-unit-test.hpp"
 #include "test/colour-space-test.hpp"
 #include "test/vector-test.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <vector>
 
 using namespace RS::Graphics::Core;
 using namespace RS::Graphics::Core::Test;
 
+namespace {
+
+    // Random colours, already premultiplied if the flag says so, with
+    // some fully transparent and fully opaque pixels
+
+    template <typename C>
+    std::vector<C> random_blend_colours(size_t n, Pma flag, Pma flags, unsigned seed) {
+        std::minstd_rand rng(seed);
+        std::uniform_real_distribution<double> dist(0, 1);
+        std::vector<C> colours(n);
+        for (auto& c: colours) {
+            for (auto& x: c)
+                x = typename C::value_type(dist(rng) * double(C::scale));
+            if (dist(rng) < 0.1)
+                c.alpha() = 0;
+            else if (dist(rng) < 0.1)
+                c.alpha() = C::scale;
+            if (!! (flags & flag))
+                c = c.multiply_alpha();
+        }
+        return colours;
+    }
+
+    // Check that span blending matches the scalar function exactly (or
+    // the integer reference in fast mode), and that integer fast mode is
+    // within the given tolerance of the exact result where the result
+    // alpha is at least half the scale
+
+    template <typename C>
+    int check_blend_span(Pma flags, ColourPrecision precision, int tolerance = 0) {
+
+        static constexpr size_t n = 103;
+
+        auto a = random_blend_colours<C>(n, Pma::first, flags, 42);
+        auto b = random_blend_colours<C>(n, Pma::second, flags, 86);
+        std::vector<C> expect(n), out(n), in_place(b);
+        int errors = 0;
+
+        alpha_blend(a.data(), b.data(), out.data(), n, flags, precision);
+        alpha_blend(a.data(), in_place.data(), n, flags, precision);
+
+        for (size_t i = 0; i < n; ++i) {
+            auto exact = alpha_blend(a[i], b[i], flags);
+            expect[i] = exact;
+            if constexpr (std::is_integral_v<typename C::value_type>) {
+                if (precision == ColourPrecision::fast) {
+                    Detail::alpha_blend_unorm(a[i].begin(), b[i].begin(), expect[i].begin(), C::alpha_index, flags);
+                    if (2 * int(exact.alpha()) >= int(C::scale))
+                        for (int j = 0; j < C::channels; ++j)
+                            errors += int(std::abs(int(out[i][j]) - int(exact[j])) > tolerance);
+                }
+            }
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            if (std::is_floating_point_v<typename C::value_type> && expect[i].alpha() == 0)
+                errors += int(out[i].alpha() != 0 || in_place[i].alpha() != 0);
+            else
+                errors += int(out[i] != expect[i]) + int(in_place[i] != expect[i]);
+        }
+
+        return errors;
+
+    }
+
+}
+
 void test_rs_graphics_core_colour_channel_order() {
 
     Colour<double, LinearRGB, ColourLayout::forward> a;
@@ -96,3 +170,42 @@ void test_rs_graphics_core_colour_alpha_blending() {
     TEST_VECTORS(f, Double4(82,120,158,238), 1);
 
 }
+
+void test_rs_graphics_core_colour_alpha_blending_spans() {
+
+    using Argbf = Colour<float, LinearRGB, ColourLayout::alpha_forward>;
+    using Argb8 = Colour<uint8_t, LinearRGB, ColourLayout::alpha_forward>;
+
+    auto native = simd_level();
+
+    for (auto level: {SimdLevel::none, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512}) {
+
+        if (level > native)
+            break;
+
+        TRY(limit_simd_level(level));
+
+        for (int i = 0; i < 8; ++i) {
+            auto flags = Pma(i);
+            TEST_EQUAL(check_blend_span<Rgbaf>(flags, ColourPrecision::exact), 0);
+            TEST_EQUAL(check_blend_span<Argbf>(flags, ColourPrecision::exact), 0);
+            TEST_EQUAL(check_blend_span<Rgbad>(flags, ColourPrecision::exact), 0);
+            TEST_EQUAL(check_blend_span<Rgba8>(flags, ColourPrecision::exact), 0);
+            TEST_EQUAL(check_blend_span<Rgba8>(flags, ColourPrecision::fast, 2), 0);
+            TEST_EQUAL(check_blend_span<Argb8>(flags, ColourPrecision::fast, 2), 0);
+            TEST_EQUAL(check_blend_span<Rgba16>(flags, ColourPrecision::fast, 2), 0);
+        }
+
+    }
+
+    TRY(limit_simd_level(SimdLevel::avx512));
+    TEST_EQUAL(simd_level(), native);
+
+    MultiArray<Rgba8, 2> src(Int2(3, 2), Rgba8(200, 100, 0, 128)), dst(Int2(3, 2), Rgba8(0, 0, 200, 255)), bad(Int2(2, 3));
+
+    TRY(alpha_blend(src, dst, Pma::none, ColourPrecision::fast));
+    TEST_EQUAL(dst(2, 1), Rgba8(100, 50, 100, 255));
+    TEST_EQUAL(dst(0, 0), alpha_blend(Rgba8(200, 100, 0, 128), Rgba8(0, 0, 200, 255)));
+    TEST_THROW(alpha_blend(src, bad), std::invalid_argument);
+
+}
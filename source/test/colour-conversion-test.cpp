@@ -1,12 +1,305 @@
 #include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/simd.hpp"
 #include "rs-graphics-core/vector.hpp"
 #include "rs-unit-test.hpp"
 #include "test/colour-space-test.hpp"
 #include "test/vector-test.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 using namespace RS::Graphics::Core;
 using namespace RS::Graphics::Core::Test;
 
+namespace {
+
+    // Check that bulk conversion gives exactly the same results as
+    // converting each colour in turn, both contiguous and strided
+
+    template <typename C1, typename C2>
+    int check_bulk_conversion() {
+
+        static constexpr size_t n = 1000;
+        static constexpr ptrdiff_t in_stride = 3;
+        static constexpr ptrdiff_t out_stride = 2;
+
+        std::minstd_rand rng(42);
+        std::uniform_real_distribution<double> dist(0, 1);
+        std::vector<C1> in(in_stride * n);
+        std::vector<C2> expect(n), out(n), strided(out_stride * n);
+        int errors = 0;
+
+        for (auto& c: in)
+            for (auto& x: c)
+                x = typename C1::value_type(dist(rng) * double(C1::scale));
+
+        for (size_t i = 0; i < n; ++i)
+            convert_colour(in[i], expect[i]);
+
+        convert_colour(in.data(), out.data(), n);
+
+        for (size_t i = 0; i < n; ++i)
+            errors += int(out[i] != expect[i]);
+
+        for (size_t i = 0; i < n; ++i)
+            convert_colour(in[in_stride * i], expect[i]);
+
+        convert_colour(in.data(), in_stride, strided.data(), out_stride, n);
+
+        for (size_t i = 0; i < n; ++i)
+            errors += int(strided[out_stride * i] != expect[i]);
+
+        return errors;
+
+    }
+
+    // Reference conversion, calling the transfer functions directly
+
+    template <typename C1, typename C2>
+    C2 direct_conversion(const C1& in) {
+        using WT = Detail::WorkingChannelType<typename C1::value_type, typename C2::value_type>;
+        using CS1 = typename C1::colour_space;
+        using CS2 = typename C2::colour_space;
+        Vector<WT, C1::colour_space_channels> v1;
+        for (int i = 0; i < C1::colour_space_channels; ++i)
+            v1[i] = Detail::channel_to_working_type<WT>(in.cs(i), C1::scale);
+        auto v2 = convert_colour_space<CS1, CS2>(v1);
+        C2 out;
+        for (int i = 0; i < C2::colour_space_channels; ++i)
+            out.cs(i) = Detail::working_type_to_channel(v2[i], C2::scale);
+        if constexpr (C2::has_alpha)
+            out.alpha() = Detail::working_type_to_channel(Detail::channel_to_working_type<WT>(in.alpha(), C1::scale), C2::scale);
+        return out;
+    }
+
+    // Every value of an integer channel (varying the channels out of step)
+
+    template <typename C1, typename C2>
+    int check_decoding() {
+        using VT = typename C1::value_type;
+        static constexpr int max = std::numeric_limits<VT>::max();
+        int errors = 0;
+        for (int i = 0; i <= max; ++i) {
+            C1 in;
+            for (int j = 0; j < C1::channels; ++j)
+                in[j] = VT((i + j * 97) % (max + 1));
+            C2 out;
+            convert_colour(in, out);
+            errors += int(out != direct_conversion<C1, C2>(in));
+        }
+        return errors;
+    }
+
+    // Values on either side of each rounding boundary, plus random values
+    // including some out of range
+
+    template <typename C1, typename C2>
+    int check_encoding() {
+        using VT = typename C1::value_type;
+        using CS2 = typename C2::colour_space;
+        std::minstd_rand rng(42);
+        std::uniform_real_distribution<double> dist(-0.1, 1.1);
+        std::vector<C1> inputs;
+        for (int code = 0; code < 256; ++code) {
+            VT x = Detail::transfer_decode<CS2>((VT(code) + VT(0.5)) / VT(255));
+            for (int i = 0; i < 20; ++i) {
+                inputs.push_back(C1(x));
+                x = std::nextafter(x, VT(0));
+            }
+        }
+        for (int i = 0; i < 10000; ++i) {
+            C1 in;
+            for (auto& x: in)
+                x = VT(dist(rng));
+            inputs.push_back(in);
+        }
+        int errors = 0;
+        for (auto& in: inputs) {
+            C2 out;
+            convert_colour(in, out);
+            errors += int(out != direct_conversion<C1, C2>(in));
+        }
+        return errors;
+    }
+
+    // Bulk encoding to 8-bit sRGB, which has its own vector path: the same
+    // rounding boundaries and out of range values as check_encoding(), plus
+    // NaN and infinity, must match the scalar function exactly
+
+    template <typename C1, typename C2>
+    int check_bulk_srgb8_encoding() {
+        std::minstd_rand rng(42);
+        std::uniform_real_distribution<float> dist(-0.1f, 1.1f);
+        std::vector<C1> in;
+        for (int code = 0; code < 256; ++code) {
+            float x = Detail::transfer_decode<sRGB>((float(code) + 0.5f) / 255.0f);
+            for (int i = 0; i < 20; ++i) {
+                in.push_back(C1(x));
+                x = std::nextafter(x, 0.0f);
+            }
+        }
+        for (float x: {std::nanf(""), std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), -0.0f, 1.0f})
+            in.push_back(C1(x));
+        for (int i = 0; i < 10003; ++i) {
+            C1 c;
+            for (auto& x: c)
+                x = dist(rng);
+            in.push_back(c);
+        }
+        std::vector<C2> expect(in.size()), out(in.size());
+        for (size_t i = 0; i < in.size(); ++i)
+            convert_colour(in[i], expect[i]);
+        convert_colour(in.data(), out.data(), in.size());
+        int errors = 0;
+        for (size_t i = 0; i < in.size(); ++i)
+            errors += int(out[i] != expect[i]);
+        return errors;
+    }
+
+    // Fast mode: the bulk conversion must match the scalar fast conversion
+    // exactly, and both must stay within the tolerance of the exact
+    // conversion (measured in units of the output channel)
+
+    template <typename C1, typename C2>
+    int check_fast_conversion(double tolerance) {
+
+        static constexpr size_t n = 1000;
+        static constexpr ptrdiff_t in_stride = 3;
+        static constexpr ptrdiff_t out_stride = 2;
+
+        std::minstd_rand rng(42);
+        std::uniform_real_distribution<double> dist(0, 1);
+        std::vector<C1> in(in_stride * n);
+        std::vector<C2> expect(n), out(n), strided(out_stride * n);
+        int errors = 0;
+
+        for (auto& c: in)
+            for (auto& x: c)
+                x = typename C1::value_type(dist(rng) * double(C1::scale));
+
+        for (size_t i = 0; i < n; ++i) {
+            C2 exact, inexact;
+            convert_colour(in[i], exact, ColourPrecision::exact);
+            errors += int(exact != direct_conversion<C1, C2>(in[i]));
+            convert_colour(in[i], inexact, ColourPrecision::fast);
+            for (int j = 0; j < C2::channels; ++j)
+                errors += int(std::abs(double(inexact[j]) - double(exact[j])) > tolerance);
+            expect[i] = inexact;
+        }
+
+        convert_colour(in.data(), out.data(), n, ColourPrecision::fast);
+
+        for (size_t i = 0; i < n; ++i)
+            errors += int(out[i] != expect[i]);
+
+        for (size_t i = 0; i < n; ++i)
+            convert_colour(in[in_stride * i], expect[i], ColourPrecision::fast);
+
+        convert_colour(in.data(), in_stride, strided.data(), out_stride, n, ColourPrecision::fast);
+
+        for (size_t i = 0; i < n; ++i)
+            errors += int(strided[out_stride * i] != expect[i]);
+
+        return errors;
+
+    }
+
+    // Maximum error of the approximate transfer functions against the exact
+    // functions in double precision, over a dense sweep of [0,1], and the
+    // number of mismatches between the scalar and bulk versions
+
+    template <typename CS>
+    std::pair<double, int> check_fast_transfer() {
+
+        using FT = Detail::FastTransfer<CS>;
+
+        static constexpr size_t n = (1 << 20) + 1;
+
+        std::vector<float> in(n), decoded(n), encoded(n);
+        double max_error = 0;
+        int mismatches = 0;
+
+        for (size_t i = 0; i < n; ++i)
+            in[i] = float(i) / float(n - 1);
+
+        FT::decode(in.data(), decoded.data(), n);
+        FT::encode(in.data(), encoded.data(), n);
+
+        for (size_t i = 0; i < n; ++i) {
+            double x = in[i];
+            max_error = std::max(max_error, std::abs(double(FT::decode(in[i])) - Detail::transfer_decode<CS>(x)));
+            max_error = std::max(max_error, std::abs(double(FT::encode(in[i])) - Detail::transfer_encode<CS>(x)));
+            mismatches += int(decoded[i] != FT::decode(in[i])) + int(encoded[i] != FT::encode(in[i]));
+        }
+
+        return {max_error, mismatches};
+
+    }
+
+    // Maximum error of the fast perceptual space steps against the exact
+    // ones in double precision, over random sRGB colours, and the number
+    // of mismatches between the scalar and bulk versions (including in
+    // place). The error in hue is measured around the circle.
+
+    template <typename CS>
+    std::tuple<double, double, int> check_fast_space() {
+
+        using FS = Detail::FastSpace<CS>;
+        using BCS = typename CS::base;
+
+        static constexpr size_t n = 1003;
+
+        std::minstd_rand rng(42);
+        std::uniform_real_distribution<double> dist(0, 1);
+        std::vector<float> base(3 * n), space(3 * n), from(3 * n), to(3 * n);
+        std::vector<Double3> exact_base(n), exact_space(n);
+        double from_error = 0;
+        double to_error = 0;
+        int mismatches = 0;
+
+        for (size_t i = 0; i < n; ++i) {
+            Double3 rgb(dist(rng), dist(rng), dist(rng));
+            exact_base[i] = convert_colour_space<sRGB, BCS>(rgb);
+            exact_space[i] = convert_colour_space<sRGB, CS>(rgb);
+            for (int j = 0; j < 3; ++j) {
+                base[3 * i + j] = float(exact_base[i][j]);
+                space[3 * i + j] = float(exact_space[i][j]);
+            }
+        }
+
+        FS::from_base(base.data(), from.data(), n);
+        FS::to_base(space.data(), to.data(), n);
+
+        for (size_t i = 0; i < n; ++i) {
+            auto f = FS::from_base(Float3(base.data() + 3 * i));
+            auto t = FS::to_base(Float3(space.data() + 3 * i));
+            for (int j = 0; j < 3; ++j) {
+                double d = std::abs(double(f[j]) - exact_space[i][j]);
+                if (cs_is_polar<CS> && j == 0)
+                    d = std::min(d, 1 - d);
+                from_error = std::max(from_error, d);
+                to_error = std::max(to_error, std::abs(double(t[j]) - exact_base[i][j]));
+                mismatches += int(from[3 * i + j] != f[j]) + int(to[3 * i + j] != t[j]);
+            }
+        }
+
+        auto copy = base;
+        FS::from_base(copy.data(), copy.data(), n);
+        mismatches += int(copy != from);
+        copy = space;
+        FS::to_base(copy.data(), copy.data(), n);
+        mismatches += int(copy != to);
+
+        return {from_error, to_error, mismatches};
+
+    }
+
+}
+
 void test_rs_graphics_core_colour_conversion_between_colour_spaces() {
 
     using C_sRGB = Colour<double, sRGB, ColourLayout::forward>;
@@ -160,3 +453,273 @@ void test_rs_graphics_core_colour_conversion_between_representations() {
     TRY(convert_colour(cdar, cuar));  TEST_VECTORS(cuar, Int4(0xcccc,0x9999,0x6666,0x3333),  0);
 
 }
+
+void test_rs_graphics_core_colour_conversion_bulk() {
+
+    using Rgba8r = Colour<uint8_t, LinearRGB, ColourLayout::reverse_alpha>;
+    using Rgbaf_r = Colour<float, LinearRGB, ColourLayout::alpha_reverse>;
+    using sRgba8_r = Colour<uint8_t, sRGB, ColourLayout::alpha_reverse>;
+    using sRgbaf = Colour<float, sRGB, ColourLayout::forward_alpha>;
+    using CIELabd = Colour<double, CIELab>;
+    using HSLf = Colour<float, HSL>;
+
+    TEST_EQUAL((check_bulk_conversion<Rgba8, Rgba8>()), 0);
+    TEST_EQUAL((check_bulk_conversion<Rgba8, Rgba8r>()), 0);
+    TEST_EQUAL((check_bulk_conversion<Rgba8, Rgbaf>()), 0);
+    TEST_EQUAL((check_bulk_conversion<Rgbaf, Rgba8>()), 0);
+    TEST_EQUAL((check_bulk_conversion<Rgbaf, Rgba16>()), 0);
+    TEST_EQUAL((check_bulk_conversion<Rgba16, Rgbaf_r>()), 0);
+    TEST_EQUAL((check_bulk_conversion<Rgb8, Rgbaf>()), 0);
+    TEST_EQUAL((check_bulk_conversion<Rgbaf, Rgb8>()), 0);
+    TEST_EQUAL((check_bulk_conversion<sRgba8, Rgbaf>()), 0);
+    TEST_EQUAL((check_bulk_conversion<Rgbaf, sRgba8>()), 0);
+    TEST_EQUAL((check_bulk_conversion<sRgba8, sRgbaf>()), 0);
+    TEST_EQUAL((check_bulk_conversion<sRgbaf, sRgba8>()), 0);
+    TEST_EQUAL((check_bulk_conversion<sRgb8, Rgbf>()), 0);
+    TEST_EQUAL((check_bulk_conversion<Rgbf, sRgb8>()), 0);
+    TEST_EQUAL((check_bulk_conversion<sRgba8_r, Rgbaf_r>()), 0);
+    TEST_EQUAL((check_bulk_conversion<Rgbaf_r, sRgba8_r>()), 0);
+    TEST_EQUAL((check_bulk_conversion<sRgb8, CIELabd>()), 0);
+    TEST_EQUAL((check_bulk_conversion<CIELabd, sRgbd>()), 0);
+    TEST_EQUAL((check_bulk_conversion<sRgbf, HSLf>()), 0);
+
+    // Rounding boundaries and out of range values must match the scalar
+    // function exactly, including wraparound in integer channels
+
+    std::vector<Rgbaf> edge;
+    std::vector<Rgba8> expect, out;
+
+    for (int i = -4; i <= 259; ++i)
+        for (float d: {-0.5f, -0.25f, 0.0f, 0.25f, 0.5f, 0.75f})
+            edge.push_back(Rgbaf((float(i) + d) / 255.0f));
+
+    TRY(expect.resize(edge.size()));
+    TRY(out.resize(edge.size()));
+
+    for (size_t i = 0; i < edge.size(); ++i)
+        TRY(convert_colour(edge[i], expect[i]));
+
+    std::vector<Rgbaf> back(edge.size()), back_expect(edge.size());
+
+    for (size_t i = 0; i < edge.size(); ++i)
+        TRY(convert_colour(expect[i], back_expect[i]));
+
+    auto native = simd_level();
+
+    for (auto level: {SimdLevel::none, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512}) {
+        if (level > native)
+            break;
+        TRY(limit_simd_level(level));
+        TRY(std::fill(out.begin(), out.end(), Rgba8(0)));
+        TRY(convert_colour(edge.data(), out.data(), edge.size()));
+        TEST(out == expect);
+        TRY(std::fill(back.begin(), back.end(), Rgbaf(0)));
+        TRY(convert_colour(expect.data(), back.data(), expect.size()));
+        TEST(back == back_expect);
+        TEST_EQUAL((check_bulk_srgb8_encoding<Rgbaf, sRgba8>()), 0);
+        TEST_EQUAL((check_bulk_srgb8_encoding<Rgbf, sRgb8>()), 0);
+        TEST_EQUAL((check_bulk_srgb8_encoding<Rgbaf_r, sRgba8_r>()), 0);
+    }
+
+    TRY(limit_simd_level(SimdLevel::avx512));
+    TEST_EQUAL(simd_level(), native);
+
+}
+
+void test_rs_graphics_core_colour_conversion_lookup_tables() {
+
+    using sGrey8 = Colour<uint8_t, sGreyscale, ColourLayout::forward>;
+    using sGrey16 = Colour<uint16_t, sGreyscale, ColourLayout::forward>;
+    using Greyf = Colour<float, Greyscale, ColourLayout::forward>;
+    using Greyd = Colour<double, Greyscale, ColourLayout::forward>;
+    using Adobe8 = Colour<uint8_t, AdobeRGB, ColourLayout::forward_alpha>;
+    using Adobe16 = Colour<uint16_t, AdobeRGB, ColourLayout::forward>;
+    using ProPhoto8 = Colour<uint8_t, ProPhoto, ColourLayout::forward>;
+    using ProPhoto16 = Colour<uint16_t, ProPhoto, ColourLayout::forward>;
+    using WideGamut8 = Colour<uint8_t, WideGamut, ColourLayout::reverse_alpha>;
+    using WideGamut16 = Colour<uint16_t, WideGamut, ColourLayout::forward>;
+    using CIELabd = Colour<double, CIELab>;
+
+    TEST_EQUAL((check_decoding<sRgba8, Rgbaf>()), 0);
+    TEST_EQUAL((check_decoding<sRgba8, Rgbad>()), 0);
+    TEST_EQUAL((check_decoding<sRgb8, CIELabd>()), 0);
+    TEST_EQUAL((check_decoding<sRgb16, Rgbf>()), 0);
+    TEST_EQUAL((check_decoding<sRgb16, Rgbd>()), 0);
+    TEST_EQUAL((check_decoding<sGrey8, Greyf>()), 0);
+    TEST_EQUAL((check_decoding<sGrey16, Rgbd>()), 0);
+    TEST_EQUAL((check_decoding<Adobe8, Rgbaf>()), 0);
+    TEST_EQUAL((check_decoding<Adobe16, Rgbd>()), 0);
+    TEST_EQUAL((check_decoding<ProPhoto8, Rgbf>()), 0);
+    TEST_EQUAL((check_decoding<ProPhoto16, Rgbf>()), 0);
+    TEST_EQUAL((check_decoding<WideGamut8, Rgbaf>()), 0);
+    TEST_EQUAL((check_decoding<WideGamut16, Rgbd>()), 0);
+    TEST_EQUAL((check_decoding<sRgb8, Adobe8>()), 0);
+    TEST_EQUAL((check_decoding<ProPhoto8, WideGamut8>()), 0);
+
+    TEST_EQUAL((check_encoding<Rgbaf, sRgba8>()), 0);
+    TEST_EQUAL((check_encoding<Rgbd, sRgb8>()), 0);
+    TEST_EQUAL((check_encoding<Greyf, sGrey8>()), 0);
+    TEST_EQUAL((check_encoding<Greyd, sGrey8>()), 0);
+    TEST_EQUAL((check_encoding<Rgbaf, Adobe8>()), 0);
+    TEST_EQUAL((check_encoding<Rgbf, ProPhoto8>()), 0);
+    TEST_EQUAL((check_encoding<Rgbd, ProPhoto8>()), 0);
+    TEST_EQUAL((check_encoding<Rgbaf, WideGamut8>()), 0);
+
+}
+
+void test_rs_graphics_core_colour_conversion_fast_transfer() {
+
+    using sGreyf = Colour<float, sGreyscale, ColourLayout::forward>;
+    using Greyf = Colour<float, Greyscale, ColourLayout::forward>;
+    using Adobef = Colour<float, AdobeRGB, ColourLayout::forward_alpha>;
+    using Adobe16 = Colour<uint16_t, AdobeRGB, ColourLayout::forward>;
+    using WideGamutf = Colour<float, WideGamut, ColourLayout::reverse_alpha>;
+    using CIELabf = Colour<float, CIELab>;
+
+    // Documented bound: a quarter of the least significant bit of a 16 bit
+    // channel
+
+    static constexpr double bound = 0.25 / 65535;
+
+    TEST(! Detail::FastTransfer<LinearRGB>::value);
+    TEST(! Detail::FastTransfer<ProPhoto>::value);
+
+    auto native = simd_level();
+
+    for (auto level: {SimdLevel::none, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512}) {
+
+        if (level > native)
+            break;
+
+        TRY(limit_simd_level(level));
+
+        std::pair<double, int> result;
+
+        TRY(result = check_fast_transfer<sRGB>());
+        TEST(result.first < bound);
+        TEST_EQUAL(result.second, 0);
+        TRY(result = check_fast_transfer<sGreyscale>());
+        TEST(result.first < bound);
+        TEST_EQUAL(result.second, 0);
+        TRY(result = check_fast_transfer<AdobeRGB>());
+        TEST(result.first < bound);
+        TEST_EQUAL(result.second, 0);
+        TRY(result = check_fast_transfer<WideGamut>());
+        TEST(result.first < bound);
+        TEST_EQUAL(result.second, 0);
+
+        TEST_EQUAL((check_fast_conversion<sRgbf, Rgbf>(1e-5)), 0);
+        TEST_EQUAL((check_fast_conversion<Rgbf, sRgbf>(1e-5)), 0);
+        TEST_EQUAL((check_fast_conversion<sRgbaf, Adobef>(1e-5)), 0);
+        TEST_EQUAL((check_fast_conversion<Adobef, WideGamutf>(1e-5)), 0);
+        TEST_EQUAL((check_fast_conversion<sGreyf, Greyf>(1e-5)), 0);
+        TEST_EQUAL((check_fast_conversion<sRgbf, CIELabf>(1e-3)), 0);
+        TEST_EQUAL((check_fast_conversion<Rgbaf, sRgba16>(1)), 0);
+        TEST_EQUAL((check_fast_conversion<Adobe16, sRgbf>(1e-5)), 0);
+
+        // Exact tables still apply to 8 bit channels
+
+        TEST_EQUAL((check_fast_conversion<sRgba8, Rgbaf>(0)), 0);
+        TEST_EQUAL((check_fast_conversion<Rgbaf, sRgba8>(0)), 0);
+
+    }
+
+    TRY(limit_simd_level(SimdLevel::avx512));
+    TEST_EQUAL(simd_level(), native);
+
+}
+
+void test_rs_graphics_core_colour_conversion_fast_spaces() {
+
+    using CIELabf = Colour<float, CIELab>;
+    using CIELuvf = Colour<float, CIELuv, ColourLayout::forward>;
+    using HCLabf = Colour<float, HCLab, ColourLayout::forward>;
+    using HCLuvf = Colour<float, HCLuv>;
+
+    double max_error = 0;
+
+    for (int i = -600; i <= 600; ++i) {
+        float x = float(std::pow(10.0, i / 100.0));
+        double y = std::cbrt(double(x));
+        max_error = std::max(max_error, std::abs(double(Detail::fast_cbrt(x)) - y) / y);
+    }
+
+    TEST(max_error < 2.5e-7);
+
+    max_error = 0;
+
+    for (int i = 0; i < 4000; ++i) {
+        double a = 2 * pi<double> * i / 4000;
+        for (double r: {1e-3, 1.0, 150.0}) {
+            float x = float(r * std::cos(a));
+            float y = float(r * std::sin(a));
+            double h = std::atan2(double(y), double(x)) / (2 * pi<double>);
+            double d = std::abs(double(Detail::fast_atan2_turns(y, x)) - (h < 0 ? h + 1 : h));
+            max_error = std::max(max_error, std::min(d, 1 - d));
+        }
+    }
+
+    TEST(max_error < 7e-7);
+    TEST_EQUAL(Detail::fast_atan2_turns(0, 0), 0);
+
+    max_error = 0;
+
+    for (int i = -4000; i <= 4000; ++i) {
+        float t = i / 1000.0f;
+        float s, c;
+        Detail::fast_sincos_turns(t, s, c);
+        double a = 2 * pi<double> * double(t);
+        max_error = std::max(max_error, std::abs(double(s) - std::sin(a)));
+        max_error = std::max(max_error, std::abs(double(c) - std::cos(a)));
+    }
+
+    TEST(max_error < 4e-7);
+
+    TEST(Detail::FastSpace<CIELab>::value);
+    TEST(Detail::FastSpace<HCLuv>::value);
+    TEST(! Detail::FastSpace<CIEXYZ>::value);
+    TEST((Detail::route_has_fast_space<sRGB, HCLab>()));
+    TEST((Detail::route_has_fast_space<CIELuv, LinearRGB>()));
+    TEST(! (Detail::route_has_fast_space<sRGB, AdobeRGB>()));
+
+    auto native = simd_level();
+
+    for (auto level: {SimdLevel::none, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512}) {
+
+        if (level > native)
+            break;
+
+        TRY(limit_simd_level(level));
+
+        std::tuple<double, double, int> result;
+
+        TRY(result = check_fast_space<CIELab>());
+        TEST(std::get<0>(result) < 2e-4);
+        TEST(std::get<1>(result) < 1e-6);
+        TEST_EQUAL(std::get<2>(result), 0);
+        TRY(result = check_fast_space<CIELuv>());
+        TEST(std::get<0>(result) < 2e-4);
+        TEST(std::get<1>(result) < 1e-6);
+        TEST_EQUAL(std::get<2>(result), 0);
+        TRY(result = check_fast_space<HCLab>());
+        TEST(std::get<0>(result) < 1e-4);
+        TEST(std::get<1>(result) < 1e-4);
+        TEST_EQUAL(std::get<2>(result), 0);
+        TRY(result = check_fast_space<HCLuv>());
+        TEST(std::get<0>(result) < 1e-4);
+        TEST(std::get<1>(result) < 1e-4);
+        TEST_EQUAL(std::get<2>(result), 0);
+
+        TEST_EQUAL((check_fast_conversion<sRgbf, HCLabf>(1e-3)), 0);
+        TEST_EQUAL((check_fast_conversion<Rgbaf, CIELuvf>(1e-3)), 0);
+        TEST_EQUAL((check_fast_conversion<CIELabf, sRgbf>(1e-5)), 0);
+        TEST_EQUAL((check_fast_conversion<HCLabf, Rgbaf>(1e-5)), 0);
+        TEST_EQUAL((check_fast_conversion<HCLuvf, sRgba16>(1)), 0);
+        TEST_EQUAL((check_fast_conversion<CIELabf, HCLuvf>(1e-3)), 0);
+
+    }
+
+    TRY(limit_simd_level(SimdLevel::avx512));
+    TEST_EQUAL(simd_level(), native);
+
+}
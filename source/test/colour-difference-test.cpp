@@ -0,0 +1,224 @@
+#include "rs-graphics-core/colour-difference.hpp"
+#include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/colour-space.hpp"
+#include "rs-graphics-core/multi-array.hpp"
+#include "rs-graphics-core/simd.hpp"
+#include "rs-graphics-core/vector.hpp"
+#include "rs-unit-test.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace RS::Graphics::Core;
+
+namespace {
+
+    using Labf = Colour<float, CIELab, ColourLayout::forward>;
+
+    template <typename C>
+    std::vector<C> random_colours(size_t n, unsigned seed) {
+        std::minstd_rand rng(seed);
+        std::uniform_real_distribution<double> dist(0, 1);
+        std::vector<C> colours(n);
+        for (auto& c: colours)
+            for (auto& x: c)
+                x = typename C::value_type(dist(rng) * double(C::scale));
+        return colours;
+    }
+
+    // Test data from Sharma, Wu & Dalal (2005)
+
+    struct SharmaPair {
+        Double3 lab1;
+        Double3 lab2;
+        double delta;
+    };
+
+    const std::vector<SharmaPair> sharma_pairs = {
+        { {50.0000, 2.6772, -79.7751},   {50.0000, 0.0000, -82.7485},     2.0425 },
+        { {50.0000, 3.1571, -77.2803},   {50.0000, 0.0000, -82.7485},     2.8615 },
+        { {50.0000, 2.8361, -74.0200},   {50.0000, 0.0000, -82.7485},     3.4412 },
+        { {50.0000, -1.3802, -84.2814},  {50.0000, 0.0000, -82.7485},     1.0000 },
+        { {50.0000, 0.0000, 0.0000},     {50.0000, -1.0000, 2.0000},      2.3669 },
+        { {50.0000, -1.0000, 2.0000},    {50.0000, 0.0000, 0.0000},       2.3669 },
+        { {50.0000, 2.5000, 0.0000},     {73.0000, 25.0000, -18.0000},    27.1492 },
+        { {50.0000, 2.5000, 0.0000},     {61.0000, -5.0000, 29.0000},     22.8977 },
+        { {60.2574, -34.0099, 36.2677},  {60.4626, -34.1751, 39.4387},    1.2644 },
+    };
+
+}
+
+void test_rs_graphics_core_colour_difference_scalar() {
+
+    for (auto& p: sharma_pairs) {
+        TEST_NEAR(delta_e(p.lab1, p.lab2), p.delta, 1e-4);
+        TEST_NEAR(delta_e(Float3(p.lab1), Float3(p.lab2)), p.delta, 1e-3);
+        TEST_NEAR(Detail::delta_e_2000_fast(Float3(p.lab1), Float3(p.lab2)), p.delta, 1e-3);
+    }
+
+    Double3 a(50, 0, 0), b(50, 3, 4), c(50, 10, 0), d(50, 0, 10);
+
+    TEST_EQUAL(delta_e(a, b, DeltaE::cie76), 5);
+    TEST_NEAR(delta_e(a, b, DeltaE::cie94), 5, 1e-12);
+    TEST_NEAR(delta_e(c, d, DeltaE::cie76), 14.142'136, 1e-6);
+    TEST_NEAR(delta_e(c, d, DeltaE::cie94), 12.297'509, 1e-6);
+    TEST_EQUAL(delta_e(a, a), 0);
+    TEST_EQUAL(delta_e(c, c), 0);
+
+    sRgb8 x(200, 100, 50), y(190, 110, 60);
+    sRgbf z;
+    Colour<double, CIELab, ColourLayout::forward> lx, ly;
+    convert_colour(x, lx);
+    convert_colour(y, ly);
+    convert_colour(y, z);
+
+    TEST_EQUAL(delta_e(x, x), 0);
+    TEST_EQUAL(delta_e(x, y), delta_e(lx.as_vector(), ly.as_vector()));
+    TEST_NEAR(delta_e(x, z, DeltaE::cie76), delta_e(lx.as_vector(), ly.as_vector(), DeltaE::cie76), 1e-4);
+
+}
+
+void test_rs_graphics_core_colour_difference_batch() {
+
+    static constexpr size_t n = 1003;
+
+    auto a = random_colours<sRgb8>(n, 1);
+    auto b = random_colours<sRgbaf>(n, 2);
+    std::vector<float> out(n);
+    std::vector<Labf> la(n), lb(n);
+    auto native = simd_level();
+    DeltaEStats stats;
+
+    for (auto& c: b)
+        c.alpha() = 1;
+    convert_colour(a[5], b[5]);
+
+    for (auto precision: {ColourPrecision::exact, ColourPrecision::fast}) {
+
+        convert_colour(a.data(), la.data(), n, precision);
+        convert_colour(b.data(), lb.data(), n, precision);
+
+        for (auto metric: {DeltaE::cie76, DeltaE::cie94, DeltaE::ciede2000}) {
+
+            std::vector<float> expect(n);
+            double sum = 0, max = 0;
+
+            for (size_t i = 0; i < n; ++i) {
+                auto x = la[i].as_vector();
+                auto y = lb[i].as_vector();
+                expect[i] = metric == DeltaE::ciede2000 ? Detail::delta_e_2000_fast(x, y) : delta_e(x, y, metric);
+                sum += expect[i];
+                max = std::max(max, double(expect[i]));
+            }
+
+            for (auto level: {SimdLevel::none, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512}) {
+                if (level > native)
+                    break;
+                TRY(limit_simd_level(level));
+                TRY(std::fill(out.begin(), out.end(), -1.0f));
+                TRY(stats = delta_e(a.data(), b.data(), out.data(), n, metric, 95, precision));
+                TEST(out == expect);
+                TEST_NEAR(stats.mean, sum / n, 1e-6);
+                TEST_EQUAL(stats.max, max);
+                TEST(stats.percentile > 0);
+                TEST(stats.percentile <= max);
+                TEST(out[5] < 1e-4f);
+            }
+
+            limit_simd_level(SimdLevel::avx512);
+            TEST_EQUAL(simd_level(), native);
+
+            TRY(stats = delta_e(a.data(), b.data(), nullptr, n, metric, 95, precision));
+            TEST_NEAR(stats.mean, sum / n, 1e-6);
+
+        }
+
+    }
+
+    // The fast CIEDE2000 against the double precision version
+
+    convert_colour(a.data(), la.data(), n);
+    convert_colour(b.data(), lb.data(), n);
+    TRY(delta_e(a.data(), b.data(), out.data(), n));
+    double error = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        auto exact = delta_e(Double3(la[i].as_vector()), Double3(lb[i].as_vector()));
+        error = std::max(error, std::abs(out[i] - exact));
+    }
+
+    TEST(error < 1e-3);
+
+    TEST_THROW(delta_e(a.data(), b.data(), out.data(), n, DeltaE::cie76, -1), std::invalid_argument);
+    TEST_THROW(delta_e(a.data(), b.data(), out.data(), n, DeltaE::cie76, 101), std::invalid_argument);
+
+}
+
+void test_rs_graphics_core_colour_difference_statistics() {
+
+    std::vector<float> values;
+    DeltaEStats stats;
+
+    for (int i = 0; i < 100; ++i)
+        values.push_back(float(i));
+    values.push_back(std::nanf(""));
+
+    Detail::DeltaEAccumulator acc95(95);
+    TRY(acc95.add(values.data(), values.size()));
+    TRY(stats = acc95.stats());
+    TEST_NEAR(stats.mean, 49.5, 1e-12);
+    TEST_EQUAL(stats.max, 99);
+    TEST_NEAR(stats.percentile, 94, 1.0 / 128);
+
+    Detail::DeltaEAccumulator acc0(0);
+    TRY(acc0.add(values.data(), values.size()));
+    TEST_NEAR(acc0.stats().percentile, 0, 1.0 / 128);
+
+    Detail::DeltaEAccumulator acc100(100);
+    TRY(acc100.add(values.data(), values.size()));
+    TEST_NEAR(acc100.stats().percentile, 99, 1.0 / 128);
+
+    values = {1000, 2000, 3000};
+    Detail::DeltaEAccumulator acc50(50);
+    TRY(acc50.add(values.data(), values.size()));
+    TEST_EQUAL(acc50.stats().percentile, 3000);
+    TEST_EQUAL(acc50.stats().max, 3000);
+
+    Detail::DeltaEAccumulator empty(50);
+    TRY(stats = empty.stats());
+    TEST_EQUAL(stats.mean, 0);
+    TEST_EQUAL(stats.max, 0);
+    TEST_EQUAL(stats.percentile, 0);
+
+    TEST_THROW(Detail::DeltaEAccumulator(std::nan("")), std::invalid_argument);
+
+}
+
+void test_rs_graphics_core_colour_difference_map() {
+
+    MultiArray<sRgb8, 2> a(40, 25), b(40, 25), c(25, 40);
+    DeltaEMap result;
+
+    auto x = random_colours<sRgb8>(a.size(), 3);
+    auto y = random_colours<sRgb8>(a.size(), 4);
+    std::copy(x.begin(), x.end(), a.data());
+    std::copy(y.begin(), y.end(), b.data());
+    std::vector<float> expect(a.size());
+    auto stats = delta_e(x.data(), y.data(), expect.data(), x.size(), DeltaE::cie94, 50);
+
+    TRY(result = delta_e_map(a, b, DeltaE::cie94, 50));
+    TEST_EQUAL(result.map.shape(), a.shape());
+    TEST((std::equal(expect.begin(), expect.end(), result.map.data())));
+    TEST_EQUAL(result.map.get(3, 4), expect[4 * 40 + 3]);
+    TEST_EQUAL(result.stats.mean, stats.mean);
+    TEST_EQUAL(result.stats.max, stats.max);
+    TEST_EQUAL(result.stats.percentile, stats.percentile);
+
+    TRY(result = delta_e_map(a, a));
+    TEST_EQUAL(result.stats.max, 0);
+
+    TEST_THROW(delta_e_map(a, c), std::invalid_argument);
+
+}
@@ -0,0 +1,276 @@
+#include "rs-graphics-core/colour-gamut.hpp"
+#include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/colour-lut.hpp"
+#include "rs-graphics-core/colour-space.hpp"
+#include "rs-graphics-core/simd.hpp"
+#include "rs-graphics-core/vector.hpp"
+#include "rs-unit-test.hpp"
+#include "test/vector-test.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace RS::Graphics::Core;
+
+namespace {
+
+    template <typename C>
+    std::vector<C> random_colours(size_t n) {
+        std::minstd_rand rng(42);
+        std::uniform_real_distribution<double> dist(-0.3, 1.3);
+        std::vector<C> colours(n);
+        for (auto& c: colours)
+            for (auto& x: c)
+                x = typename C::value_type(dist(rng));
+        return colours;
+    }
+
+    template <typename C>
+    bool in_unit_cube(const C& c) {
+        for (int i = 0; i < 3; ++i)
+            if (c.cs(i) < 0 || c.cs(i) > 1)
+                return false;
+        return true;
+    }
+
+}
+
+void test_rs_graphics_core_colour_gamut_mask() {
+
+    static constexpr size_t n = 1003;
+
+    using HCLabf = Colour<float, HCLab, ColourLayout::forward>;
+    using sBgrf = Colour<float, sRGB, ColourLayout::reverse>;
+
+    auto rgba = random_colours<Rgbaf>(n);
+    auto bgr = random_colours<sBgrf>(n);
+    auto hcl = random_colours<HCLabf>(n);
+    std::vector<uint8_t> mask(n), expect(n);
+    size_t count = 0, expect_count = 0;
+    auto native = simd_level();
+
+    for (auto& c: rgba)
+        c.alpha() *= 4;
+    rgba[10] = Rgbaf(0.5f, std::nanf(""), 0.5f, 1);
+
+    for (auto level: {SimdLevel::none, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512}) {
+
+        if (level > native)
+            break;
+
+        TRY(limit_simd_level(level));
+
+        expect_count = 0;
+        for (size_t i = 0; i < n; ++i) {
+            expect[i] = uint8_t(is_colour_in_gamut<LinearRGB>(rgba[i].partial_vector()));
+            expect_count += size_t(! expect[i]);
+        }
+        TRY(std::fill(mask.begin(), mask.end(), uint8_t(2)));
+        TRY(count = gamut_mask(rgba.data(), mask.data(), n));
+        TEST(mask == expect);
+        TEST_EQUAL(count, expect_count);
+        TEST_EQUAL(mask[10], 1);
+        TEST(expect_count > 0);
+        TEST(expect_count < n);
+
+        expect_count = 0;
+        for (size_t i = 0; i < n; ++i) {
+            expect[i] = uint8_t(is_colour_in_gamut<sRGB>(bgr[i].partial_vector()));
+            expect_count += size_t(! expect[i]);
+        }
+        TRY(count = gamut_mask(bgr.data(), mask.data(), n));
+        TEST(mask == expect);
+        TEST_EQUAL(count, expect_count);
+
+        expect_count = 0;
+        for (size_t i = 0; i < n; ++i) {
+            expect[i] = uint8_t(is_colour_in_gamut<HCLab>(hcl[i].partial_vector()));
+            expect_count += size_t(! expect[i]);
+        }
+        TRY(count = gamut_mask(hcl.data(), mask.data(), n));
+        TEST(mask == expect);
+        TEST_EQUAL(count, expect_count);
+
+    }
+
+    TRY(limit_simd_level(SimdLevel::avx512));
+    TEST_EQUAL(simd_level(), native);
+
+}
+
+void test_rs_graphics_core_colour_gamut_mapping() {
+
+    sRgbad a, b;
+
+    TRY((a = map_to_gamut(sRgbad(0.2, 0.4, 0.6, 0.5))));
+    TEST_EQUAL(a, sRgbad(0.2, 0.4, 0.6, 0.5));
+
+    for (auto mode: {GamutMapping::clip, GamutMapping::chroma}) {
+        TRY((a = map_to_gamut(sRgbad(0.25, 0.5, 0.75, 0.5), mode)));
+        TEST_EQUAL(a, sRgbad(0.25, 0.5, 0.75, 0.5));
+    }
+
+    TRY((a = map_to_gamut(sRgbad(1.5, -0.25, 0.5, 2), GamutMapping::clip)));
+    TEST_EQUAL(a, sRgbad(1, 0, 0.5, 2));
+
+    // Soft knee leaves values below the knee alone, and rolls off values
+    // above it smoothly towards 1
+
+    TRY((a = map_to_gamut(sRgbad(0.5, -0.25, 0.9, 0.5), GamutMapping::soft_knee)));
+    TEST_EQUAL(a.R(), 0.5);
+    TEST_EQUAL(a.G(), 0);
+    TEST_NEAR(a.B(), 0.8 + 0.1 / 1.5, 1e-12);
+    TEST_EQUAL(a.alpha(), 0.5);
+    TRY((a = map_to_gamut(sRgbad(0.5, 0.5, 100, 1), GamutMapping::soft_knee)));
+    TEST(a.B() < 1);
+    TEST(a.B() > 0.999);
+    TRY((a = map_to_gamut(sRgbad(0.5, 0.5, 0.9, 1), GamutMapping::soft_knee, 0.5)));
+    TEST_NEAR(a.B(), 0.5 + 0.4 / 1.8, 1e-12);
+
+    // The knee must be in [0,1]; a knee of 1 clips at the top of the range
+
+    TRY((a = map_to_gamut(sRgbad(0.5, 0, 2, 1), GamutMapping::soft_knee, 0.0)));
+    TEST_NEAR(a.R(), 0.5 / 1.5, 1e-12);
+    TEST_EQUAL(a.G(), 0);
+    TEST_NEAR(a.B(), 2 / 3.0, 1e-12);
+    TRY((a = map_to_gamut(sRgbad(0.5, 0.9, 2, 1), GamutMapping::soft_knee, 1.0)));
+    TEST_EQUAL(a.R(), 0.5);
+    TEST_EQUAL(a.G(), 0.9);
+    TEST_EQUAL(a.B(), 1);
+    TEST_THROW(map_to_gamut(sRgbad(0.5, 0.5, 2, 1), GamutMapping::soft_knee, 1.5), std::invalid_argument);
+    TEST_THROW(map_to_gamut(sRgbad(0.5, 0.5, 2, 1), GamutMapping::soft_knee, -0.5), std::invalid_argument);
+    TEST_THROW(map_to_gamut(sRgbad(0.5, 0.5, 2, 1), GamutMapping::soft_knee, std::nan("")), std::invalid_argument);
+    TEST_THROW(map_to_gamut(sRgbad(0.5, 0.5, 2, 1), GamutMapping::clip, 1.5), std::invalid_argument);
+
+    std::vector<sRgbaf> span(20, sRgbaf(0.5f, 0.9f, 2, 1));
+    TRY(map_to_gamut(span.data(), span.size(), GamutMapping::soft_knee, 1.0f));
+    for (auto& c: span)
+        TEST_EQUAL(c, sRgbaf(0.5f, 0.9f, 1, 1));
+    TEST_THROW(map_to_gamut(span.data(), span.size(), GamutMapping::soft_knee, 1.5f), std::invalid_argument);
+
+    // Chroma compression keeps hue and lightness while reducing chroma
+
+    for (auto& c: random_colours<sRgbad>(200)) {
+        c.alpha() = 0.75;
+        TRY((a = map_to_gamut(c, GamutMapping::chroma)));
+        TEST(in_unit_cube(a));
+        TEST_EQUAL(a.alpha(), 0.75);
+        if (in_unit_cube(c)) {
+            TEST_EQUAL(a, c);
+            continue;
+        }
+        auto hcl_in = convert_colour_space<sRGB, HCLab>(c.partial_vector());
+        auto hcl_out = convert_colour_space<sRGB, HCLab>(a.partial_vector());
+        if (hcl_in[2] <= 0 || hcl_in[2] >= 100)
+            continue;
+        TEST_NEAR(hcl_out[2], hcl_in[2], 0.01);
+        TEST(hcl_out[1] <= hcl_in[1] + 1e-6);
+        if (hcl_out[1] > 1) {
+            auto dh = std::abs(hcl_out[0] - hcl_in[0]);
+            TEST(std::min(dh, 1 - dh) < 1e-3);
+        }
+    }
+
+    TRY((a = map_to_gamut(sRgbad(2, 2, 2, 1), GamutMapping::chroma)));
+    TEST_EQUAL(a, sRgbad(1, 1, 1, 1));
+    TRY((a = map_to_gamut(sRgbad(-1, -1, -1, 1), GamutMapping::chroma)));
+    TEST_EQUAL(a, sRgbad(0, 0, 0, 1));
+
+    // Red in ProPhoto is far outside sRGB
+
+    auto red = convert_colour_space<LinearProPhoto, sRGB>(Double3(1, 0, 0));
+    TRY((b = sRgbad(red[0], red[1], red[2], 1)));
+    TEST(! in_unit_cube(b));
+    TRY((a = map_to_gamut(b, GamutMapping::clip)));
+    TEST(in_unit_cube(a));
+    TRY((a = map_to_gamut(b, GamutMapping::chroma)));
+    TEST(in_unit_cube(a));
+
+}
+
+void test_rs_graphics_core_colour_gamut_spans() {
+
+    static constexpr size_t n = 1003;
+
+    using sBgrf = Colour<float, sRGB, ColourLayout::reverse>;
+
+    auto rgba = random_colours<Rgbaf>(n);
+    auto bgr = random_colours<sBgrf>(n);
+    auto rgbad = random_colours<Rgbad>(n);
+    std::vector<Rgbaf> rgba_in, rgba_expect;
+    std::vector<sBgrf> bgr_in, bgr_expect;
+    std::vector<Rgbad> rgbad_in, rgbad_expect;
+    auto native = simd_level();
+
+    for (auto& c: rgba)
+        c.alpha() *= 4;
+
+    for (auto mode: {GamutMapping::clip, GamutMapping::chroma, GamutMapping::soft_knee}) {
+
+        rgba_expect = rgba;
+        bgr_expect = bgr;
+        rgbad_expect = rgbad;
+
+        for (auto& c: rgba_expect)
+            c = map_to_gamut(c, mode);
+        for (auto& c: bgr_expect)
+            c = map_to_gamut(c, mode, 0.7f);
+        for (auto& c: rgbad_expect)
+            c = map_to_gamut(c, mode);
+
+        for (size_t i = 0; i < n; ++i) {
+            TEST(in_unit_cube(rgba_expect[i]));
+            TEST_EQUAL(rgba_expect[i].alpha(), rgba[i].alpha());
+        }
+
+        for (auto level: {SimdLevel::none, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512}) {
+            if (level > native)
+                break;
+            TRY(limit_simd_level(level));
+            rgba_in = rgba;
+            bgr_in = bgr;
+            rgbad_in = rgbad;
+            TRY(map_to_gamut(rgba_in.data(), n, mode));
+            TEST(rgba_in == rgba_expect);
+            TRY(map_to_gamut(bgr_in.data(), n, mode, 0.7f));
+            TEST(bgr_in == bgr_expect);
+            TRY(map_to_gamut(rgbad_in.data(), n, mode));
+            TEST(rgbad_in == rgbad_expect);
+        }
+
+    }
+
+    TRY(limit_simd_level(SimdLevel::avx512));
+    TEST_EQUAL(simd_level(), native);
+
+}
+
+void test_rs_graphics_core_colour_gamut_lut() {
+
+    ColourLut3D lut;
+    Float3 c;
+
+    TRY((lut = gamut_mapping_lut<LinearProPhoto, sRGB>(17)));
+    TEST_EQUAL(lut.size(), 17);
+
+    for (int r = 0; r <= 16; r += 4) {
+        for (int g = 0; g <= 16; g += 4) {
+            for (int b = 0; b <= 16; b += 4) {
+                Float3 x(r / 16.0f, g / 16.0f, b / 16.0f);
+                auto y = Colour<double, sRGB, ColourLayout::forward>(convert_colour_space<LinearProPhoto, sRGB>(Double3(x)));
+                y = map_to_gamut(y, GamutMapping::chroma);
+                TRY(c = lut(x));
+                TEST_VECTORS(c, y.as_vector(), 1e-6);
+                TEST(in_unit_cube(Colour<float, sRGB, ColourLayout::forward>(c)));
+            }
+        }
+    }
+
+    TRY((lut = gamut_mapping_lut<sRGB, sRGB>(5, GamutMapping::clip)));
+    TRY(c = lut(Float3(0.25f, 0.5f, 0.75f)));
+    TEST_VECTORS(c, Float3(0.25f, 0.5f, 0.75f), 1e-6);
+
+}
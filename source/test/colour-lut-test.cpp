@@ -0,0 +1,184 @@
+#include "rs-graphics-core/colour-lut.hpp"
+#include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/colour-space.hpp"
+#include "rs-graphics-core/linear-map.hpp"
+#include "rs-graphics-core/parallel.hpp"
+#include "rs-graphics-core/simd.hpp"
+#include "rs-graphics-core/vector.hpp"
+#include "rs-unit-test.hpp"
+#include "test/vector-test.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace RS::Graphics::Core;
+
+namespace {
+
+    std::vector<Float3> random_colours(size_t n) {
+        std::minstd_rand rng(42);
+        std::uniform_real_distribution<float> dist(-0.1f, 1.1f);
+        std::vector<Float3> colours(n);
+        for (auto& c: colours)
+            for (auto& x: c)
+                x = dist(rng);
+        return colours;
+    }
+
+}
+
+void test_rs_graphics_core_colour_lut_construction() {
+
+    ColourLut3D lut;
+
+    TEST(lut.empty());
+    TEST_EQUAL(lut.size(), 0);
+    TEST_EQUAL(lut(Float3(0.25f, 0.5f, 0.75f)), Float3(0.25f, 0.5f, 0.75f));
+
+    TEST_THROW(ColourLut3D(0), std::invalid_argument);
+    TEST_THROW(ColourLut3D(1), std::invalid_argument);
+    TEST_THROW(ColourLut3D(ColourLut3D::max_size + 1), std::invalid_argument);
+    TEST_THROW(ColourLut3D(1000), std::invalid_argument);
+
+    TRY(lut = ColourLut3D(5));
+    TEST(! lut.empty());
+    TEST_EQUAL(lut.size(), 5);
+    TEST_EQUAL(lut.table().shape(), Int3(5, 5, 5));
+    TEST_EQUAL(lut.table()(0, 0, 0), Float3(0, 0, 0));
+    TEST_EQUAL(lut.table()(4, 2, 1), Float3(1, 0.5f, 0.25f));
+    TEST_EQUAL(lut.table()(4, 4, 4), Float3(1, 1, 1));
+
+    ThreadPool pool(3);
+
+    TRY(lut = ColourLut3D(9, [] (Float3 c) { return Float3(c.z(), c.y(), c.x()); }, pool));
+    TEST_EQUAL(lut.size(), 9);
+    TEST_EQUAL(lut.table()(8, 2, 0), Float3(0, 0.25f, 1));
+    TEST_EQUAL(lut.table()(1, 4, 6), Float3(0.75f, 0.5f, 0.125f));
+
+}
+
+void test_rs_graphics_core_colour_lut_interpolation() {
+
+    ColourLut3D lut;
+    Float3 c;
+
+    TRY(lut = ColourLut3D(17));
+
+    for (auto mode: {LutInterpolation::trilinear, LutInterpolation::tetrahedral}) {
+        for (int r = 0; r <= 16; r += 4) {
+            for (int g = 0; g <= 16; g += 4) {
+                for (int b = 0; b <= 16; b += 4) {
+                    Float3 x(r / 16.0f, g / 16.0f, b / 16.0f);
+                    TRY(c = lut(x, mode));
+                    TEST_EQUAL(c, x);
+                }
+            }
+        }
+        TRY(c = lut(Float3(0.3f, 0.6f, 0.9f), mode));
+        TEST_VECTORS(c, Float3(0.3f, 0.6f, 0.9f), 1e-6);
+        TRY(c = lut(Float3(-1, 0.5f, 2), mode));
+        TEST_VECTORS(c, Float3(0, 0.5f, 1), 1e-6);
+    }
+
+    // Both schemes reproduce affine functions exactly, and each is exact
+    // on the grid points of any function
+
+    auto affine = [] (Float3 c) { return Float3(0.2f + 0.5f * c.x(), c.y() - 0.25f * c.z(), 0.5f * (c.x() + c.z())); };
+
+    TRY(lut = ColourLut3D(5, affine));
+
+    for (auto& x: random_colours(100)) {
+        auto y = affine(clampv(x, Float3(0, 0, 0), Float3(1, 1, 1)));
+        TRY(c = lut(x, LutInterpolation::trilinear));
+        TEST_VECTORS(c, y, 1e-6);
+        TRY(c = lut(x, LutInterpolation::tetrahedral));
+        TEST_VECTORS(c, y, 1e-6);
+    }
+
+}
+
+void test_rs_graphics_core_colour_lut_colour_spaces() {
+
+    ColourLut3D lut;
+    Float3 c;
+    Double3 expect;
+
+    TRY((lut = colour_space_lut<sRGB, CIEXYZ>(33)));
+    TEST_EQUAL(lut.size(), 33);
+
+    std::minstd_rand rng(42);
+    std::uniform_real_distribution<double> dist(0, 1);
+
+    for (int i = 0; i < 1000; ++i) {
+        Double3 x(dist(rng), dist(rng), dist(rng));
+        TRY((expect = convert_colour_space<sRGB, CIEXYZ>(x)));
+        TRY(c = lut(Float3(x), LutInterpolation::trilinear));
+        TEST_VECTORS(c, expect, 0.005);
+        TRY(c = lut(Float3(x), LutInterpolation::tetrahedral));
+        TEST_VECTORS(c, expect, 0.005);
+    }
+
+}
+
+void test_rs_graphics_core_colour_lut_batch() {
+
+    static constexpr size_t n = 1003;
+
+    ColourLut3D lut;
+    auto in = random_colours(n);
+    std::vector<Float3> expect(n), out(n);
+    auto native = simd_level();
+
+    TRY((lut = colour_space_lut<sRGB, LinearRGB>(17)));
+
+    for (auto mode: {LutInterpolation::trilinear, LutInterpolation::tetrahedral}) {
+        for (size_t i = 0; i < n; ++i)
+            expect[i] = lut(in[i], mode);
+        for (auto level: {SimdLevel::none, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512}) {
+            if (level > native)
+                break;
+            TRY(limit_simd_level(level));
+            TRY(std::fill(out.begin(), out.end(), Float3(-1, -1, -1)));
+            TRY(lut.batch(in.data(), out.data(), n, mode));
+            TEST(out == expect);
+        }
+    }
+
+    TRY(limit_simd_level(SimdLevel::avx512));
+    TEST_EQUAL(simd_level(), native);
+
+}
+
+void test_rs_graphics_core_colour_lut_ramp_perceptual() {
+
+    LinearMap<float, sRgbaf> map;
+    map.insert(0, sRgbaf(1, 0, 0, 1));
+    map.insert(1, sRgbaf(0, 0, 1, 0.5f));
+
+    auto ramp = perceptual_ramp<HCLab>(map, 6);
+    Colour<float, HCLab, ColourLayout::forward> h0, h1, hm;
+    sRgbaf mid;
+
+    TEST_EQUAL(ramp.size(), 64u);
+    TEST_VECTORS(ramp(0).as_vector(), Float4(1, 0, 0, 1), 1e-4);
+    TEST_VECTORS(ramp(1).as_vector(), Float4(0, 0, 1, 0.5f), 1e-4);
+
+    // Red to blue goes the short way round, through magenta, with the
+    // lightness and chroma interpolated on the way
+
+    convert_colour(ramp(0), h0);
+    convert_colour(ramp(1), h1);
+    TRY(mid = ramp(0.5f));
+    convert_colour(mid, hm);
+    TEST_NEAR(mid.alpha(), 0.75, 1e-6);
+    TEST(mid.R() > mid.G());
+    TEST(mid.B() > mid.G());
+    TEST_NEAR(hm.L(), (h0.L() + h1.L()) / 2, 0.01);
+    TEST_NEAR(hm.C(), (h0.C() + h1.C()) / 2, 0.01);
+    TEST(h0.H() < 0.2);
+    TEST(h1.H() > 0.7);
+    TEST(hm.H() > h1.H());
+
+}
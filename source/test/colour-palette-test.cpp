@@ -0,0 +1,224 @@
+#include "rs-graphics-core/colour-palette.hpp"
+#include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/colour-space.hpp"
+#include "rs-graphics-core/parallel.hpp"
+#include "rs-graphics-core/vector.hpp"
+#include "rs-unit-test.hpp"
+#include "test/vector-test.hpp"
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace RS::Graphics::Core;
+
+namespace {
+
+    template <typename C>
+    std::vector<C> random_colours(size_t n, unsigned seed, double lo = 0, double hi = 1) {
+        std::minstd_rand rng(seed);
+        std::uniform_real_distribution<double> dist(lo, hi);
+        std::vector<C> colours(n);
+        for (auto& c: colours) {
+            for (auto& x: c)
+                x = typename C::value_type(dist(rng) * double(C::scale));
+            if constexpr (C::has_alpha)
+                c.alpha() = C::scale;
+        }
+        return colours;
+    }
+
+    // Reference linear scan, with ties going to the lowest index
+
+    template <typename MS>
+    size_t linear_nearest(const ColourPalette<MS>& palette, Float3 p) {
+        size_t best = 0;
+        float best_d2 = Detail::PaletteIndex::distance2(p, palette.metric(0));
+        for (size_t i = 1; i < palette.size(); ++i) {
+            float d2 = Detail::PaletteIndex::distance2(p, palette.metric(i));
+            if (d2 < best_d2) {
+                best = i;
+                best_d2 = d2;
+            }
+        }
+        return best;
+    }
+
+    template <typename MS>
+    int check_nearest(size_t size, PaletteSearch search) {
+        using MC = typename ColourPalette<MS>::metric_colour;
+        auto entries = random_colours<sRgbf>(size, 1);
+        if (size > 4)
+            entries[3] = entries[1];
+        ColourPalette<MS> palette(entries, search);
+        int errors = int(palette.size() != size) + int(palette.search() != search);
+        // Queries include colours well outside the sRGB gamut
+        for (auto& c: random_colours<sRgbf>(2000, 2, -0.5, 1.5)) {
+            MC m;
+            convert_colour(c, m);
+            errors += int(palette.nearest(c) != linear_nearest(palette, m.as_vector()));
+        }
+        for (size_t i = 0; i < size; ++i) {
+            auto j = palette.nearest(palette.template colour<Colour<float, MS, ColourLayout::forward>>(i));
+            errors += int(palette.metric(j) != palette.metric(i)) + int(j > i);
+        }
+        return errors;
+    }
+
+    template <typename MS>
+    double mean_square_error(const ColourPalette<MS>& palette, const std::vector<sRgb8>& pixels) {
+        using MC = typename ColourPalette<MS>::metric_colour;
+        double sum = 0;
+        for (auto& c: pixels) {
+            MC m;
+            convert_colour(c, m);
+            sum += Detail::PaletteIndex::distance2(m.as_vector(), palette.metric(palette.nearest(c)));
+        }
+        return sum / double(pixels.size());
+    }
+
+}
+
+void test_rs_graphics_core_colour_palette_nearest() {
+
+    ColourPalette<> palette;
+
+    TEST(palette.empty());
+    TEST_EQUAL(palette.size(), 0u);
+    TEST_THROW(ColourPalette<>(std::vector<sRgbf>()), std::invalid_argument);
+    TEST_THROW(palette.nearest(sRgbf(0.5f, 0.5f, 0.5f)), std::invalid_argument);
+
+    for (auto search: {PaletteSearch::kd_tree, PaletteSearch::grid}) {
+        for (size_t size: {1, 2, 7, 64, 256}) {
+            TEST_EQUAL((check_nearest<CIELab>(size, search)), 0);
+            TEST_EQUAL((check_nearest<LinearRGB>(size, search)), 0);
+        }
+    }
+
+    std::vector<sRgba8> colours = {
+        {0, 0, 0, 255},
+        {255, 0, 0, 255},
+        {0, 255, 0, 255},
+        {0, 0, 255, 255},
+        {255, 255, 255, 255},
+    };
+
+    TRY(palette = ColourPalette<>(colours, PaletteSearch::grid));
+    TEST_EQUAL(palette.size(), 5u);
+    TEST_EQUAL(palette.nearest(sRgba8(10, 20, 30, 0)), 0u);
+    TEST_EQUAL(palette.nearest(sRgba8(200, 40, 40, 255)), 1u);
+    TEST_EQUAL(palette.nearest(sRgbf(0.1f, 0.9f, 0.2f)), 2u);
+    TEST_EQUAL(palette.nearest(sRgbf(0.95f, 0.9f, 0.97f)), 4u);
+    TEST_EQUAL(palette.nearest(sRgbf(std::nanf(""), 0, 0)), 0u);
+
+    for (size_t i = 0; i < colours.size(); ++i)
+        TEST_EQUAL(palette.colour<sRgba8>(i), colours[i]);
+
+}
+
+void test_rs_graphics_core_colour_palette_batch() {
+
+    static constexpr size_t n = 5003;
+
+    auto entries = random_colours<sRgbf>(100, 3);
+    auto pixels = random_colours<sRgba8>(n, 4);
+    std::vector<uint8_t> index8(n);
+    std::vector<uint32_t> index32(n);
+    std::vector<size_t> index_size(n);
+    std::vector<uint64_t> index64(n);
+    ThreadPool pool(3);
+
+    for (auto search: {PaletteSearch::kd_tree, PaletteSearch::grid}) {
+        ColourPalette<> palette(entries, search);
+        for (auto precision: {ColourPrecision::exact, ColourPrecision::fast}) {
+            TRY(palette.nearest(pixels.data(), index8.data(), n, precision));
+            TRY(palette.nearest(pixels.data(), index32.data(), n, precision, pool));
+            TRY(palette.nearest(pixels.data(), index_size.data(), n, precision));
+            TRY(palette.nearest(pixels.data(), index64.data(), n, precision, pool));
+            int errors = 0;
+            for (size_t i = 0; i < n; ++i) {
+                auto j = palette.nearest(pixels[i], precision);
+                errors += int(index8[i] != j) + int(index32[i] != j) + int(index_size[i] != j) + int(index64[i] != j);
+            }
+            TEST_EQUAL(errors, 0);
+        }
+    }
+
+    ColourPalette<> empty;
+
+    TEST_THROW(empty.nearest(pixels.data(), index32.data(), n), std::invalid_argument);
+
+    auto big = random_colours<sRgbf>(300, 5);
+    ColourPalette<> palette(big);
+
+    TEST_THROW(palette.nearest(pixels.data(), index8.data(), n), std::invalid_argument);
+    TRY(palette.nearest(pixels.data(), index32.data(), n));
+    TRY(palette.nearest(pixels.data(), index_size.data(), n));
+    TRY(palette.nearest(pixels.data(), index64.data(), n));
+
+}
+
+void test_rs_graphics_core_colour_palette_median_cut() {
+
+    std::vector<sRgb8> pixels;
+    std::vector<sRgb8> distinct = {{200, 30, 30}, {30, 200, 30}, {30, 30, 200}, {250, 250, 250}};
+
+    for (int i = 0; i < 1000; ++i)
+        pixels.push_back(distinct[size_t(i * 7 % 4)]);
+
+    ColourPalette<> palette;
+
+    TRY(palette = ColourPalette<>::median_cut(pixels.data(), pixels.size(), 16));
+    TEST_EQUAL(palette.size(), 4u);
+
+    for (auto& c: distinct) {
+        Colour<float, CIELab, ColourLayout::forward> lab;
+        convert_colour(c, lab, ColourPrecision::fast);
+        TEST_VECTORS(palette.metric(palette.nearest(c, ColourPrecision::fast)), lab.as_vector(), 1e-6);
+        TEST_EQUAL(palette.colour<sRgb8>(palette.nearest(c)), c);
+    }
+
+    TRY(palette = ColourPalette<>::median_cut(pixels.data(), pixels.size(), 2, PaletteSearch::grid));
+    TEST_EQUAL(palette.size(), 2u);
+    TEST_EQUAL(palette.search(), PaletteSearch::grid);
+
+    TEST_THROW(ColourPalette<>::median_cut(pixels.data(), pixels.size(), 0), std::invalid_argument);
+    TEST_THROW(ColourPalette<>::median_cut(pixels.data(), 0, 16), std::invalid_argument);
+
+    auto random = random_colours<sRgb8>(20000, 6);
+
+    TRY(palette = ColourPalette<>::median_cut(random.data(), random.size(), 64));
+    TEST_EQUAL(palette.size(), 64u);
+
+}
+
+void test_rs_graphics_core_colour_palette_k_means() {
+
+    auto pixels = random_colours<sRgb8>(40000, 7);
+    ThreadPool pool1(1);
+    ThreadPool pool4(4);
+    ColourPalette<> a, b, c;
+
+    TRY(a = ColourPalette<>::median_cut(pixels.data(), pixels.size(), 32));
+    TRY(b = ColourPalette<>::k_means(pixels.data(), pixels.size(), 32, 8, PaletteSearch::kd_tree, pool1));
+    TRY(c = ColourPalette<>::k_means(pixels.data(), pixels.size(), 32, 8, PaletteSearch::grid, pool4));
+
+    TEST_EQUAL(b.size(), 32u);
+    TEST_EQUAL(c.size(), 32u);
+
+    int mismatches = 0;
+    for (size_t i = 0; i < b.size(); ++i)
+        mismatches += int(b.metric(i) != c.metric(i));
+    TEST_EQUAL(mismatches, 0);
+
+    double mse_a = mean_square_error(a, pixels);
+    double mse_b = mean_square_error(b, pixels);
+
+    TEST(mse_b < mse_a);
+
+    ColourPalette<LinearRGB> d;
+
+    TRY(d = ColourPalette<LinearRGB>::k_means(pixels.data(), pixels.size(), 16));
+    TEST_EQUAL(d.size(), 16u);
+
+}
@@ -13,6 +13,37 @@ using namespace RS::Graphics::Core::Test;
 
 using Grey = Vector<double, 1>;
 
+namespace {
+
+    // A trivial space derived from CIE L*a*b*, with a registered shortcut
+    // to CIE L*u*v* that counts its calls
+
+    class HalfLab {
+    public:
+        using base = CIELab;
+        static constexpr std::array<char, 3> channels = {{ 'L', 'A', 'B' }};
+        static constexpr Csp properties = Csp::none;
+        template <typename T> static Vector<T, 3> from_base(Vector<T, 3> colour) noexcept { return colour / T(2); }
+        template <typename T> static Vector<T, 3> to_base(Vector<T, 3> colour) noexcept { return colour * T(2); }
+    };
+
+    int shortcut_calls = 0;
+
+}
+
+namespace RS::Graphics::Core {
+
+    template <>
+    struct ColourSpaceShortcut<HalfLab, CIELuv> {
+        template <typename T>
+        static Vector<T, 3> convert(Vector<T, 3> colour) noexcept {
+            ++shortcut_calls;
+            return CIELuv::from_base(CIELab::to_base(HalfLab::to_base(colour)));
+        }
+    };
+
+}
+
 void test_rs_graphics_core_colour_space_ciexyy() {
 
     Double3 xyy, xyz;
@@ -316,3 +347,134 @@ void test_rs_graphics_core_colour_space_conversion() {
     }
 
 }
+
+void test_rs_graphics_core_colour_space_linear_chains() {
+
+    TEST(Detail::is_linear_chain<CIEXYZ>);
+    TEST(Detail::is_linear_chain<LinearRGB>);
+    TEST(Detail::is_linear_chain<LinearAdobeRGB>);
+    TEST(Detail::is_linear_chain<LinearProPhoto>);
+    TEST(Detail::is_linear_chain<LinearWideGamut>);
+    TEST(! Detail::is_linear_chain<sRGB>);
+    TEST(! Detail::is_linear_chain<AdobeRGB>);
+    TEST(! Detail::is_linear_chain<CIELab>);
+    TEST(! Detail::is_linear_chain<Greyscale>);
+
+    // A conversion within a linear chain is one fused matrix, matching the
+    // two step conversion through CIE XYZ
+
+    Double3 c, d, e;
+
+    for (auto& v: {Double3(0, 0, 0), Double3(1, 1, 1), Double3(0.25, 0.5, 0.75), Double3(1, 0, 0), Double3(0.1, 0.9, 0.3)}) {
+
+        TRY((c = convert_colour_space<LinearAdobeRGB, LinearProPhoto>(v)));
+        TRY((d = LinearProPhoto::from_base(LinearAdobeRGB::to_base(v))));
+        TRY((e = Detail::linear_conversion_matrix<LinearAdobeRGB, LinearProPhoto, double> * v));
+        TEST_VECTORS(c, d, 1e-12);
+        TEST_EQUAL(c, e);
+
+        TRY((c = convert_colour_space<LinearWideGamut, CIEXYZ>(v)));
+        TRY((d = LinearWideGamut::to_base(v)));
+        TEST_VECTORS(c, d, 1e-12);
+
+        // The working space of a nonlinear space is reached without a round
+        // trip through CIE XYZ
+
+        TRY((c = convert_colour_space<LinearRGB, sRGB>(v)));
+        TRY((d = sRGB::from_base(v)));
+        TEST_EQUAL(c, d);
+        TRY((c = convert_colour_space<AdobeRGB, LinearAdobeRGB>(v)));
+        TRY((d = AdobeRGB::to_base(v)));
+        TEST_EQUAL(c, d);
+
+        TRY((c = convert_colour_space<AdobeRGB, sRGB>(v)));
+        TRY((d = sRGB::from_base(LinearRGB::from_base(LinearAdobeRGB::to_base(AdobeRGB::to_base(v))))));
+        TEST_VECTORS(c, d, 1e-12);
+
+    }
+
+}
+
+void test_rs_graphics_core_colour_space_routing() {
+
+    using namespace Detail;
+
+    TEST_EQUAL((route_cost<sRGB, sRGB>()), 0);
+    TEST_EQUAL((route_cost<LinearAdobeRGB, LinearProPhoto>()), 1);
+    TEST_EQUAL((route_cost<sRGB, AdobeRGB>()), 3);
+    TEST_EQUAL((route_cost<sRGB, HSV>()), 2);
+    TEST_EQUAL((route_cost<HSL, HSV>()), 1);
+    TEST_EQUAL((route_cost<CIELab, HCLab>()), 1);
+    TEST_EQUAL((route_cost<HCLab, CIELab>()), 1);
+    TEST_EQUAL((route_cost<HCLab, CIELuv>()), 3);
+    TEST_EQUAL((route_cost<HCLab, HCLuv>()), 4);
+    TEST_EQUAL((route_cost<HalfLab, CIELuv>()), 1);
+    TEST_EQUAL((route_cost<HalfLab, HCLuv>()), 2);
+    TEST_EQUAL((route_cost<HalfLab, CIEXYZ>()), 2);
+
+    TEST((route_step<sRGB, AdobeRGB>() == RouteStep::up));
+    TEST((route_step<CIELab, HCLab>() == RouteStep::down));
+    TEST((route_step<HSV, HSL>() == RouteStep::shortcut));
+    TEST((route_step<CIEXYZ, LinearRGB>() == RouteStep::matrix));
+    TEST((route_ends_with_from_base<LinearRGB, sRGB>()));
+    TEST((! route_ends_with_from_base<HSL, HSV>()));
+
+    Double3 c, d;
+
+    // A space and its descendant convert directly, without a round trip
+    // through CIE XYZ
+
+    for (auto& sample: samples()) {
+        TRY((c = convert_colour_space<CIELab, HCLab>(sample.CIELab)));
+        TRY((d = HCLab::from_base(sample.CIELab)));
+        TEST_EQUAL(c, d);
+        auto hcl = HCLab::from_base(sample.CIELab);
+        TRY((c = convert_colour_space<HCLab, CIELab>(hcl)));
+        TRY((d = HCLab::to_base(hcl)));
+        TEST_EQUAL(c, d);
+    }
+
+    // The HSL/HSV shortcuts agree with the route through linear RGB
+
+    for (auto& sample: samples()) {
+        TRY((c = convert_colour_space<HSL, HSV>(sample.HSL)));
+        TRY((d = HSV::from_base(HSL::to_base(sample.HSL))));
+        TEST_VECTORS_HSPACE(c, d, 1e-10);
+        TRY((c = convert_colour_space<HSV, HSL>(sample.HSV)));
+        TRY((d = HSL::from_base(HSV::to_base(sample.HSV))));
+        TEST_VECTORS_HSPACE(c, d, 1e-10);
+    }
+
+    // The shortcuts normalise the hue, matching the route through linear RGB
+    // for the equivalent hue in the unit range
+
+    for (auto h: {1.3, -0.2}) {
+        Double3 in(h, 0.6, 0.4);
+        Double3 unit(euclidean_remainder(h, 1.0), 0.6, 0.4);
+        TRY((c = convert_colour_space<HSL, HSV>(in)));
+        TRY((d = HSV::from_base(HSL::to_base(unit))));
+        TEST(c[0] >= 0 && c[0] < 1);
+        TEST_VECTORS(c, d, 1e-10);
+        TRY((c = convert_colour_space<HSV, HSL>(in)));
+        TRY((d = HSL::from_base(HSV::to_base(unit))));
+        TEST(c[0] >= 0 && c[0] < 1);
+        TEST_VECTORS(c, d, 1e-10);
+    }
+
+    // A registered shortcut is used wherever it gives the cheapest route
+
+    for (auto& sample: samples()) {
+        Double3 half = sample.CIELab / 2.0;
+        shortcut_calls = 0;
+        TRY((c = convert_colour_space<HalfLab, CIELuv>(half)));
+        TEST_EQUAL(shortcut_calls, 1);
+        TEST_VECTORS(c, sample.CIELuv, 0.1);
+        TRY((c = convert_colour_space<HalfLab, HCLuv>(half)));
+        TEST_EQUAL(shortcut_calls, 2);
+        TEST_VECTORS_HSPACE(c, HCLuv::from_base(sample.CIELuv), 0.1);
+        TRY((c = convert_colour_space<HalfLab, CIEXYZ>(half)));
+        TEST_EQUAL(shortcut_calls, 2);
+        TEST_VECTORS(c, sample.CIEXYZ, 1e-4);
+    }
+
+}
@@ -4,6 +4,8 @@
 #include "test/colour-space-test.hpp"
 #include "test/vector-test.hpp"
 #include <stdexcept>
+#include <string>
+#include <string_view>
 
 using namespace RS::Graphics::Core;
 using namespace RS::Graphics::Core::Test;
@@ -133,3 +135,52 @@ void test_rs_graphics_core_colour_css_colours() {
     TRY(d = css_colour<Rgbad>("(789abcde)"));     TEST_VECTORS(d,  Rgbad(0.187821,0.323144,0.502887,0.870588), 1e-6);
 
 }
+
+void test_rs_graphics_core_colour_string_parsing() {
+
+    sRgba8 a;
+    sRgb8 b;
+    Rgbaf c;
+    char buf[8];
+    char* end = nullptr;
+
+    TEST_EQUAL(parse_hex_colour("123456", a), ColourParseError::none);          TEST_EQUAL(a, sRgba8(0x12, 0x34, 0x56, 0xff));
+    TEST_EQUAL(parse_hex_colour("#789ABCDE", a), ColourParseError::none);       TEST_EQUAL(a, sRgba8(0x78, 0x9a, 0xbc, 0xde));
+    TEST_EQUAL(parse_hex_colour(" (fedcba) ", b), ColourParseError::none);      TEST_EQUAL(b, sRgb8(0xfe, 0xdc, 0xba));
+    TEST_EQUAL(parse_hex_colour("", a), ColourParseError::invalid_hex);         TEST_EQUAL(a, sRgba8(0x78, 0x9a, 0xbc, 0xde));
+    TEST_EQUAL(parse_hex_colour("#abc", a), ColourParseError::invalid_hex);     TEST_EQUAL(a, sRgba8(0x78, 0x9a, 0xbc, 0xde));
+    TEST_EQUAL(parse_hex_colour("1234567", a), ColourParseError::invalid_hex);  TEST_EQUAL(a, sRgba8(0x78, 0x9a, 0xbc, 0xde));
+    TEST_EQUAL(parse_hex_colour("abcdefgh", a), ColourParseError::invalid_hex);
+    TEST_EQUAL(parse_hex_colour("12 3456", a), ColourParseError::invalid_hex);
+    TEST_EQUAL(parse_hex_colour("red", a), ColourParseError::invalid_hex);
+
+    TEST_EQUAL(parse_css_colour("Crimson", a), ColourParseError::none);                 TEST_EQUAL(a, sRgba8(0xdc, 0x14, 0x3c, 0xff));
+    TEST_EQUAL(parse_css_colour("LIGHT-GOLDENROD-YELLOW", a), ColourParseError::none);  TEST_EQUAL(a, sRgba8(0xfa, 0xfa, 0xd2, 0xff));
+    TEST_EQUAL(parse_css_colour("#123456", a), ColourParseError::none);                 TEST_EQUAL(a, sRgba8(0x12, 0x34, 0x56, 0xff));
+    TEST_EQUAL(parse_css_colour("transparent", c), ColourParseError::none);             TEST_EQUAL(c, Rgbaf(0, 0, 0, 0));
+    TEST_EQUAL(parse_css_colour("", a), ColourParseError::unknown_name);                TEST_EQUAL(a, sRgba8(0x12, 0x34, 0x56, 0xff));
+    TEST_EQUAL(parse_css_colour("redd", a), ColourParseError::unknown_name);            TEST_EQUAL(a, sRgba8(0x12, 0x34, 0x56, 0xff));
+    TEST_EQUAL(parse_css_colour("lightgoldenrodyellowx", a), ColourParseError::unknown_name);
+    TEST_EQUAL(parse_css_colour("not a colour at all, but a very long string", a), ColourParseError::unknown_name);
+
+    TEST_THROW(css_colour<sRgba8>("redd"), std::invalid_argument);
+
+    TRY((a = {0x98,0x76,0x54,0x32}));
+    TRY(end = a.hex(buf));
+    TEST_EQUAL(end - buf, 8);
+    TEST_EQUAL(std::string(buf, end), "98765432");
+    TRY((b = {0xfe,0xdc,0xba}));
+    TRY(end = b.hex(buf));
+    TEST_EQUAL(end - buf, 6);
+    TEST_EQUAL(std::string(buf, end), "fedcba");
+
+    for (int i = 0; i < 256; ++i) {
+        auto x = uint8_t(i);
+        sRgba8 d = {x, uint8_t(255 - x), uint8_t(x ^ 0x5a), uint8_t(x * 7)};
+        sRgba8 e;
+        TRY(end = d.hex(buf));
+        TEST_EQUAL(parse_hex_colour(std::string_view(buf, end - buf), e), ColourParseError::none);
+        TEST_EQUAL(e, d);
+    }
+
+}
@@ -1,5 +1,15 @@
 #include "rs-graphics-core/linear-map.hpp"
+#include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/simd.hpp"
+#include "rs-graphics-core/vector.hpp"
 #include "rs-unit-test.hpp"
+#include "test/vector-test.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
 
 using namespace RS::Graphics::Core;
 
@@ -130,3 +140,235 @@ void test_rs_graphics_core_linear_map() {
     TEST_NEAR(map[35], 600, eps);
 
 }
+
+void test_rs_graphics_core_linear_map_transform() {
+
+    LinearMap<double> map = {
+        {10, 100},
+        {20, 200, 300, 400},
+        {30, 500, 600},
+    };
+
+    std::vector<double> seen;
+    LinearMap<double> out;
+
+    TRY(out = map.transform([&] (double y) { seen.push_back(y); return y / 10; }));
+    TEST_EQUAL(out.min(), 10);
+    TEST_EQUAL(out.max(), 30);
+    TEST_NEAR(out[5], 10, eps);
+    TEST_NEAR(out[15], 15, eps);
+    TEST_NEAR(out[20], 30, eps);
+    TEST_NEAR(out[25], 45, eps);
+    TEST_NEAR(out[35], 60, eps);
+    TEST_EQUAL(seen.size(), 9u);
+    std::sort(seen.begin(), seen.end());
+    TEST((seen == std::vector<double>{100, 100, 100, 200, 300, 400, 500, 550, 600}));
+
+}
+
+void test_rs_graphics_core_linear_map_frozen() {
+
+    static constexpr double inf = std::numeric_limits<double>::infinity();
+
+    std::minstd_rand rng(42);
+    std::uniform_real_distribution<double> dist(-10, 110);
+
+    for (int knots: {1, 2, 3, 4, 7, 16, 64, 100}) {
+
+        LinearMap<double> map;
+
+        for (int i = 0; i < knots; ++i) {
+            if (i % 3 == 1)
+                map.insert(100.0 * i / knots, dist(rng), dist(rng));
+            else
+                map.insert(100.0 * i / knots, dist(rng));
+        }
+
+        std::vector<double> in;
+        for (int i = 0; i < 1000; ++i)
+            in.push_back(dist(rng));
+        for (int i = 0; i < knots; ++i)
+            in.push_back(100.0 * i / knots);
+        in.push_back(std::nan(""));
+        in.push_back(inf);
+        in.push_back(- inf);
+
+        std::vector<double> expect(in.size()), out(in.size());
+        for (size_t i = 0; i < in.size(); ++i)
+            expect[i] = map[in[i]];
+
+        TEST(! map.frozen());
+        TRY(map.batch(in.data(), out.data(), in.size()));
+        TEST((std::equal(out.begin(), out.end(), expect.begin(), [] (double a, double b)
+            { return a == b || (std::isnan(a) && std::isnan(b)); })));
+
+        TRY(map.freeze());
+        TEST(map.frozen());
+        int errors = 0;
+        for (size_t i = 0; i < in.size(); ++i)
+            errors += int(map[in[i]] != expect[i]);
+        TEST_EQUAL(errors, 0);
+
+        TRY(map.batch(in.data(), out.data(), in.size()));
+        TEST(out == expect);
+
+        // Sorted and partly sorted inputs
+
+        auto sorted = in;
+        std::sort(sorted.begin(), sorted.end() - 3);
+        std::rotate(sorted.begin(), sorted.begin() + 500, sorted.end());
+        TRY(map.batch(sorted.data(), out.data(), sorted.size()));
+        errors = 0;
+        for (size_t i = 0; i < sorted.size(); ++i)
+            errors += int(out[i] != map[sorted[i]]);
+        TEST_EQUAL(errors, 0);
+
+        auto copy = map;
+        TEST(copy.frozen());
+        TEST_EQUAL(copy[50], map[50]);
+
+    }
+
+    LinearMap<double> map = {{10, 100}, {20, 200}};
+
+    TRY(map.freeze());
+    TEST(map.frozen());
+    TEST_NEAR(map[15], 150, eps);
+    TRY(map.insert(30, 500));
+    TEST(! map.frozen());
+    TEST_NEAR(map[25], 350, eps);
+    TRY(map.freeze());
+    TEST_NEAR(map[25], 350, eps);
+    TRY(map.erase(20));
+    TEST(! map.frozen());
+    TEST_NEAR(map[20], 300, eps);
+    TRY(map.freeze());
+    TRY(map.clear());
+    TEST(! map.frozen());
+    TRY(map.freeze());
+    TEST(map.frozen());
+    TEST_EQUAL(map[20], 0);
+
+}
+
+void test_rs_graphics_core_linear_map_knots() {
+
+    LinearMap<double> map;
+    std::vector<LinearMap<double>::knot_type> knots;
+
+    TRY(knots = map.knots());
+    TEST(knots.empty());
+
+    map = {
+        {30, 500, 600},
+        {10, 100},
+        {20, 200, 300, 400},
+    };
+
+    TRY(knots = map.knots());
+    TEST_EQUAL(knots.size(), 3u);
+    TEST_EQUAL(knots[0].x, 10);  TEST_EQUAL(knots[0].left, 100);  TEST_EQUAL(knots[0].mid, 100);  TEST_EQUAL(knots[0].right, 100);
+    TEST_EQUAL(knots[1].x, 20);  TEST_EQUAL(knots[1].left, 200);  TEST_EQUAL(knots[1].mid, 300);  TEST_EQUAL(knots[1].right, 400);
+    TEST_EQUAL(knots[2].x, 30);  TEST_EQUAL(knots[2].left, 500);  TEST_EQUAL(knots[2].mid, 550);  TEST_EQUAL(knots[2].right, 600);
+
+}
+
+void test_rs_graphics_core_linear_map_ramp() {
+
+    LinearRamp<double> ramp;
+
+    TEST(ramp.empty());
+    TEST_EQUAL(ramp.size(), 0u);
+    TEST_EQUAL(ramp(0.5), 0);
+
+    LinearMap<double> map = {
+        {10, 100},
+        {20, 200, 300, 400},
+        {30, 500, 600},
+    };
+
+    TEST_THROW(LinearRamp<double>(map, 0), std::invalid_argument);
+    TEST_THROW(LinearRamp<double>(map, 21), std::invalid_argument);
+
+    TRY(ramp = LinearRamp<double>(map, 4));
+    TEST_EQUAL(ramp.size(), 16u);
+    TEST_EQUAL(ramp.table().size(), 17u);
+    TEST_EQUAL(ramp.min(), 10);
+    TEST_EQUAL(ramp.max(), 30);
+
+    // Linear between samples, so exact except around the step at 20
+
+    for (double x: {0.0, 10.0, 12.5, 15.0, 16.0, 23.75, 27.0, 30.0})
+        TEST_NEAR(ramp(x), map[x], 1e-10);
+
+    // Out of range inputs take the value at the end of the domain
+
+    TEST_EQUAL(ramp(20), 300);
+    TEST_EQUAL(ramp(35), 550);
+    TEST_EQUAL(ramp(std::nan("")), 100);
+
+    LinearRamp<double> flat;
+
+    TRY(flat = LinearRamp<double>(LinearMap<double>{{5, 42}}));
+    TEST_EQUAL(flat.size(), 256u);
+    TEST_EQUAL(flat(0), 42);
+    TEST_EQUAL(flat(5), 42);
+    TEST_EQUAL(flat(100), 42);
+
+}
+
+void test_rs_graphics_core_linear_map_ramp_batch() {
+
+    static constexpr size_t n = 1003;
+
+    LinearMap<float, Rgbaf> colours = {
+        {0.0f, Rgbaf(0, 0, 0.5f, 1)},
+        {0.3f, Rgbaf(0, 0.8f, 1, 1)},
+        {0.7f, Rgbaf(1, 1, 0, 0.5f)},
+        {1.0f, Rgbaf(1, 0, 0, 1)},
+    };
+
+    LinearMap<float> values = {
+        {-2.0f, 1.0f},
+        {1.0f, 3.0f, 5.0f},
+        {4.0f, -1.0f},
+    };
+
+    LinearRamp<float, Rgbaf> colour_ramp(colours, 6);
+    LinearRamp<float> value_ramp(values, 10);
+    std::minstd_rand rng(42);
+    std::uniform_real_distribution<float> dist(-3, 5);
+    std::vector<float> in(n);
+    std::vector<Rgbaf> colour_out(n), colour_expect(n);
+    std::vector<float> value_out(n), value_expect(n);
+    auto native = simd_level();
+
+    for (auto& x: in)
+        x = dist(rng);
+    in[10] = std::nanf("");
+    in[11] = - INFINITY;
+    in[12] = INFINITY;
+
+    for (size_t i = 0; i < n; ++i) {
+        colour_expect[i] = colour_ramp(in[i]);
+        value_expect[i] = value_ramp(in[i]);
+    }
+
+    TEST_VECTORS(colour_ramp(0.5f).as_vector(), colours[0.5f].as_vector(), 1e-6);
+    TEST_EQUAL(colour_ramp(std::nanf("")), colours[0]);
+    TEST_EQUAL(value_ramp(100), -1);
+
+    for (auto level: {SimdLevel::none, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512}) {
+        if (level > native)
+            break;
+        TRY(limit_simd_level(level));
+        TRY(colour_ramp.batch(in.data(), colour_out.data(), n));
+        TRY(value_ramp.batch(in.data(), value_out.data(), n));
+        TEST(colour_out == colour_expect);
+        TEST(value_out == value_expect);
+    }
+
+    limit_simd_level(SimdLevel::avx512);
+    TEST_EQUAL(simd_level(), native);
+
+}
@@ -1,14 +1,21 @@
 #include "rs-graphics-core/noise.hpp"
 #include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/geometry.hpp"
+#include "rs-graphics-core/multi-array.hpp"
+#include "rs-graphics-core/parallel.hpp"
+#include "rs-graphics-core/simd.hpp"
 #include "rs-graphics-core/vector.hpp"
 #include "rs-format/format.hpp"
 #include "rs-tl/thread.hpp"
 #include "rs-unit-test.hpp"
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <iostream>
 #include <random>
+#include <stdexcept>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
@@ -123,6 +130,551 @@ void test_rs_graphics_core_noise_result_stability() {
 
 }
 
+void test_rs_graphics_core_noise_batch_evaluation() {
+
+    static constexpr int n = 1000;
+
+    std::minstd_rand rng(42);
+    std::uniform_real_distribution<double> coord_dist(-100, 100);
+
+    Noise<float, 2> noise2f(42);
+    Noise<float, 3> noise3f(42);
+    Noise<double, 2> noise2d(42);
+    Noise<double, 3> noise3d(42);
+
+    std::vector<Float2> points2f(n);
+    std::vector<Float3> points3f(n);
+    std::vector<Double2> points2d(n);
+    std::vector<Double3> points3d(n);
+    std::vector<float> values_f(n);
+    std::vector<double> values_d(n);
+
+    for (int i = 0; i < n; ++i) {
+        for (auto& p: points3d[i])
+            p = coord_dist(rng);
+        points2d[i] = {points3d[i].x(), points3d[i].y()};
+        points2f[i] = Float2(points2d[i]);
+        points3f[i] = Float3(points3d[i]);
+    }
+
+    TRY(noise2f.batch(points2f.data(), values_f.data(), n));
+    for (int i = 0; i < n; ++i)
+        TEST_EQUAL(values_f[i], noise2f(points2f[i]));
+
+    TRY(noise3f.batch(points3f.data(), values_f.data(), n));
+    for (int i = 0; i < n; ++i)
+        TEST_EQUAL(values_f[i], noise3f(points3f[i]));
+
+    TRY(noise2d.batch(points2d.data(), values_d.data(), n));
+    for (int i = 0; i < n; ++i)
+        TEST_EQUAL(values_d[i], noise2d(points2d[i]));
+
+    TRY(noise3d.batch(points3d.data(), values_d.data(), n));
+    for (int i = 0; i < n; ++i)
+        TEST_EQUAL(values_d[i], noise3d(points3d[i]));
+
+    TRY(noise2d.batch(nullptr, nullptr, 0));
+
+}
+
+void test_rs_graphics_core_noise_simd_kernels() {
+
+    static constexpr int n = 1003;
+
+    std::minstd_rand rng(42);
+    std::uniform_real_distribution<float> coord_dist(-100, 100);
+
+    Noise<float, 2> noise2(42);
+    Noise<float, 3> noise3(42);
+    std::vector<Float2> points2(n);
+    std::vector<Float3> points3(n);
+    std::vector<float> expect2(n);
+    std::vector<float> expect3(n);
+    std::vector<float> values(n);
+
+    for (int i = 0; i < n; ++i) {
+        for (auto& p: points3[i])
+            p = coord_dist(rng);
+        if (i % 10 == 0)
+            for (auto& p: points3[i])
+                p = std::round(4 * p) / 4;
+        points2[i] = {points3[i].x(), points3[i].y()};
+        expect2[i] = noise2(points2[i]);
+        expect3[i] = noise3(points3[i]);
+    }
+
+    auto native = simd_level();
+
+    for (auto level: {SimdLevel::none, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512}) {
+        if (level > native)
+            break;
+        TRY(limit_simd_level(level));
+        TEST_EQUAL(simd_level(), level);
+        TRY(std::fill(values.begin(), values.end(), 99.0f));
+        TRY(noise2.batch(points2.data(), values.data(), n));
+        for (int i = 0; i < n; ++i)
+            TEST_EQUAL(values[i], expect2[i]);
+        TRY(std::fill(values.begin(), values.end(), 99.0f));
+        TRY(noise3.batch(points3.data(), values.data(), n));
+        for (int i = 0; i < n; ++i)
+            TEST_EQUAL(values[i], expect3[i]);
+    }
+
+    TRY(limit_simd_level(SimdLevel::avx512));
+    TEST_EQUAL(simd_level(), native);
+
+}
+
+void test_rs_graphics_core_noise_scanline() {
+
+    static constexpr int n = 2003;
+
+    Noise<float, 2> noise2f(42);
+    Noise<float, 3> noise3f(42);
+    Noise<double, 2> noise2d(42);
+    Noise<double, 3> noise3d(42);
+    std::vector<float> values_f(n);
+    std::vector<double> values_d(n);
+    auto native = simd_level();
+
+    for (double delta: {0.015625, 0.125, 0.75}) {
+
+        Double2 origin2(-10.5, 3.25);
+        Double2 step2(delta, delta / 4);
+        Double3 origin3(-10.5, 3.25, 7.0);
+        Double3 step3(delta, - delta / 2, delta / 8);
+
+        for (auto level: {SimdLevel::none, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512}) {
+
+            if (level > native)
+                break;
+
+            TRY(limit_simd_level(level));
+
+            TRY(noise2d.scanline(origin2, step2, values_d.data(), n));
+            for (int i = 0; i < n; ++i)
+                TEST_EQUAL(values_d[i], noise2d(origin2 + double(i) * step2));
+
+            TRY(noise3d.scanline(origin3, step3, values_d.data(), n));
+            for (int i = 0; i < n; ++i)
+                TEST_EQUAL(values_d[i], noise3d(origin3 + double(i) * step3));
+
+            TRY(noise2f.scanline(Float2(origin2), Float2(step2), values_f.data(), n));
+            for (int i = 0; i < n; ++i)
+                TEST_EQUAL(values_f[i], noise2f(Float2(origin2) + float(i) * Float2(step2)));
+
+            TRY(noise3f.scanline(Float3(origin3), Float3(step3), values_f.data(), n));
+            for (int i = 0; i < n; ++i)
+                TEST_EQUAL(values_f[i], noise3f(Float3(origin3) + float(i) * Float3(step3)));
+
+        }
+
+        limit_simd_level(SimdLevel::avx512);
+        TEST_EQUAL(simd_level(), native);
+
+    }
+
+    TRY(noise2d.scanline(Double2(), Double2(), nullptr, 0));
+
+}
+
+void test_rs_graphics_core_noise_array_fill() {
+
+    NoiseSource<float, 2, 1> source2(20, 1, 4, 42);
+    NoiseSource<float, 3, 2> source3(10, 1, 3, 86);
+    MultiArray<float, 2> array2(150, 90);
+    MultiArray<Float2, 3> array3(40, 35, 20);
+
+    for (int threads: {1, 3}) {
+
+        ThreadPool pool(threads);
+
+        TRY(array2.fill(99));
+        TRY(source2.fill(array2, Box_i2(Int2(0), array2.shape()), pool));
+        for (auto i = array2.begin(); i != array2.end(); ++i)
+            TEST_EQUAL(*i, source2(Float2(i.pos())));
+
+        TRY(array3.fill(Float2(99)));
+        TRY(source3.fill(array3, Box_i3(Int3(0), array3.shape()), pool));
+        for (auto i = array3.begin(); i != array3.end(); ++i)
+            TEST_EQUAL(*i, source3(Float3(i.pos())));
+
+        Box_i2 box2({70, 10}, {75, 30});
+        TRY(array2.fill(99));
+        TRY(source2.fill(array2, box2, pool));
+        for (auto i = array2.begin(); i != array2.end(); ++i) {
+            if (box2.contains(i.pos()))
+                TEST_EQUAL(*i, source2(Float2(i.pos())));
+            else
+                TEST_EQUAL(*i, 99);
+        }
+
+        Box_i3 box3({5, 17, 3}, {30, 18, 10});
+        TRY(array3.fill(Float2(99)));
+        TRY(source3.fill(array3, box3, pool));
+        for (auto i = array3.begin(); i != array3.end(); ++i) {
+            if (box3.contains(i.pos()))
+                TEST_EQUAL(*i, source3(Float3(i.pos())));
+            else
+                TEST_EQUAL(*i, Float2(99));
+        }
+
+        TEST_THROW(source2.fill(array2, Box_i2({100, 0}, {100, 10}), pool), std::invalid_argument);
+
+    }
+
+    TRY(array2.fill(99));
+    TRY(source2.fill(array2));
+    TEST_EQUAL(array2(0, 0), source2(Float2(0, 0)));
+    TEST_EQUAL(array2(149, 89), source2(Float2(149, 89)));
+
+    // One dimensional rows span more than one tile, and the compact layout
+    // goes through the split channel tables
+
+    NoiseSource<float, 1, 3, NoiseLayout::compact> source1(15, 1, 5, 99);
+    MultiArray<Float3, 1> array1(Vector<int, 1>(5000));
+    auto native = simd_level();
+
+    for (auto level: {SimdLevel::none, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512}) {
+        if (level > native)
+            break;
+        TRY(limit_simd_level(level));
+        TRY(array1.fill(Float3(99)));
+        TRY(source1.fill(array1));
+        int errors = 0;
+        for (int x = 0; x < 5000; ++x)
+            errors += int(array1.get(Vector<int, 1>(x)) != source1(float(x)));
+        TEST_EQUAL(errors, 0);
+    }
+
+    TRY(limit_simd_level(SimdLevel::avx512));
+    TEST_EQUAL(simd_level(), native);
+
+}
+
+void test_rs_graphics_core_noise_source_fused_evaluation() {
+
+    // Compare against the sum of independent generators, seeded the same way
+
+    static constexpr int n = 1000;
+    static constexpr uint64_t seed = 86;
+    static constexpr int octaves = 8;
+
+    std::minstd_rand rng(42);
+    std::uniform_real_distribution<double> coord_dist(-1000, 1000);
+
+    NoiseSource<double, 1, 1> source11(20, 2, octaves, seed);
+    NoiseSource<float, 2, 2> source22(20, 2, octaves, seed);
+    NoiseSource<double, 3, 3> source33(20, 2, octaves, seed);
+    std::array<Noise<double, 2>, 1> gen11;
+    std::array<Noise<float, 2>, 2> gen22;
+    std::array<Noise<double, 3>, 3> gen33;
+
+    auto make_gens = [] (auto& gens) {
+        uint64_t s = seed;
+        for (auto& g: gens) {
+            g.seed(s);
+            s = Detail::lcg64_2(s);
+        }
+    };
+
+    make_gens(gen11);
+    make_gens(gen22);
+    make_gens(gen33);
+
+    std::vector<double> points11(n), values11(n);
+    std::vector<Float2> points22(n), values22(n);
+    std::vector<Double3> points33(n), values33(n);
+
+    for (int i = 0; i < n; ++i) {
+        for (auto& x: points33[i])
+            x = coord_dist(rng);
+        points11[i] = points33[i].x();
+        points22[i] = Float2(float(points33[i].x()), float(points33[i].y()));
+    }
+
+    TRY(source11.batch(points11.data(), values11.data(), n));
+    TRY(source22.batch(points22.data(), values22.data(), n));
+    TRY(source33.batch(points33.data(), values33.data(), n));
+
+    for (int i = 0; i < n; ++i) {
+
+        Double2 in11(points11[i] / 20, 0);
+        Float2 in22 = points22[i] / 20.0f;
+        Double3 in33 = points33[i] / 20.0;
+        double out11 = 0;
+        Float2 out22;
+        Double3 out33;
+        double s = 2;
+        float sf = 2;
+
+        for (int j = 0; j < octaves; ++j, in11 *= 2, in22 *= 2, in33 *= 2, s /= 2, sf /= 2) {
+            out11 += s * gen11[0](in11);
+            for (int k = 0; k < 2; ++k)
+                out22[k] += sf * gen22[k](in22);
+            for (int k = 0; k < 3; ++k)
+                out33[k] += s * gen33[k](in33);
+        }
+
+        TEST_EQUAL(source11(points11[i]), out11);
+        TEST_EQUAL(source22(points22[i]), out22);
+        TEST_EQUAL(source33(points33[i]), out33);
+        TEST_EQUAL(values11[i], out11);
+        TEST_EQUAL(values22[i], out22);
+        TEST_EQUAL(values33[i], out33);
+
+    }
+
+}
+
+void test_rs_graphics_core_noise_compact_layout() {
+
+    static constexpr int n = 1003;
+
+    std::minstd_rand rng(42);
+    std::uniform_real_distribution<double> coord_dist(-100, 100);
+
+    Noise<float, 2> standard2f(42);
+    Noise<float, 2, NoiseLayout::compact> compact2f(42);
+    Noise<float, 3> standard3f(42);
+    Noise<float, 3, NoiseLayout::compact> compact3f(42);
+    Noise<double, 2> standard2d(42);
+    Noise<double, 2, NoiseLayout::compact> compact2d(42);
+    Noise<double, 3> standard3d(42);
+    Noise<double, 3, NoiseLayout::compact> compact3d(42);
+    NoiseSource<double, 3, 3> standard_source(10, 1, 4, 42);
+    NoiseSource<double, 3, 3, NoiseLayout::compact> compact_source(10, 1, 4, 42);
+
+    TEST(sizeof(compact2f) < sizeof(standard2f));
+    TEST(sizeof(compact3d) < sizeof(standard3d));
+    TEST_EQUAL(sizeof(compact3d), 2048 * sizeof(uint32_t));
+
+    std::vector<Double3> points(n);
+    std::vector<Float2> points2(n);
+    std::vector<Float3> points3(n);
+    std::vector<float> expect2(n);
+    std::vector<float> expect3(n);
+    std::vector<float> values(n);
+
+    for (int i = 0; i < n; ++i) {
+        for (auto& p: points[i])
+            p = coord_dist(rng);
+        auto& p = points[i];
+        points2[i] = Float2(float(p.x()), float(p.y()));
+        points3[i] = Float3(points[i]);
+        expect2[i] = standard2f(points2[i]);
+        expect3[i] = standard3f(points3[i]);
+        TEST_EQUAL(compact2f(points2[i]), expect2[i]);
+        TEST_EQUAL(compact3f(points3[i]), expect3[i]);
+        TEST_EQUAL(compact2d(Double2(p.x(), p.y())), standard2d(Double2(p.x(), p.y())));
+        TEST_EQUAL(compact3d(p), standard3d(p));
+        TEST_EQUAL(compact_source(p), standard_source(p));
+    }
+
+    auto native = simd_level();
+
+    for (auto level: {SimdLevel::none, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512}) {
+        if (level > native)
+            break;
+        TRY(limit_simd_level(level));
+        TRY(std::fill(values.begin(), values.end(), 99.0f));
+        TRY(compact2f.batch(points2.data(), values.data(), n));
+        for (int i = 0; i < n; ++i)
+            TEST_EQUAL(values[i], expect2[i]);
+        TRY(std::fill(values.begin(), values.end(), 99.0f));
+        TRY(compact3f.batch(points3.data(), values.data(), n));
+        for (int i = 0; i < n; ++i)
+            TEST_EQUAL(values[i], expect3[i]);
+    }
+
+    TRY(limit_simd_level(SimdLevel::avx512));
+
+}
+
+void test_rs_graphics_core_noise_fast_seeding() {
+
+    static constexpr int n = 100'000;
+
+    std::minstd_rand rng(42);
+    std::uniform_real_distribution<double> coord_dist(-100, 100);
+
+    Noise<double, 3> standard(86);
+    Noise<double, 3> explicit_standard(86, NoiseSeeding::standard);
+    Noise<double, 3> fast1(86, NoiseSeeding::fast);
+    Noise<double, 3> fast2;
+    Noise<double, 3, NoiseLayout::compact> fast_compact(86, NoiseSeeding::fast);
+    NoiseSource<double, 3, 2> source1(10, 1, 4, 86, NoiseSeeding::fast);
+    NoiseSource<double, 3, 2> source2;
+
+    TRY(fast2.seed(86, NoiseSeeding::fast));
+    TRY(source2.cell(10));
+    TRY(source2.octaves(4));
+    TRY(source2.seed(86, NoiseSeeding::fast));
+
+    Double3 point;
+    double x = 0;
+    double y = 0;
+    double sum = 0;
+    double sum2 = 0;
+    double ref2 = 0;
+    int differ = 0;
+
+    for (int i = 0; i < n; ++i) {
+        for (auto& p: point)
+            p = coord_dist(rng);
+        TRY(x = fast1(point));
+        TRY(y = standard(point));
+        TEST_EQUAL(fast2(point), x);
+        TEST_EQUAL(fast_compact(point), x);
+        TEST_EQUAL(explicit_standard(point), y);
+        TEST_EQUAL(source1(point), source2(point));
+        TEST(x >= -1);
+        TEST(x <= 1);
+        differ += int(x != y);
+        sum += x;
+        sum2 += x * x;
+        ref2 += y * y;
+    }
+
+    double mean = sum / n;
+    double sd = std::sqrt(sum2 / n - mean * mean);
+    double ref_sd = std::sqrt(ref2 / n);
+    TEST(differ > n / 2);
+    TEST_NEAR(mean, 0, 0.03);
+    TEST_NEAR(sd, ref_sd, 0.03);
+
+}
+
+void test_rs_graphics_core_noise_cache() {
+
+    using cache_type = NoiseCache<double, 3>;
+    using pointer = cache_type::pointer;
+
+    cache_type cache;
+    pointer p1, p2, p3;
+    Noise<double, 3> noise42(42);
+    Double3 point(12.3, 45.6, 78.9);
+
+    TEST_EQUAL(cache.mode(), NoiseSeeding::standard);
+    TEST_EQUAL(cache.size(), 0u);
+
+    TRY(p1 = cache(42));
+    TRY(p2 = cache(42));
+    TRY(p3 = cache(86));
+    REQUIRE(p1);
+    REQUIRE(p3);
+    TEST_EQUAL(p1, p2);
+    TEST(p1 != p3);
+    TEST_EQUAL(cache.size(), 2u);
+    TEST_EQUAL((*p1)(point), noise42(point));
+    TEST((*p3)(point) != noise42(point));
+
+    TRY(p1.reset());
+    TEST_EQUAL(cache.size(), 2u);
+    TRY(p2.reset());
+    TEST_EQUAL(cache.size(), 1u);
+    TRY(cache.clear());
+    TEST_EQUAL(cache.size(), 0u);
+    TEST_EQUAL(p3.use_count(), 1);
+    TEST((*p3)(point) != noise42(point));
+
+    for (int i = 0; i < 1000; ++i)
+        TRY(cache(uint64_t(i)));
+    TEST_EQUAL(cache.size(), 0u);
+
+    NoiseCache<float, 2, NoiseLayout::compact> fast_cache(NoiseSeeding::fast);
+    Noise<float, 2, NoiseLayout::compact> fast_noise(42, NoiseSeeding::fast);
+    Float2 fpoint(12.3f, 45.6f);
+
+    TEST_EQUAL(fast_cache.mode(), NoiseSeeding::fast);
+    TEST_EQUAL((*fast_cache(42))(fpoint), fast_noise(fpoint));
+
+    static constexpr int tasks = 256;
+    static constexpr int seeds = 8;
+
+    ThreadPool pool(4);
+    std::vector<pointer> ptrs(tasks);
+
+    TRY(pool.for_each(tasks, [&] (size_t i) { ptrs[i] = cache(i % seeds); }));
+    TEST_EQUAL(cache.size(), size_t(seeds));
+
+    for (int i = 0; i < tasks; ++i)
+        TEST_EQUAL(ptrs[i], ptrs[i % seeds]);
+
+}
+
+void test_rs_graphics_core_noise_gradient() {
+
+    // Finite differences occasionally straddle one of the rare
+    // discontinuities in the candidate selection, so allow a few outliers
+
+    static constexpr int n = 10'000;
+    static constexpr double h = 1e-6;
+    static constexpr double epsilon = 1e-4;
+
+    std::minstd_rand rng(42);
+    std::uniform_real_distribution<double> coord_dist(-100, 100);
+
+    Noise<double, 2> noise2(42);
+    Noise<double, 3> noise3(42);
+    NoiseSource<double, 1, 1> source1(5, 2, 4, 42);
+    NoiseSource<double, 3, 2> source3(5, 2, 4, 42);
+    Double2 point2, grad2;
+    Double3 point3, grad3;
+    double value = 0;
+    int outliers = 0;
+
+    for (int i = 0; i < n; ++i) {
+
+        for (auto& p: point3)
+            p = coord_dist(rng);
+        point2 = {point3.x(), point3.y()};
+
+        TRY(std::tie(value, grad2) = noise2.eval_with_gradient(point2));
+        TEST_EQUAL(value, noise2(point2));
+        for (int j = 0; j < 2; ++j) {
+            auto p = point2, q = point2;
+            p[j] += h;
+            q[j] -= h;
+            double diff = (noise2(p) - noise2(q)) / (2 * h);
+            outliers += int(std::abs(grad2[j] - diff) > epsilon);
+        }
+
+        TRY(std::tie(value, grad3) = noise3.eval_with_gradient(point3));
+        TEST_EQUAL(value, noise3(point3));
+        for (int j = 0; j < 3; ++j) {
+            auto p = point3, q = point3;
+            p[j] += h;
+            q[j] -= h;
+            double diff = (noise3(p) - noise3(q)) / (2 * h);
+            outliers += int(std::abs(grad3[j] - diff) > epsilon);
+        }
+
+        double x = point3.x();
+        double dx = 0;
+        TRY(std::tie(value, dx) = source1.eval_with_gradient(x));
+        TEST_EQUAL(value, source1(x));
+        outliers += int(std::abs(dx - (source1(x + h) - source1(x - h)) / (2 * h)) > epsilon);
+
+        Double2 out;
+        std::array<Double3, 2> grads;
+        TRY(std::tie(out, grads) = source3.eval_with_gradient(point3));
+        TEST_EQUAL(out, source3(point3));
+        for (int j = 0; j < 3; ++j) {
+            auto p = point3, q = point3;
+            p[j] += h;
+            q[j] -= h;
+            auto diff = (source3(p) - source3(q)) / (2 * h);
+            for (int k = 0; k < 2; ++k)
+                outliers += int(std::abs(grads[k][j] - diff[k]) > epsilon);
+        }
+
+    }
+
+    TEST(outliers <= n / 1000);
+
+}
+
 void test_rs_graphics_core_noise_multiple_sources() {
 
     NoiseSource<double, 3, 1> source31;
@@ -0,0 +1,63 @@
+#include "rs-graphics-core/parallel.hpp"
+#include "rs-unit-test.hpp"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace RS::Graphics::Core;
+
+void test_rs_graphics_core_parallel_thread_pool() {
+
+    static constexpr size_t n = 10'000;
+
+    for (int threads: {1, 2, 4, 7}) {
+
+        ThreadPool pool(threads);
+        std::vector<int> hits(n, 0);
+
+        TEST_EQUAL(pool.threads(), threads);
+
+        TRY(pool.for_each(n, [&] (size_t i) { ++hits[i]; }));
+        TEST_EQUAL(std::count(hits.begin(), hits.end(), 1), int(n));
+
+        TRY(pool.for_each(n, [&] (size_t i) { hits[i] += int(i); }));
+        for (size_t i = 0; i < n; ++i)
+            TEST_EQUAL(hits[i], int(i) + 1);
+
+        TRY(pool.for_each(0, [&] (size_t) { hits[0] = -1; }));
+        TEST_EQUAL(hits[0], 1);
+
+    }
+
+    TEST(ThreadPool::global().threads() >= 1);
+
+}
+
+void test_rs_graphics_core_parallel_thread_pool_nesting() {
+
+    ThreadPool pool(4);
+    std::atomic<int> sum(0);
+
+    TRY(pool.for_each(10, [&] (size_t i) {
+        pool.for_each(10, [&] (size_t j) { sum += int(10 * i + j); });
+    }));
+    TEST_EQUAL(sum.load(), 4950);
+
+}
+
+void test_rs_graphics_core_parallel_thread_pool_exceptions() {
+
+    ThreadPool pool(4);
+    std::atomic<int> count(0);
+
+    TEST_THROW(pool.for_each(1000, [&] (size_t i) {
+        if (i == 500)
+            throw std::runtime_error("Test");
+        ++count;
+    }), std::runtime_error);
+    TEST(count.load() < 1000);
+
+    TRY(pool.for_each(1000, [&] (size_t) { ++count; }));
+
+}
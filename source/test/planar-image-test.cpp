@@ -0,0 +1,223 @@
+#include "rs-graphics-core/planar-image.hpp"
+#include "rs-graphics-core/colour.hpp"
+#include "rs-graphics-core/colour-space.hpp"
+#include "rs-graphics-core/simd.hpp"
+#include "rs-graphics-core/vector.hpp"
+#include "rs-unit-test.hpp"
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace RS::Graphics::Core;
+
+namespace {
+
+    constexpr Int2 test_shape = {37, 5};
+
+    template <typename C>
+    std::vector<C> random_pixels(size_t n) {
+        std::minstd_rand rng(42);
+        std::uniform_real_distribution<double> dist(0, 1);
+        std::vector<C> pixels(n);
+        for (auto& c: pixels)
+            for (auto& x: c)
+                x = typename C::value_type(dist(rng) * double(C::scale));
+        return pixels;
+    }
+
+    // Round trip through planes, checking against direct channel access
+
+    template <typename C>
+    int check_interleaving() {
+
+        using VT = typename C::value_type;
+        using CS = typename C::colour_space;
+
+        size_t n = size_t(test_shape.x() * test_shape.y());
+        auto in = random_pixels<C>(n);
+        PlanarImage<VT, CS, C::layout> image(test_shape, in.data());
+        std::vector<C> out(n);
+        int errors = 0;
+
+        for (int y = 0; y < test_shape.y(); ++y) {
+            for (int x = 0; x < test_shape.x(); ++x) {
+                auto& c = in[size_t(x + y * test_shape.x())];
+                for (int i = 0; i < C::colour_space_channels; ++i)
+                    errors += int(image.plane(i)(x, y) != c.cs(i));
+                if constexpr (C::has_alpha)
+                    errors += int(image.plane(C::colour_space_channels)(x, y) != c.alpha());
+            }
+        }
+
+        interleave(image.view(), out.data());
+        errors += int(out != in);
+
+        return errors;
+
+    }
+
+    // Planar conversion must give exactly the same results as bulk
+    // conversion of the interleaved pixels
+
+    template <typename C1, typename C2>
+    int check_conversion(ColourPrecision precision = ColourPrecision::exact) {
+
+        size_t n = size_t(test_shape.x() * test_shape.y());
+        auto in = random_pixels<C1>(n);
+        std::vector<C2> expect(n), out(n);
+        convert_colour(in.data(), expect.data(), n, precision);
+
+        PlanarImage<typename C1::value_type, typename C1::colour_space, C1::layout> image1(test_shape, in.data());
+        PlanarImage<typename C2::value_type, typename C2::colour_space, C2::layout> image2(test_shape);
+        convert_colour(image1.view(), image2.view(), precision);
+        interleave(image2.view(), out.data());
+
+        int errors = 0;
+        for (size_t i = 0; i < n; ++i)
+            errors += int(out[i] != expect[i]);
+
+        return errors;
+
+    }
+
+}
+
+void test_rs_graphics_core_planar_image_construction() {
+
+    using Image = PlanarImage<float, LinearRGB, ColourLayout::forward_alpha>;
+
+    Image image;
+
+    TEST(image.empty());
+    TEST_EQUAL(image.shape(), Int2(0, 0));
+    TEST_EQUAL(image.size(), 0u);
+    TEST_EQUAL(Image::planes, 4);
+
+    TRY(image = Image({4, 3}, Rgbaf(0.25f, 0.5f, 0.75f, 1)));
+    TEST(! image.empty());
+    TEST_EQUAL(image.shape(), Int2(4, 3));
+    TEST_EQUAL(image.width(), 4);
+    TEST_EQUAL(image.height(), 3);
+    TEST_EQUAL(image.size(), 12u);
+    TEST_EQUAL(image.plane(0).shape(), Int2(4, 3));
+    TEST_EQUAL(image.plane(2)(3, 2), 0.75f);
+    TEST_EQUAL(image.get(1, 1), Rgbaf(0.25f, 0.5f, 0.75f, 1));
+
+    TRY(image.set(2, 1, Rgbaf(0.1f, 0.2f, 0.3f, 0.4f)));
+    TEST_EQUAL(image.get(2, 1), Rgbaf(0.1f, 0.2f, 0.3f, 0.4f));
+    TEST_EQUAL(image.plane(3)(2, 1), 0.4f);
+
+    TEST_THROW(Image({-1, 2}), std::invalid_argument);
+
+}
+
+void test_rs_graphics_core_planar_image_views() {
+
+    using Image = PlanarImage<uint8_t, sRGB, ColourLayout::alpha_reverse>;
+    using C = Image::colour_type;
+
+    Image image({6, 4}, C(10, 20, 30, 40));
+    const auto& cimage = image;
+    Image::view_type view;
+    Image::const_view_type cview;
+
+    TRY(view = image.view({2, 1}, {3, 2}));
+    TEST_EQUAL(view.shape(), Int2(3, 2));
+    TEST_EQUAL(view.stride(), 6);
+    TEST_EQUAL(view.size(), 6u);
+    TEST(view.plane(0) == image.plane(0).data() + 8);
+
+    TRY(view.set(0, 0, C(1, 2, 3, 4)));
+    TRY(view.set(2, 1, C(5, 6, 7, 8)));
+    TEST_EQUAL(image.get(2, 1), C(1, 2, 3, 4));
+    TEST_EQUAL(image.get(4, 2), C(5, 6, 7, 8));
+    TEST_EQUAL(image.get(3, 2), C(10, 20, 30, 40));
+    TEST_EQUAL(int(image.plane(0)(4, 2)), 8);  // Red
+    TEST_EQUAL(int(image.plane(3)(4, 2)), 5);  // Alpha
+
+    TRY(cview = view);
+    TEST_EQUAL(cview.get(2, 1), C(5, 6, 7, 8));
+    TRY(cview = cimage.view().subview({4, 2}, {2, 2}));
+    TEST_EQUAL(cview.get(0, 0), C(5, 6, 7, 8));
+    TEST(cview.row(0, 1) == image.plane(0).data() + 22);
+
+    TEST_THROW(image.view({4, 2}, {3, 1}), std::invalid_argument);
+    TEST_THROW(image.view({0, 0}, {6, 5}), std::invalid_argument);
+    TEST_THROW(image.view({-1, 0}, {1, 1}), std::invalid_argument);
+
+}
+
+void test_rs_graphics_core_planar_image_interleaving() {
+
+    auto native = simd_level();
+
+    for (auto level: {SimdLevel::none, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512}) {
+        if (level > native)
+            break;
+        TRY(limit_simd_level(level));
+        TEST_EQUAL(check_interleaving<Rgbf>(), 0);
+        TEST_EQUAL(check_interleaving<Rgbaf>(), 0);
+        TEST_EQUAL((check_interleaving<Colour<float, sRGB, ColourLayout::reverse>>()), 0);
+        TEST_EQUAL((check_interleaving<Colour<float, LinearRGB, ColourLayout::alpha_forward>>()), 0);
+        TEST_EQUAL((check_interleaving<Colour<float, CIELab, ColourLayout::reverse_alpha>>()), 0);
+        TEST_EQUAL(check_interleaving<Rgba8>(), 0);
+        TEST_EQUAL(check_interleaving<sRgb16>(), 0);
+        TEST_EQUAL(check_interleaving<Rgbad>(), 0);
+    }
+
+    TRY(limit_simd_level(SimdLevel::avx512));
+    TEST_EQUAL(simd_level(), native);
+
+}
+
+void test_rs_graphics_core_planar_image_conversion() {
+
+    using AdobeRgbf = Colour<float, AdobeRGB, ColourLayout::forward>;
+    using AdobeRgba8 = Colour<uint8_t, AdobeRGB, ColourLayout::forward_alpha>;
+    using LinearAdobeRgbf = Colour<float, LinearAdobeRGB, ColourLayout::forward>;
+    using LinearProPhotof = Colour<float, LinearProPhoto, ColourLayout::forward>;
+    using CIELabd = Colour<double, CIELab, ColourLayout::forward>;
+    using HCLabf = Colour<float, HCLab, ColourLayout::forward>;
+
+    auto native = simd_level();
+
+    for (auto level: {SimdLevel::none, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512}) {
+
+        if (level > native)
+            break;
+
+        TRY(limit_simd_level(level));
+
+        TEST_EQUAL((check_conversion<Rgbaf, Rgbaf>()), 0);
+        TEST_EQUAL((check_conversion<Rgbf, Rgbaf>()), 0);
+        TEST_EQUAL((check_conversion<Rgbaf, Rgba8>()), 0);
+        TEST_EQUAL((check_conversion<Rgba8, Rgbaf>()), 0);
+        TEST_EQUAL((check_conversion<sRgba8, Rgbaf>()), 0);
+        TEST_EQUAL((check_conversion<Rgbaf, sRgba8>()), 0);
+        TEST_EQUAL((check_conversion<sRgbf, Rgbf>()), 0);
+        TEST_EQUAL((check_conversion<Rgbf, sRgb16>()), 0);
+        TEST_EQUAL((check_conversion<Rgbf, LinearAdobeRgbf>()), 0);
+        TEST_EQUAL((check_conversion<LinearAdobeRgbf, LinearProPhotof>()), 0);
+        TEST_EQUAL((check_conversion<sRgba8, AdobeRgba8>()), 0);
+        TEST_EQUAL((check_conversion<sRgbd, CIELabd>()), 0);
+        TEST_EQUAL((check_conversion<sRgbf, HCLabf>()), 0);
+
+        for (auto precision: {ColourPrecision::exact, ColourPrecision::fast}) {
+            TEST_EQUAL((check_conversion<sRgbf, Rgbf>(precision)), 0);
+            TEST_EQUAL((check_conversion<Rgbf, sRgbf>(precision)), 0);
+            TEST_EQUAL((check_conversion<Rgbaf, sRgba16>(precision)), 0);
+            TEST_EQUAL((check_conversion<sRgbf, AdobeRgbf>(precision)), 0);
+            TEST_EQUAL((check_conversion<AdobeRgbf, sRgba8>(precision)), 0);
+        }
+
+    }
+
+    TRY(limit_simd_level(SimdLevel::avx512));
+    TEST_EQUAL(simd_level(), native);
+
+    PlanarImage<float, LinearRGB, ColourLayout::forward_alpha> a({4, 4}), b({4, 5});
+
+    TEST_THROW(convert_colour(a.view(), b.view()), std::invalid_argument);
+
+}
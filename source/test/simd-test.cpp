@@ -0,0 +1,23 @@
+#include "rs-graphics-core/simd.hpp"
+#include "rs-unit-test.hpp"
+
+using namespace RS::Graphics::Core;
+
+void test_rs_graphics_core_simd_level() {
+
+    SimdLevel native = SimdLevel::none;
+
+    TRY(native = simd_level());
+    TEST(native >= SimdLevel::none);
+    TEST(native <= SimdLevel::avx512);
+
+    TRY(limit_simd_level(SimdLevel::none));
+    TEST_EQUAL(simd_level(), SimdLevel::none);
+
+    TRY(limit_simd_level(SimdLevel::sse2));
+    TEST(simd_level() <= SimdLevel::sse2);
+
+    TRY(limit_simd_level(SimdLevel::avx512));
+    TEST_EQUAL(simd_level(), native);
+
+}
@@ -20,8 +20,21 @@ int main(int argc, char** argv) {
     // root-finding-test.cpp
     UNIT_TEST(rs_graphics_core_root_finding_newton_raphson)
 
+    // simd-test.cpp
+    UNIT_TEST(rs_graphics_core_simd_level)
+
+    // parallel-test.cpp
+    UNIT_TEST(rs_graphics_core_parallel_thread_pool)
+    UNIT_TEST(rs_graphics_core_parallel_thread_pool_nesting)
+    UNIT_TEST(rs_graphics_core_parallel_thread_pool_exceptions)
+
     // linear-map-test.cpp
     UNIT_TEST(rs_graphics_core_linear_map)
+    UNIT_TEST(rs_graphics_core_linear_map_transform)
+    UNIT_TEST(rs_graphics_core_linear_map_frozen)
+    UNIT_TEST(rs_graphics_core_linear_map_knots)
+    UNIT_TEST(rs_graphics_core_linear_map_ramp)
+    UNIT_TEST(rs_graphics_core_linear_map_ramp_batch)
 
     // vector-test.cpp
     UNIT_TEST(rs_graphics_core_integer_vector_construction)
@@ -70,6 +83,8 @@ int main(int argc, char** argv) {
     UNIT_TEST(rs_graphics_core_colour_space_greyscale)
     UNIT_TEST(rs_graphics_core_colour_space_sgreyscale)
     UNIT_TEST(rs_graphics_core_colour_space_conversion)
+    UNIT_TEST(rs_graphics_core_colour_space_linear_chains)
+    UNIT_TEST(rs_graphics_core_colour_space_routing)
 
     // colour-floating-channel-test.cpp
     UNIT_TEST(rs_graphics_core_colour_floating_point_elements)
@@ -85,10 +100,15 @@ int main(int argc, char** argv) {
     UNIT_TEST(rs_graphics_core_colour_channel_order)
     UNIT_TEST(rs_graphics_core_colour_premultiplied_alpha)
     UNIT_TEST(rs_graphics_core_colour_alpha_blending)
+    UNIT_TEST(rs_graphics_core_colour_alpha_blending_spans)
 
     // colour-conversion-test.cpp
     UNIT_TEST(rs_graphics_core_colour_conversion_between_colour_spaces)
     UNIT_TEST(rs_graphics_core_colour_conversion_between_representations)
+    UNIT_TEST(rs_graphics_core_colour_conversion_bulk)
+    UNIT_TEST(rs_graphics_core_colour_conversion_lookup_tables)
+    UNIT_TEST(rs_graphics_core_colour_conversion_fast_transfer)
+    UNIT_TEST(rs_graphics_core_colour_conversion_fast_spaces)
 
     // colour-interpolation-test.cpp
     UNIT_TEST(rs_graphics_core_colour_interpolation)
@@ -96,9 +116,50 @@ int main(int argc, char** argv) {
     // colour-string-test.cpp
     UNIT_TEST(rs_graphics_core_colour_hex_representation)
     UNIT_TEST(rs_graphics_core_colour_css_colours)
+    UNIT_TEST(rs_graphics_core_colour_string_parsing)
+
+    // colour-lut-test.cpp
+    UNIT_TEST(rs_graphics_core_colour_lut_construction)
+    UNIT_TEST(rs_graphics_core_colour_lut_interpolation)
+    UNIT_TEST(rs_graphics_core_colour_lut_colour_spaces)
+    UNIT_TEST(rs_graphics_core_colour_lut_batch)
+    UNIT_TEST(rs_graphics_core_colour_lut_ramp_perceptual)
+
+    // colour-gamut-test.cpp
+    UNIT_TEST(rs_graphics_core_colour_gamut_mask)
+    UNIT_TEST(rs_graphics_core_colour_gamut_mapping)
+    UNIT_TEST(rs_graphics_core_colour_gamut_spans)
+    UNIT_TEST(rs_graphics_core_colour_gamut_lut)
+
+    // colour-difference-test.cpp
+    UNIT_TEST(rs_graphics_core_colour_difference_scalar)
+    UNIT_TEST(rs_graphics_core_colour_difference_batch)
+    UNIT_TEST(rs_graphics_core_colour_difference_statistics)
+    UNIT_TEST(rs_graphics_core_colour_difference_map)
+
+    // colour-palette-test.cpp
+    UNIT_TEST(rs_graphics_core_colour_palette_nearest)
+    UNIT_TEST(rs_graphics_core_colour_palette_batch)
+    UNIT_TEST(rs_graphics_core_colour_palette_median_cut)
+    UNIT_TEST(rs_graphics_core_colour_palette_k_means)
+
+    // planar-image-test.cpp
+    UNIT_TEST(rs_graphics_core_planar_image_construction)
+    UNIT_TEST(rs_graphics_core_planar_image_views)
+    UNIT_TEST(rs_graphics_core_planar_image_interleaving)
+    UNIT_TEST(rs_graphics_core_planar_image_conversion)
 
     // noise-test.cpp
     UNIT_TEST(rs_graphics_core_noise_result_stability)
+    UNIT_TEST(rs_graphics_core_noise_batch_evaluation)
+    UNIT_TEST(rs_graphics_core_noise_simd_kernels)
+    UNIT_TEST(rs_graphics_core_noise_scanline)
+    UNIT_TEST(rs_graphics_core_noise_array_fill)
+    UNIT_TEST(rs_graphics_core_noise_source_fused_evaluation)
+    UNIT_TEST(rs_graphics_core_noise_compact_layout)
+    UNIT_TEST(rs_graphics_core_noise_fast_seeding)
+    UNIT_TEST(rs_graphics_core_noise_cache)
+    UNIT_TEST(rs_graphics_core_noise_gradient)
     UNIT_TEST(rs_graphics_core_noise_multiple_sources)
     UNIT_TEST(rs_graphics_core_noise_statistics)
     UNIT_TEST(rs_graphics_core_noise_sample_renders)